@@ -31,8 +31,7 @@ let package = Package(
         )
     ],
     dependencies: [
-        // We'll add DuckDB and other dependencies here later
-        // For now, keeping it simple to get the structure right
+        // Native libraries (Arrow, Parquet, DuckDB) come from Homebrew
     ],
     targets: [
         // Main application target
@@ -69,13 +68,32 @@ let package = Package(
             ]
         ),
         
+        // DuckDB C API
+        .systemLibrary(
+            name: "CDuckDB",
+            path: "Sources/CDuckDB",
+            providers: [.brew(["duckdb"])]
+        ),
+
         // Shared core functionality
         .target(
             name: "SharedCore",
-            dependencies: ["CParquetReader"],
+            dependencies: ["CParquetReader", "CDuckDB"],
             path: "Sources/SharedCore",
             exclude: ["Scripts", "cpp"],
-            sources: ["Bridge", "Models", "Services"]
+            sources: ["Bridge", "Models", "Services"],
+            swiftSettings: [
+                .unsafeFlags([
+                    "-Xcc", "-I/opt/homebrew/include",
+                    "-Xcc", "-I/usr/local/include"
+                ])
+            ],
+            linkerSettings: [
+                .unsafeFlags([
+                    "-L/opt/homebrew/lib",
+                    "-L/usr/local/lib"
+                ])
+            ]
         ),
         
         // Test reader executable
@@ -247,7 +247,7 @@ echo ""
 echo "Distribution Notes:"
 echo "  - The app requires macOS 13.0 (Ventura) or later"
 echo "  - Users need Apache Arrow and Parquet libraries installed"
-echo "    Install with: brew install apache-arrow"
+echo "    Install with: brew install apache-arrow duckdb"
 
 if [ "$SIGN_APP" = false ]; then
     echo ""
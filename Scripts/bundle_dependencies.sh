@@ -31,7 +31,7 @@ copy_and_update_lib() {
         install_name_tool -id "@executable_path/../Frameworks/$lib_name" "$FRAMEWORKS_PATH/$lib_name" 2>/dev/null || true
         
         # Check for dependencies of this library
-        otool -L "$FRAMEWORKS_PATH/$lib_name" | grep -E "(arrow|parquet)" | awk '{print $1}' | while read dep; do
+        otool -L "$FRAMEWORKS_PATH/$lib_name" | grep -E "(arrow|parquet|duckdb)" | awk '{print $1}' | while read dep; do
             if [[ "$dep" != "@executable_path"* ]]; then
                 local dep_name=$(basename "$dep")
                 install_name_tool -change "$dep" "@executable_path/../Frameworks/$dep_name" "$FRAMEWORKS_PATH/$lib_name" 2>/dev/null || true
@@ -42,7 +42,7 @@ copy_and_update_lib() {
 
 # Find actual library paths from the binary
 echo "Detecting library dependencies..."
-LIBS_TO_COPY=$(otool -L "$EXECUTABLE_PATH" | grep -E "(arrow|parquet)" | awk '{print $1}')
+LIBS_TO_COPY=$(otool -L "$EXECUTABLE_PATH" | grep -E "(arrow|parquet|duckdb)" | awk '{print $1}')
 
 # Copy each library
 for lib_path in $LIBS_TO_COPY; do
@@ -77,7 +77,7 @@ done
 
 # Fix any remaining absolute paths in the main executable
 echo "Fixing library paths in executable..."
-otool -L "$EXECUTABLE_PATH" | grep -E "(arrow|parquet)" | awk '{print $1}' | while read lib; do
+otool -L "$EXECUTABLE_PATH" | grep -E "(arrow|parquet|duckdb)" | awk '{print $1}' | while read lib; do
     if [[ "$lib" != "@executable_path"* ]]; then
         lib_name=$(basename "$lib")
         if [ -f "$FRAMEWORKS_PATH/$lib_name" ]; then
@@ -90,7 +90,7 @@ done
 echo ""
 echo "Verifying bundled libraries..."
 echo "Main executable dependencies:"
-otool -L "$EXECUTABLE_PATH" | grep -E "(arrow|parquet)" || echo "  No Arrow/Parquet dependencies found (might be statically linked)"
+otool -L "$EXECUTABLE_PATH" | grep -E "(arrow|parquet|duckdb)" || echo "  No Arrow/Parquet dependencies found (might be statically linked)"
 
 echo ""
 echo "Bundled frameworks:"
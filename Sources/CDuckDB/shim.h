@@ -0,0 +1,7 @@
+#ifndef CDUCKDB_SHIM_H
+#define CDUCKDB_SHIM_H
+
+// DuckDB's C API, from the Homebrew duckdb formula
+#include <duckdb.h>
+
+#endif // CDUCKDB_SHIM_H
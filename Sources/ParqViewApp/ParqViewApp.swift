@@ -35,6 +35,7 @@ class AppDelegate: NSObject, NSApplicationDelegate {
 
     func applicationDidFinishLaunching(_ notification: Notification) {
         logger.debug("applicationDidFinishLaunching - Windows: \(NSApplication.shared.windows.count)")
+        SettingsView.applyBinaryFormat()
         NSApplication.shared.activate(ignoringOtherApps: true)
 
         DispatchQueue.main.async {
@@ -92,8 +93,8 @@ class AppDelegate: NSObject, NSApplicationDelegate {
             NSApplication.shared.setActivationPolicy(.regular)
         }
 
-        // Process all valid parquet files, not just the first one
-        let parquetURLs = urls.filter { ["parquet", "parq"].contains($0.pathExtension.lowercased()) }
+        // Process all readable files, not just the first one
+        let parquetURLs = urls.filter { ParquetFileFormat.readableExtensions.contains($0.pathExtension.lowercased()) }
 
         for url in parquetURLs {
             if let appState = appState {
@@ -111,7 +112,7 @@ class AppDelegate: NSObject, NSApplicationDelegate {
         }
 
         if parquetURLs.isEmpty && !urls.isEmpty {
-            logger.warning("No valid parquet files in opened URLs")
+            logger.warning("No readable files in opened URLs")
         }
     }
 
@@ -208,9 +209,7 @@ class AppState: ObservableObject {
 
     func openDocument() {
         let panel = NSOpenPanel()
-        let parquetType = UTType(filenameExtension: "parquet") ?? .data
-        let parqType = UTType(filenameExtension: "parq") ?? .data
-        panel.allowedContentTypes = [parquetType, parqType]
+        panel.allowedContentTypes = ParquetFileFormat.readableExtensions.map { UTType(filenameExtension: $0) ?? .data }
         panel.allowsMultipleSelection = false
         panel.canChooseDirectories = false
 
@@ -241,9 +240,9 @@ class AppState: ObservableObject {
                     throw ParquetError.fileNotFound(url.path)
                 }
 
-                let validExtensions = ["parquet", "parq"]
-                guard validExtensions.contains(url.pathExtension.lowercased()) else {
-                    throw ParquetError.invalidFormat("Invalid file type. Expected .parquet or .parq")
+                guard ParquetFileFormat.readableExtensions.contains(url.pathExtension.lowercased()) else {
+                    let expected = ParquetFileFormat.readableExtensions.map { ".\($0)" }.joined(separator: ", ")
+                    throw ParquetError.invalidFormat("Invalid file type. Expected one of \(expected)")
                 }
 
                 let file = try await ParquetFile.load(from: url)
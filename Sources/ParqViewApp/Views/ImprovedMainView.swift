@@ -17,6 +17,7 @@ struct ImprovedMainView: View {
                             // Schema sidebar
                             SchemaSidebar(
                                 schema: file.schema,
+                                fileURL: file.url,
                                 selectedColumns: $selectedColumns
                             )
                             .frame(width: 250)
@@ -109,6 +110,8 @@ struct HeaderToolbar: View {
     let onBack: () -> Void
     @FocusState private var isFilterFocused: Bool
     @State private var showFileInfo: Bool = false
+    @State private var isAccelerated = false
+    @State private var isAccelerating = false
 
     private var hasUnappliedChanges: Bool {
         filterText != activeFilter
@@ -270,24 +273,61 @@ struct HeaderToolbar: View {
 
                     Divider()
 
-                    // Copy path button
-                    Button(action: {
-                        NSPasteboard.general.clearContents()
-                        NSPasteboard.general.setString(file.url.path, forType: .string)
-                    }) {
-                        Label("Copy Path", systemImage: "doc.on.doc")
+                    HStack {
+                        // Copy path button
+                        Button(action: {
+                            NSPasteboard.general.clearContents()
+                            NSPasteboard.general.setString(file.url.path, forType: .string)
+                        }) {
+                            Label("Copy Path", systemImage: "doc.on.doc")
+                        }
+
+                        // Keeps an Arrow copy that pages are sliced from without decoding
+                        if ParquetBridge.shared.fileFormat(of: file.url) == .parquet {
+                            Button(action: toggleAcceleration) {
+                                if isAccelerating {
+                                    Label("Accelerating...", systemImage: "bolt")
+                                } else if isAccelerated {
+                                    Label("Remove Arrow Copy", systemImage: "bolt.slash")
+                                } else {
+                                    Label("Accelerate", systemImage: "bolt")
+                                }
+                            }
+                            .disabled(isAccelerating)
+                            .help("Keep an uncompressed Arrow copy for faster browsing")
+                        }
                     }
                     .buttonStyle(.bordered)
                     .controlSize(.small)
                 }
                 .padding()
                 .frame(minWidth: 300)
+                .onAppear {
+                    isAccelerated = ParquetBridge.shared.isAccelerated(file.url)
+                }
             }
         }
         .padding()
         .background(Color(NSColor.windowBackgroundColor))
     }
 
+    private func toggleAcceleration() {
+        let url = file.url
+        if isAccelerated {
+            ParquetBridge.shared.removeAcceleration(for: url)
+            isAccelerated = false
+            return
+        }
+        isAccelerating = true
+        Task {
+            let accelerated = await Task.detached(priority: .utility) {
+                (try? ParquetBridge.shared.accelerate(url)) != nil
+            }.value
+            isAccelerating = false
+            isAccelerated = accelerated
+        }
+    }
+
     private func performSearch() {
         guard !isSearching else { return }
         activeFilter = filterText
@@ -302,8 +342,10 @@ struct HeaderToolbar: View {
 
 struct SchemaSidebar: View {
     let schema: ParquetSchema
+    let fileURL: URL
     @Binding var selectedColumns: Set<String>
     @State private var searchText = ""
+    @State private var columnStats: [String: ColumnStatistics] = [:]
 
     private var filteredColumns: [SchemaColumn] {
         if searchText.isEmpty {
@@ -396,6 +438,8 @@ struct SchemaSidebar: View {
                         ForEach(filteredColumns) { column in
                             ColumnCheckbox(
                                 column: column,
+                                stats: columnStats[column.name],
+                                fileURL: fileURL,
                                 isSelected: selectedColumns.contains(column.name),
                                 onToggle: {
                                     if selectedColumns.contains(column.name) {
@@ -411,6 +455,34 @@ struct SchemaSidebar: View {
                 .padding(.vertical, 8)
             }
         }
+        .task(id: schema) {
+            await loadStatistics()
+        }
+    }
+
+    /// Fills in per-column statistics. A first pass reads only footer
+    /// statistics and dictionary pages, so even very large files show null
+    /// counts and ranges at once; columns the footer says nothing about are
+    /// then scanned one at a time.
+    private func loadStatistics() async {
+        columnStats = [:]
+        let url = fileURL
+        for allowScan in [false, true] {
+            for (index, column) in schema.columns.enumerated() {
+                if Task.isCancelled {
+                    return
+                }
+                if allowScan, let known = columnStats[column.name], known.nullCount >= 0 {
+                    continue
+                }
+                let stats = await Task.detached(priority: .utility) {
+                    try? ParquetBridge.shared.readColumnStatistics(from: url, columnIndex: index, allowScan: allowScan)
+                }.value
+                if let stats = stats {
+                    columnStats[column.name] = stats
+                }
+            }
+        }
     }
 
     private var allSelected: Bool {
@@ -432,8 +504,35 @@ struct SchemaSidebar: View {
 
 struct ColumnCheckbox: View {
     let column: SchemaColumn
+    var stats: ColumnStatistics? = nil
+    var fileURL: URL? = nil
     let isSelected: Bool
     let onToggle: () -> Void
+    @State private var showingValueCounts = false
+    @State private var showingFields = false
+
+    private var isNested: Bool {
+        column.type == .structure || column.type == .list || column.type == .map
+    }
+
+    /// Null share and distinct count, whichever are known
+    private var statsSummary: String? {
+        guard let stats = stats else { return nil }
+        var parts: [String] = []
+        if stats.nullCount >= 0 {
+            parts.append(String(format: "%.1f%% null", stats.nullPercentage))
+        }
+        if stats.distinctCount >= 0 {
+            let prefix = stats.isDistinctCountEstimate ? "~" : ""
+            parts.append("\(prefix)\(stats.distinctCount.formatted()) distinct")
+        }
+        return parts.isEmpty ? nil : parts.joined(separator: " · ")
+    }
+
+    private var rangeSummary: String? {
+        guard let min = stats?.minValue, let max = stats?.maxValue else { return nil }
+        return min == max ? min : "\(min) – \(max)"
+    }
     
     var body: some View {
         Button(action: onToggle) {
@@ -450,6 +549,21 @@ struct ColumnCheckbox: View {
                     Text(column.type.description)
                         .font(.system(size: 11))
                         .foregroundStyle(.secondary)
+
+                    if let summary = statsSummary {
+                        Text(summary)
+                            .font(.system(size: 10))
+                            .foregroundStyle(.tertiary)
+                    }
+
+                    if let range = rangeSummary {
+                        Text(range)
+                            .font(.system(size: 10, design: .monospaced))
+                            .foregroundStyle(.tertiary)
+                            .lineLimit(1)
+                            .truncationMode(.middle)
+                            .help(range)
+                    }
                 }
                 
                 Spacer()
@@ -457,9 +571,267 @@ struct ColumnCheckbox: View {
             .contentShape(Rectangle())
         }
         .buttonStyle(.plain)
+        .overlay(alignment: .topTrailing) {
+            if let fileURL = fileURL {
+                HStack(spacing: 8) {
+                    if isNested {
+                        Button(action: { showingFields.toggle() }) {
+                            Image(systemName: showingFields ? "chevron.down" : "chevron.right")
+                                .font(.system(size: 11))
+                                .foregroundStyle(.secondary)
+                        }
+                        .buttonStyle(.plain)
+                        .help("Nested fields")
+                    }
+
+                    Button(action: { showingValueCounts.toggle() }) {
+                        Image(systemName: "chart.bar.xaxis")
+                            .font(.system(size: 11))
+                            .foregroundStyle(.secondary)
+                    }
+                    .buttonStyle(.plain)
+                    .help("Most frequent values")
+                    .popover(isPresented: $showingValueCounts, arrowEdge: .trailing) {
+                        ValueCountsView(fileURL: fileURL, column: column.name)
+                    }
+                }
+            }
+        }
         .padding(.horizontal, 12)
         .padding(.vertical, 4)
         .background(isSelected ? Color.accentColor.opacity(0.1) : Color.clear)
+
+        if showingFields, let fileURL = fileURL {
+            NestedFieldsView(fileURL: fileURL, column: column.name)
+                .padding(.leading, 33)
+                .padding(.trailing, 12)
+                .padding(.bottom, 4)
+        }
+    }
+}
+
+/// The fields under a struct, list or map column, read from the file's
+/// field tree when the column is first expanded
+struct NestedFieldsView: View {
+    let fileURL: URL
+    let column: String
+    @State private var fields: [ParquetField]?
+    @State private var failed = false
+
+    var body: some View {
+        VStack(alignment: .leading, spacing: 2) {
+            if let fields = fields {
+                ForEach(fields) { field in
+                    NestedFieldRow(fileURL: fileURL, field: field)
+                }
+            } else if failed {
+                Text("Fields unavailable")
+                    .font(.caption)
+                    .foregroundStyle(.secondary)
+            } else {
+                ProgressView()
+                    .controlSize(.small)
+            }
+        }
+        .task {
+            await loadFields()
+        }
+    }
+
+    private func loadFields() async {
+        let url = fileURL
+        let name = column
+        let result = await Task.detached(priority: .userInitiated) {
+            try? ParquetBridge.shared.readFieldTree(from: url).first { $0.path == name }
+        }.value
+        if let result = result {
+            fields = result.children
+        } else {
+            failed = true
+        }
+    }
+}
+
+/// One nested field: expands into its children, or for a leaf, previews
+/// its first values while decoding only that leaf column
+struct NestedFieldRow: View {
+    let fileURL: URL
+    let field: ParquetField
+    @State private var isExpanded = false
+    @State private var showingValues = false
+
+    var body: some View {
+        if field.children.isEmpty {
+            HStack(spacing: 6) {
+                fieldLabel
+                Spacer()
+                Button(action: { showingValues.toggle() }) {
+                    Image(systemName: "eye")
+                        .font(.system(size: 10))
+                        .foregroundStyle(.secondary)
+                }
+                .buttonStyle(.plain)
+                .help("First values")
+                .popover(isPresented: $showingValues, arrowEdge: .trailing) {
+                    FieldValuesView(fileURL: fileURL, path: field.path)
+                }
+            }
+        } else {
+            DisclosureGroup(isExpanded: $isExpanded) {
+                ForEach(field.children) { child in
+                    NestedFieldRow(fileURL: fileURL, field: child)
+                }
+            } label: {
+                fieldLabel
+            }
+        }
+    }
+
+    private var fieldLabel: some View {
+        VStack(alignment: .leading, spacing: 1) {
+            Text(field.name)
+                .font(.system(size: 12))
+            Text(field.type)
+                .font(.system(size: 10))
+                .foregroundStyle(.secondary)
+                .lineLimit(1)
+                .truncationMode(.tail)
+                .help(field.type)
+        }
+    }
+}
+
+/// The first values of one nested field
+struct FieldValuesView: View {
+    let fileURL: URL
+    let path: String
+    @State private var values: [String]?
+    @State private var failed = false
+
+    var body: some View {
+        VStack(alignment: .leading, spacing: 4) {
+            Text(path)
+                .font(.headline)
+                .lineLimit(1)
+                .truncationMode(.middle)
+
+            if let values = values {
+                ForEach(Array(values.enumerated()), id: \.offset) { _, value in
+                    Text(value)
+                        .font(.system(size: 12, design: .monospaced))
+                        .lineLimit(1)
+                        .truncationMode(.tail)
+                }
+            } else if failed {
+                Text("Values unavailable")
+                    .font(.caption)
+                    .foregroundStyle(.secondary)
+            } else {
+                ProgressView()
+                    .controlSize(.small)
+            }
+        }
+        .padding(12)
+        .frame(width: 300, alignment: .leading)
+        .task {
+            await loadValues()
+        }
+    }
+
+    private func loadValues() async {
+        let url = fileURL
+        let fieldPath = path
+        let result = await Task.detached(priority: .userInitiated) {
+            try? ParquetBridge.shared.readFieldPaths(from: url, paths: [fieldPath], limit: 20)
+        }.value
+        if let rows = result {
+            values = rows.map { $0.values.first.map { ValueFormatters.displayString(for: $0) } ?? "NULL" }
+        } else {
+            failed = true
+        }
+    }
+}
+
+/// Most frequent values of one column, shown from the schema sidebar
+struct ValueCountsView: View {
+    let fileURL: URL
+    let column: String
+    @State private var facets: ColumnFacets?
+    @State private var failed = false
+
+    var body: some View {
+        VStack(alignment: .leading, spacing: 6) {
+            Text(column)
+                .font(.headline)
+                .lineLimit(1)
+
+            if let facets = facets {
+                ForEach(Array(facets.values.enumerated()), id: \.offset) { _, value in
+                    VStack(alignment: .leading, spacing: 2) {
+                        HStack {
+                            Text(value.value)
+                                .font(.system(size: 12))
+                                .lineLimit(1)
+                                .truncationMode(.middle)
+                            Spacer()
+                            Text(countLabel(value))
+                                .font(.system(size: 11).monospacedDigit())
+                                .foregroundStyle(.secondary)
+                        }
+                        ProgressView(value: Double(value.count), total: Double(max(facets.rowCount, value.count, 1)))
+                            .progressViewStyle(.linear)
+                    }
+                }
+
+                if facets.nullCount > 0 {
+                    HStack {
+                        Text("NULL")
+                            .font(.system(size: 12))
+                            .italic()
+                            .foregroundStyle(.secondary)
+                        Spacer()
+                        Text(facets.nullCount.formatted())
+                            .font(.system(size: 11).monospacedDigit())
+                            .foregroundStyle(.secondary)
+                    }
+                }
+
+                if !facets.isExact {
+                    Text("Counts are approximate")
+                        .font(.caption)
+                        .foregroundStyle(.tertiary)
+                }
+            } else if failed {
+                Text("Value counts unavailable")
+                    .font(.caption)
+                    .foregroundStyle(.secondary)
+            } else {
+                ProgressView()
+                    .controlSize(.small)
+            }
+        }
+        .padding(12)
+        .frame(width: 260)
+        .task {
+            await loadFacets()
+        }
+    }
+
+    private func countLabel(_ value: ColumnFacets.Value) -> String {
+        value.error > 0 ? "≤ \(value.count.formatted())" : value.count.formatted()
+    }
+
+    private func loadFacets() async {
+        let url = fileURL
+        let name = column
+        let result = await Task.detached(priority: .userInitiated) {
+            try? ParquetBridge.shared.readFacets(from: url, columns: [name], topN: 10).first
+        }.value
+        if let result = result {
+            facets = result
+        } else {
+            failed = true
+        }
     }
 }
 
@@ -493,7 +865,7 @@ struct WelcomeScreen: View {
             .controlSize(.large)
             .buttonStyle(.borderedProminent)
             
-            Text("or drag and drop a .parquet file")
+            Text("or drag and drop a Parquet, Arrow, CSV or NDJSON file")
                 .font(.caption)
                 .foregroundStyle(.secondary)
             
@@ -542,11 +914,10 @@ struct WelcomeScreen: View {
             DispatchQueue.main.async {
                 if let urlData = urlData as? Data,
                    let url = URL(dataRepresentation: urlData, relativeTo: nil) {
-                    let validExtensions = ["parquet", "parq"]
-                    if validExtensions.contains(url.pathExtension.lowercased()) {
+                    if ParquetFileFormat.readableExtensions.contains(url.pathExtension.lowercased()) {
                         appState.loadFile(at: url)
                     } else {
-                        appState.errorMessage = "Please drop a valid Parquet file (.parquet or .parq)"
+                        appState.errorMessage = "Please drop a Parquet, Arrow, CSV or NDJSON file"
                     }
                 }
             }
@@ -1,7 +1,9 @@
 import SwiftUI
+import SharedCore
 
 struct SettingsView: View {
     @AppStorage("rowsPerPage") private var rowsPerPage = 50
+    @AppStorage("binaryFormat") private var binaryFormat = ParquetBinaryFormat.hex.rawValue
 
     var body: some View {
         Form {
@@ -13,6 +15,13 @@ struct SettingsView: View {
             }
             .pickerStyle(.menu)
 
+            Picker("Binary values:", selection: $binaryFormat) {
+                Text("Hex").tag(ParquetBinaryFormat.hex.rawValue)
+                Text("Base64").tag(ParquetBinaryFormat.base64.rawValue)
+            }
+            .pickerStyle(.menu)
+            .onChange(of: binaryFormat) { _ in Self.applyBinaryFormat() }
+
             Section {
                 Text("File associations are managed by macOS. To set ParqView as the default app for .parquet files, select a parquet file in Finder, press Cmd+I, and change 'Open with' to ParqView.")
                     .font(.caption)
@@ -20,6 +29,12 @@ struct SettingsView: View {
             }
         }
         .padding()
-        .frame(width: 350, height: 150)
+        .frame(width: 350, height: 180)
+    }
+
+    /// Hands the stored binary format to the C++ core, which formats cells
+    static func applyBinaryFormat() {
+        let stored = UserDefaults.standard.string(forKey: "binaryFormat") ?? ""
+        ParquetBridge.shared.setBinaryFormat(ParquetBinaryFormat(rawValue: stored) ?? .hex)
     }
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 import SwiftUI
 import SharedCore
+import UniformTypeIdentifiers
 
 /// Simple virtual table view that directly uses ParquetBridge for data loading
 struct SimpleVirtualTableView: View {
@@ -10,6 +11,7 @@ struct SimpleVirtualTableView: View {
 
     @AppStorage("rowsPerPage") private var rowsPerPage = 25
     @State private var visibleRows: [ParquetRow] = []
+    @State private var visibleRowNumbers: [Int] = []  // File row of each visible row, when known
     @State private var isLoading = false
     @State private var currentOffset = 0
     @State private var filteredTotalRows: Int = 0
@@ -27,15 +29,21 @@ struct SimpleVirtualTableView: View {
     private let minColumnWidth: CGFloat = 60
     private let maxColumnWidth: CGFloat = 500
     private let rowNumberWidth: CGFloat = 50
+    private let cellPreviewBytes = 4096  // Longer values are read in full only when copied
 
     /// Columns to display based on selection
     private var visibleColumns: [SchemaColumn] {
         file.schema.columns.filter { selectedColumns.contains($0.name) }
     }
 
+    /// Sorting and exports read Parquet row groups
+    private var isParquet: Bool {
+        ParquetBridge.shared.fileFormat(of: file.url) == .parquet
+    }
+
     /// Check if sorting is allowed (disabled for large files to prevent memory issues)
     private var canSort: Bool {
-        file.totalRows <= maxRowsForSorting
+        isParquet && file.totalRows <= maxRowsForSorting
     }
 
     /// Get width for a column (from state or default)
@@ -124,7 +132,9 @@ struct SimpleVirtualTableView: View {
                                             }
                                             .buttonStyle(.plain)
                                             .disabled(!canSort)
-                                            .help(!canSort
+                                            .help(!isParquet
+                                                ? "Sorting is only available for Parquet files"
+                                                : !canSort
                                                 ? "Sorting disabled for files > \(maxRowsForSorting / 1000)k rows"
                                                 : sortColumn == column.name
                                                     ? (sortAscending ? "Sorted ascending - click for descending" : "Sorted descending - click to clear")
@@ -194,7 +204,7 @@ struct SimpleVirtualTableView: View {
                                                     let globalRowIndex = currentOffset + index
                                                     let isSelected = selectedCell?.row == globalRowIndex && selectedCell?.col == column.name
 
-                                                    cellView(for: row.values[colIndex])
+                                                    cellView(for: row.values[colIndex], truncated: row.truncatedColumns.contains(colIndex))
                                                         .frame(width: columnWidth(for: column.name), height: rowHeight, alignment: .leading)
                                                         .padding(.horizontal, 6)
                                                         .background(isSelected ? Color.accentColor.opacity(0.3) : Color.clear)
@@ -204,7 +214,7 @@ struct SimpleVirtualTableView: View {
                                                         }
                                                         .onTapGesture(count: 2) {
                                                             // Double-click to copy
-                                                            copyValueToClipboard(row.values[colIndex])
+                                                            copyCell(row, at: index, column: colIndex)
                                                         }
 
                                                     // Divider line matching header
@@ -308,8 +318,10 @@ struct SimpleVirtualTableView: View {
                 }
                 .buttonStyle(.bordered)
                 .controlSize(.small)
-                .help("Export to CSV (⌘E)")
+                .help("Export to CSV or Parquet (⌘E)")
                 .keyboardShortcut("e", modifiers: .command)
+                // Exports read Parquet row groups
+                .disabled(!isParquet)
 
                 // Copy selected cell
                 Button(action: { copySelectedCell() }) {
@@ -352,8 +364,8 @@ struct SimpleVirtualTableView: View {
     }
 
     @ViewBuilder
-    private func cellView(for value: ParquetValue) -> some View {
-        let displayText = ValueFormatters.displayString(for: value)
+    private func cellView(for value: ParquetValue, truncated: Bool) -> some View {
+        let displayText = ValueFormatters.displayString(for: value) + (truncated ? "…" : "")
         let colorType = ValueFormatters.color(for: value)
 
         Text(displayText)
@@ -413,6 +425,18 @@ struct SimpleVirtualTableView: View {
         NSPasteboard.general.setString(text, forType: .string)
     }
 
+    /// Copy a cell, reading the full value when the page holds only a preview
+    /// localIndex is the row's place on the page; sorted pages are not in
+    /// file order, so its file row comes from visibleRowNumbers
+    private func copyCell(_ row: ParquetRow, at localIndex: Int, column colIndex: Int) {
+        if row.truncatedColumns.contains(colIndex), localIndex < visibleRowNumbers.count,
+           let value = try? ParquetBridge.shared.readCell(from: file.url, row: visibleRowNumbers[localIndex], column: colIndex) {
+            copyValueToClipboard(value)
+        } else {
+            copyValueToClipboard(row.values[colIndex])
+        }
+    }
+
     /// Copy the currently selected cell
     private func copySelectedCell() {
         guard let cell = selectedCell else { return }
@@ -421,7 +445,7 @@ struct SimpleVirtualTableView: View {
 
         if let colIndex = file.schema.columns.firstIndex(where: { $0.name == cell.col }),
            colIndex < visibleRows[localIndex].values.count {
-            copyValueToClipboard(visibleRows[localIndex].values[colIndex])
+            copyCell(visibleRows[localIndex], at: localIndex, column: colIndex)
         }
     }
 
@@ -444,45 +468,38 @@ struct SimpleVirtualTableView: View {
         }
     }
 
-    /// Export visible data to CSV
+    /// Export the visible columns of the rows the search matches to CSV, or
+    /// to Parquet when saved with a .parquet extension, in the current sort
+    /// order. The export runs natively off the main thread and reuses the
+    /// search's cached row bitmap.
     private func exportToCSV() {
         let panel = NSSavePanel()
-        panel.allowedContentTypes = [.commaSeparatedText]
+        panel.allowedContentTypes = [.commaSeparatedText, UTType(filenameExtension: "parquet") ?? .data]
         panel.nameFieldStringValue = "\(file.name.replacingOccurrences(of: ".parquet", with: "")).csv"
 
-        if panel.runModal() == .OK, let url = panel.url {
-            do {
-                var csv = ""
-
-                // Header row
-                let headers = visibleColumns.map { $0.name }
-                csv += headers.joined(separator: ",") + "\n"
-
-                // Data rows
-                for row in visibleRows {
-                    var rowValues: [String] = []
-                    for column in visibleColumns {
-                        if let colIndex = file.schema.columns.firstIndex(where: { $0.name == column.name }),
-                           colIndex < row.values.count {
-                            let value = ValueFormatters.displayString(for: row.values[colIndex])
-                            // Escape CSV values
-                            if value.contains(",") || value.contains("\"") || value.contains("\n") {
-                                rowValues.append("\"\(value.replacingOccurrences(of: "\"", with: "\"\""))\"")
-                            } else {
-                                rowValues.append(value)
-                            }
-                        }
-                    }
-                    csv += rowValues.joined(separator: ",") + "\n"
-                }
+        guard panel.runModal() == .OK, let url = panel.url else { return }
+        let format: ParquetExportFormat = url.pathExtension.lowercased() == "parquet" ? .parquet : .csv
 
-                try csv.write(to: url, atomically: true, encoding: .utf8)
-                exportMessage = "Exported \(visibleRows.count) rows to \(url.lastPathComponent)"
-                showExportAlert = true
-            } catch {
+        var options = ParquetExportOptions()
+        options.columns = visibleColumns.map { $0.name }
+        if let sortColumn = sortColumn {
+            options.sortBy = [ParquetSortKey(column: sortColumn, descending: !sortAscending)]
+        }
+        options.filterText = filterText
+        let source = file.url
+        isLoading = true
+        Task {
+            let result = await Task.detached(priority: .userInitiated) {
+                Result { try ParquetBridge.shared.export(source, to: url, format: format, options: options) }
+            }.value
+            isLoading = false
+            switch result {
+            case .success(let exported):
+                exportMessage = "Exported \(exported.rowCount.formatted()) rows to \(url.lastPathComponent)"
+            case .failure(let error):
                 exportMessage = "Export failed: \(error.localizedDescription)"
-                showExportAlert = true
             }
+            showExportAlert = true
         }
     }
     
@@ -514,46 +531,38 @@ struct SimpleVirtualTableView: View {
         }
 
         do {
-            // Use DuckDB for filtered queries
             try await DuckDBService.shared.loadFile(at: file.url)
 
             if filterText.isEmpty {
-                // No filter - simple pagination with optional sorting
-                let rows = try await DuckDBService.shared.getPage(
+                // No filter - pages are read and cut to previews in C++; a
+                // sort only asks DuckDB for the page's row numbers
+                let (rows, rowNumbers) = try await DuckDBService.shared.getPageWithRowNumbers(
                     offset: offset,
                     limit: rowsPerPage,
-                    sortBy: sortColumn,
-                    ascending: sortAscending
+                    sortBy: canSort ? sortColumn : nil,
+                    ascending: sortAscending,
+                    maxCellLength: cellPreviewBytes
                 )
                 visibleRows = rows
+                visibleRowNumbers = rowNumbers
                 currentOffset = offset
                 filteredTotalRows = file.totalRows
             } else {
-                // With filter - use SQL WHERE clause
-                let (rows, totalCount) = try await DuckDBService.shared.getFilteredPage(
+                // With filter - the C++ core searches every column and
+                // cuts the matching rows' cells as it does unfiltered pages
+                let (rows, rowNumbers, totalCount) = try await DuckDBService.shared.getFilteredPage(
                     filterText: filterText,
                     offset: offset,
-                    limit: rowsPerPage
+                    limit: rowsPerPage,
+                    maxCellLength: cellPreviewBytes
                 )
                 visibleRows = rows
+                visibleRowNumbers = rowNumbers
                 currentOffset = offset
                 filteredTotalRows = totalCount
             }
         } catch {
             print("Error loading page at offset \(offset): \(error)")
-            // Fallback to ParquetBridge without filtering
-            do {
-                let rows = try ParquetBridge.shared.readSampleRows(
-                    from: file.url,
-                    limit: rowsPerPage,
-                    offset: offset
-                )
-                visibleRows = rows
-                currentOffset = offset
-                filteredTotalRows = file.totalRows
-            } catch {
-                print("Fallback also failed: \(error)")
-            }
         }
     }
 }
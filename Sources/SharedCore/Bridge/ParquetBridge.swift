@@ -11,6 +11,9 @@ public class ParquetBridge {
     /// Cache for schema to avoid repeated C++ calls (C++ handles file caching internally)
     private var schemaCache: [URL: ParquetSchema] = [:]
 
+    /// Guards schemaCache: statistics, profiles and facets are read off the main thread
+    private let schemaCacheLock = NSLock()
+
     /// Cached date formatter for performance
     private static let isoFormatter: ISO8601DateFormatter = {
         let formatter = ISO8601DateFormatter()
@@ -19,7 +22,12 @@ public class ParquetBridge {
     }()
     
     private init() {
-        // C++ components initialized on first use
+        // C++ components initialized on first use; parsed footers persist
+        // across launches in the user's caches directory
+        if let caches = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask).first {
+            setFooterCache(directory: caches.appendingPathComponent("ParqView/Footers"))
+            setAcceleratedCache(directory: caches.appendingPathComponent("ParqView/Arrow"))
+        }
     }
     
     deinit {
@@ -33,7 +41,10 @@ public class ParquetBridge {
     /// This is very fast as it only reads metadata
     public func readSchema(from url: URL) throws -> ParquetSchema {
         // Check cache first
-        if let cached = schemaCache[url] {
+        schemaCacheLock.lock()
+        let cached = schemaCache[url]
+        schemaCacheLock.unlock()
+        if let cached = cached {
             return cached
         }
         
@@ -60,7 +71,9 @@ public class ParquetBridge {
         let schema = ParquetSchema(columns: columns)
         
         // Cache the schema
+        schemaCacheLock.lock()
         schemaCache[url] = schema
+        schemaCacheLock.unlock()
         
         if schema.columns.isEmpty {
             throw ParquetError.invalidSchema
@@ -72,6 +85,15 @@ public class ParquetBridge {
     private func convertArrowType(_ arrowType: String) -> ParquetType {
         let type = arrowType.lowercased()
 
+        // Nested types first: their strings name their children's types
+        if type.hasPrefix("struct<") {
+            return .structure
+        } else if type.hasPrefix("list<") || type.hasPrefix("large_list<") || type.hasPrefix("fixed_size_list<") {
+            return .list
+        } else if type.hasPrefix("map<") {
+            return .map
+        }
+
         // Handle Arrow C++ type strings
         if type.contains("bool") {
             return .boolean
@@ -128,9 +150,8 @@ public class ParquetBridge {
             }
             return .string(valueStr)
         case .binary, .fixedLenByteArray:
-            if let data = Data(base64Encoded: valueStr) {
-                return .binary(data)
-            }
+            // Already formatted for display as hex, base64 or a UUID, and
+            // cut to the preview length; not the value's bytes
             return .string(valueStr)
         default:
             return .string(valueStr)
@@ -153,12 +174,16 @@ public class ParquetBridge {
     // MARK: - Data Sampling
     
     /// Reads the first N rows from a Parquet file
-    /// Used for initial display and data preview
-    public func readSampleRows(from url: URL, limit: Int = 100, offset: Int = 0) throws -> [ParquetRow] {
+    /// Used for initial display and data preview. With `maxCellLength`, each
+    /// value is cut to at most that many UTF-8 bytes in C++ and its column
+    /// listed in the row's `truncatedColumns`, so a page stays small however
+    /// large its cells are.
+    public func readSampleRows(from url: URL, limit: Int = 100, offset: Int = 0,
+                               maxCellLength: Int = 0) throws -> [ParquetRow] {
         let startTime = Date()
         
         // Read data using C++ implementation
-        guard let tableData = read_parquet_data(url.path, Int32(offset), Int32(limit)) else {
+        guard let tableData = read_parquet_page(url.path, Int64(offset), Int32(limit), Int32(maxCellLength)) else {
             throw ParquetError.dataReadError
         }
         defer { free_table_data(tableData) }
@@ -168,16 +193,213 @@ public class ParquetBridge {
             print("⏱️ Data read took \(String(format: "%.2f", elapsed)) seconds")
         }
         
-        // Get schema for proper type conversion
+        return try convertRows(tableData, schema: readSchema(from: url))
+    }
+
+    /// Sets how binary cells are shown by every read and search: hex or
+    /// base64 of the first `previewBytes` bytes (all of them when 0), then the
+    /// value's length. UUID columns always show their canonical form.
+    public func setBinaryFormat(_ format: ParquetBinaryFormat, previewBytes: Int = Int(PARQUET_BINARY_PREVIEW_BYTES)) {
+        set_binary_format(format == .base64 ? BINARY_FORMAT_BASE64 : BINARY_FORMAT_HEX, Int32(previewBytes))
+    }
+
+    /// Reads the full value of one cell, for a cell a page cut short
+    public func readCell(from url: URL, row: Int, column: Int) throws -> ParquetValue {
+        guard let text = read_parquet_cell(url.path, Int64(row), Int32(column)) else {
+            throw ParquetError.dataReadError
+        }
+        defer { free_parquet_cell(text) }
+
         let schema = try readSchema(from: url)
-        
-        // Convert C data to Swift rows
+        let valueStr = String(cString: text)
+        if valueStr == "NULL" || valueStr.isEmpty {
+            return .null
+        }
+        return convertValue(valueStr, to: column < schema.columns.count ? schema.columns[column].type : .string)
+    }
+
+    /// Reads the rows with the given row numbers, in the order given, with
+    /// cells cut as `readSampleRows` cuts them. Parquet files only.
+    public func readRows(from url: URL, rowNumbers: [Int], maxCellLength: Int = 0) throws -> [ParquetRow] {
+        let rows = rowNumbers.map { Int64($0) }
+        let tableData = rows.withUnsafeBufferPointer { buffer in
+            read_parquet_rows(url.path, buffer.baseAddress, Int32(buffer.count), Int32(maxCellLength))
+        }
+        guard let tableData = tableData else {
+            throw ParquetError.dataReadError
+        }
+        defer { free_table_data(tableData) }
+
+        return try convertRows(tableData, schema: readSchema(from: url))
+    }
+
+    /// Reads `count` rows drawn uniformly at random from the whole file, in
+    /// file order, with the row number of each. `stratified` draws from every
+    /// row group in proportion to its size; a non-zero `seed` repeats a draw.
+    /// Only the pages holding sampled rows are decoded. Cells are cut to
+    /// maxCellLength UTF-8 bytes as readSampleRows cuts them.
+    public func readRandomSample(from url: URL, count: Int = 100, seed: UInt64 = 0, stratified: Bool = false,
+                                 maxCellLength: Int = 0) throws -> (rows: [ParquetRow], rowNumbers: [Int]) {
+        var rowNumbers = [Int64](repeating: 0, count: max(count, 1))
+        let tableData = rowNumbers.withUnsafeMutableBufferPointer { buffer in
+            read_parquet_sample(url.path, Int32(count), seed, stratified ? 1 : 0, Int32(maxCellLength),
+                                buffer.baseAddress)
+        }
+        guard let tableData = tableData else {
+            throw ParquetError.dataReadError
+        }
+        defer { free_table_data(tableData) }
+
+        let sampled = Int(tableData.pointee.row_count)
+        return (try convertRows(tableData, schema: readSchema(from: url)), rowNumbers.prefix(sampled).map { Int($0) })
+    }
+
+    /// Reads a page of rows containing the filter text, ignoring the case of
+    /// Latin, Greek and Cyrillic letters (other scripts match exactly).
+    /// Filtering runs in C++, which decodes dictionary-encoded columns only once
+    /// per distinct value. The matching rows are cached per file and filter, so
+    /// later pages of the same search are served without rescanning.
+    /// Returns the page and the exact number of matching rows.
+    public func readFilteredRows(from url: URL, filterText: String, columns: [String]? = nil,
+                                 limit: Int = 100, offset: Int = 0, maxCellLength: Int = 0) throws -> ([ParquetRow], Int) {
+        let page = try readFilteredRowsWithRowNumbers(from: url, filterText: filterText, columns: columns,
+                                                      limit: limit, offset: offset, maxCellLength: maxCellLength)
+        return (page.rows, page.totalMatches)
+    }
+
+    /// Reads a page of matching rows as readFilteredRows does, with the row
+    /// number of each in the file. Cells are cut to maxCellLength UTF-8
+    /// bytes as readSampleRows cuts them; readCell reads a full value.
+    public func readFilteredRowsWithRowNumbers(from url: URL, filterText: String, columns: [String]? = nil,
+                                               limit: Int = 100, offset: Int = 0, maxCellLength: Int = 0) throws
+        -> (rows: [ParquetRow], rowNumbers: [Int], totalMatches: Int) {
+        let schema = try readSchema(from: url)
+
+        // Map column names to indices; nil searches every column
+        var columnIndices: [Int32] = []
+        if let columns = columns {
+            columnIndices = columns.compactMap { name in
+                schema.columns.firstIndex(where: { $0.name == name }).map { Int32($0) }
+            }
+        }
+
+        var totalMatches: Int64 = 0
+        var rowNumbers = [Int64](repeating: 0, count: max(limit, 1))
+        let tableData = columnIndices.withUnsafeBufferPointer { indices in
+            rowNumbers.withUnsafeMutableBufferPointer { numbers in
+                read_parquet_filtered_page(
+                    url.path, filterText,
+                    columns == nil ? nil : indices.baseAddress, Int32(indices.count),
+                    Int64(offset), Int32(limit), Int32(maxCellLength), &totalMatches, numbers.baseAddress
+                )
+            }
+        }
+        guard let tableData = tableData else {
+            throw ParquetError.dataReadError
+        }
+        defer { free_table_data(tableData) }
+
+        let count = Int(tableData.pointee.row_count)
+        return (convertRows(tableData, schema: schema), rowNumbers.prefix(count).map { Int($0) }, Int(totalMatches))
+    }
+
+    /// Reads a page of rows matching every predicate.
+    /// Row groups and pages whose min/max statistics rule out a match are
+    /// skipped without being decompressed, as are row groups whose bloom
+    /// filters exclude every value of an equality or IN predicate. Results are cached like text filters.
+    /// Returns the page, the exact number of matching rows and what the scan read.
+    public func readPredicateRows(from url: URL, predicates: [ParquetPredicate], limit: Int = 100, offset: Int = 0,
+                                  maxCellLength: Int = 0) throws -> ([ParquetRow], Int, PredicateScanSummary) {
+        let page = try readPredicateRowsWithRowNumbers(from: url, predicates: predicates, limit: limit,
+                                                       offset: offset, maxCellLength: maxCellLength)
+        return (page.rows, page.totalMatches, page.summary)
+    }
+
+    /// Reads a page of matching rows as readPredicateRows does, with the row
+    /// number of each in the file. Cells are cut to maxCellLength UTF-8
+    /// bytes as readSampleRows cuts them; readCell reads a full value.
+    public func readPredicateRowsWithRowNumbers(from url: URL, predicates: [ParquetPredicate], limit: Int = 100,
+                                                offset: Int = 0, maxCellLength: Int = 0) throws
+        -> (rows: [ParquetRow], rowNumbers: [Int], totalMatches: Int, summary: PredicateScanSummary) {
+        let schema = try readSchema(from: url)
+
+        var totalMatches: Int64 = 0
+        var stats = PredicateScanStats()
+        var rowNumbers = [Int64](repeating: 0, count: max(limit, 1))
+        let tableData = try withCPredicates(predicates, schema: schema) { buffer in
+            rowNumbers.withUnsafeMutableBufferPointer { numbers in
+                read_parquet_predicate_page(
+                    url.path, buffer.baseAddress, Int32(buffer.count),
+                    Int64(offset), Int32(limit), Int32(maxCellLength), &totalMatches, &stats, numbers.baseAddress
+                )
+            }
+        }
+        guard let tableData = tableData else {
+            throw ParquetError.dataReadError
+        }
+        defer { free_table_data(tableData) }
+
+        let summary = PredicateScanSummary(
+            rowGroupsTotal: Int(stats.row_groups_total),
+            rowGroupsRead: Int(stats.row_groups_read),
+            pagesRead: Int(stats.pages_read),
+            pagesSkipped: Int(stats.pages_skipped),
+            rowGroupsSkippedByBloomFilter: Int(stats.row_groups_bloom_skipped)
+        )
+        let count = Int(tableData.pointee.row_count)
+        return (convertRows(tableData, schema: schema), rowNumbers.prefix(count).map { Int($0) },
+                Int(totalMatches), summary)
+    }
+
+    /// Passes predicates to C as ColumnPredicate structs, with operand strings
+    /// copied to C memory for the duration of body
+    private func withCPredicates<T>(_ predicates: [ParquetPredicate], schema: ParquetSchema,
+                                    _ body: (UnsafeBufferPointer<ColumnPredicate>) -> T) throws -> T {
+        var operandArrays: [(UnsafeMutablePointer<UnsafePointer<CChar>?>, Int)] = []
+        defer {
+            for (array, count) in operandArrays {
+                for i in 0..<count {
+                    free(UnsafeMutablePointer(mutating: array[i]))
+                }
+                array.deallocate()
+            }
+        }
+
+        var cPredicates: [ColumnPredicate] = []
+        for predicate in predicates {
+            let index = try columnIndex(predicate.column, in: schema)
+            let array = UnsafeMutablePointer<UnsafePointer<CChar>?>.allocate(capacity: max(predicate.values.count, 1))
+            for (i, value) in predicate.values.enumerated() {
+                array[i] = UnsafePointer(strdup(value))
+            }
+            operandArrays.append((array, predicate.values.count))
+            cPredicates.append(ColumnPredicate(
+                column_index: index,
+                op: predicate.op.cValue,
+                values: UnsafePointer(array),
+                value_count: Int32(predicate.values.count)
+            ))
+        }
+        return cPredicates.withUnsafeBufferPointer(body)
+    }
+
+    /// Index of the column named `name` in `schema`, as the C API takes it
+    private func columnIndex(_ name: String, in schema: ParquetSchema) throws -> Int32 {
+        guard let index = schema.columns.firstIndex(where: { $0.name == name }) else {
+            throw ParquetError.invalidFormat("Unknown column: \(name)")
+        }
+        return Int32(index)
+    }
+
+    /// Converts C table data to Swift rows using the schema for typing
+    private func convertRows(_ tableData: UnsafeMutablePointer<TableData>, schema: ParquetSchema) -> [ParquetRow] {
         var rows: [ParquetRow] = []
         let rowCount = Int(tableData.pointee.row_count)
         let colCount = Int(tableData.pointee.column_count)
 
         for rowIdx in 0..<rowCount {
             var values: [ParquetValue] = []
+            var truncatedColumns: Set<Int> = []
 
             // Bounds check: ensure row pointer exists
             guard let rowPtr = tableData.pointee.data[rowIdx] else {
@@ -192,6 +414,9 @@ public class ParquetBridge {
                 }
 
                 let valueStr = String(cString: valuePtr)
+                if let truncated = tableData.pointee.truncated, truncated[rowIdx * colCount + colIdx] != 0 {
+                    truncatedColumns.insert(colIdx)
+                }
 
                 // Convert based on schema type if available
                 let columnType = colIdx < schema.columns.count ? schema.columns[colIdx].type : .string
@@ -204,51 +429,841 @@ public class ParquetBridge {
             }
 
             if !values.isEmpty {
-                rows.append(ParquetRow(values: values))
+                rows.append(ParquetRow(values: values, truncatedColumns: truncatedColumns))
             }
         }
         
         return rows
     }
     
+    // MARK: - Statistics
+
+    /// Computes statistics for a top-level column. Footer statistics and
+    /// dictionary pages are used when present; otherwise the column is
+    /// scanned, unless `allowScan` is false, in which case the fields that
+    /// need a scan come back as -1 / nil. Safe to call off the main thread.
+    public func readColumnStatistics(from url: URL, columnIndex: Int,
+                                     allowScan: Bool = true) throws -> ColumnStatistics {
+        guard let stats = read_parquet_column_stats(url.path, Int32(columnIndex), allowScan ? 1 : 0) else {
+            throw ParquetError.dataReadError
+        }
+        defer { free_column_stats(stats) }
+
+        return ColumnStatistics(
+            count: Int(stats.pointee.count),
+            distinctCount: Int(stats.pointee.distinct_count),
+            nullCount: Int(stats.pointee.null_count),
+            minValue: stats.pointee.min_value.map { String(cString: $0) },
+            maxValue: stats.pointee.max_value.map { String(cString: $0) },
+            isDistinctCountEstimate: stats.pointee.distinct_is_estimate != 0
+        )
+    }
+
+    /// Profiles numeric and temporal columns (all of them when `columns` is
+    /// nil) in one parallel scan: quantiles at the given probabilities and an
+    /// equal-width histogram. Sketches are cached per file, so asking again
+    /// for other quantiles does not rescan. Other columns are left out.
+    public func readColumnProfiles(from url: URL, columns: [String]? = nil,
+                                   probabilities: [Double] = [0.01, 0.25, 0.5, 0.75, 0.95, 0.99],
+                                   binCount: Int = 20) throws -> [ColumnProfile] {
+        let schema = try readSchema(from: url)
+
+        let indices = try (columns ?? []).map { try columnIndex($0, in: schema) }
+
+        let result = indices.withUnsafeBufferPointer { indexBuffer in
+            probabilities.withUnsafeBufferPointer { probabilityBuffer in
+                read_parquet_profile(
+                    url.path, indexBuffer.baseAddress, Int32(indexBuffer.count),
+                    probabilityBuffer.baseAddress, Int32(probabilityBuffer.count), Int32(binCount)
+                )
+            }
+        }
+        guard let result = result else {
+            throw ParquetError.dataReadError
+        }
+        defer { free_profile_result(result) }
+
+        var profiles: [ColumnProfile] = []
+        for i in 0..<Int(result.pointee.column_count) {
+            let profile = result.pointee.columns[i]
+            guard profile.supported != 0 else { continue }
+
+            let quantiles = (0..<Int(profile.quantile_count)).map { q in
+                ColumnProfile.Quantile(
+                    probability: probabilities[q],
+                    value: profile.quantiles[q],
+                    label: profile.quantile_labels[q].map { String(cString: $0) }
+                )
+            }
+            let histogram = (0..<Int(profile.bin_count)).map { b in
+                ColumnProfile.HistogramBin(
+                    lowerBound: profile.bin_edges[b],
+                    upperBound: profile.bin_edges[b + 1],
+                    count: Int(profile.bin_counts[b])
+                )
+            }
+            profiles.append(ColumnProfile(
+                column: schema.columns[Int(profile.column_index)].name,
+                valueCount: Int(profile.value_count),
+                minimumLabel: profile.min_label.map { String(cString: $0) },
+                maximumLabel: profile.max_label.map { String(cString: $0) },
+                quantiles: quantiles,
+                histogram: histogram,
+                isHistogramEstimate: profile.histogram_is_estimate != 0
+            ))
+        }
+        return profiles
+    }
+
+    /// Most frequent values per column (all columns when `columns` is nil),
+    /// over the rows matching every predicate. Dictionary-encoded data is
+    /// counted exactly; otherwise counts come from a heavy-hitter sketch and
+    /// carry an error bound. Nested columns are left out.
+    public func readFacets(from url: URL, columns: [String]? = nil, topN: Int = 10,
+                           predicates: [ParquetPredicate] = []) throws -> [ColumnFacets] {
+        let schema = try readSchema(from: url)
+
+        let indices = try (columns ?? []).map { try columnIndex($0, in: schema) }
+
+        let result = try withCPredicates(predicates, schema: schema) { predicateBuffer in
+            indices.withUnsafeBufferPointer { indexBuffer in
+                read_parquet_facets(
+                    url.path, indexBuffer.baseAddress, Int32(indexBuffer.count), Int32(topN),
+                    predicateBuffer.baseAddress, Int32(predicateBuffer.count)
+                )
+            }
+        }
+        guard let result = result else {
+            throw ParquetError.dataReadError
+        }
+        defer { free_facet_result(result) }
+
+        var facets: [ColumnFacets] = []
+        for i in 0..<Int(result.pointee.column_count) {
+            let column = result.pointee.columns[i]
+            guard column.supported != 0 else { continue }
+
+            let values = (0..<Int(column.value_count)).map { v in
+                ColumnFacets.Value(
+                    value: String(cString: column.values[v].value),
+                    count: Int(column.values[v].count),
+                    error: Int(column.values[v].error)
+                )
+            }
+            facets.append(ColumnFacets(
+                column: schema.columns[Int(column.column_index)].name,
+                values: values,
+                nullCount: Int(column.null_count),
+                rowCount: Int(result.pointee.row_count),
+                isExact: column.is_exact != 0
+            ))
+        }
+        return facets
+    }
+
+    // MARK: - Aggregation
+
+    /// Groups the rows matching every predicate by `groupBy` and computes
+    /// each aggregation per group. The result is sorted on the result column
+    /// at `orderBy` (keys first, then aggregations), or on the keys when nil,
+    /// and cut to `limit` rows when it is above 0. Partial aggregates beyond
+    /// `memoryLimit` bytes (0 for the default) are spilled to disk.
+    public func aggregate(from url: URL, groupBy: [String], aggregations: [Aggregation],
+                          predicates: [ParquetPredicate] = [], orderBy: Int? = nil, descending: Bool = false,
+                          limit: Int = 0, memoryLimit: Int = 0) throws -> AggregationResult {
+        let schema = try readSchema(from: url)
+        let groupIndices = try groupBy.map { try columnIndex($0, in: schema) }
+        let specs = try aggregations.map { aggregation in
+            AggregateSpec(function: aggregation.function.cValue,
+                          column_index: try aggregation.column.map { try columnIndex($0, in: schema) } ?? -1)
+        }
+
+        let result = try withCPredicates(predicates, schema: schema) { predicateBuffer in
+            groupIndices.withUnsafeBufferPointer { groupBuffer in
+                specs.withUnsafeBufferPointer { specBuffer -> UnsafeMutablePointer<AggregateResult>? in
+                    var request = AggregateRequest(
+                        group_columns: groupBuffer.baseAddress,
+                        group_count: Int32(groupBuffer.count),
+                        aggregates: specBuffer.baseAddress,
+                        aggregate_count: Int32(specBuffer.count),
+                        predicates: predicateBuffer.baseAddress,
+                        predicate_count: Int32(predicateBuffer.count),
+                        order_by: Int32(orderBy ?? -1),
+                        descending: descending ? 1 : 0,
+                        limit: Int32(limit),
+                        memory_limit: Int64(memoryLimit)
+                    )
+                    return read_parquet_aggregate(url.path, &request)
+                }
+            }
+        }
+        guard let result = result else {
+            throw ParquetError.dataReadError
+        }
+        defer { free_aggregate_result(result) }
+
+        var columns: [SchemaColumn] = []
+        for i in 0..<Int(result.pointee.column_count) {
+            let column = result.pointee.columns[i]
+            columns.append(SchemaColumn(
+                name: String(cString: column.name),
+                type: convertArrowType(String(cString: column.type)),
+                isNullable: true
+            ))
+        }
+        let resultSchema = ParquetSchema(columns: columns)
+        return AggregationResult(
+            table: QueryResult(columns: columns, rows: convertRows(result.pointee.rows, schema: resultSchema)),
+            groupCount: Int(result.pointee.group_count),
+            inputRowCount: Int(result.pointee.input_rows),
+            spilled: result.pointee.spilled != 0
+        )
+    }
+
+    // MARK: - Datasets
+
+    /// Opens a directory or glob of Parquet files as one dataset. Partition
+    /// directories (key=value) become trailing columns; `partitionFilter`
+    /// may only reference those and drops non-matching files before any read.
+    public func readDatasetInfo(from url: URL,
+                                partitionFilter: [ParquetPredicate] = []) throws -> ParquetDatasetInfo {
+        guard let info = read_dataset_info(url.path, nil, 0) else {
+            throw ParquetError.invalidSchema
+        }
+        let full = datasetInfo(info)
+        free_dataset_info(info)
+        if partitionFilter.isEmpty {
+            return full
+        }
+
+        let pruned = try withCPredicates(partitionFilter, schema: full.schema) { buffer in
+            read_dataset_info(url.path, buffer.baseAddress, Int32(buffer.count))
+        }
+        guard let pruned = pruned else {
+            throw ParquetError.dataReadError
+        }
+        defer { free_dataset_info(pruned) }
+        return datasetInfo(pruned)
+    }
+
+    /// Reads rows of a dataset, numbered across the files left after
+    /// `partitionFilter`, in path order
+    public func readDatasetRows(from url: URL, partitionFilter: [ParquetPredicate] = [],
+                                limit: Int = 100, offset: Int = 0) throws -> [ParquetRow] {
+        let schema = try readDatasetInfo(from: url).schema
+        let tableData = try withCPredicates(partitionFilter, schema: schema) { buffer in
+            read_dataset_data(url.path, buffer.baseAddress, Int32(buffer.count), Int64(offset), Int32(limit))
+        }
+        guard let tableData = tableData else {
+            throw ParquetError.dataReadError
+        }
+        defer { free_table_data(tableData) }
+        return convertRows(tableData, schema: schema)
+    }
+
+    /// Finds the file, row group and offset holding a dataset row
+    public func locateDatasetRow(_ row: Int, in url: URL,
+                                 partitionFilter: [ParquetPredicate] = []) throws -> DatasetRowLocation {
+        let schema = try readDatasetInfo(from: url).schema
+        let location = try withCPredicates(partitionFilter, schema: schema) { buffer in
+            locate_dataset_row(url.path, buffer.baseAddress, Int32(buffer.count), Int64(row))
+        }
+        guard let location = location else {
+            throw ParquetError.dataReadError
+        }
+        defer { free_dataset_row_location(location) }
+        return DatasetRowLocation(
+            fileURL: URL(fileURLWithPath: String(cString: location.pointee.file_path)),
+            fileIndex: Int(location.pointee.file_index),
+            rowGroup: Int(location.pointee.row_group),
+            rowInGroup: Int(location.pointee.row_in_group),
+            rowInFile: Int(location.pointee.row_in_file)
+        )
+    }
+
+    private func datasetInfo(_ info: UnsafeMutablePointer<DatasetInfo>) -> ParquetDatasetInfo {
+        var columns: [SchemaColumn] = []
+        for i in 0..<Int(info.pointee.column_count) {
+            let column = info.pointee.columns[i]
+            columns.append(SchemaColumn(
+                name: String(cString: column.name),
+                type: convertArrowType(String(cString: column.type)),
+                isNullable: true
+            ))
+        }
+        let partitionCount = Int(info.pointee.partition_column_count)
+        return ParquetDatasetInfo(
+            schema: ParquetSchema(columns: columns),
+            partitionColumns: columns.suffix(partitionCount).map(\.name),
+            fileCount: Int(info.pointee.file_count),
+            rowCount: Int(info.pointee.row_count),
+            totalBytes: Int(info.pointee.total_bytes)
+        )
+    }
+
+    /// Summarizes every file of a directory or glob from its footer alone,
+    /// with at most `maxConcurrentReads` reads in flight (0 for the default)
+    public func readCatalog(from url: URL, maxConcurrentReads: Int = 0) throws -> ParquetCatalog {
+        guard let result = read_parquet_catalog(url.path, Int32(maxConcurrentReads)) else {
+            throw ParquetError.dataReadError
+        }
+        defer { free_catalog_result(result) }
+
+        var files: [ParquetCatalog.File] = []
+        files.reserveCapacity(Int(result.pointee.file_count))
+        for i in 0..<Int(result.pointee.file_count) {
+            let file = result.pointee.files[i]
+            files.append(ParquetCatalog.File(
+                url: URL(fileURLWithPath: String(cString: file.file_path)),
+                size: Int(file.file_size),
+                rowCount: Int(file.row_count),
+                rowGroupCount: Int(file.row_group_count),
+                columnCount: Int(file.column_count),
+                schemaIndex: file.schema_index >= 0 ? Int(file.schema_index) : nil,
+                createdBy: file.created_by.map { String(cString: $0) },
+                error: file.error.map { String(cString: $0) }
+            ))
+        }
+        let schemas = (0..<Int(result.pointee.schema_count)).map { String(cString: result.pointee.schemas[$0]!) }
+        return ParquetCatalog(
+            files: files,
+            schemas: schemas,
+            totalRows: Int(result.pointee.total_rows),
+            totalBytes: Int(result.pointee.total_bytes)
+        )
+    }
+
+    // MARK: - Rewrite
+
+    /// Rewrites `source` into `output` with bounded row groups, small pages
+    /// and a page index, so rows can be read without decoding whole row
+    /// groups. Blocks until the new file is in place; call it off the main
+    /// thread.
+    public func rewriteForViewing(_ source: URL, to output: URL,
+                                  options: ParquetRewriteOptions = ParquetRewriteOptions()) throws -> ParquetRewriteResult {
+        let schema = try readSchema(from: source)
+        let bloomColumns = try options.bloomFilterColumns.map { try columnIndex($0, in: schema) }
+        let sortColumns = try options.sortBy.map { try columnIndex($0.column, in: schema) }
+        let sortDescending = options.sortBy.map { Int32($0.descending ? 1 : 0) }
+
+        let result = bloomColumns.withUnsafeBufferPointer { bloomBuffer in
+            sortColumns.withUnsafeBufferPointer { sortBuffer in
+                sortDescending.withUnsafeBufferPointer { descendingBuffer -> UnsafeMutablePointer<RewriteResult>? in
+                    var cOptions = RewriteOptions(
+                        row_group_rows: Int64(options.rowGroupRows),
+                        data_page_bytes: Int64(options.dataPageBytes),
+                        max_rows_per_page: Int64(options.maxRowsPerPage),
+                        codec: options.compression.cValue,
+                        write_page_index: options.writePageIndex ? 1 : 0,
+                        dictionary_encoding: options.dictionaryEncoding ? 1 : 0,
+                        bloom_filter_columns: bloomBuffer.baseAddress,
+                        bloom_filter_column_count: Int32(bloomBuffer.count),
+                        sort_columns: sortBuffer.baseAddress,
+                        sort_descending: descendingBuffer.baseAddress,
+                        sort_column_count: Int32(sortBuffer.count)
+                    )
+                    return rewrite_parquet_file(source.path, output.path, &cOptions)
+                }
+            }
+        }
+        guard let result = result else {
+            throw ParquetError.dataReadError
+        }
+        defer { free_rewrite_result(result) }
+        if let error = result.pointee.error {
+            throw ParquetError.writeFailed(String(cString: error))
+        }
+        return ParquetRewriteResult(
+            rowCount: Int(result.pointee.row_count),
+            rowGroupCount: Int(result.pointee.row_group_count),
+            outputBytes: Int(result.pointee.output_bytes),
+            sourceLatencyMs: result.pointee.source_latency_ms,
+            outputLatencyMs: result.pointee.output_latency_ms
+        )
+    }
+
+    /// Exports `source`, or the rows and columns `options` select, to
+    /// `output` without passing rows through Swift. A Parquet export with
+    /// no predicates, filter text or sort copies the stored column chunks
+    /// as they are.
+    /// `progress` is called on a background thread with the rows written so
+    /// far and the rows to write, and cancels the export by returning false,
+    /// leaving `output` untouched. Blocks until done; call it off the main
+    /// thread.
+    public func export(_ source: URL, to output: URL, format: ParquetExportFormat,
+                       options: ParquetExportOptions = ParquetExportOptions(),
+                       progress: ((_ written: Int, _ total: Int) -> Bool)? = nil) throws -> ParquetExportResult {
+        let schema = try readSchema(from: source)
+        let columns = try options.columns.map { try columnIndex($0, in: schema) }
+        let sortColumns = try options.sortBy.map { try columnIndex($0.column, in: schema) }
+        let sortDescending = options.sortBy.map { Int32($0.descending ? 1 : 0) }
+
+        let handler = progress.map(ExportProgressHandler.init)
+        let callback: ExportProgressCallback? = handler == nil ? nil : { written, total, context in
+            let handler = Unmanaged<ExportProgressHandler>.fromOpaque(context!).takeUnretainedValue()
+            return handler.report(Int(written), Int(total)) ? 0 : 1
+        }
+        let result = try withExtendedLifetime(handler) {
+            try withCPredicates(options.predicates, schema: schema) { predicateBuffer in
+                options.filterText.withCString { filterText in
+                    columns.withUnsafeBufferPointer { columnBuffer in
+                        sortColumns.withUnsafeBufferPointer { sortBuffer in
+                            sortDescending.withUnsafeBufferPointer { descendingBuffer -> UnsafeMutablePointer<ExportResult>? in
+                                var request = ExportRequest(
+                                    format: format.cValue,
+                                    columns: columns.isEmpty ? nil : columnBuffer.baseAddress,
+                                    column_count: Int32(columnBuffer.count),
+                                    predicates: predicateBuffer.baseAddress,
+                                    predicate_count: Int32(predicateBuffer.count),
+                                    filter_text: filterText,
+                                    sort_columns: sortBuffer.baseAddress,
+                                    sort_descending: descendingBuffer.baseAddress,
+                                    sort_column_count: Int32(sortBuffer.count),
+                                    max_workers: Int32(options.maxWorkers),
+                                    progress: callback,
+                                    progress_context: handler.map { Unmanaged.passUnretained($0).toOpaque() }
+                                )
+                                return export_parquet_file(source.path, output.path, &request)
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        guard let result = result else {
+            throw ParquetError.dataReadError
+        }
+        defer { free_export_result(result) }
+        if let error = result.pointee.error {
+            throw ParquetError.writeFailed(String(cString: error))
+        }
+        return ParquetExportResult(
+            rowCount: Int(result.pointee.row_count),
+            bytesWritten: Int(result.pointee.bytes_written),
+            cancelled: result.pointee.cancelled != 0
+        )
+    }
+
     // MARK: - Metadata
     
-    /// Reads file metadata without loading data
-    public func readMetadata(from url: URL) throws -> ParquetMetadata {
-        // For now, return basic metadata from schema
-        // In a full implementation, we'd add more C++ functions for detailed metadata
-        let _ = try readSchema(from: url)
-        
+    /// Reads file metadata without loading data. Chunk min/max values are
+    /// formatted only with `includeStatistics`, which costs a conversion per
+    /// chunk on files with many row groups.
+    public func readMetadata(from url: URL, includeStatistics: Bool = false) throws -> ParquetMetadata {
+        guard let metadata = read_parquet_metadata(url.path, includeStatistics ? 1 : 0) else {
+            throw ParquetError.invalidMetadata
+        }
+        defer { free_parquet_metadata(metadata) }
+        let info = metadata.pointee
+
+        var keyValues: [String: String] = [:]
+        for i in 0..<Int(info.key_value_count) {
+            keyValues[String(cString: info.keys[i]!)] = String(cString: info.values[i]!)
+        }
+        let columnCount = Int(info.column_count)
+        let columnPaths = (0..<columnCount).map { String(cString: info.column_paths[$0]!) }
+
+        func text(_ offset: Int64) -> String? {
+            offset >= 0 ? String(cString: info.strings + Int(offset)) : nil
+        }
+        func known(_ value: Int64) -> Int? {
+            value >= 0 ? Int(value) : nil
+        }
+
+        var codecBytes: [String: Int] = [:]
+        var rowGroups: [RowGroupMetadata] = []
+        rowGroups.reserveCapacity(Int(info.row_group_count))
+        for rg in 0..<Int(info.row_group_count) {
+            let group = info.row_groups[rg]
+            let sorting = (0..<Int(group.sorting_column_count)).map { i -> RowGroupMetadata.SortingColumn in
+                let column = info.sorting_columns[Int(group.first_sorting_column) + i]
+                return RowGroupMetadata.SortingColumn(column: Int(column.column), descending: column.descending != 0,
+                                                      nullsFirst: column.nulls_first != 0)
+            }
+            var chunks: [ColumnChunkMetadata] = []
+            chunks.reserveCapacity(columnCount)
+            for c in 0..<columnCount {
+                let chunk = info.column_chunks[rg * columnCount + c]
+                let codec = codecName(chunk.codec)
+                codecBytes[codec, default: 0] += Int(chunk.compressed_size)
+                chunks.append(ColumnChunkMetadata(
+                    codec: codec,
+                    encodings: encodingNames(chunk.encodings),
+                    compressedSize: Int(chunk.compressed_size),
+                    uncompressedSize: Int(chunk.uncompressed_size),
+                    valueCount: Int(chunk.value_count),
+                    nullCount: known(chunk.null_count),
+                    distinctCount: known(chunk.distinct_count),
+                    dataPageOffset: Int(chunk.data_page_offset),
+                    dictionaryPageOffset: known(chunk.dictionary_page_offset),
+                    columnIndexOffset: known(chunk.column_index_offset),
+                    offsetIndexOffset: known(chunk.offset_index_offset),
+                    minValue: text(chunk.min_value),
+                    maxValue: text(chunk.max_value)
+                ))
+            }
+            rowGroups.append(RowGroupMetadata(
+                rowCount: Int(group.row_count),
+                totalByteSize: Int(group.total_byte_size),
+                compressedSize: Int(group.total_compressed_size),
+                fileOffset: Int(group.file_offset),
+                sortingColumns: sorting,
+                columns: chunks
+            ))
+        }
+
+        let codecs = codecBytes.sorted { $0.value != $1.value ? $0.value > $1.value : $0.key < $1.key }.map(\.key)
         return ParquetMetadata(
-            createdBy: "Unknown",
-            version: "Unknown",
-            rowGroups: 1,  // Would need C++ function to get this
-            compressionCodec: "Unknown"
+            createdBy: info.created_by.map { String(cString: $0) },
+            version: String(info.format_version),
+            rowGroups: Int(info.row_group_count),
+            compressionCodec: codecs.isEmpty ? nil : codecs.joined(separator: ", "),
+            keyValueMetadata: keyValues,
+            columnPaths: columnPaths,
+            rowGroupDetails: rowGroups
         )
     }
+
+    // MARK: - Nested Fields
+
+    /// Reads the full field tree of the file: every struct, list and map
+    /// column down to its primitive leaves
+    public func readFieldTree(from url: URL) throws -> [ParquetField] {
+        guard let tree = read_parquet_field_tree(url.path) else {
+            throw ParquetError.invalidSchema
+        }
+        defer { free_field_tree(tree) }
+
+        // Nodes come depth first, each after its parent
+        let nodes = (0..<Int(tree.pointee.node_count)).map { tree.pointee.nodes[$0] }
+        var children = [[Int]](repeating: [], count: nodes.count)
+        var roots: [Int] = []
+        for (i, node) in nodes.enumerated() {
+            if node.parent < 0 {
+                roots.append(i)
+            } else {
+                children[Int(node.parent)].append(i)
+            }
+        }
+        func field(_ i: Int) -> ParquetField {
+            let node = nodes[i]
+            return ParquetField(
+                name: String(cString: node.name),
+                path: String(cString: node.path),
+                type: String(cString: node.type),
+                leafColumn: node.leaf_column >= 0 ? Int(node.leaf_column) : nil,
+                children: children[i].map(field)
+            )
+        }
+        return roots.map(field)
+    }
+
+    /// Reads rows of the given field paths, one value per path. A Parquet
+    /// file decodes only the leaf columns under those paths; values under a
+    /// list or map come back as a bounded list preview.
+    public func readFieldPaths(from url: URL, paths: [String], limit: Int = 100,
+                               offset: Int = 0) throws -> [ParquetRow] {
+        // Each path's type, read as a list when a list or map lies above it
+        let tree = try readFieldTree(from: url)
+        var columns: [SchemaColumn] = []
+        for path in paths {
+            var fields = tree
+            var listed = false
+            var found: ParquetField?
+            while found == nil, let field = fields.first(where: { path == $0.path || path.hasPrefix($0.path + ".") }) {
+                if field.path == path {
+                    found = field
+                } else {
+                    let type = convertArrowType(field.type)
+                    listed = listed || type == .list || type == .map
+                    fields = field.children
+                }
+            }
+            guard let field = found else {
+                throw ParquetError.invalidFormat("Unknown field: \(path)")
+            }
+            columns.append(SchemaColumn(name: path, type: listed ? .list : convertArrowType(field.type),
+                                        isNullable: true))
+        }
+
+        let cPaths = paths.map { UnsafePointer(strdup($0)) }
+        defer { cPaths.forEach { free(UnsafeMutablePointer(mutating: $0)) } }
+        guard let tableData = cPaths.withUnsafeBufferPointer({
+            read_parquet_field_paths(url.path, $0.baseAddress, Int32(paths.count), Int64(offset), Int32(limit))
+        }) else {
+            throw ParquetError.dataReadError
+        }
+        defer { free_table_data(tableData) }
+        return convertRows(tableData, schema: ParquetSchema(columns: columns))
+    }
+
+    /// Walks every page header of the file to report its storage layout,
+    /// without reading page bodies. Column chunks are walked on up to
+    /// `maxConcurrentReads` threads; 0 uses one per core.
+    public func readLayout(from url: URL, maxConcurrentReads: Int = 0) throws -> ParquetLayoutReport {
+        guard let report = read_parquet_layout(url.path, Int32(maxConcurrentReads)) else {
+            throw ParquetError.dataReadError
+        }
+        defer { free_layout_report(report) }
+        let info = report.pointee
+        let columnCount = Int(info.column_count)
+
+        let columns = (0..<columnCount).map { c -> ParquetLayoutReport.Column in
+            let column = info.columns[c]
+            return ParquetLayoutReport.Column(
+                path: String(cString: column.path),
+                pages: layoutPages(column.pages),
+                fallbackChunkCount: Int(column.fallback_chunk_count),
+                indexedChunkCount: Int(column.indexed_chunk_count)
+            )
+        }
+        let rowGroups = (0..<Int(info.row_group_count)).map { rg -> ParquetLayoutReport.RowGroup in
+            let chunks = (0..<columnCount).map { c -> ParquetLayoutReport.Chunk in
+                let chunk = info.chunks[rg * columnCount + c]
+                return ParquetLayoutReport.Chunk(
+                    pages: layoutPages(chunk.pages),
+                    codec: codecName(chunk.codec),
+                    hasColumnIndex: chunk.has_column_index != 0,
+                    hasOffsetIndex: chunk.has_offset_index != 0,
+                    error: chunk.error.map { String(cString: $0) }
+                )
+            }
+            return ParquetLayoutReport.RowGroup(
+                rowCount: Int(info.row_groups[rg].row_count),
+                pages: layoutPages(info.row_groups[rg].pages),
+                chunks: chunks
+            )
+        }
+        return ParquetLayoutReport(
+            columns: columns,
+            rowGroups: rowGroups,
+            total: layoutPages(info.total),
+            errorCount: Int(info.error_count)
+        )
+    }
+
+    /// Reads, checksums and decodes every page of the file on up to
+    /// `maxWorkers` threads (0 uses one per core), reporting the first bad
+    /// page of each column. A corrupt footer is reported, not thrown.
+    public func validate(_ url: URL, maxWorkers: Int = 0) throws -> ParquetValidationReport {
+        guard let report = validate_parquet_file(url.path, Int32(maxWorkers)) else {
+            throw ParquetError.dataReadError
+        }
+        defer { free_validation_report(report) }
+        let info = report.pointee
+
+        let columns = (0..<Int(info.column_count)).map { c -> ParquetValidationReport.Column in
+            let column = info.columns[c]
+            let failed = column.error != nil
+            return ParquetValidationReport.Column(
+                path: String(cString: column.path),
+                pageCount: Int(column.page_count),
+                checksummedPageCount: Int(column.checksummed_page_count),
+                errorRowGroup: failed ? Int(column.error_row_group) : nil,
+                errorPage: column.error_page >= 0 ? Int(column.error_page) : nil,
+                errorOffset: column.error_offset >= 0 ? Int(column.error_offset) : nil,
+                error: column.error.map { String(cString: $0) }
+            )
+        }
+        return ParquetValidationReport(
+            columns: columns,
+            rowGroupCount: Int(info.row_group_count),
+            rowCount: Int(info.row_count),
+            pageCount: Int(info.page_count),
+            checksummedPageCount: Int(info.checksummed_page_count),
+            bytesChecked: Int(info.bytes_checked),
+            error: info.error.map { String(cString: $0) }
+        )
+    }
+
+    private func layoutPages(_ pages: PageLayout) -> ParquetLayoutReport.Pages {
+        let histogram = withUnsafeBytes(of: pages.page_size_histogram) { Array($0.bindMemory(to: Int32.self)).map(Int.init) }
+        let hasDataPages = pages.data_page_count > 0
+        return ParquetLayoutReport.Pages(
+            dataPageCount: Int(pages.data_page_count),
+            dictionaryPageCount: Int(pages.dictionary_page_count),
+            v2PageCount: Int(pages.v2_page_count),
+            checksummedPageCount: Int(pages.checksummed_page_count),
+            fallbackPageCount: Int(pages.fallback_page_count),
+            valueCount: Int(pages.value_count),
+            headerBytes: Int(pages.header_bytes),
+            compressedSize: Int(pages.compressed_size),
+            uncompressedSize: Int(pages.uncompressed_size),
+            dictionarySize: Int(pages.dictionary_size),
+            minPageSize: hasDataPages ? Int(pages.min_page_size) : nil,
+            maxPageSize: hasDataPages ? Int(pages.max_page_size) : nil,
+            pageSizeHistogram: histogram,
+            encodings: encodingNames(pages.data_encodings)
+        )
+    }
+
+    private func codecName(_ codec: ParquetCodec) -> String {
+        switch codec {
+        case PARQUET_CODEC_UNCOMPRESSED: return "UNCOMPRESSED"
+        case PARQUET_CODEC_SNAPPY: return "SNAPPY"
+        case PARQUET_CODEC_GZIP: return "GZIP"
+        case PARQUET_CODEC_LZO: return "LZO"
+        case PARQUET_CODEC_BROTLI: return "BROTLI"
+        case PARQUET_CODEC_LZ4: return "LZ4"
+        case PARQUET_CODEC_ZSTD: return "ZSTD"
+        case PARQUET_CODEC_LZ4_RAW: return "LZ4_RAW"
+        default: return "OTHER"
+        }
+    }
+
+    private static let encodingBits: [(UInt32, String)] = [
+        (PARQUET_ENCODING_PLAIN, "PLAIN"),
+        (PARQUET_ENCODING_PLAIN_DICTIONARY, "PLAIN_DICTIONARY"),
+        (PARQUET_ENCODING_RLE, "RLE"),
+        (PARQUET_ENCODING_BIT_PACKED, "BIT_PACKED"),
+        (PARQUET_ENCODING_DELTA_BINARY_PACKED, "DELTA_BINARY_PACKED"),
+        (PARQUET_ENCODING_DELTA_LENGTH_BYTE_ARRAY, "DELTA_LENGTH_BYTE_ARRAY"),
+        (PARQUET_ENCODING_DELTA_BYTE_ARRAY, "DELTA_BYTE_ARRAY"),
+        (PARQUET_ENCODING_RLE_DICTIONARY, "RLE_DICTIONARY"),
+        (PARQUET_ENCODING_BYTE_STREAM_SPLIT, "BYTE_STREAM_SPLIT"),
+    ]
+
+    private func encodingNames(_ bits: UInt32) -> [String] {
+        Self.encodingBits.filter { bits & $0.0 != 0 }.map(\.1)
+    }
     
     /// Gets the total row count without loading data
+    /// A CSV or NDJSON file is indexed to its end to count its rows
     public func getRowCount(from url: URL) throws -> Int {
-        // Read schema which includes row count
-        guard let schemaInfo = read_parquet_schema(url.path) else {
+        let rowCount = read_row_count(url.path)
+        guard rowCount >= 0 else {
             throw ParquetError.invalidMetadata
         }
-        defer { free_schema_info(schemaInfo) }
-        
-        return Int(schemaInfo.pointee.row_count)
+        return Int(rowCount)
     }
     
+    /// The format a file is read in, from its extension
+    public func fileFormat(of url: URL) -> ParquetFileFormat {
+        switch detect_file_format(url.path) {
+        case FILE_FORMAT_ARROW_IPC: return .arrowIPC
+        case FILE_FORMAT_CSV: return .csv
+        case FILE_FORMAT_NDJSON: return .ndjson
+        default: return .parquet
+        }
+    }
+
     /// Clear cached metadata for a file
     public func clearCache(for url: URL) {
+        schemaCacheLock.lock()
         schemaCache.removeValue(forKey: url)
-        // Also clear C++ cache for this file
+        schemaCacheLock.unlock()
+        // Also clear C++ cache for this file, or dataset
         clear_parquet_cache(url.path)
+        clear_dataset_cache(url.path)
     }
     
+    /// Keeps parsed footers in `directory`, up to `maxBytes` (0 for the
+    /// default), so files reopen without reading their footers; nil turns
+    /// the on-disk cache off
+    @discardableResult
+    public func setFooterCache(directory: URL?, maxBytes: Int = 0) -> Bool {
+        set_footer_cache_directory(directory?.path, Int64(maxBytes)) != 0
+    }
+
+    /// Removes every footer kept on disk
+    public func clearFooterCache() {
+        clear_footer_cache()
+    }
+
+    /// Keeps Arrow copies of accelerated files in `directory`, up to
+    /// `maxBytes` (0 for the default); nil turns acceleration off
+    @discardableResult
+    public func setAcceleratedCache(directory: URL?, maxBytes: Int = 0) -> Bool {
+        set_accelerated_cache_directory(directory?.path, Int64(maxBytes)) != 0
+    }
+
+    /// Transcodes a file to an Arrow copy that pages are then sliced from
+    /// without decoding. Blocks for about as long as reading the whole
+    /// file, so call it off the main thread.
+    public func accelerate(_ url: URL, compressed: Bool = false) throws {
+        guard accelerate_parquet_file(url.path, compressed ? 1 : 0) != 0 else {
+            throw ParquetError.dataReadError
+        }
+    }
+
+    /// Whether a file has an Arrow copy of its current contents
+    public func isAccelerated(_ url: URL) -> Bool {
+        is_parquet_file_accelerated(url.path) != 0
+    }
+
+    /// Drops a file's Arrow copy
+    public func removeAcceleration(for url: URL) {
+        remove_accelerated_file(url.path)
+    }
+
     /// Clear all cached metadata
     public func clearAllCache() {
+        schemaCacheLock.lock()
         schemaCache.removeAll()
+        schemaCacheLock.unlock()
         // Clear all C++ caches
         clear_all_parquet_cache()
     }
-}
\ No newline at end of file
+}
+
+private extension Aggregation.Function {
+    var cValue: AggregateFunction {
+        switch self {
+        case .count: return AGGREGATE_COUNT
+        case .sum: return AGGREGATE_SUM
+        case .min: return AGGREGATE_MIN
+        case .max: return AGGREGATE_MAX
+        case .average: return AGGREGATE_AVG
+        }
+    }
+}
+
+private extension ParquetPredicate.Operator {
+    var cValue: PredicateOp {
+        switch self {
+        case .equal: return PREDICATE_EQ
+        case .notEqual: return PREDICATE_NE
+        case .lessThan: return PREDICATE_LT
+        case .lessThanOrEqual: return PREDICATE_LE
+        case .greaterThan: return PREDICATE_GT
+        case .greaterThanOrEqual: return PREDICATE_GE
+        case .between: return PREDICATE_BETWEEN
+        case .isIn: return PREDICATE_IN
+        case .isNull: return PREDICATE_IS_NULL
+        case .isNotNull: return PREDICATE_IS_NOT_NULL
+        }
+    }
+}
+
+private extension ParquetCompression {
+    var cValue: ParquetCodec {
+        switch self {
+        case .uncompressed: return PARQUET_CODEC_UNCOMPRESSED
+        case .snappy: return PARQUET_CODEC_SNAPPY
+        case .gzip: return PARQUET_CODEC_GZIP
+        case .brotli: return PARQUET_CODEC_BROTLI
+        case .lz4: return PARQUET_CODEC_LZ4_RAW
+        case .zstd: return PARQUET_CODEC_ZSTD
+        }
+    }
+}
+
+private extension ParquetExportFormat {
+    var cValue: ExportFormat {
+        switch self {
+        case .csv: return EXPORT_FORMAT_CSV
+        case .ndjson: return EXPORT_FORMAT_NDJSON
+        case .arrowIPC: return EXPORT_FORMAT_ARROW_IPC
+        case .parquet: return EXPORT_FORMAT_PARQUET
+        }
+    }
+}
+
+/// Carries an export's progress closure through the C callback's context
+private final class ExportProgressHandler {
+    let report: (Int, Int) -> Bool
+
+    init(_ report: @escaping (Int, Int) -> Bool) {
+        self.report = report
+    }
+}
@@ -11,6 +11,7 @@ public enum ParquetError: Error, LocalizedError {
     case invalidResponse
     case invalidSchema
     case invalidMetadata
+    case writeFailed(String)
 
     public var errorDescription: String? {
         switch self {
@@ -34,6 +35,8 @@ public enum ParquetError: Error, LocalizedError {
             return "Invalid schema data"
         case .invalidMetadata:
             return "Invalid metadata"
+        case .writeFailed(let message):
+            return "Failed to write file: \(message)"
         }
     }
 }
\ No newline at end of file
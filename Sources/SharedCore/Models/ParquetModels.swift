@@ -106,9 +106,13 @@ public enum ParquetType: String, Codable, CustomStringConvertible {
 public struct ParquetRow: Identifiable {
     public let id = UUID()
     public let values: [ParquetValue]
+    /// Columns whose values were cut to a preview; the full value is read
+    /// with `ParquetBridge.readCell`
+    public let truncatedColumns: Set<Int>
     
-    public init(values: [ParquetValue]) {
+    public init(values: [ParquetValue], truncatedColumns: Set<Int> = []) {
         self.values = values
+        self.truncatedColumns = truncatedColumns
     }
 }
 
@@ -165,10 +169,10 @@ public struct ParquetFile: Equatable, Identifiable {
         let sizeInBytes = fileAttributes[.size] as? Int64 ?? 0
         let fileName = url.lastPathComponent
         
-        // Read schema and metadata
+        // Read schema and metadata; only Parquet files have a footer
         let schema = try bridge.readSchema(from: url)
         let totalRows = try bridge.getRowCount(from: url)
-        let metadata = try bridge.readMetadata(from: url)
+        let metadata = bridge.fileFormat(of: url) == .parquet ? try bridge.readMetadata(from: url) : nil
         
         return ParquetFile(
             name: fileName,
@@ -186,18 +190,626 @@ public struct ParquetMetadata: Codable, Equatable {
     public let createdBy: String?
     public let version: String?
     public let rowGroups: Int
+    /// Codecs in use, the one holding the most bytes first
     public let compressionCodec: String?
-    
-    public init(createdBy: String? = nil, version: String? = nil, rowGroups: Int, compressionCodec: String? = nil) {
+    /// Footer key-value metadata, such as the writer's Arrow schema
+    public let keyValueMetadata: [String: String]
+    /// Dotted paths of the leaf columns, in the order of each row group's chunks
+    public let columnPaths: [String]
+    public let rowGroupDetails: [RowGroupMetadata]
+
+    public init(createdBy: String? = nil, version: String? = nil, rowGroups: Int, compressionCodec: String? = nil,
+                keyValueMetadata: [String: String] = [:], columnPaths: [String] = [],
+                rowGroupDetails: [RowGroupMetadata] = []) {
         self.createdBy = createdBy
         self.version = version
         self.rowGroups = rowGroups
         self.compressionCodec = compressionCodec
+        self.keyValueMetadata = keyValueMetadata
+        self.columnPaths = columnPaths
+        self.rowGroupDetails = rowGroupDetails
+    }
+}
+
+/// One row group as recorded in the footer
+public struct RowGroupMetadata: Codable, Equatable {
+    public struct SortingColumn: Codable, Equatable {
+        public let column: Int
+        public let descending: Bool
+        public let nullsFirst: Bool
+
+        public init(column: Int, descending: Bool, nullsFirst: Bool) {
+            self.column = column
+            self.descending = descending
+            self.nullsFirst = nullsFirst
+        }
+    }
+
+    public let rowCount: Int
+    public let totalByteSize: Int
+    public let compressedSize: Int
+    public let fileOffset: Int
+    public let sortingColumns: [SortingColumn]
+    /// One chunk per leaf column
+    public let columns: [ColumnChunkMetadata]
+
+    public init(rowCount: Int, totalByteSize: Int, compressedSize: Int, fileOffset: Int,
+                sortingColumns: [SortingColumn], columns: [ColumnChunkMetadata]) {
+        self.rowCount = rowCount
+        self.totalByteSize = totalByteSize
+        self.compressedSize = compressedSize
+        self.fileOffset = fileOffset
+        self.sortingColumns = sortingColumns
+        self.columns = columns
+    }
+}
+
+/// One column of one row group as recorded in the footer
+public struct ColumnChunkMetadata: Codable, Equatable {
+    public let codec: String
+    public let encodings: [String]
+    public let compressedSize: Int
+    public let uncompressedSize: Int
+    public let valueCount: Int
+    public let nullCount: Int?
+    public let distinctCount: Int?
+    public let dataPageOffset: Int
+    public let dictionaryPageOffset: Int?
+    public let columnIndexOffset: Int?
+    public let offsetIndexOffset: Int?
+    public let minValue: String?
+    public let maxValue: String?
+
+    public init(codec: String, encodings: [String], compressedSize: Int, uncompressedSize: Int, valueCount: Int,
+                nullCount: Int?, distinctCount: Int?, dataPageOffset: Int, dictionaryPageOffset: Int?,
+                columnIndexOffset: Int?, offsetIndexOffset: Int?, minValue: String?, maxValue: String?) {
+        self.codec = codec
+        self.encodings = encodings
+        self.compressedSize = compressedSize
+        self.uncompressedSize = uncompressedSize
+        self.valueCount = valueCount
+        self.nullCount = nullCount
+        self.distinctCount = distinctCount
+        self.dataPageOffset = dataPageOffset
+        self.dictionaryPageOffset = dictionaryPageOffset
+        self.columnIndexOffset = columnIndexOffset
+        self.offsetIndexOffset = offsetIndexOffset
+        self.minValue = minValue
+        self.maxValue = maxValue
     }
 }
 
 // MARK: - Query Support
 
+/// A typed comparison against one column, evaluated in C++
+/// Values are text and are parsed for the column's type, e.g. "42",
+/// "3.5", "true", "2024-01-31" or "2024-01-31 12:00:00" (UTC)
+public struct ParquetPredicate: Equatable {
+    public enum Operator: Equatable {
+        case equal, notEqual
+        case lessThan, lessThanOrEqual
+        case greaterThan, greaterThanOrEqual
+        case between
+        case isIn
+        case isNull, isNotNull
+    }
+
+    public let column: String
+    public let op: Operator
+    public let values: [String]
+
+    public init(column: String, op: Operator, values: [String] = []) {
+        self.column = column
+        self.op = op
+        self.values = values
+    }
+}
+
+/// How much of a file a predicate scan had to decode
+public struct PredicateScanSummary: Equatable {
+    public let rowGroupsTotal: Int
+    public let rowGroupsRead: Int
+    public let pagesRead: Int
+    public let pagesSkipped: Int
+    public let rowGroupsSkippedByBloomFilter: Int
+
+    public init(rowGroupsTotal: Int, rowGroupsRead: Int, pagesRead: Int, pagesSkipped: Int,
+                rowGroupsSkippedByBloomFilter: Int = 0) {
+        self.rowGroupsTotal = rowGroupsTotal
+        self.rowGroupsRead = rowGroupsRead
+        self.pagesRead = pagesRead
+        self.pagesSkipped = pagesSkipped
+        self.rowGroupsSkippedByBloomFilter = rowGroupsSkippedByBloomFilter
+    }
+}
+
+/// Distribution of a numeric or temporal column, read off a quantile sketch
+/// Values are in the column's own units (days for dates, ticks of the unit
+/// for times and timestamps); labels are formatted like the table
+public struct ColumnProfile {
+    public struct Quantile: Equatable {
+        public let probability: Double
+        public let value: Double
+        public let label: String?
+    }
+
+    public struct HistogramBin: Equatable {
+        public let lowerBound: Double
+        public let upperBound: Double
+        public let count: Int
+    }
+
+    public let column: String
+    public let valueCount: Int
+    public let minimumLabel: String?
+    public let maximumLabel: String?
+    public let quantiles: [Quantile]
+    public let histogram: [HistogramBin]
+    /// True when bin counts were estimated from the sketch because the file
+    /// had no footer statistics to size the bins before the scan
+    public let isHistogramEstimate: Bool
+
+    public init(column: String, valueCount: Int, minimumLabel: String?, maximumLabel: String?,
+                quantiles: [Quantile], histogram: [HistogramBin], isHistogramEstimate: Bool) {
+        self.column = column
+        self.valueCount = valueCount
+        self.minimumLabel = minimumLabel
+        self.maximumLabel = maximumLabel
+        self.quantiles = quantiles
+        self.histogram = histogram
+        self.isHistogramEstimate = isHistogramEstimate
+    }
+
+    /// Median, when the profile was asked for it
+    public var median: Quantile? {
+        quantiles.first { $0.probability == 0.5 }
+    }
+}
+
+/// Most frequent values of a column
+public struct ColumnFacets {
+    public struct Value: Equatable {
+        public let value: String
+        /// Upper bound on the true count
+        public let count: Int
+        /// The true count is at least count - error; 0 when exact
+        public let error: Int
+
+        public init(value: String, count: Int, error: Int = 0) {
+            self.value = value
+            self.count = count
+            self.error = error
+        }
+    }
+
+    public let column: String
+    /// Most frequent first
+    public let values: [Value]
+    public let nullCount: Int
+    /// Rows the counts were taken over, after filtering
+    public let rowCount: Int
+    /// True when every count is exact and no unlisted value outranks a listed one
+    public let isExact: Bool
+
+    public init(column: String, values: [Value], nullCount: Int, rowCount: Int, isExact: Bool) {
+        self.column = column
+        self.values = values
+        self.nullCount = nullCount
+        self.rowCount = rowCount
+        self.isExact = isExact
+    }
+}
+
+/// One aggregate of a group-by, over a column or over rows
+public struct Aggregation: Equatable {
+    public enum Function: Equatable {
+        case count, sum, min, max, average
+    }
+
+    public let function: Function
+    /// nil with .count counts rows, count(*)
+    public let column: String?
+
+    public init(_ function: Function, _ column: String? = nil) {
+        self.function = function
+        self.column = column
+    }
+}
+
+/// Result of a group-by: key columns first, then one column per aggregation
+public struct AggregationResult {
+    public let table: QueryResult
+    /// Groups before the limit was applied
+    public let groupCount: Int
+    /// Rows aggregated, after filtering
+    public let inputRowCount: Int
+    /// True when partial aggregates outgrew the memory limit and went through disk
+    public let spilled: Bool
+
+    public init(table: QueryResult, groupCount: Int, inputRowCount: Int, spilled: Bool) {
+        self.table = table
+        self.groupCount = groupCount
+        self.inputRowCount = inputRowCount
+        self.spilled = spilled
+    }
+}
+
+/// A directory or glob of Parquet files read as one table
+public struct ParquetDatasetInfo {
+    /// Columns of the files, unified by name, then the partition columns
+    public let schema: ParquetSchema
+    public let partitionColumns: [String]
+    public let fileCount: Int
+    public let rowCount: Int
+    public let totalBytes: Int
+
+    public init(schema: ParquetSchema, partitionColumns: [String], fileCount: Int, rowCount: Int, totalBytes: Int) {
+        self.schema = schema
+        self.partitionColumns = partitionColumns
+        self.fileCount = fileCount
+        self.rowCount = rowCount
+        self.totalBytes = totalBytes
+    }
+}
+
+/// Where a dataset row lives
+public struct DatasetRowLocation: Equatable {
+    public let fileURL: URL
+    /// Among the files left after partition pruning
+    public let fileIndex: Int
+    public let rowGroup: Int
+    public let rowInGroup: Int
+    public let rowInFile: Int
+
+    public init(fileURL: URL, fileIndex: Int, rowGroup: Int, rowInGroup: Int, rowInFile: Int) {
+        self.fileURL = fileURL
+        self.fileIndex = fileIndex
+        self.rowGroup = rowGroup
+        self.rowInGroup = rowInGroup
+        self.rowInFile = rowInFile
+    }
+}
+
+/// Footer-level summary of every file in a directory or glob
+public struct ParquetCatalog {
+    public struct File {
+        public let url: URL
+        public let size: Int
+        public let rowCount: Int
+        public let rowGroupCount: Int
+        public let columnCount: Int
+        /// Into `schemas`, nil when the footer could not be read
+        public let schemaIndex: Int?
+        public let createdBy: String?
+        public let error: String?
+
+        public init(url: URL, size: Int, rowCount: Int, rowGroupCount: Int, columnCount: Int,
+                    schemaIndex: Int?, createdBy: String?, error: String?) {
+            self.url = url
+            self.size = size
+            self.rowCount = rowCount
+            self.rowGroupCount = rowGroupCount
+            self.columnCount = columnCount
+            self.schemaIndex = schemaIndex
+            self.createdBy = createdBy
+            self.error = error
+        }
+    }
+
+    public let files: [File]
+    /// Distinct schemas, "name: type" per leaf column
+    public let schemas: [String]
+    public let totalRows: Int
+    public let totalBytes: Int
+
+    public var unreadableFiles: [File] { files.filter { $0.error != nil } }
+
+    public init(files: [File], schemas: [String], totalRows: Int, totalBytes: Int) {
+        self.files = files
+        self.schemas = schemas
+        self.totalRows = totalRows
+        self.totalBytes = totalBytes
+    }
+}
+
+/// How a file's pages are laid out, from walking every page header.
+/// Codable so a report can be saved or compared as JSON.
+public struct ParquetLayoutReport: Codable, Equatable {
+    /// Page counts and sizes over a chunk, column, row group or file
+    public struct Pages: Codable, Equatable {
+        public let dataPageCount: Int
+        public let dictionaryPageCount: Int
+        public let v2PageCount: Int
+        public let checksummedPageCount: Int
+        /// Data pages not dictionary-encoded in chunks that have a dictionary
+        public let fallbackPageCount: Int
+        public let valueCount: Int
+        public let headerBytes: Int
+        public let compressedSize: Int
+        public let uncompressedSize: Int
+        public let dictionarySize: Int
+        /// Decompressed data page sizes, nil when there are no data pages
+        public let minPageSize: Int?
+        public let maxPageSize: Int?
+        /// Data pages under 8 KB, then per doubling up to 1 MB, then 1 MB and over
+        public let pageSizeHistogram: [Int]
+        public let encodings: [String]
+
+        public var compressionRatio: Double? {
+            compressedSize > 0 ? Double(uncompressedSize) / Double(compressedSize) : nil
+        }
+
+        public init(dataPageCount: Int, dictionaryPageCount: Int, v2PageCount: Int, checksummedPageCount: Int,
+                    fallbackPageCount: Int, valueCount: Int, headerBytes: Int, compressedSize: Int,
+                    uncompressedSize: Int, dictionarySize: Int, minPageSize: Int?, maxPageSize: Int?,
+                    pageSizeHistogram: [Int], encodings: [String]) {
+            self.dataPageCount = dataPageCount
+            self.dictionaryPageCount = dictionaryPageCount
+            self.v2PageCount = v2PageCount
+            self.checksummedPageCount = checksummedPageCount
+            self.fallbackPageCount = fallbackPageCount
+            self.valueCount = valueCount
+            self.headerBytes = headerBytes
+            self.compressedSize = compressedSize
+            self.uncompressedSize = uncompressedSize
+            self.dictionarySize = dictionarySize
+            self.minPageSize = minPageSize
+            self.maxPageSize = maxPageSize
+            self.pageSizeHistogram = pageSizeHistogram
+            self.encodings = encodings
+        }
+    }
+
+    public struct Chunk: Codable, Equatable {
+        public let pages: Pages
+        public let codec: String
+        public let hasColumnIndex: Bool
+        public let hasOffsetIndex: Bool
+        public let error: String?
+
+        public init(pages: Pages, codec: String, hasColumnIndex: Bool, hasOffsetIndex: Bool, error: String?) {
+            self.pages = pages
+            self.codec = codec
+            self.hasColumnIndex = hasColumnIndex
+            self.hasOffsetIndex = hasOffsetIndex
+            self.error = error
+        }
+    }
+
+    public struct Column: Codable, Equatable {
+        public let path: String
+        public let pages: Pages
+        public let fallbackChunkCount: Int
+        /// Chunks with both a column and an offset index
+        public let indexedChunkCount: Int
+
+        public init(path: String, pages: Pages, fallbackChunkCount: Int, indexedChunkCount: Int) {
+            self.path = path
+            self.pages = pages
+            self.fallbackChunkCount = fallbackChunkCount
+            self.indexedChunkCount = indexedChunkCount
+        }
+    }
+
+    public struct RowGroup: Codable, Equatable {
+        public let rowCount: Int
+        public let pages: Pages
+        /// One per column
+        public let chunks: [Chunk]
+
+        public init(rowCount: Int, pages: Pages, chunks: [Chunk]) {
+            self.rowCount = rowCount
+            self.pages = pages
+            self.chunks = chunks
+        }
+    }
+
+    public let columns: [Column]
+    public let rowGroups: [RowGroup]
+    public let total: Pages
+    public let errorCount: Int
+
+    public init(columns: [Column], rowGroups: [RowGroup], total: Pages, errorCount: Int) {
+        self.columns = columns
+        self.rowGroups = rowGroups
+        self.total = total
+        self.errorCount = errorCount
+    }
+}
+
+/// Outcome of reading and decoding every page of a file
+public struct ParquetValidationReport: Codable, Equatable {
+    public struct Column: Codable, Equatable {
+        public let path: String
+        public let pageCount: Int
+        public let checksummedPageCount: Int
+        /// The first bad page, when the column is invalid
+        public let errorRowGroup: Int?
+        /// Ordinal within its column chunk, dictionary page included; nil
+        /// when the chunk as a whole disagrees with the footer
+        public let errorPage: Int?
+        public let errorOffset: Int?
+        public let error: String?
+
+        public init(path: String, pageCount: Int, checksummedPageCount: Int, errorRowGroup: Int?,
+                    errorPage: Int?, errorOffset: Int?, error: String?) {
+            self.path = path
+            self.pageCount = pageCount
+            self.checksummedPageCount = checksummedPageCount
+            self.errorRowGroup = errorRowGroup
+            self.errorPage = errorPage
+            self.errorOffset = errorOffset
+            self.error = error
+        }
+    }
+
+    public let columns: [Column]
+    public let rowGroupCount: Int
+    public let rowCount: Int
+    public let pageCount: Int
+    public let checksummedPageCount: Int
+    public let bytesChecked: Int
+    /// Set when the footer did not parse or contradicts itself
+    public let error: String?
+
+    public var invalidColumns: [Column] { columns.filter { $0.error != nil } }
+    public var isValid: Bool { error == nil && invalidColumns.isEmpty }
+
+    public init(columns: [Column], rowGroupCount: Int, rowCount: Int, pageCount: Int, checksummedPageCount: Int,
+                bytesChecked: Int, error: String?) {
+        self.columns = columns
+        self.rowGroupCount = rowGroupCount
+        self.rowCount = rowCount
+        self.pageCount = pageCount
+        self.checksummedPageCount = checksummedPageCount
+        self.bytesChecked = bytesChecked
+        self.error = error
+    }
+}
+
+/// Compression for files ParqView writes
+public enum ParquetCompression: String, Codable, CaseIterable {
+    case uncompressed, snappy, gzip, brotli, lz4, zstd
+}
+
+/// A column to order rows by
+public struct ParquetSortKey: Codable, Equatable {
+    public let column: String
+    public let descending: Bool
+
+    public init(column: String, descending: Bool = false) {
+        self.column = column
+        self.descending = descending
+    }
+}
+
+/// How to lay out a file rewritten for viewing
+public struct ParquetRewriteOptions: Codable, Equatable {
+    public var rowGroupRows: Int = 131_072
+    public var dataPageBytes: Int = 64 * 1024
+    public var maxRowsPerPage: Int = 20_000
+    public var compression: ParquetCompression = .zstd
+    public var writePageIndex: Bool = true
+    public var dictionaryEncoding: Bool = true
+    public var bloomFilterColumns: [String] = []
+    /// Orders rows within each row group
+    public var sortBy: [ParquetSortKey] = []
+
+    public init() {}
+}
+
+/// Outcome of a rewrite, with the mean time to read one random row
+/// before and after
+public struct ParquetRewriteResult: Codable, Equatable {
+    public let rowCount: Int
+    public let rowGroupCount: Int
+    public let outputBytes: Int
+    public let sourceLatencyMs: Double
+    public let outputLatencyMs: Double
+
+    public init(rowCount: Int, rowGroupCount: Int, outputBytes: Int, sourceLatencyMs: Double, outputLatencyMs: Double) {
+        self.rowCount = rowCount
+        self.rowGroupCount = rowGroupCount
+        self.outputBytes = outputBytes
+        self.sourceLatencyMs = sourceLatencyMs
+        self.outputLatencyMs = outputLatencyMs
+    }
+}
+
+/// File formats a file or a view of it can be exported to
+public enum ParquetExportFormat: String, Codable, CaseIterable {
+    case csv, ndjson, arrowIPC, parquet
+
+    public var fileExtension: String {
+        switch self {
+        case .csv: return "csv"
+        case .ndjson: return "ndjson"
+        case .arrowIPC: return "arrow"
+        case .parquet: return "parquet"
+        }
+    }
+}
+
+/// Which rows and columns an export writes, and in what order
+public struct ParquetExportOptions: Equatable {
+    /// Columns in output order; empty for every column
+    public var columns: [String] = []
+    public var predicates: [ParquetPredicate] = []
+    /// Keeps rows holding this text in any column, as `readFilteredRows`
+    /// matches it; empty for every row
+    public var filterText: String = ""
+    /// Orders every exported row, which gathers them in memory first
+    public var sortBy: [ParquetSortKey] = []
+    /// 0 for one per core
+    public var maxWorkers: Int = 0
+
+    public init() {}
+}
+
+/// Outcome of an export
+public struct ParquetExportResult: Codable, Equatable {
+    public let rowCount: Int
+    public let bytesWritten: Int
+    /// The progress handler stopped the export; the output was not written
+    public let cancelled: Bool
+
+    public init(rowCount: Int, bytesWritten: Int, cancelled: Bool) {
+        self.rowCount = rowCount
+        self.bytesWritten = bytesWritten
+        self.cancelled = cancelled
+    }
+}
+
+/// Formats a file can be opened in, chosen by its extension. Parquet is
+/// the only one with metadata, statistics and predicate scans; the others
+/// share the schema, page and search reads.
+public enum ParquetFileFormat: String, Codable, CaseIterable {
+    case parquet, arrowIPC, csv, ndjson
+
+    public var fileExtensions: [String] {
+        switch self {
+        case .parquet: return ["parquet", "parq"]
+        case .arrowIPC: return ["arrow", "arrows", "feather", "ipc"]
+        case .csv: return ["csv", "tsv"]
+        case .ndjson: return ["jsonl", "ndjson"]
+        }
+    }
+
+    /// Every extension the app opens
+    public static var readableExtensions: [String] {
+        allCases.flatMap { $0.fileExtensions }
+    }
+}
+
+/// How binary cells are shown
+public enum ParquetBinaryFormat: String, Codable, CaseIterable {
+    case hex, base64
+}
+
+/// A field of a file's nested schema. Top-level columns are the roots;
+/// struct, list and map columns have children, down to primitive leaves.
+public struct ParquetField: Identifiable, Codable, Equatable {
+    public let name: String
+    /// Dotted from the top-level column, e.g. payload.user.id. A list's
+    /// child is its element field, a map's children are key and value.
+    public let path: String
+    /// Arrow type
+    public let type: String
+    /// Parquet leaf column of a primitive field
+    public let leafColumn: Int?
+    public let children: [ParquetField]
+
+    public var id: String { path }
+
+    public init(name: String, path: String, type: String, leafColumn: Int?, children: [ParquetField]) {
+        self.name = name
+        self.path = path
+        self.type = type
+        self.leafColumn = leafColumn
+        self.children = children
+    }
+}
+
 /// Result from a SQL query
 public struct QueryResult {
     public let columns: [SchemaColumn]
@@ -0,0 +1,243 @@
+import Foundation
+import CDuckDB
+
+/// Owns an in-memory DuckDB database and a connection to it
+/// Results are read chunk by chunk straight from DuckDB's column vectors,
+/// so values arrive typed instead of being formatted to text and parsed back.
+/// Safe to share between threads: statements run one at a time.
+final class DuckDBConnection: @unchecked Sendable {
+
+    /// How a result column's vector is decoded
+    enum ValueKind: Equatable {
+        case boolean
+        case int8, int16, int32, int64
+        case uint8, uint16, uint32
+        case float, double
+        case varchar, blob
+        case date
+        case timestampSeconds, timestampMillis, timestampMicros, timestampNanos
+        /// Anything else (decimals, lists, structs, ...): select it cast to
+        /// VARCHAR; read uncast, it decodes as null
+        case other
+
+        init(_ type: duckdb_type) {
+            switch type {
+            case DUCKDB_TYPE_BOOLEAN: self = .boolean
+            case DUCKDB_TYPE_TINYINT: self = .int8
+            case DUCKDB_TYPE_SMALLINT: self = .int16
+            case DUCKDB_TYPE_INTEGER: self = .int32
+            case DUCKDB_TYPE_BIGINT: self = .int64
+            case DUCKDB_TYPE_UTINYINT: self = .uint8
+            case DUCKDB_TYPE_USMALLINT: self = .uint16
+            case DUCKDB_TYPE_UINTEGER: self = .uint32
+            case DUCKDB_TYPE_FLOAT: self = .float
+            case DUCKDB_TYPE_DOUBLE: self = .double
+            case DUCKDB_TYPE_VARCHAR: self = .varchar
+            case DUCKDB_TYPE_BLOB: self = .blob
+            case DUCKDB_TYPE_DATE: self = .date
+            case DUCKDB_TYPE_TIMESTAMP_S: self = .timestampSeconds
+            case DUCKDB_TYPE_TIMESTAMP_MS: self = .timestampMillis
+            case DUCKDB_TYPE_TIMESTAMP, DUCKDB_TYPE_TIMESTAMP_TZ: self = .timestampMicros
+            case DUCKDB_TYPE_TIMESTAMP_NS: self = .timestampNanos
+            default: self = .other
+            }
+        }
+
+        var parquetType: ParquetType {
+            switch self {
+            case .boolean: return .boolean
+            case .int8, .int16, .int32: return .int32
+            case .int64, .uint8, .uint16, .uint32: return .int64
+            case .float: return .float
+            case .double: return .double
+            case .varchar, .other: return .string
+            case .blob: return .binary
+            case .date: return .date
+            case .timestampSeconds, .timestampMillis, .timestampMicros, .timestampNanos: return .timestamp
+            }
+        }
+    }
+
+    struct ResultColumn: Equatable {
+        let name: String
+        let kind: ValueKind
+    }
+
+    struct ResultSet {
+        let columns: [ResultColumn]
+        let rows: [ParquetRow]
+    }
+
+    private var database: duckdb_database?
+    private var connection: duckdb_connection?
+
+    /// A DuckDB connection runs one statement at a time
+    private let lock = NSLock()
+
+    /// Opens an in-memory database; nil if DuckDB can't be started
+    init?() {
+        guard duckdb_open(nil, &database) == DuckDBSuccess else {
+            return nil
+        }
+        guard duckdb_connect(database, &connection) == DuckDBSuccess else {
+            duckdb_close(&database)
+            return nil
+        }
+    }
+
+    deinit {
+        duckdb_disconnect(&connection)
+        duckdb_close(&database)
+    }
+
+    /// Executes a statement without returning results
+    func execute(_ sql: String) throws {
+        lock.lock()
+        defer { lock.unlock() }
+        var result = duckdb_result()
+        defer { duckdb_destroy_result(&result) }
+
+        guard duckdb_query(connection, sql, &result) == DuckDBSuccess else {
+            throw DuckDBError.queryFailed(Self.message(duckdb_result_error(&result)))
+        }
+    }
+
+    /// Runs a query with integer parameters bound to its ? placeholders
+    /// The result is streamed: DuckDB produces one vector-sized chunk at a
+    /// time and stops once maxRows rows have been read
+    func query(_ sql: String, bindings: [Int64] = [], maxRows: Int = .max) throws -> ResultSet {
+        lock.lock()
+        defer { lock.unlock() }
+        var statement: duckdb_prepared_statement?
+        defer { duckdb_destroy_prepare(&statement) }
+
+        guard duckdb_prepare(connection, sql, &statement) == DuckDBSuccess else {
+            throw DuckDBError.invalidSQL(Self.message(duckdb_prepare_error(statement)))
+        }
+        for (index, value) in bindings.enumerated() {
+            guard duckdb_bind_int64(statement, idx_t(index + 1), value) == DuckDBSuccess else {
+                throw DuckDBError.invalidSQL("Cannot bind parameter \(index + 1)")
+            }
+        }
+
+        var pending: duckdb_pending_result?
+        defer { duckdb_destroy_pending(&pending) }
+        guard duckdb_pending_prepared_streaming(statement, &pending) == DuckDBSuccess else {
+            throw DuckDBError.queryFailed(Self.message(duckdb_pending_error(pending)))
+        }
+
+        var result = duckdb_result()
+        defer { duckdb_destroy_result(&result) }
+        guard duckdb_execute_pending(pending, &result) == DuckDBSuccess else {
+            throw DuckDBError.queryFailed(Self.message(duckdb_result_error(&result)))
+        }
+
+        var columns: [ResultColumn] = []
+        for index in 0..<duckdb_column_count(&result) {
+            let name = duckdb_column_name(&result, index).map { String(cString: $0) } ?? "column\(index)"
+            columns.append(ResultColumn(name: name, kind: ValueKind(duckdb_column_type(&result, index))))
+        }
+
+        var rows: [ParquetRow] = []
+        while rows.count < maxRows {
+            var chunk: duckdb_data_chunk? = duckdb_fetch_chunk(result)
+            guard let current = chunk else {
+                break
+            }
+            defer { duckdb_destroy_data_chunk(&chunk) }
+
+            let count = min(Int(duckdb_data_chunk_get_size(current)), maxRows - rows.count)
+            if count == 0 {
+                continue
+            }
+
+            // Decode column by column, then transpose into rows
+            let columnValues = columns.indices.map { index in
+                Self.decode(duckdb_data_chunk_get_vector(current, idx_t(index)), kind: columns[index].kind, count: count)
+            }
+            for row in 0..<count {
+                rows.append(ParquetRow(values: columnValues.map { $0[row] }))
+            }
+        }
+
+        return ResultSet(columns: columns, rows: rows)
+    }
+
+    // MARK: - Vector Decoding
+
+    private static func decode(_ vector: duckdb_vector?, kind: ValueKind, count: Int) -> [ParquetValue] {
+        guard let vector = vector, let data = duckdb_vector_get_data(vector) else {
+            return Array(repeating: .null, count: count)
+        }
+        // No validity mask means no nulls in this chunk
+        let validity = duckdb_vector_get_validity(vector)
+
+        var values: [ParquetValue] = []
+        values.reserveCapacity(count)
+        for row in 0..<count {
+            if let validity = validity, !duckdb_validity_row_is_valid(validity, idx_t(row)) {
+                values.append(.null)
+            } else {
+                values.append(value(at: row, in: data, kind: kind))
+            }
+        }
+        return values
+    }
+
+    private static func value(at row: Int, in data: UnsafeMutableRawPointer, kind: ValueKind) -> ParquetValue {
+        switch kind {
+        case .boolean:
+            return .bool(data.load(fromByteOffset: row, as: Bool.self))
+        case .int8:
+            return .int(Int64(data.load(fromByteOffset: row, as: Int8.self)))
+        case .int16:
+            return .int(Int64(data.load(fromByteOffset: row * 2, as: Int16.self)))
+        case .int32:
+            return .int(Int64(data.load(fromByteOffset: row * 4, as: Int32.self)))
+        case .int64:
+            return .int(data.load(fromByteOffset: row * 8, as: Int64.self))
+        case .uint8:
+            return .int(Int64(data.load(fromByteOffset: row, as: UInt8.self)))
+        case .uint16:
+            return .int(Int64(data.load(fromByteOffset: row * 2, as: UInt16.self)))
+        case .uint32:
+            return .int(Int64(data.load(fromByteOffset: row * 4, as: UInt32.self)))
+        case .float:
+            return .float(Double(data.load(fromByteOffset: row * 4, as: Float.self)))
+        case .double:
+            return .float(data.load(fromByteOffset: row * 8, as: Double.self))
+        case .varchar:
+            return .string(String(decoding: bytes(at: row, in: data), as: UTF8.self))
+        case .other:
+            // Its vector is not laid out as strings; queries select such
+            // columns cast to VARCHAR, so this is only reached by statements
+            // that can't be wrapped
+            return .null
+        case .blob:
+            return .binary(Data(bytes(at: row, in: data)))
+        case .date:
+            let days = data.load(fromByteOffset: row * 4, as: Int32.self)
+            return .date(Date(timeIntervalSince1970: Double(days) * 86_400))
+        case .timestampSeconds:
+            return .timestamp(Date(timeIntervalSince1970: Double(data.load(fromByteOffset: row * 8, as: Int64.self))))
+        case .timestampMillis:
+            return .timestamp(Date(timeIntervalSince1970: Double(data.load(fromByteOffset: row * 8, as: Int64.self)) / 1_000))
+        case .timestampMicros:
+            return .timestamp(Date(timeIntervalSince1970: Double(data.load(fromByteOffset: row * 8, as: Int64.self)) / 1_000_000))
+        case .timestampNanos:
+            return .timestamp(Date(timeIntervalSince1970: Double(data.load(fromByteOffset: row * 8, as: Int64.self)) / 1_000_000_000))
+        }
+    }
+
+    /// Bytes of a VARCHAR/BLOB entry. Short strings are inlined in the vector
+    /// itself, so the pointer must come from the vector, not a copy.
+    private static func bytes(at row: Int, in data: UnsafeMutableRawPointer) -> UnsafeRawBufferPointer {
+        let entry = (data + row * MemoryLayout<duckdb_string_t>.stride).assumingMemoryBound(to: duckdb_string_t.self)
+        let length = Int(duckdb_string_t_length(entry.pointee))
+        return UnsafeRawBufferPointer(start: duckdb_string_t_data(entry), count: length)
+    }
+
+    private static func message(_ error: UnsafePointer<CChar>?) -> String {
+        error.map { String(cString: $0) } ?? "Unknown DuckDB error"
+    }
+}
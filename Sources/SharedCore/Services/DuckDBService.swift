@@ -1,4 +1,5 @@
 import Foundation
+import CDuckDB
 
 /// Service for executing SQL queries on Parquet files using DuckDB
 /// DuckDB is an embedded SQL database that can query Parquet files directly
@@ -9,176 +10,212 @@ public class DuckDBService: ObservableObject {
     public static let shared = DuckDBService()
     
     /// Current database connection
-    private var database: OpaquePointer?
+    private let connection: DuckDBConnection?
     
     /// Currently loaded file path
     private var currentFilePath: String?
+
+    /// File the 'parquet' view currently reads
+    private var viewFilePath: String?
     
     private init() {
-        initializeDatabase()
-    }
-    
-    deinit {
-        closeDatabase()
-    }
-    
-    // MARK: - Database Management
-    
-    /// Initialize DuckDB database
-    private func initializeDatabase() {
-        // TODO: Call DuckDB C API to create in-memory database
-        // duckdb_open(nil, &database)
-    }
-    
-    /// Close database connection
-    nonisolated private func closeDatabase() {
-        // TODO: Call DuckDB C API to close database
-        // if database != nil {
-        //     duckdb_close(&database)
-        // }
+        connection = DuckDBConnection()
     }
     
     // MARK: - File Operations
     
     /// Loads a Parquet file into DuckDB for querying
-    /// Creates a view called 'parquet' that can be queried
+    /// The 'parquet' view is created on the first query, so opening a file
+    /// costs nothing until its data is needed
     public func loadFile(at url: URL) async throws {
-        let path = url.path
-        
-        // In DuckDB, we can query Parquet files directly without loading them
-        // CREATE VIEW parquet AS SELECT * FROM read_parquet('path/to/file.parquet')
+        guard connection != nil else {
+            throw DuckDBError.connectionFailed
+        }
+        currentFilePath = url.path
+    }
+
+    /// Creates the 'parquet' view over the current file if it isn't already
+    private func prepareView() throws -> DuckDBConnection {
+        guard let connection = connection else {
+            throw DuckDBError.connectionFailed
+        }
+        guard let path = currentFilePath else {
+            throw DuckDBError.fileNotFound
+        }
+        if viewFilePath == path {
+            return connection
+        }
+
+        // In DuckDB, we can query Parquet, CSV and JSON files directly without loading them
+        let reader: String
+        switch ParquetBridge.shared.fileFormat(of: URL(fileURLWithPath: path)) {
+        case .parquet: reader = "read_parquet"
+        case .csv: reader = "read_csv_auto"
+        case .ndjson: reader = "read_json_auto"
+        case .arrowIPC: throw DuckDBError.queryFailed("SQL queries are not supported for Arrow IPC files")
+        }
         let sql = """
             CREATE OR REPLACE VIEW parquet AS 
-            SELECT * FROM read_parquet('\(path)')
+            SELECT * FROM \(reader)(\(quoteLiteral(path)))
         """
-        
-        try await execute(sql)
-        currentFilePath = path
+        try connection.execute(sql)
+        viewFilePath = path
+        return connection
     }
     
     // MARK: - Data Operations
     
-    /// Gets a page of data from the loaded file with optional sorting and filtering
-    public func getPage(offset: Int, limit: Int, sortBy: String? = nil, ascending: Bool = true) async throws -> [ParquetRow] {
-        // For now, use ParquetBridge directly until DuckDB is integrated
+    /// Gets a page of data from the loaded file with optional sorting
+    /// Cells are cut to maxCellLength UTF-8 bytes (0 for no limit), as
+    /// ParquetBridge.readSampleRows cuts them
+    public func getPage(offset: Int, limit: Int, sortBy: String? = nil, ascending: Bool = true,
+                        maxCellLength: Int = 0) async throws -> [ParquetRow] {
+        try await getPageWithRowNumbers(offset: offset, limit: limit, sortBy: sortBy, ascending: ascending,
+                                        maxCellLength: maxCellLength).rows
+    }
+
+    /// Gets a page as getPage does, with the row number of each row in the file
+    /// Every row is read by the C++ core, so cells are formatted the same
+    /// whether or not the page is sorted. Sorting is Parquet-only: DuckDB
+    /// orders the file on the one column and hands back just the row numbers
+    /// of the page, and only those rows are then read, off the main actor.
+    public func getPageWithRowNumbers(offset: Int, limit: Int, sortBy: String? = nil, ascending: Bool = true,
+                                      maxCellLength: Int = 0) async throws -> (rows: [ParquetRow], rowNumbers: [Int]) {
+        guard let connection = connection else {
+            throw DuckDBError.connectionFailed
+        }
         guard let path = currentFilePath else {
             throw DuckDBError.fileNotFound
         }
-
         let url = URL(fileURLWithPath: path)
+        let offset = max(offset, 0)
+        let limit = max(limit, 0)
 
-        // If sorting, we need to load all data, sort, then paginate
-        if let sortColumn = sortBy {
-            let schema = try ParquetBridge.shared.readSchema(from: url)
-            guard let columnIndex = schema.columns.firstIndex(where: { $0.name == sortColumn }) else {
-                // Column not found, return unsorted
-                return try ParquetBridge.shared.readSampleRows(from: url, limit: limit, offset: offset)
-            }
+        guard let sortColumn = sortBy else {
+            let rows = try ParquetBridge.shared.readSampleRows(from: url, limit: limit, offset: offset,
+                                                               maxCellLength: maxCellLength)
+            return (rows, Array(offset..<offset + rows.count))
+        }
+        guard ParquetBridge.shared.fileFormat(of: url) == .parquet else {
+            throw DuckDBError.queryFailed("Sorting is only supported for Parquet files")
+        }
+        guard try ParquetBridge.shared.readSchema(from: url).columns.contains(where: { $0.name == sortColumn }) else {
+            throw DuckDBError.queryFailed("Unknown column: \(sortColumn)")
+        }
 
-            // Load all rows for sorting (this is inefficient but works until DuckDB is integrated)
-            let totalRows = try ParquetBridge.shared.getRowCount(from: url)
-            let allRows = try ParquetBridge.shared.readSampleRows(from: url, limit: totalRows, offset: 0)
-
-            // Sort the rows
-            let sortedRows = allRows.sorted { row1, row2 in
-                guard columnIndex < row1.values.count && columnIndex < row2.values.count else {
-                    return false
-                }
-                let cmp = compareParquetValues(row1.values[columnIndex], row2.values[columnIndex])
-                return ascending ? cmp < 0 : cmp > 0
+        // Nulls sort as the smallest value, as the table always has; ties
+        // keep file order, so pages neither repeat nor skip rows
+        let sql = """
+            SELECT file_row_number FROM read_parquet(\(quoteLiteral(path)), file_row_number = true)
+            ORDER BY \(quoteIdentifier(sortColumn)) \(ascending ? "ASC NULLS FIRST" : "DESC NULLS LAST"), file_row_number
+            LIMIT ? OFFSET ?
+        """
+        return try await Task.detached(priority: .userInitiated) {
+            let rowNumbers = try connection.query(sql, bindings: [Int64(limit), Int64(offset)]).rows.compactMap { row -> Int? in
+                guard case .int(let number)? = row.values.first else { return nil }
+                return Int(number)
             }
+            let rows = try ParquetBridge.shared.readRows(from: url, rowNumbers: rowNumbers, maxCellLength: maxCellLength)
+            return (rows: rows, rowNumbers: rowNumbers)
+        }.value
+    }
+
+    /// Runs a SQL query against the loaded file, available as the view 'parquet'
+    /// At most maxRows rows are fetched from DuckDB's result stream
+    public func executeQuery(_ sql: String, maxRows: Int = 10_000) async throws -> QueryResult {
+        let connection = try prepareView()
+        let body = sql.trimmingCharacters(in: .whitespacesAndNewlines.union(CharacterSet(charactersIn: ";")))
 
-            // Apply pagination
-            let startIndex = min(offset, sortedRows.count)
-            let endIndex = min(offset + limit, sortedRows.count)
-            return Array(sortedRows[startIndex..<endIndex])
+        // Queries are wrapped so columns DuckDB can't hand over natively are
+        // cast to text; other statements (PRAGMA, SET, ...) run as written,
+        // and such columns of theirs come back null. The body ends its own
+        // line, so a trailing -- comment can't swallow the closing paren
+        let result: DuckDBConnection.ResultSet
+        if let columns = try? connection.query("SELECT * FROM (\(body)\n) LIMIT 0").columns {
+            result = try connection.query("SELECT \(selectList(columns)) FROM (\(body)\n) AS query", maxRows: maxRows)
+        } else {
+            result = try connection.query(body, maxRows: maxRows)
         }
 
-        // No sorting - simple pagination
-        let rows = try ParquetBridge.shared.readSampleRows(from: url, limit: limit, offset: offset)
-        return rows
+        let columns = result.columns.map {
+            SchemaColumn(name: $0.name, type: $0.kind.parquetType, isNullable: true)
+        }
+        return QueryResult(columns: columns, rows: result.rows)
     }
 
-    /// Compare two ParquetValues for sorting
-    private func compareParquetValues(_ lhs: ParquetValue, _ rhs: ParquetValue) -> Int {
-        switch (lhs, rhs) {
-        case (.null, .null): return 0
-        case (.null, _): return -1  // nulls first
-        case (_, .null): return 1
-        case (.bool(let a), .bool(let b)):
-            return a == b ? 0 : (a ? 1 : -1)
-        case (.int(let a), .int(let b)):
-            return a < b ? -1 : (a > b ? 1 : 0)
-        case (.float(let a), .float(let b)):
-            return a < b ? -1 : (a > b ? 1 : 0)
-        case (.string(let a), .string(let b)):
-            return a.localizedCompare(b).rawValue
-        case (.date(let a), .date(let b)):
-            return a < b ? -1 : (a > b ? 1 : 0)
-        case (.timestamp(let a), .timestamp(let b)):
-            return a < b ? -1 : (a > b ? 1 : 0)
-        case (.binary(let a), .binary(let b)):
-            return a.count < b.count ? -1 : (a.count > b.count ? 1 : 0)
-        default:
-            // Different types - compare string representations
-            let strA = String(describing: lhs)
-            let strB = String(describing: rhs)
-            return strA.localizedCompare(strB).rawValue
+    /// Columns to select, with types DuckDB can't hand over natively cast to text
+    private func selectList(_ columns: [DuckDBConnection.ResultColumn]) -> String {
+        if columns.isEmpty {
+            return "*"
         }
+        return columns.map { column in
+            let name = quoteIdentifier(column.name)
+            return column.kind == .other ? "CAST(\(name) AS VARCHAR) AS \(name)" : name
+        }.joined(separator: ", ")
+    }
+
+    private func quoteIdentifier(_ name: String) -> String {
+        "\"" + name.replacingOccurrences(of: "\"", with: "\"\"") + "\""
+    }
+
+    private func quoteLiteral(_ text: String) -> String {
+        "'" + text.replacingOccurrences(of: "'", with: "''") + "'"
     }
 
     /// Gets a filtered page of data - searches all columns for the filter text
-    /// Returns (rows, totalMatchingRows)
-    public func getFilteredPage(filterText: String, offset: Int, limit: Int) async throws -> ([ParquetRow], Int) {
+    /// Cells are cut to maxCellLength UTF-8 bytes as getPage cuts them; each
+    /// row comes with its row number in the file, for ParquetBridge.readCell
+    public func getFilteredPage(filterText: String, offset: Int, limit: Int, maxCellLength: Int = 0) async throws
+        -> (rows: [ParquetRow], rowNumbers: [Int], totalMatches: Int) {
         guard let path = currentFilePath else {
             throw DuckDBError.fileNotFound
         }
 
+        // Filtering runs in the C++ core, which scans only the searched columns,
+        // matches dictionary-encoded strings once per distinct value and caches
+        // the matching rows, so paging through results does not rescan the file
         let url = URL(fileURLWithPath: path)
-        let totalRows = try ParquetBridge.shared.getRowCount(from: url)
-
-        // For now, use in-memory filtering since DuckDB isn't fully integrated
-        // Load batches and filter - stops early once we have enough results
-        let batchSize = 5000
-        var allMatchingRows: [ParquetRow] = []
-        var currentBatchOffset = 0
-        let neededRows = offset + limit
-
-        while currentBatchOffset < totalRows {
-            let rows = try ParquetBridge.shared.readSampleRows(
-                from: url,
-                limit: batchSize,
-                offset: currentBatchOffset
-            )
-
-            if rows.isEmpty { break }
-
-            // Filter rows using shared utility
-            let matchingRows = rows.filter { row in
-                row.values.contains { ValueFormatters.valueContains($0, searchText: filterText) }
-            }
+        return try ParquetBridge.shared.readFilteredRowsWithRowNumbers(
+            from: url,
+            filterText: filterText,
+            limit: limit,
+            offset: offset,
+            maxCellLength: maxCellLength
+        )
+    }
 
-            allMatchingRows.append(contentsOf: matchingRows)
-            currentBatchOffset += rows.count
+    /// Statistics for one column of the loaded file
+    /// Null count and min/max come from the footer when the file has them;
+    /// anything else is a parallel scan in the C++ core, run off the main actor
+    public func getColumnStats(columnName: String) async throws -> ColumnStatistics {
+        guard let path = currentFilePath else {
+            throw DuckDBError.fileNotFound
+        }
 
-            // Stop early if we have enough rows and scanned at least half the file
-            if allMatchingRows.count >= neededRows + 500 && currentBatchOffset >= totalRows / 2 {
-                break
-            }
+        let url = URL(fileURLWithPath: path)
+        let schema = try ParquetBridge.shared.readSchema(from: url)
+        guard let index = schema.columns.firstIndex(where: { $0.name == columnName }) else {
+            throw DuckDBError.queryFailed("Unknown column: \(columnName)")
         }
+        return try await Task.detached(priority: .userInitiated) {
+            try ParquetBridge.shared.readColumnStatistics(from: url, columnIndex: index)
+        }.value
+    }
 
-        // Apply pagination
-        let startIndex = min(offset, allMatchingRows.count)
-        let endIndex = min(offset + limit, allMatchingRows.count)
-        let pageRows = Array(allMatchingRows[startIndex..<endIndex])
+    // MARK: - Export
 
-        return (pageRows, allMatchingRows.count)
-    }
-    
-    /// Executes a SQL statement without returning results
-    private func execute(_ sql: String) async throws {
-        // DuckDB integration pending - currently using ParquetBridge directly
-        try await Task.sleep(nanoseconds: 10_000_000)
+    /// Writes the loaded file to outputPath as CSV
+    /// The export streams through the C++ core, run off the main actor
+    @discardableResult
+    public func exportToCSV(outputPath: URL) async throws -> ParquetExportResult {
+        guard let path = currentFilePath else {
+            throw DuckDBError.fileNotFound
+        }
+
+        let url = URL(fileURLWithPath: path)
+        return try await Task.detached(priority: .userInitiated) {
+            try ParquetBridge.shared.export(url, to: outputPath, format: .csv)
+        }.value
     }
 }
 
@@ -187,13 +224,17 @@ public class DuckDBService: ObservableObject {
 /// Statistics for a column
 public struct ColumnStatistics {
     public let count: Int
+    /// -1 when not computed (statistics read without scanning)
     public let distinctCount: Int
+    /// -1 when not computed (statistics read without scanning)
     public let nullCount: Int
     public let minValue: String?
     public let maxValue: String?
+    /// True when distinctCount is a HyperLogLog estimate rather than exact
+    public var isDistinctCountEstimate: Bool = false
     
     public var nullPercentage: Double {
-        guard count > 0 else { return 0 }
+        guard count > 0, nullCount >= 0 else { return 0 }
         return Double(nullCount) / Double(count) * 100
     }
 }
@@ -219,36 +260,3 @@ public enum DuckDBError: LocalizedError {
         }
     }
 }
-
-/*
- DuckDB C API Integration Notes:
- 
- 1. Include DuckDB header: #include <duckdb.h>
- 
- 2. Basic connection:
-    duckdb_database db;
-    duckdb_connection con;
-    duckdb_open(nullptr, &db);  // In-memory database
-    duckdb_connect(db, &con);
- 
- 3. Query execution:
-    duckdb_result result;
-    duckdb_query(con, "SELECT * FROM table", &result);
-    
- 4. Reading results:
-    idx_t row_count = duckdb_row_count(&result);
-    idx_t column_count = duckdb_column_count(&result);
-    
-    for (idx_t row = 0; row < row_count; row++) {
-        for (idx_t col = 0; col < column_count; col++) {
-            auto value = duckdb_value_varchar(&result, col, row);
-            // Process value
-            duckdb_free(value);
-        }
-    }
-    
- 5. Cleanup:
-    duckdb_destroy_result(&result);
-    duckdb_disconnect(&con);
-    duckdb_close(&db);
- */
\ No newline at end of file
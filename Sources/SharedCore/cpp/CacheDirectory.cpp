@@ -0,0 +1,177 @@
+#include "CacheDirectory.h"
+#include "DistinctCounter.h"
+#include <signal.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace parqview {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Once over budget, the directory is trimmed to this fraction of it, so a
+// full cache is not rescanned on every write
+constexpr double kEvictionTarget = 0.75;
+
+const char* const kTempMarker = ".tmp";
+
+// Reads the digits at name[pos] into value; false when there are none
+bool parse_digits(const std::string& name, size_t& pos, long long& value) {
+    size_t start = pos;
+    value = 0;
+    while (pos < name.size() && std::isdigit(static_cast<unsigned char>(name[pos])) && pos - start < 18) {
+        value = value * 10 + (name[pos++] - '0');
+    }
+    return pos > start;
+}
+
+// The writing process of a name temp_path made for extension, which is
+// <16 hex digits><extension>.tmp<pid>-<n>; -1 for any other name
+long long temp_owner(const std::string& name, const std::string& extension) {
+    size_t pos = 16;
+    if (name.size() < pos || !std::all_of(name.begin(), name.begin() + pos, [](char c) {
+            return std::isxdigit(static_cast<unsigned char>(c)) && !std::isupper(static_cast<unsigned char>(c));
+        })) {
+        return -1;
+    }
+    std::string marker = extension + kTempMarker;
+    if (name.compare(pos, marker.size(), marker) != 0) {
+        return -1;
+    }
+    pos += marker.size();
+    long long pid = 0;
+    long long counter = 0;
+    if (!parse_digits(name, pos, pid) || pos >= name.size() || name[pos++] != '-' ||
+        !parse_digits(name, pos, counter) || pos != name.size()) {
+        return -1;
+    }
+    return pid;
+}
+
+// True while pid names a running process, including one of another user
+bool process_alive(long long pid) {
+    return pid > 0 && (kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM);
+}
+
+} // namespace
+
+bool CacheDirectory::configure(const char* directory, long long max_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    directory_.clear();
+    used_bytes_ = 0;
+    if (!directory) {
+        return true;
+    }
+
+    std::error_code error;
+    fs::create_directories(directory, error);
+    if (!fs::is_directory(directory, error)) {
+        std::cerr << "Cannot use " << directory << " as a cache directory" << std::endl;
+        return false;
+    }
+    directory_ = directory;
+    max_bytes_ = max_bytes;
+
+    // Only this cache's own temporary files, and only those whose writer
+    // has exited: the directory is the user's choice and may hold other files
+    std::vector<fs::path> abandoned;
+    for (const auto& entry : fs::directory_iterator(directory_, error)) {
+        long long owner = temp_owner(entry.path().filename().string(), extension_);
+        if (owner > 0 && !process_alive(owner)) {
+            abandoned.push_back(entry.path());
+        }
+    }
+    for (const auto& path : abandoned) {
+        fs::remove(path, error);
+    }
+    trim(max_bytes_);
+    return true;
+}
+
+fs::path CacheDirectory::entry_path(const char* source_path) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (directory_.empty()) {
+        return fs::path();
+    }
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx",
+                  static_cast<unsigned long long>(hash_bytes(source_path, std::strlen(source_path))));
+    return directory_ / (std::string(name) + extension_);
+}
+
+fs::path CacheDirectory::temp_path(const fs::path& entry) {
+    auto temp = entry;
+    temp += kTempMarker + std::to_string(static_cast<long long>(getpid())) + "-" + std::to_string(temp_counter_++);
+    return temp;
+}
+
+bool CacheDirectory::commit(const fs::path& temp, const fs::path& entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::error_code error;
+    auto added = static_cast<long long>(fs::file_size(temp, error));
+    auto replaced = fs::exists(entry, error) ? static_cast<long long>(fs::file_size(entry, error)) : 0;
+    fs::rename(temp, entry, error);
+    if (error) {
+        fs::remove(temp, error);
+        return false;
+    }
+    used_bytes_ += added - replaced;
+    if (used_bytes_ > max_bytes_) {
+        trim(static_cast<long long>(static_cast<double>(max_bytes_) * kEvictionTarget));
+    }
+    return true;
+}
+
+void CacheDirectory::touch(const fs::path& entry) {
+    std::error_code error;
+    fs::last_write_time(entry, fs::file_time_type::clock::now(), error);
+}
+
+void CacheDirectory::remove(const fs::path& entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::error_code error;
+    auto size = static_cast<long long>(fs::file_size(entry, error));
+    if (fs::remove(entry, error)) {
+        used_bytes_ -= size;
+    }
+}
+
+void CacheDirectory::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!directory_.empty()) {
+        trim(0);
+    }
+}
+
+void CacheDirectory::trim(long long target) {
+    std::error_code error;
+    std::vector<std::pair<fs::file_time_type, fs::path>> entries;
+    long long total = 0;
+    for (const auto& entry : fs::directory_iterator(directory_, error)) {
+        if (entry.is_regular_file(error) && entry.path().extension() == extension_) {
+            total += static_cast<long long>(entry.file_size(error));
+            entries.emplace_back(entry.last_write_time(error), entry.path());
+        }
+    }
+    std::sort(entries.begin(), entries.end());
+
+    for (const auto& entry : entries) {
+        if (total <= target) {
+            break;
+        }
+        auto size = static_cast<long long>(fs::file_size(entry.second, error));
+        if (fs::remove(entry.second, error)) {
+            total -= size;
+        }
+    }
+    used_bytes_ = total;
+}
+
+} // namespace parqview
@@ -0,0 +1,60 @@
+#ifndef PARQVIEW_CACHE_DIRECTORY_H
+#define PARQVIEW_CACHE_DIRECTORY_H
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+
+namespace parqview {
+
+// A directory of files derived from source files, one per source path and
+// named by its hash, kept under a byte budget by removing the least
+// recently used. Entries are written under a temporary name and renamed
+// into place, so a reader sees either the old entry or the whole new one.
+// Off until configured.
+class CacheDirectory {
+public:
+    explicit CacheDirectory(std::string extension) : extension_(std::move(extension)) {}
+
+    // Uses directory (created when missing), holding at most max_bytes; NULL
+    // turns the cache off. False, leaving it off, when the directory cannot
+    // be created. Temporary files this cache's writes left behind when their
+    // process exited are removed; other files are left alone.
+    bool configure(const char* directory, long long max_bytes);
+
+    // Where source_path's entry lives; empty when the cache is off
+    std::filesystem::path entry_path(const char* source_path) const;
+
+    // A fresh name beside entry to write a new version into
+    std::filesystem::path temp_path(const std::filesystem::path& entry);
+
+    // Renames temp over entry, then evicts while over budget. temp is
+    // removed when the rename fails.
+    bool commit(const std::filesystem::path& temp, const std::filesystem::path& entry);
+
+    // Marks entry as recently used
+    void touch(const std::filesystem::path& entry);
+
+    void remove(const std::filesystem::path& entry);
+
+    // Removes every entry
+    void clear();
+
+private:
+    // Measures the directory and removes the least recently used entries
+    // until it holds at most target bytes. Caller holds mutex_.
+    void trim(long long target);
+
+    std::string extension_;
+    mutable std::mutex mutex_;
+    std::filesystem::path directory_;
+    long long max_bytes_ = 0;
+    long long used_bytes_ = 0;
+    std::atomic<uint64_t> temp_counter_{0};
+};
+
+} // namespace parqview
+
+#endif // PARQVIEW_CACHE_DIRECTORY_H
@@ -0,0 +1,146 @@
+#include "DistinctCounter.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace parqview {
+
+namespace {
+
+// splitmix64 finalizer
+uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+
+// Ertl, "New cardinality estimation algorithms for HyperLogLog sketches"
+// (2017): corrects the raw estimate across the whole range without the
+// empirical bias tables of HyperLogLog++
+double sigma(double x) {
+    if (x == 1.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double y = 1.0;
+    double z = x;
+    double previous;
+    do {
+        x *= x;
+        previous = z;
+        z += x * y;
+        y += y;
+    } while (z != previous);
+    return z;
+}
+
+double tau(double x) {
+    if (x == 0.0 || x == 1.0) {
+        return 0.0;
+    }
+    double y = 1.0;
+    double z = 1.0 - x;
+    double previous;
+    do {
+        x = std::sqrt(x);
+        previous = z;
+        y *= 0.5;
+        z -= (1.0 - x) * (1.0 - x) * y;
+    } while (z != previous);
+    return z / 3.0;
+}
+
+} // namespace
+
+uint64_t hash_u64(uint64_t value) {
+    return mix64(value + 0x9E3779B97F4A7C15ull);
+}
+
+uint64_t hash_bytes(const void* data, size_t length) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ (length * 0xC2B2AE3D27D4EB4Full);
+    while (length >= 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes, 8);
+        h = mix64(h ^ word) * 0x9E3779B97F4A7C15ull;
+        bytes += 8;
+        length -= 8;
+    }
+    uint64_t tail = 0;
+    if (length > 0) {
+        std::memcpy(&tail, bytes, length);
+    }
+    return mix64(h ^ tail);
+}
+
+void DistinctCounter::add(uint64_t hash) {
+    if (registers_.empty()) {
+        exact_.insert(hash);
+        if (exact_.size() > kExactLimit) {
+            promote();
+        }
+        return;
+    }
+    add_to_sketch(hash);
+}
+
+void DistinctCounter::add_to_sketch(uint64_t hash) {
+    size_t index = static_cast<size_t>(hash >> (64 - kPrecision));
+    uint64_t rest = hash << kPrecision;
+    // Rank of the first set bit among the remaining 50, or 51 when none is
+    uint8_t rank = rest == 0 ? static_cast<uint8_t>(64 - kPrecision + 1)
+                             : static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+    if (rank > registers_[index]) {
+        registers_[index] = rank;
+    }
+}
+
+void DistinctCounter::promote() {
+    registers_.assign(kRegisterCount, 0);
+    for (uint64_t hash : exact_) {
+        add_to_sketch(hash);
+    }
+    exact_ = std::unordered_set<uint64_t>();
+}
+
+void DistinctCounter::merge(const DistinctCounter& other) {
+    if (other.registers_.empty()) {
+        for (uint64_t hash : other.exact_) {
+            add(hash);
+        }
+        return;
+    }
+    if (registers_.empty()) {
+        promote();
+    }
+    for (size_t i = 0; i < kRegisterCount; i++) {
+        registers_[i] = std::max(registers_[i], other.registers_[i]);
+    }
+}
+
+uint64_t DistinctCounter::estimate() const {
+    if (registers_.empty()) {
+        return exact_.size();
+    }
+
+    constexpr int q = 64 - kPrecision;
+    std::vector<double> histogram(q + 2, 0.0);
+    for (uint8_t rank : registers_) {
+        histogram[rank] += 1.0;
+    }
+
+    double m = static_cast<double>(kRegisterCount);
+    double z = m * tau(1.0 - histogram[q + 1] / m);
+    for (int k = q; k >= 1; k--) {
+        z = 0.5 * (z + histogram[k]);
+    }
+    z += m * sigma(histogram[0] / m);
+
+    double alpha = 1.0 / (2.0 * std::log(2.0));
+    return static_cast<uint64_t>(std::llround(alpha * m * m / z));
+}
+
+} // namespace parqview
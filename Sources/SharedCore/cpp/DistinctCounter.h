@@ -0,0 +1,42 @@
+#ifndef PARQVIEW_DISTINCT_COUNTER_H
+#define PARQVIEW_DISTINCT_COUNTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+namespace parqview {
+
+// 64-bit hashes for distinct counting. Equal values hash equally; the
+// output is well mixed so the top bits can index a sketch directly.
+uint64_t hash_u64(uint64_t value);
+uint64_t hash_bytes(const void* data, size_t length);
+
+// Counts distinct hashes. Exact while few hashes have been seen, then a
+// HyperLogLog sketch (2^14 registers, ~0.8% standard error) so memory stays
+// at 16 KB however many values go in. Counters from separate threads merge.
+class DistinctCounter {
+public:
+    void add(uint64_t hash);
+    void merge(const DistinctCounter& other);
+
+    uint64_t estimate() const;
+    bool is_exact() const { return registers_.empty(); }
+
+private:
+    static constexpr int kPrecision = 14;
+    static constexpr size_t kRegisterCount = size_t(1) << kPrecision;
+    // Past this many hashes the exact set costs more than the sketch
+    static constexpr size_t kExactLimit = 4096;
+
+    void add_to_sketch(uint64_t hash);
+    void promote();
+
+    std::unordered_set<uint64_t> exact_;
+    std::vector<uint8_t> registers_;
+};
+
+} // namespace parqview
+
+#endif // PARQVIEW_DISTINCT_COUNTER_H
@@ -0,0 +1,497 @@
+#include "FormatReader.h"
+#include "ReaderInternal.h"
+#include <arrow/csv/api.h>
+#include <arrow/io/api.h>
+#include <arrow/ipc/api.h>
+#include <arrow/ipc/feather.h>
+#include <arrow/json/api.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+namespace fs = std::filesystem;
+
+// Rows between two entries of a CSV or NDJSON row index, and so the most
+// rows parsed that a read does not return
+constexpr int64_t kIndexStride = 4096;
+
+// Leading rows the column types of a CSV or NDJSON file are inferred from
+constexpr int64_t kInferRows = 4 * kIndexStride;
+
+// Bytes scanned between checks of whether the index reaches far enough
+constexpr int64_t kIndexStepBytes = 16 * 1024 * 1024;
+
+const char* const kIpcFileMagic = "ARROW1";
+const char* const kFeatherV1Magic = "FEA1";
+
+template <typename T>
+T checked(arrow::Result<T> result) {
+    if (!result.ok()) {
+        throw std::runtime_error(result.status().ToString());
+    }
+    return std::move(result).ValueUnsafe();
+}
+
+std::shared_ptr<arrow::io::MemoryMappedFile> map_file(const char* file_path) {
+    return checked(arrow::io::MemoryMappedFile::Open(file_path, arrow::io::FileMode::READ));
+}
+
+// Arrow IPC files are read batch by batch straight from the mapping; a
+// stream or Feather V1 file has no footer locating its batches, so its
+// batches are read once when it opens, still pointing into the mapping
+// unless compressed.
+class IpcReader : public parqview::FormatReader {
+public:
+    explicit IpcReader(const char* file_path) {
+        file_ = map_file(file_path);
+        auto magic = checked(file_->ReadAt(0, 6));
+        if (magic->ToString() == kIpcFileMagic) {
+            reader_ = checked(arrow::ipc::RecordBatchFileReader::Open(file_));
+            schema_ = reader_->schema();
+            // Batch lengths from their first column only, which saves
+            // decompressing the rest of every batch
+            auto options = arrow::ipc::IpcReadOptions::Defaults();
+            options.included_fields = {0};
+            auto lengths = schema_->num_fields() > 0
+                ? checked(arrow::ipc::RecordBatchFileReader::Open(file_, options))
+                : nullptr;
+            offsets_.push_back(0);
+            for (int i = 0; i < reader_->num_record_batches(); i++) {
+                offsets_.push_back(offsets_.back() + (lengths ? checked(lengths->ReadRecordBatch(i))->num_rows() : 0));
+            }
+            return;
+        }
+
+        if (magic->ToString().compare(0, 4, kFeatherV1Magic) == 0) {
+            auto feather = checked(arrow::ipc::feather::Reader::Open(file_));
+            std::shared_ptr<arrow::Table> table;
+            auto status = feather->Read(&table);
+            if (!status.ok()) {
+                throw std::runtime_error(status.ToString());
+            }
+            schema_ = table->schema();
+            batches_ = checked(arrow::TableBatchReader(*table).ToRecordBatches());
+        } else {
+            auto stream = checked(arrow::ipc::RecordBatchStreamReader::Open(file_));
+            schema_ = stream->schema();
+            batches_ = checked(stream->ToRecordBatches());
+        }
+        offsets_.push_back(0);
+        for (const auto& batch : batches_) {
+            offsets_.push_back(offsets_.back() + batch->num_rows());
+        }
+    }
+
+    std::shared_ptr<arrow::Schema> schema() const override { return schema_; }
+
+    int64_t row_count() override { return offsets_.back(); }
+
+    std::shared_ptr<arrow::Table> read_rows(int64_t start_row, int64_t num_rows) override {
+        int64_t end_row = std::min(start_row + num_rows, offsets_.back());
+        arrow::RecordBatchVector slices;
+        if (start_row < end_row) {
+            // The IPC reader is not safe to share between threads
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto index = std::upper_bound(offsets_.begin(), offsets_.end(), start_row) - offsets_.begin() - 1;
+            for (int64_t row = start_row; row < end_row; index++) {
+                auto batch = reader_ ? checked(reader_->ReadRecordBatch(static_cast<int>(index))) : batches_[index];
+                int64_t first = row - offsets_[index];
+                int64_t count = std::min(batch->num_rows() - first, end_row - row);
+                slices.push_back(batch->Slice(first, count));
+                row += count;
+            }
+        }
+        return checked(arrow::Table::FromRecordBatches(schema_, slices));
+    }
+
+private:
+    std::shared_ptr<arrow::io::MemoryMappedFile> file_;
+    std::shared_ptr<arrow::ipc::RecordBatchFileReader> reader_;  // null when batches_ holds every batch
+    arrow::RecordBatchVector batches_;
+    std::shared_ptr<arrow::Schema> schema_;
+    std::vector<int64_t> offsets_;  // first row of each batch, then the row count
+    std::mutex mutex_;
+};
+
+// CSV and NDJSON files are indexed rather than parsed up front: the byte
+// offset of every kIndexStride-th row, found by scanning the mapping for
+// record ends and extended only as far as a read needs. A read parses just
+// the indexed blocks holding its rows, with Arrow's multithreaded readers.
+class TextReader : public parqview::FormatReader {
+public:
+    std::shared_ptr<arrow::Schema> schema() const override { return schema_; }
+
+    int64_t row_count() override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        extend_index(INT64_MAX);
+        return indexed_rows_;
+    }
+
+    std::shared_ptr<arrow::Table> read_rows(int64_t start_row, int64_t num_rows) override {
+        int64_t begin = 0;
+        int64_t end = 0;
+        int64_t first_row = 0;
+        bool newlines_in_values = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            extend_index(num_rows > 0 ? start_row + num_rows : start_row);
+            if (num_rows <= 0 || start_row >= indexed_rows_) {
+                return checked(arrow::Table::MakeEmpty(schema_));
+            }
+            int64_t last_row = std::min(start_row + num_rows, indexed_rows_);
+            size_t next = static_cast<size_t>((last_row + kIndexStride - 1) / kIndexStride);
+            first_row = start_row / kIndexStride * kIndexStride;
+            begin = checkpoints_[start_row / kIndexStride];
+            end = next < checkpoints_.size() ? checkpoints_[next] : scanned_;
+            newlines_in_values = newlines_in_values_;
+        }
+
+        auto block = arrow::SliceBuffer(data_, begin, end - begin);
+        std::shared_ptr<arrow::Table> table;
+        try {
+            table = parse(block, true, newlines_in_values);
+        } catch (const std::exception&) {
+            // A value the leading rows did not prepare the types for
+            table = parse(block, false, newlines_in_values);
+        }
+        return align(table)->Slice(start_row - first_row, num_rows);
+    }
+
+protected:
+    TextReader(const char* file_path, bool quoted, char delimiter)
+        : file_(map_file(file_path)), quoted_(quoted), delimiter_(delimiter) {
+        data_ = checked(file_->ReadAt(0, checked(file_->GetSize())));
+    }
+
+    const std::shared_ptr<arrow::Buffer>& data() const { return data_; }
+
+    // Indexes from first_byte, after any header, and infers the schema
+    // from the leading rows
+    void open(int64_t first_byte) {
+        scanned_ = first_byte;
+        extend_index(kInferRows);
+        int64_t end = static_cast<size_t>(kInferRows / kIndexStride) < checkpoints_.size()
+            ? checkpoints_[kInferRows / kIndexStride]
+            : scanned_;
+        auto inferred = parse(arrow::SliceBuffer(data_, first_byte, end - first_byte), false, newlines_in_values_);
+        // A column empty throughout the leading rows is read as text
+        arrow::FieldVector fields;
+        for (const auto& field : inferred->schema()->fields()) {
+            fields.push_back(field->type()->id() == arrow::Type::NA ? field->WithType(arrow::utf8()) : field);
+        }
+        schema_ = arrow::schema(fields);
+    }
+
+    // Parses whole records, into the schema's types when typed
+    virtual std::shared_ptr<arrow::Table> parse(const std::shared_ptr<arrow::Buffer>& block, bool typed,
+                                                bool newlines_in_values) = 0;
+
+    // The end of the record starting at pos, and whether it is blank.
+    // Records end at a newline outside a quoted value.
+    int64_t record_end(int64_t pos, bool* blank) const {
+        const char* base = reinterpret_cast<const char*>(data_->data());
+        int64_t size = data_->size();
+        *blank = true;
+        bool in_quotes = false;
+        while (pos < size) {
+            const void* newline = std::memchr(base + pos, '\n', static_cast<size_t>(size - pos));
+            int64_t line_end = newline ? static_cast<const char*>(newline) - base : size;
+            for (int64_t i = pos; *blank && i < line_end; i++) {
+                *blank = std::isspace(static_cast<unsigned char>(base[i])) != 0;
+            }
+            if (quoted_ && (in_quotes || std::memchr(base + pos, '"', static_cast<size_t>(line_end - pos)))) {
+                in_quotes = quote_state(base + pos, base + line_end, in_quotes);
+            }
+            pos = newline ? line_end + 1 : size;
+            if (!in_quotes) {
+                break;
+            }
+            *blank = false;
+            newlines_in_values_ = true;
+        }
+        return pos;
+    }
+
+private:
+    // Whether a line that starts inside a quoted value or not ends inside
+    // one. Quotes open only at the start of a field, and a doubled quote
+    // inside one is an escaped quote.
+    bool quote_state(const char* pos, const char* end, bool in_quotes) const {
+        bool field_start = true;
+        bool closing = false;
+        for (; pos < end; pos++) {
+            char c = *pos;
+            if (in_quotes) {
+                if (c == '"') {
+                    in_quotes = false;
+                    closing = true;
+                }
+                continue;
+            }
+            if (c == '"' && (field_start || closing)) {
+                in_quotes = true;
+            }
+            field_start = c == delimiter_;
+            closing = false;
+        }
+        return in_quotes;
+    }
+
+    // Scans until the index holds a row past rows, so the block after
+    // each requested row has an entry, or the file ends
+    void extend_index(int64_t rows) {
+        int64_t target = rows >= INT64_MAX - kIndexStride ? INT64_MAX : (rows / kIndexStride + 1) * kIndexStride;
+        int64_t size = data_->size();
+        while (scanned_ < size && indexed_rows_ <= target) {
+            int64_t stop = std::min(size, scanned_ + kIndexStepBytes);
+            while (scanned_ < stop) {
+                bool blank;
+                int64_t end = record_end(scanned_, &blank);
+                // Blank lines are skipped by Arrow's readers, so they hold no row
+                if (!blank) {
+                    if (indexed_rows_ % kIndexStride == 0) {
+                        checkpoints_.push_back(scanned_);
+                    }
+                    indexed_rows_++;
+                }
+                scanned_ = end;
+            }
+        }
+    }
+
+    // The table with its columns in schema order, matched by name, and a
+    // column of nulls for any the block lacks
+    std::shared_ptr<arrow::Table> align(const std::shared_ptr<arrow::Table>& table) const {
+        if (table->schema()->Equals(*schema_)) {
+            return table;
+        }
+        std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+        arrow::FieldVector fields;
+        for (const auto& field : schema_->fields()) {
+            auto column = table->GetColumnByName(field->name());
+            if (!column) {
+                column = std::make_shared<arrow::ChunkedArray>(
+                    checked(arrow::MakeArrayOfNull(field->type(), table->num_rows())));
+            }
+            fields.push_back(field->WithType(column->type()));
+            columns.push_back(column);
+        }
+        return arrow::Table::Make(arrow::schema(fields), columns, table->num_rows());
+    }
+
+    std::shared_ptr<arrow::io::MemoryMappedFile> file_;
+    std::shared_ptr<arrow::Buffer> data_;  // the whole mapping
+    bool quoted_;
+    char delimiter_;
+    std::shared_ptr<arrow::Schema> schema_;
+
+    mutable bool newlines_in_values_ = false;
+    std::mutex mutex_;
+    std::vector<int64_t> checkpoints_;  // byte offset of every kIndexStride-th row
+    int64_t indexed_rows_ = 0;
+    int64_t scanned_ = 0;               // end of the last indexed record
+};
+
+class CsvReader : public TextReader {
+public:
+    CsvReader(const char* file_path, char delimiter) : TextReader(file_path, true, delimiter), delimiter_(delimiter) {
+        // The first record that is not blank holds the column names
+        int64_t pos = 0;
+        bool blank = true;
+        while (blank && pos < data()->size()) {
+            int64_t end = record_end(pos, &blank);
+            if (!blank) {
+                header_ = arrow::SliceBuffer(data(), pos, end - pos);
+            }
+            pos = end;
+        }
+        if (!header_) {
+            throw std::runtime_error("the file has no header line");
+        }
+        open(pos);
+    }
+
+protected:
+    std::shared_ptr<arrow::Table> parse(const std::shared_ptr<arrow::Buffer>& block, bool typed,
+                                        bool newlines_in_values) override {
+        auto read_options = arrow::csv::ReadOptions::Defaults();
+        read_options.use_threads = true;
+        auto parse_options = arrow::csv::ParseOptions::Defaults();
+        parse_options.delimiter = delimiter_;
+        parse_options.newlines_in_values = newlines_in_values;
+        auto convert_options = arrow::csv::ConvertOptions::Defaults();
+
+        // Blocks after the first are parsed behind the header line, so
+        // that names come out the same however the block is cut
+        auto input = checked(arrow::ConcatenateBuffers({header_, block}));
+        if (typed) {
+            for (const auto& field : schema()->fields()) {
+                convert_options.column_types[field->name()] = field->type();
+            }
+        }
+        auto reader = checked(arrow::csv::TableReader::Make(arrow::io::default_io_context(),
+                                                            std::make_shared<arrow::io::BufferReader>(input),
+                                                            read_options, parse_options, convert_options));
+        return checked(reader->Read());
+    }
+
+private:
+    char delimiter_;
+    std::shared_ptr<arrow::Buffer> header_;
+};
+
+class NdjsonReader : public TextReader {
+public:
+    explicit NdjsonReader(const char* file_path) : TextReader(file_path, false, '\n') {
+        open(0);
+    }
+
+protected:
+    std::shared_ptr<arrow::Table> parse(const std::shared_ptr<arrow::Buffer>& block, bool typed,
+                                        bool /*newlines_in_values*/) override {
+        auto read_options = arrow::json::ReadOptions::Defaults();
+        read_options.use_threads = true;
+        auto parse_options = arrow::json::ParseOptions::Defaults();
+        if (typed) {
+            parse_options.explicit_schema = schema();
+            parse_options.unexpected_field_behavior = arrow::json::UnexpectedFieldBehavior::Ignore;
+        }
+        auto reader = checked(arrow::json::TableReader::Make(arrow::default_memory_pool(),
+                                                             std::make_shared<arrow::io::BufferReader>(block),
+                                                             read_options, parse_options));
+        return checked(reader->Read());
+    }
+};
+
+struct OpenFormatReader {
+    std::string fingerprint;
+    std::shared_ptr<parqview::FormatReader> reader;
+};
+
+std::mutex format_reader_mutex;
+std::unordered_map<std::string, OpenFormatReader> format_readers;
+
+std::string lowercase_extension(const char* file_path) {
+    std::string extension = fs::path(file_path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension;
+}
+
+} // namespace
+
+namespace parqview {
+
+std::shared_ptr<FormatReader> get_format_reader(const char* file_path) {
+    FileFormat format = detect_file_format(file_path);
+    if (format == FILE_FORMAT_PARQUET) {
+        return nullptr;
+    }
+    std::string fingerprint = file_fingerprint(file_path);
+    {
+        std::lock_guard<std::mutex> lock(format_reader_mutex);
+        auto it = format_readers.find(file_path);
+        if (it != format_readers.end()) {
+            if (it->second.fingerprint == fingerprint) {
+                return it->second.reader;
+            }
+            format_readers.erase(it);
+        }
+    }
+
+    // Opened outside the lock: a CSV or NDJSON file parses its leading rows
+    std::shared_ptr<FormatReader> reader;
+    try {
+        switch (format) {
+            case FILE_FORMAT_ARROW_IPC:
+                reader = std::make_shared<IpcReader>(file_path);
+                break;
+            case FILE_FORMAT_CSV:
+                reader = std::make_shared<CsvReader>(file_path, lowercase_extension(file_path) == ".tsv" ? '\t' : ',');
+                break;
+            case FILE_FORMAT_NDJSON:
+                reader = std::make_shared<NdjsonReader>(file_path);
+                break;
+            default:
+                return nullptr;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error opening " << file_path << ": " << e.what() << std::endl;
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(format_reader_mutex);
+    format_readers[file_path] = {fingerprint, reader};
+    return reader;
+}
+
+TableData* read_format_rows(FormatReader& reader, int64_t start_row, int num_rows, int max_cell_bytes) {
+    auto table = reader.read_rows(start_row, num_rows);
+    auto* data = allocate_table_data(static_cast<int>(table->num_rows()), table->num_columns());
+    for (int col = 0; col < table->num_columns(); col++) {
+        int row = 0;
+        for (const auto& chunk : table->column(col)->chunks()) {
+            for (int64_t i = 0; i < chunk->length(); i++) {
+                set_cell(data, row++, col, *chunk, i, max_cell_bytes);
+            }
+        }
+    }
+    return data;
+}
+
+TableData* take_format_rows(FormatReader& reader, const std::vector<int64_t>& rows, int max_cell_bytes) {
+    int column_count = reader.schema()->num_fields();
+    auto* data = allocate_table_data(static_cast<int>(rows.size()), column_count);
+    size_t first = 0;
+    while (first < rows.size()) {
+        size_t last = first;
+        while (last + 1 < rows.size() && rows[last + 1] < rows[first] + kIndexStride) {
+            last++;
+        }
+        auto table = reader.read_rows(rows[first], rows[last] - rows[first] + 1);
+        std::vector<int64_t> local;
+        for (size_t i = first; i <= last; i++) {
+            local.push_back(rows[i] - rows[first]);
+        }
+        for (int col = 0; col < column_count; col++) {
+            fill_column_rows(data, static_cast<int>(first), col, *table->column(col), local, max_cell_bytes);
+        }
+        first = last + 1;
+    }
+    return data;
+}
+
+void clear_format_reader_cache(const char* file_path) {
+    std::lock_guard<std::mutex> lock(format_reader_mutex);
+    if (file_path) {
+        format_readers.erase(file_path);
+    } else {
+        format_readers.clear();
+    }
+}
+
+} // namespace parqview
+
+extern "C" {
+
+FileFormat detect_file_format(const char* file_path) {
+    std::string extension = lowercase_extension(file_path);
+    if (extension == ".arrow" || extension == ".arrows" || extension == ".feather" || extension == ".ipc") {
+        return FILE_FORMAT_ARROW_IPC;
+    }
+    if (extension == ".csv" || extension == ".tsv") {
+        return FILE_FORMAT_CSV;
+    }
+    if (extension == ".jsonl" || extension == ".ndjson") {
+        return FILE_FORMAT_NDJSON;
+    }
+    return FILE_FORMAT_PARQUET;
+}
+
+} // extern "C"
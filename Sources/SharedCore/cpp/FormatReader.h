@@ -0,0 +1,48 @@
+#ifndef PARQVIEW_FORMAT_READER_H
+#define PARQVIEW_FORMAT_READER_H
+
+// Readers for the formats other than Parquet, behind the same schema, page
+// and search calls. Not part of the C API exposed to Swift.
+
+#include "../include/ParquetReader.h"
+#include <arrow/api.h>
+#include <memory>
+#include <vector>
+
+namespace parqview {
+
+// A non-Parquet file opened for reading by row position. Safe to share
+// between threads.
+class FormatReader {
+public:
+    virtual ~FormatReader() = default;
+
+    virtual std::shared_ptr<arrow::Schema> schema() const = 0;
+
+    // Rows in the file. CSV and NDJSON complete their row index to answer.
+    virtual int64_t row_count() = 0;
+
+    // Rows [start_row, start_row + num_rows), fewer past the end. Columns
+    // follow schema() by position; a CSV or NDJSON block whose values do not
+    // convert to the schema's types keeps the types inferred for the block.
+    virtual std::shared_ptr<arrow::Table> read_rows(int64_t start_row, int64_t num_rows) = 0;
+};
+
+// The open reader of file_path, opened on first use and reopened when the
+// file changes. NULL for Parquet files, and for files that cannot be read,
+// with the reason logged.
+std::shared_ptr<FormatReader> get_format_reader(const char* file_path);
+
+// Formats rows [start_row, start_row + num_rows) as read_parquet_page does
+TableData* read_format_rows(FormatReader& reader, int64_t start_row, int num_rows, int max_cell_bytes = 0);
+
+// Formats the given rows (ascending), reading each run of nearby rows once,
+// cut as read_format_rows cuts them
+TableData* take_format_rows(FormatReader& reader, const std::vector<int64_t>& rows, int max_cell_bytes = 0);
+
+// Closes the reader of file_path, or of every file when file_path is null
+void clear_format_reader_cache(const char* file_path);
+
+} // namespace parqview
+
+#endif // PARQVIEW_FORMAT_READER_H
@@ -0,0 +1,164 @@
+#include "FrequencySketch.h"
+#include "DistinctCounter.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace parqview {
+
+void FrequencySummary::merge(const FrequencySummary& other) {
+    // A value missing from one side occurred there at most its missing_bound
+    // times, which widens both its count and its error
+    for (auto& entry : counters) {
+        auto it = other.counters.find(entry.first);
+        if (it != other.counters.end()) {
+            entry.second.count += it->second.count;
+            entry.second.error += it->second.error;
+        } else {
+            entry.second.count += other.missing_bound;
+            entry.second.error += other.missing_bound;
+        }
+    }
+    for (const auto& entry : other.counters) {
+        if (counters.count(entry.first)) {
+            continue;
+        }
+        counters[entry.first] = Counter{entry.second.count + missing_bound, entry.second.error + missing_bound};
+    }
+    missing_bound += other.missing_bound;
+}
+
+void FrequencySummary::prune(size_t capacity) {
+    if (counters.size() <= capacity) {
+        return;
+    }
+
+    std::vector<std::pair<long long, const std::string*>> ranked;
+    ranked.reserve(counters.size());
+    for (const auto& entry : counters) {
+        ranked.emplace_back(entry.second.count, &entry.first);
+    }
+    std::nth_element(ranked.begin(), ranked.begin() + capacity, ranked.end(),
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    // The largest dropped count bounds every value no longer listed
+    missing_bound = std::max(missing_bound, ranked[capacity].first);
+    std::vector<std::string> doomed;
+    for (size_t i = capacity; i < ranked.size(); i++) {
+        doomed.push_back(*ranked[i].second);
+    }
+    for (const auto& key : doomed) {
+        counters.erase(key);
+    }
+}
+
+SpaceSaving::SpaceSaving(size_t capacity) : capacity_(std::max<size_t>(capacity, 1)) {
+    entries_.reserve(capacity_);
+    heap_.reserve(capacity_);
+    position_.reserve(capacity_);
+    index_.reserve(capacity_ * 2);
+}
+
+void SpaceSaving::add(const void* data, size_t length) {
+    uint64_t hash = hash_bytes(data, length);
+    long found = find(hash, data, length);
+    if (found >= 0) {
+        entries_[found].count++;
+        sift_down(position_[found]);
+        return;
+    }
+
+    if (entries_.size() < capacity_) {
+        size_t slot = entries_.size();
+        entries_.push_back(Entry{std::string(static_cast<const char*>(data), length), hash, 1, 0});
+        index_.emplace(hash, slot);
+        position_.push_back(heap_.size());
+        heap_.push_back(slot);
+        sift_up(heap_.size() - 1);
+        return;
+    }
+
+    // Take over the smallest counter
+    size_t slot = heap_[0];
+    Entry& entry = entries_[slot];
+    erase_index(entry.hash, slot);
+    entry.key.assign(static_cast<const char*>(data), length);
+    entry.hash = hash;
+    entry.error = entry.count;
+    entry.count++;
+    index_.emplace(hash, slot);
+    sift_down(0);
+}
+
+long SpaceSaving::find(uint64_t hash, const void* data, size_t length) const {
+    auto range = index_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        const std::string& key = entries_[it->second].key;
+        if (key.size() == length && (length == 0 || std::memcmp(key.data(), data, length) == 0)) {
+            return static_cast<long>(it->second);
+        }
+    }
+    return -1;
+}
+
+void SpaceSaving::erase_index(uint64_t hash, size_t slot) {
+    auto range = index_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == slot) {
+            index_.erase(it);
+            return;
+        }
+    }
+}
+
+void SpaceSaving::sift_up(size_t position) {
+    while (position > 0) {
+        size_t parent = (position - 1) / 2;
+        if (entries_[heap_[parent]].count <= entries_[heap_[position]].count) {
+            return;
+        }
+        swap_heap(position, parent);
+        position = parent;
+    }
+}
+
+void SpaceSaving::sift_down(size_t position) {
+    size_t size = heap_.size();
+    while (true) {
+        size_t smallest = position;
+        size_t left = 2 * position + 1;
+        size_t right = left + 1;
+        if (left < size && entries_[heap_[left]].count < entries_[heap_[smallest]].count) {
+            smallest = left;
+        }
+        if (right < size && entries_[heap_[right]].count < entries_[heap_[smallest]].count) {
+            smallest = right;
+        }
+        if (smallest == position) {
+            return;
+        }
+        swap_heap(position, smallest);
+        position = smallest;
+    }
+}
+
+void SpaceSaving::swap_heap(size_t a, size_t b) {
+    std::swap(heap_[a], heap_[b]);
+    position_[heap_[a]] = a;
+    position_[heap_[b]] = b;
+}
+
+FrequencySummary SpaceSaving::summary() const {
+    FrequencySummary summary;
+    for (const auto& entry : entries_) {
+        summary.counters[entry.key] = FrequencySummary::Counter{entry.count, entry.error};
+    }
+    // Until every counter is in use nothing has been evicted, so an unlisted
+    // value never occurred
+    if (entries_.size() >= capacity_) {
+        summary.missing_bound = entries_[heap_[0]].count;
+    }
+    return summary;
+}
+
+} // namespace parqview
@@ -0,0 +1,68 @@
+#ifndef PARQVIEW_FREQUENCY_SKETCH_H
+#define PARQVIEW_FREQUENCY_SKETCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace parqview {
+
+// Value counts with error bounds. Each count is an upper bound on the true
+// count, and count - error a lower bound. Any value not listed occurs at
+// most missing_bound times. Summaries from separate row groups merge.
+struct FrequencySummary {
+    struct Counter {
+        long long count = 0;
+        long long error = 0;
+    };
+
+    std::unordered_map<std::string, Counter> counters;
+    long long missing_bound = 0;
+
+    void merge(const FrequencySummary& other);
+    // Keeps the capacity largest counters, raising missing_bound to cover
+    // the ones dropped
+    void prune(size_t capacity);
+};
+
+// Space-saving heavy hitters (Metwally et al., 2005): a fixed number of
+// counters; a value without one takes over the smallest counter and
+// inherits its count as error. Every value occurring more than
+// total / capacity times is guaranteed a counter.
+class SpaceSaving {
+public:
+    explicit SpaceSaving(size_t capacity);
+
+    void add(const void* data, size_t length);
+    FrequencySummary summary() const;
+
+private:
+    struct Entry {
+        std::string key;
+        uint64_t hash;
+        long long count;
+        long long error;
+    };
+
+    // Index of the entry holding these bytes, or -1
+    long find(uint64_t hash, const void* data, size_t length) const;
+    void erase_index(uint64_t hash, size_t slot);
+    void sift_up(size_t position);
+    void sift_down(size_t position);
+    void swap_heap(size_t a, size_t b);
+
+    size_t capacity_;
+    std::vector<Entry> entries_;
+    // Min-heap of entry indices by count, and each entry's heap position
+    std::vector<size_t> heap_;
+    std::vector<size_t> position_;
+    // Entries by hash; values that collide share a hash, so a hit is
+    // confirmed against the entry's bytes
+    std::unordered_multimap<uint64_t, size_t> index_;
+};
+
+} // namespace parqview
+
+#endif // PARQVIEW_FREQUENCY_SKETCH_H
@@ -0,0 +1,324 @@
+#include "PageHeader.h"
+#include <algorithm>
+
+namespace parqview {
+namespace {
+
+// Thrift compact protocol type codes
+enum : int {
+    kStop = 0, kTrue = 1, kFalse = 2, kByte = 3, kI16 = 4, kI32 = 5, kI64 = 6,
+    kDouble = 7, kBinary = 8, kList = 9, kSet = 10, kMap = 11, kStruct = 12
+};
+
+// Nesting deeper than any page header needs means the bytes are not one
+constexpr int kMaxDepth = 16;
+
+class CompactReader {
+public:
+    CompactReader(const uint8_t* data, int64_t size) : pos_(data), begin_(data), end_(data + size) {}
+
+    bool truncated() const { return truncated_; }
+    int64_t consumed() const { return pos_ - begin_; }
+
+    bool byte(uint8_t* out) {
+        if (pos_ >= end_) {
+            truncated_ = true;
+            return false;
+        }
+        *out = *pos_++;
+        return true;
+    }
+
+    bool varint(uint64_t* out) {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t b;
+            if (!byte(&b)) {
+                return false;
+            }
+            value |= static_cast<uint64_t>(b & 0x7f) << shift;
+            if (!(b & 0x80)) {
+                *out = value;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool zigzag(int64_t* out) {
+        uint64_t raw;
+        if (!varint(&raw)) {
+            return false;
+        }
+        *out = static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+        return true;
+    }
+
+    bool i32(int32_t* out) {
+        int64_t value;
+        if (!zigzag(&value)) {
+            return false;
+        }
+        *out = static_cast<int32_t>(value);
+        return true;
+    }
+
+    bool skip_bytes(uint64_t count) {
+        if (count > static_cast<uint64_t>(end_ - pos_)) {
+            truncated_ = true;
+            return false;
+        }
+        pos_ += count;
+        return true;
+    }
+
+    // Reads a field header; type kStop ends the struct
+    bool field(int16_t* id, int* type) {
+        uint8_t b;
+        if (!byte(&b)) {
+            return false;
+        }
+        *type = b & 0x0f;
+        if (*type == kStop) {
+            return true;
+        }
+        int delta = b >> 4;
+        if (delta != 0) {
+            *id = static_cast<int16_t>(*id + delta);
+            return true;
+        }
+        int64_t absolute;
+        if (!zigzag(&absolute)) {
+            return false;
+        }
+        *id = static_cast<int16_t>(absolute);
+        return true;
+    }
+
+    bool skip(int type, int depth) {
+        if (depth > kMaxDepth) {
+            return false;
+        }
+        uint64_t unused;
+        switch (type) {
+            case kTrue:
+            case kFalse:
+                return true;
+            case kByte:
+                return skip_bytes(1);
+            case kI16:
+            case kI32:
+            case kI64:
+                return varint(&unused);
+            case kDouble:
+                return skip_bytes(8);
+            case kBinary: {
+                uint64_t length;
+                return varint(&length) && skip_bytes(length);
+            }
+            case kList:
+            case kSet: {
+                uint8_t b;
+                if (!byte(&b)) {
+                    return false;
+                }
+                uint64_t count = b >> 4;
+                if (count == 15 && !varint(&count)) {
+                    return false;
+                }
+                int element = b & 0x0f;
+                for (uint64_t i = 0; i < count; i++) {
+                    // Booleans inside collections take a byte each
+                    bool ok = element == kTrue || element == kFalse ? skip_bytes(1) : skip(element, depth + 1);
+                    if (!ok) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            case kMap: {
+                uint64_t count;
+                if (!varint(&count)) {
+                    return false;
+                }
+                if (count == 0) {
+                    return true;
+                }
+                uint8_t types;
+                if (!byte(&types)) {
+                    return false;
+                }
+                for (uint64_t i = 0; i < count; i++) {
+                    if (!skip(types >> 4, depth + 1) || !skip(types & 0x0f, depth + 1)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            case kStruct: {
+                int16_t id = 0;
+                while (true) {
+                    int field_type;
+                    if (!field(&id, &field_type)) {
+                        return false;
+                    }
+                    if (field_type == kStop) {
+                        return true;
+                    }
+                    if (!skip(field_type, depth + 1)) {
+                        return false;
+                    }
+                }
+            }
+            default:
+                return false;
+        }
+    }
+
+private:
+    const uint8_t* pos_;
+    const uint8_t* begin_;
+    const uint8_t* end_;
+    bool truncated_ = false;
+};
+
+// Reads the fields of DataPageHeader, DataPageHeaderV2 or
+// DictionaryPageHeader that PageHeader keeps. Field ids differ between
+// them, so each maps its own.
+bool read_nested_header(CompactReader& in, int page_type, PageHeader* header) {
+    int16_t id = 0;
+    while (true) {
+        int type;
+        if (!in.field(&id, &type)) {
+            return false;
+        }
+        if (type == kStop) {
+            return true;
+        }
+        int32_t* target = nullptr;
+        if (id == 1 && type == kI32) {
+            target = &header->value_count;
+        } else if (page_type == 3 && id == 2 && type == kI32) {
+            target = &header->null_count;
+        } else if (page_type == 3 && id == 3 && type == kI32) {
+            target = &header->row_count;
+        } else if ((page_type == 3 ? id == 4 : id == 2) && type == kI32) {
+            target = &header->encoding;
+        } else if (page_type == 3 && id == 7 && (type == kTrue || type == kFalse)) {
+            header->is_compressed = type == kTrue;
+            continue;
+        }
+        if (target) {
+            if (!in.i32(target)) {
+                return false;
+            }
+        } else if (!in.skip(type, 1)) {
+            return false;
+        }
+    }
+}
+
+} // namespace
+
+bool parse_page_header(const uint8_t* data, int64_t size, PageHeader* header, bool* truncated) {
+    CompactReader in(data, size);
+    *header = PageHeader();
+    bool ok = [&]() {
+        int16_t id = 0;
+        while (true) {
+            int type;
+            if (!in.field(&id, &type)) {
+                return false;
+            }
+            if (type == kStop) {
+                return true;
+            }
+            int32_t crc = 0;
+            bool field_ok;
+            if (id == 1 && type == kI32) {
+                field_ok = in.i32(&header->type);
+            } else if (id == 2 && type == kI32) {
+                field_ok = in.i32(&header->uncompressed_size);
+            } else if (id == 3 && type == kI32) {
+                field_ok = in.i32(&header->compressed_size);
+            } else if (id == 4 && type == kI32) {
+                field_ok = in.i32(&crc);
+                header->has_crc = true;
+                header->crc = static_cast<uint32_t>(crc);
+            } else if ((id == 5 || id == 7 || id == 8) && type == kStruct) {
+                // The page type field always precedes the nested header
+                field_ok = read_nested_header(in, header->type, header);
+            } else {
+                field_ok = in.skip(type, 1);
+            }
+            if (!field_ok) {
+                return false;
+            }
+        }
+    }();
+    *truncated = !ok && in.truncated();
+    if (ok && (header->type < 0 || header->compressed_size < 0 || header->uncompressed_size < 0)) {
+        ok = false;
+    }
+    header->header_size = static_cast<int32_t>(in.consumed());
+    return ok;
+}
+
+int64_t chunk_start_offset(const parquet::ColumnChunkMetaData& chunk) {
+    // Some writers record a dictionary offset of 0 to mean none
+    int64_t offset = chunk.data_page_offset();
+    if (chunk.has_dictionary_page() && chunk.dictionary_page_offset() > 0) {
+        offset = std::min(offset, chunk.dictionary_page_offset());
+    }
+    return offset;
+}
+
+bool walk_chunk_pages(arrow::io::RandomAccessFile& file, const parquet::ColumnChunkMetaData& chunk,
+                      const std::function<bool(const PageHeader&, int64_t)>& visit, std::string* error) {
+    if (chunk.crypto_metadata()) {
+        *error = "column chunk is encrypted";
+        return false;
+    }
+
+    int64_t offset = chunk_start_offset(chunk);
+    int64_t end = offset + chunk.total_compressed_size();
+
+    // Headers are a few dozen bytes unless they carry long min/max
+    // statistics; a short read that ends mid-header is retried larger
+    constexpr int64_t kInitialRead = 512;
+    constexpr int64_t kMaxHeaderSize = 16 << 20;
+    while (offset < end) {
+        int64_t want = std::min(kInitialRead, end - offset);
+        PageHeader header;
+        while (true) {
+            auto buffer = file.ReadAt(offset, want);
+            if (!buffer.ok()) {
+                *error = buffer.status().ToString();
+                return false;
+            }
+            const auto& bytes = *buffer;
+            bool truncated = false;
+            if (parse_page_header(bytes->data(), bytes->size(), &header, &truncated)) {
+                break;
+            }
+            if (!truncated || want >= end - offset || want >= kMaxHeaderSize) {
+                *error = "corrupt page header at offset " + std::to_string(offset);
+                return false;
+            }
+            want = std::min(want * 8, end - offset);
+        }
+
+        int64_t body = offset + header.header_size;
+        if (body + header.compressed_size > end) {
+            *error = "page at offset " + std::to_string(offset) + " runs past the end of its column chunk";
+            return false;
+        }
+        if (!visit(header, body)) {
+            return true;
+        }
+        offset = body + header.compressed_size;
+    }
+    return true;
+}
+
+} // namespace parqview
@@ -0,0 +1,52 @@
+#ifndef PARQVIEW_PAGE_HEADER_H
+#define PARQVIEW_PAGE_HEADER_H
+
+#include <arrow/io/interfaces.h>
+#include <parquet/metadata.h>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace parqview {
+
+// Page types, numbered as in the Parquet format
+enum class PageKind { DataPage = 0, IndexPage = 1, DictionaryPage = 2, DataPageV2 = 3 };
+
+// The fields of a Thrift page header that describe the page's layout.
+// Statistics are skipped rather than decoded.
+struct PageHeader {
+    int type = -1;
+    int32_t uncompressed_size = 0;
+    int32_t compressed_size = 0;
+    bool has_crc = false;
+    uint32_t crc = 0;
+    int32_t value_count = 0;     // values, nulls included
+    int32_t null_count = -1;     // v2 data pages only
+    int32_t row_count = -1;      // v2 data pages only
+    int encoding = -1;           // of the values, or of the dictionary
+    bool is_compressed = true;   // false for a v2 page written uncompressed
+    int32_t header_size = 0;     // bytes the header itself took
+
+    PageKind kind() const { return static_cast<PageKind>(type); }
+    bool is_data() const { return type == 0 || type == 3; }
+};
+
+// Decodes the compact-protocol header at the start of data. False when
+// the bytes end before the header does or do not decode; truncated is set
+// in the first case, so the caller can retry with more bytes.
+bool parse_page_header(const uint8_t* data, int64_t size, PageHeader* header, bool* truncated);
+
+// Where a column chunk's first page starts: its dictionary page if it has
+// one, else its first data page
+int64_t chunk_start_offset(const parquet::ColumnChunkMetaData& chunk);
+
+// Visits every page header of a column chunk in file order, reading only
+// the headers, never the page bodies. visit receives the header and the
+// offset of the page body; returning false stops the walk. False with
+// error set when a header does not decode or the chunk is encrypted.
+bool walk_chunk_pages(arrow::io::RandomAccessFile& file, const parquet::ColumnChunkMetaData& chunk,
+                      const std::function<bool(const PageHeader&, int64_t)>& visit, std::string* error);
+
+} // namespace parqview
+
+#endif // PARQVIEW_PAGE_HEADER_H
@@ -0,0 +1,304 @@
+#include "../include/ParquetAccelerate.h"
+#include "CacheDirectory.h"
+#include "ReaderInternal.h"
+#include <arrow/compute/api.h>
+#include <arrow/io/file.h>
+#include <arrow/ipc/api.h>
+#include <arrow/util/compression.h>
+#include <arrow/util/key_value_metadata.h>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr long long kDefaultMaxBytes = 4LL * 1024 * 1024 * 1024;
+
+// Rows per record batch, so a page read maps only the batches it touches
+constexpr int64_t kBatchRows = 65536;
+
+// Footer metadata: the source fingerprint, and the row count of every
+// batch so a read finds its batch without touching the others
+const char* const kSourceKey = "parqview.source";
+const char* const kBatchRowsKey = "parqview.batch_rows";
+
+parqview::CacheDirectory& arrow_directory() {
+    static parqview::CacheDirectory directory(".arrow");
+    return directory;
+}
+
+struct AcceleratedFile {
+    std::string fingerprint;
+    std::shared_ptr<arrow::ipc::RecordBatchFileReader> reader;
+    std::vector<int64_t> offsets;  // first row of each batch, then the row count
+    std::mutex read_mutex;         // the IPC reader is not safe to share between threads
+};
+
+std::mutex accelerated_mutex;
+std::unordered_map<std::string, std::shared_ptr<AcceleratedFile>> accelerated_files;
+
+std::shared_ptr<arrow::DataType> stored_type(const std::shared_ptr<arrow::DataType>& type) {
+    if (type->id() == arrow::Type::DICTIONARY) {
+        return static_cast<const arrow::DictionaryType&>(*type).value_type();
+    }
+    return type;
+}
+
+std::vector<int64_t> parse_offsets(const std::string& batch_rows) {
+    std::vector<int64_t> offsets{0};
+    size_t start = 0;
+    while (start < batch_rows.size()) {
+        size_t comma = batch_rows.find(',', start);
+        if (comma == std::string::npos) {
+            comma = batch_rows.size();
+        }
+        offsets.push_back(offsets.back() + std::stoll(batch_rows.substr(start, comma - start)));
+        start = comma + 1;
+    }
+    return offsets;
+}
+
+// The open copy of file_path, if it was written from the file's current
+// contents. A stale or unreadable copy is removed.
+std::shared_ptr<AcceleratedFile> open_copy(const char* file_path) {
+    std::string fingerprint = parqview::file_fingerprint(file_path);
+    {
+        std::lock_guard<std::mutex> lock(accelerated_mutex);
+        auto it = accelerated_files.find(file_path);
+        if (it != accelerated_files.end()) {
+            if (it->second->fingerprint == fingerprint) {
+                return it->second;
+            }
+            accelerated_files.erase(it);
+        }
+    }
+
+    auto path = arrow_directory().entry_path(file_path);
+    std::error_code error;
+    if (path.empty() || fingerprint.empty() || !fs::exists(path, error)) {
+        return nullptr;
+    }
+    auto input = arrow::io::MemoryMappedFile::Open(path.string(), arrow::io::FileMode::READ);
+    if (!input.ok()) {
+        return nullptr;
+    }
+    auto reader = arrow::ipc::RecordBatchFileReader::Open(*input);
+    std::shared_ptr<const arrow::KeyValueMetadata> metadata = reader.ok() ? (*reader)->metadata() : nullptr;
+    int source = metadata ? metadata->FindKey(kSourceKey) : -1;
+    int batch_rows = metadata ? metadata->FindKey(kBatchRowsKey) : -1;
+    if (source < 0 || batch_rows < 0 || metadata->value(source) != fingerprint) {
+        arrow_directory().remove(path);
+        return nullptr;
+    }
+
+    auto file = std::make_shared<AcceleratedFile>();
+    file->fingerprint = fingerprint;
+    file->reader = *reader;
+    file->offsets = parse_offsets(metadata->value(batch_rows));
+    if (static_cast<int>(file->offsets.size()) - 1 != file->reader->num_record_batches()) {
+        arrow_directory().remove(path);
+        return nullptr;
+    }
+    arrow_directory().touch(path);
+
+    std::lock_guard<std::mutex> lock(accelerated_mutex);
+    accelerated_files[file_path] = file;
+    return file;
+}
+
+// Writes the Arrow copy to temp: every row group in order, cut into
+// batches of kBatchRows
+bool write_copy(const char* file_path, const std::string& fingerprint, const fs::path& temp, bool compress) {
+    auto reader_ptr = get_cached_reader(file_path);
+    if (!reader_ptr || !(*reader_ptr)) {
+        return false;
+    }
+    auto metadata = (*reader_ptr)->parquet_reader()->metadata();
+
+    // A reader of its own: the cached one serves the table meanwhile
+    parquet::ArrowReaderProperties props;
+    props.set_batch_size(kBatchRows);
+    auto reader = parqview::open_reader(file_path, metadata, props);
+    std::shared_ptr<arrow::Schema> schema;
+    if (!reader || !reader->GetSchema(&schema).ok()) {
+        return false;
+    }
+    // UUIDs are stored as arrow.uuid, so the copy shows them as the file does
+    arrow::FieldVector fields;
+    for (int i = 0; i < schema->num_fields(); i++) {
+        auto type = parqview::with_uuid_type(stored_type(schema->field(i)->type()), reader->manifest(), i);
+        fields.push_back(schema->field(i)->WithType(type));
+    }
+    auto stored_schema = arrow::schema(fields);
+
+    std::string batch_rows;
+    for (int rg = 0; rg < metadata->num_row_groups(); rg++) {
+        int64_t rows = metadata->RowGroup(rg)->num_rows();
+        for (int64_t offset = 0; offset < rows; offset += kBatchRows) {
+            batch_rows += (batch_rows.empty() ? "" : ",") + std::to_string(std::min(kBatchRows, rows - offset));
+        }
+    }
+    auto footer = arrow::key_value_metadata({kSourceKey, kBatchRowsKey}, {fingerprint, batch_rows});
+
+    auto options = arrow::ipc::IpcWriteOptions::Defaults();
+    if (compress) {
+        auto codec = arrow::util::Codec::Create(arrow::Compression::LZ4_FRAME);
+        if (!codec.ok()) {
+            std::cerr << "LZ4 is not available: " << codec.status().ToString() << std::endl;
+            return false;
+        }
+        options.codec = std::move(*codec);
+    }
+
+    auto output = arrow::io::FileOutputStream::Open(temp.string());
+    if (!output.ok()) {
+        return false;
+    }
+    auto writer = arrow::ipc::MakeFileWriter(*output, stored_schema, options, footer);
+    if (!writer.ok()) {
+        return false;
+    }
+    for (int rg = 0; rg < metadata->num_row_groups(); rg++) {
+        std::shared_ptr<arrow::Table> table;
+        if (!reader->ReadRowGroup(rg, &table).ok()) {
+            return false;
+        }
+        std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+        for (int i = 0; i < table->num_columns(); i++) {
+            columns.push_back(parqview::with_uuid_type(parqview::decode_dictionary(table->column(i)),
+                                                       reader->manifest(), i));
+        }
+        // One chunk per column, so batches are cut exactly every kBatchRows
+        auto combined = arrow::Table::Make(stored_schema, columns, table->num_rows())->CombineChunks();
+        if (!combined.ok()) {
+            return false;
+        }
+        arrow::TableBatchReader batches(**combined);
+        batches.set_chunksize(kBatchRows);
+        std::shared_ptr<arrow::RecordBatch> batch;
+        while (batches.ReadNext(&batch).ok() && batch) {
+            if (!(*writer)->WriteRecordBatch(*batch).ok()) {
+                return false;
+            }
+        }
+    }
+    return (*writer)->Close().ok() && (*output)->Close().ok();
+}
+
+} // namespace
+
+namespace parqview {
+
+std::shared_ptr<arrow::ChunkedArray> decode_dictionary(const std::shared_ptr<arrow::ChunkedArray>& column) {
+    if (column->type()->id() != arrow::Type::DICTIONARY) {
+        return column;
+    }
+    arrow::ArrayVector chunks;
+    for (const auto& chunk : column->chunks()) {
+        const auto& dictionary = static_cast<const arrow::DictionaryArray&>(*chunk);
+        auto decoded = arrow::compute::Take(*dictionary.dictionary(), *dictionary.indices());
+        if (!decoded.ok()) {
+            throw std::runtime_error(decoded.status().ToString());
+        }
+        chunks.push_back(*decoded);
+    }
+    return std::make_shared<arrow::ChunkedArray>(chunks, stored_type(column->type()));
+}
+
+TableData* read_accelerated_rows(const char* file_path, int64_t start_row, int num_rows, int max_cell_bytes) {
+    auto file = open_copy(file_path);
+    if (!file) {
+        return nullptr;
+    }
+    int64_t end_row = std::min(start_row + num_rows, file->offsets.back());
+    if (end_row <= start_row) {
+        return allocate_table_data(0, 0);
+    }
+
+    int row_count = static_cast<int>(end_row - start_row);
+    int column_count = file->reader->schema()->num_fields();
+    auto* data = allocate_table_data(row_count, column_count);
+    std::lock_guard<std::mutex> lock(file->read_mutex);
+    auto batch_index = std::upper_bound(file->offsets.begin(), file->offsets.end(), start_row) - file->offsets.begin() - 1;
+    for (int row = 0; row < row_count; batch_index++) {
+        auto batch = file->reader->ReadRecordBatch(static_cast<int>(batch_index));
+        if (!batch.ok()) {
+            free_table_data(data);
+            return nullptr;
+        }
+        int64_t first = start_row + row - file->offsets[batch_index];
+        int64_t count = std::min<int64_t>((*batch)->num_rows() - first, row_count - row);
+        for (int col = 0; col < column_count; col++) {
+            const auto& column = *(*batch)->column(col);
+            for (int64_t i = 0; i < count; i++) {
+                set_cell(data, row + static_cast<int>(i), col, column, first + i, max_cell_bytes);
+            }
+        }
+        row += static_cast<int>(count);
+    }
+    return data;
+}
+
+void clear_accelerated_cache(const char* file_path) {
+    std::lock_guard<std::mutex> lock(accelerated_mutex);
+    if (file_path) {
+        accelerated_files.erase(file_path);
+    } else {
+        accelerated_files.clear();
+    }
+}
+
+} // namespace parqview
+
+extern "C" {
+
+int set_accelerated_cache_directory(const char* directory, long long max_bytes) {
+    parqview::clear_accelerated_cache(nullptr);
+    return arrow_directory().configure(directory, max_bytes > 0 ? max_bytes : kDefaultMaxBytes) ? 1 : 0;
+}
+
+int accelerate_parquet_file(const char* file_path, int compress) {
+    try {
+        auto path = arrow_directory().entry_path(file_path);
+        std::string fingerprint = parqview::file_fingerprint(file_path);
+        if (path.empty() || fingerprint.empty()) {
+            return 0;
+        }
+
+        auto temp = arrow_directory().temp_path(path);
+        std::error_code error;
+        // A source rewritten during the transcode leaves a mixed copy
+        if (!write_copy(file_path, fingerprint, temp, compress != 0) ||
+            parqview::file_fingerprint(file_path) != fingerprint) {
+            fs::remove(temp, error);
+            return 0;
+        }
+        parqview::clear_accelerated_cache(file_path);
+        return arrow_directory().commit(temp, path) ? 1 : 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error accelerating " << file_path << ": " << e.what() << std::endl;
+        return 0;
+    }
+}
+
+int is_parquet_file_accelerated(const char* file_path) {
+    try {
+        return open_copy(file_path) ? 1 : 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error opening Arrow copy of " << file_path << ": " << e.what() << std::endl;
+        return 0;
+    }
+}
+
+void remove_accelerated_file(const char* file_path) {
+    parqview::clear_accelerated_cache(file_path);
+    auto path = arrow_directory().entry_path(file_path);
+    if (!path.empty()) {
+        arrow_directory().remove(path);
+    }
+}
+
+} // extern "C"
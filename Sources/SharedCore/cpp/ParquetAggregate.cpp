@@ -0,0 +1,1156 @@
+#include "../include/ParquetAggregate.h"
+#include "DistinctCounter.h"
+#include "ReaderInternal.h"
+#include "RowBitmap.h"
+#include <arrow/compute/api.h>
+#include <arrow/table.h>
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <type_traits>
+
+namespace {
+
+constexpr long long kDefaultMemoryLimit = 256LL << 20;
+constexpr int64_t kBatch = 65536;
+constexpr int kPartitionBits = 4;
+constexpr int kPartitions = 1 << kPartitionBits;
+constexpr uint32_t kNoGroup = UINT32_MAX;
+
+// MARK: - Columns
+
+// How a column's values are stored, compared and summed
+enum class ValueKind { Signed, Unsigned, Float, Boolean, Bytes, Fixed };
+
+struct ColumnLayout {
+    ValueKind kind = ValueKind::Fixed;
+    int width = 0;          // bytes per value, for every kind but Bytes
+    bool large = false;     // Bytes with 64-bit offsets
+    bool temporal = false;  // Signed values that are dates, times or durations
+};
+
+bool classify(const arrow::DataType& type, ColumnLayout* layout) {
+    switch (type.id()) {
+        case arrow::Type::INT8:
+        case arrow::Type::INT16:
+        case arrow::Type::INT32:
+        case arrow::Type::INT64:
+            layout->kind = ValueKind::Signed;
+            break;
+        case arrow::Type::DATE32:
+        case arrow::Type::DATE64:
+        case arrow::Type::TIMESTAMP:
+        case arrow::Type::TIME32:
+        case arrow::Type::TIME64:
+        case arrow::Type::DURATION:
+            layout->kind = ValueKind::Signed;
+            layout->temporal = true;
+            break;
+        case arrow::Type::UINT8:
+        case arrow::Type::UINT16:
+        case arrow::Type::UINT32:
+        case arrow::Type::UINT64:
+            layout->kind = ValueKind::Unsigned;
+            break;
+        case arrow::Type::FLOAT:
+        case arrow::Type::DOUBLE:
+            layout->kind = ValueKind::Float;
+            break;
+        case arrow::Type::BOOL:
+            layout->kind = ValueKind::Boolean;
+            layout->width = 1;
+            return true;
+        case arrow::Type::STRING:
+        case arrow::Type::BINARY:
+            layout->kind = ValueKind::Bytes;
+            return true;
+        case arrow::Type::LARGE_STRING:
+        case arrow::Type::LARGE_BINARY:
+            layout->kind = ValueKind::Bytes;
+            layout->large = true;
+            return true;
+        case arrow::Type::FIXED_SIZE_BINARY:
+        case arrow::Type::DECIMAL128:
+        case arrow::Type::DECIMAL256:
+            layout->kind = ValueKind::Fixed;
+            break;
+        default:
+            return false;
+    }
+    layout->width = static_cast<const arrow::FixedWidthType&>(type).bit_width() / 8;
+    return true;
+}
+
+// Dictionary columns group and aggregate by their values
+std::shared_ptr<arrow::DataType> value_type(const std::shared_ptr<arrow::DataType>& type) {
+    if (type->id() == arrow::Type::DICTIONARY) {
+        return static_cast<const arrow::DictionaryType&>(*type).value_type();
+    }
+    return type;
+}
+
+std::shared_ptr<arrow::Array> decode_dictionary(const std::shared_ptr<arrow::Array>& column) {
+    if (column->type_id() != arrow::Type::DICTIONARY) {
+        return column;
+    }
+    const auto& dictionary = static_cast<const arrow::DictionaryArray&>(*column);
+    auto decoded = arrow::compute::Take(*dictionary.dictionary(), *dictionary.indices());
+    if (!decoded.ok()) {
+        throw std::runtime_error(decoded.status().ToString());
+    }
+    return *decoded;
+}
+
+// Formats one value given as its raw bytes, by wrapping them in a one-row
+// array so the column's logical type formats exactly as in the table
+std::string value_label(const std::shared_ptr<arrow::DataType>& type, const ColumnLayout& layout,
+                        const void* data, size_t length) {
+    uint8_t bits = 0;
+    int64_t offsets[2] = {0, static_cast<int64_t>(length)};
+    int32_t narrow_offsets[2] = {0, static_cast<int32_t>(length)};
+    std::vector<std::shared_ptr<arrow::Buffer>> buffers{nullptr};
+    auto wrap = [](const void* bytes, size_t size) {
+        return std::make_shared<arrow::Buffer>(static_cast<const uint8_t*>(bytes), static_cast<int64_t>(size));
+    };
+    if (layout.kind == ValueKind::Boolean) {
+        bits = *static_cast<const uint8_t*>(data) ? 1 : 0;
+        buffers.push_back(wrap(&bits, 1));
+    } else if (layout.kind == ValueKind::Bytes) {
+        buffers.push_back(layout.large ? wrap(offsets, sizeof(offsets)) : wrap(narrow_offsets, sizeof(narrow_offsets)));
+        buffers.push_back(wrap(data, length));
+    } else {
+        buffers.push_back(wrap(data, length));
+    }
+
+    auto array = arrow::MakeArray(arrow::ArrayData::Make(type, 1, std::move(buffers), 0));
+    std::string text = parqview::format_value(*array, 0);
+    if (text == "UNSUPPORTED") {
+        auto scalar = array->GetScalar(0);
+        if (scalar.ok()) {
+            return (*scalar)->ToString();
+        }
+    }
+    return text;
+}
+
+std::string format_real(double value) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.15g", value);
+    return buffer;
+}
+
+// MARK: - Keys
+
+// A group key is the concatenation of its columns, each a presence byte
+// followed (when present) by the value: fixed-width values as raw bytes,
+// variable-length ones behind a 32-bit length
+struct KeyColumn {
+    const arrow::Array* array = nullptr;
+    ColumnLayout layout;
+    const uint8_t* values = nullptr;
+
+    KeyColumn(const arrow::Array& column, const ColumnLayout& column_layout) : array(&column), layout(column_layout) {
+        if (layout.kind != ValueKind::Bytes && layout.kind != ValueKind::Boolean) {
+            values = column.data()->buffers[1]->data() + column.offset() * layout.width;
+        }
+    }
+
+    template <typename View>
+    static void append_bytes(const View& view, std::string& key) {
+        uint32_t length = static_cast<uint32_t>(view.size());
+        key.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        key.append(view.data(), view.size());
+    }
+
+    void append(int64_t row, std::string& key) const {
+        if (array->IsNull(row)) {
+            key.push_back(0);
+            return;
+        }
+        key.push_back(1);
+        switch (layout.kind) {
+            case ValueKind::Boolean:
+                key.push_back(static_cast<const arrow::BooleanArray&>(*array).Value(row) ? 1 : 0);
+                break;
+            case ValueKind::Bytes:
+                if (layout.large) {
+                    append_bytes(static_cast<const arrow::LargeBinaryArray&>(*array).GetView(row), key);
+                } else {
+                    append_bytes(static_cast<const arrow::BinaryArray&>(*array).GetView(row), key);
+                }
+                break;
+            case ValueKind::Float: {
+                // -0.0 and 0.0 are the same group
+                if (layout.width == 4) {
+                    float value = reinterpret_cast<const float*>(values)[row];
+                    value = value == 0.0f ? 0.0f : value;
+                    key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+                } else {
+                    double value = reinterpret_cast<const double*>(values)[row];
+                    value = value == 0.0 ? 0.0 : value;
+                    key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+                }
+                break;
+            }
+            default:
+                key.append(reinterpret_cast<const char*>(values + row * layout.width), layout.width);
+        }
+    }
+};
+
+// Steps over one column of an encoded key, returning the position of the next
+const char* read_key_field(const ColumnLayout& layout, const char* position,
+                           const char** value, size_t* length) {
+    if (*position++ == 0) {
+        *value = nullptr;
+        *length = 0;
+        return position;
+    }
+    if (layout.kind == ValueKind::Bytes) {
+        uint32_t size;
+        std::memcpy(&size, position, sizeof(size));
+        position += sizeof(size);
+        *length = size;
+    } else {
+        *length = static_cast<size_t>(layout.width);
+    }
+    *value = position;
+    return position + *length;
+}
+
+template <typename T>
+int compare_as(const char* a, const char* b) {
+    T x;
+    T y;
+    std::memcpy(&x, a, sizeof(T));
+    std::memcpy(&y, b, sizeof(T));
+    return x < y ? -1 : (y < x ? 1 : 0);
+}
+
+int compare_values(const ColumnLayout& layout, const char* a, size_t a_length, const char* b, size_t b_length) {
+    switch (layout.kind) {
+        case ValueKind::Signed:
+            switch (layout.width) {
+                case 1: return compare_as<int8_t>(a, b);
+                case 2: return compare_as<int16_t>(a, b);
+                case 4: return compare_as<int32_t>(a, b);
+                default: return compare_as<int64_t>(a, b);
+            }
+        case ValueKind::Unsigned:
+            switch (layout.width) {
+                case 1: return compare_as<uint8_t>(a, b);
+                case 2: return compare_as<uint16_t>(a, b);
+                case 4: return compare_as<uint32_t>(a, b);
+                default: return compare_as<uint64_t>(a, b);
+            }
+        case ValueKind::Float:
+            return layout.width == 4 ? compare_as<float>(a, b) : compare_as<double>(a, b);
+        default: {
+            int order = std::memcmp(a, b, std::min(a_length, b_length));
+            if (order != 0) {
+                return order;
+            }
+            return a_length < b_length ? -1 : (a_length > b_length ? 1 : 0);
+        }
+    }
+}
+
+// Orders encoded keys column by column, NULLs last. Only column `only`
+// counts when it is not negative.
+int compare_keys(const std::vector<ColumnLayout>& layouts, const std::string& a, const std::string& b, int only) {
+    const char* x = a.data();
+    const char* y = b.data();
+    for (int i = 0; i < static_cast<int>(layouts.size()); i++) {
+        const char* x_value;
+        const char* y_value;
+        size_t x_length;
+        size_t y_length;
+        x = read_key_field(layouts[i], x, &x_value, &x_length);
+        y = read_key_field(layouts[i], y, &y_value, &y_length);
+        if (only >= 0 && i != only) {
+            continue;
+        }
+        int order = 0;
+        if (!x_value || !y_value) {
+            order = (x_value ? 0 : 1) - (y_value ? 0 : 1);
+        } else {
+            order = compare_values(layouts[i], x_value, x_length, y_value, y_length);
+        }
+        if (order != 0) {
+            return order;
+        }
+    }
+    return 0;
+}
+
+// MARK: - Aggregates
+
+// Running state of one aggregate in one group
+struct AggState {
+    int64_t count = 0;      // values folded in
+    int64_t integer = 0;    // sum, min or max of integer-like values (unsigned ones by bit pattern)
+    double real = 0;        // sum, min or max of floating point values
+};
+
+struct AggregatePlan {
+    AggregateFunction function = AGGREGATE_COUNT;
+    int field = -1;         // -1 for count(*)
+    int input = -1;         // position among the row group's read columns
+    ColumnLayout layout;
+    std::shared_ptr<arrow::DataType> type;
+};
+
+template <typename T>
+T current(const AggState& state) {
+    if constexpr (std::is_floating_point<T>::value) {
+        return static_cast<T>(state.real);
+    } else {
+        return static_cast<T>(state.integer);
+    }
+}
+
+template <typename T>
+void store(AggState& state, T value) {
+    if constexpr (std::is_floating_point<T>::value) {
+        state.real = value;
+    } else {
+        state.integer = static_cast<int64_t>(value);
+    }
+}
+
+void merge_state(const AggregatePlan& plan, AggState& into, const AggState& from) {
+    if (from.count == 0) {
+        return;
+    }
+    if (into.count == 0 || plan.function == AGGREGATE_COUNT) {
+        int64_t count = into.count + from.count;
+        into = from;
+        into.count = count;
+        return;
+    }
+
+    switch (plan.function) {
+        case AGGREGATE_SUM:
+        case AGGREGATE_AVG:
+            into.integer = static_cast<int64_t>(static_cast<uint64_t>(into.integer) + static_cast<uint64_t>(from.integer));
+            into.real += from.real;
+            break;
+        case AGGREGATE_MIN:
+        case AGGREGATE_MAX: {
+            const AggState& low = plan.function == AGGREGATE_MIN ? from : into;
+            const AggState& high = plan.function == AGGREGATE_MIN ? into : from;
+            bool replace;
+            if (plan.layout.kind == ValueKind::Float) {
+                replace = low.real < high.real;
+            } else if (plan.layout.kind == ValueKind::Unsigned) {
+                replace = static_cast<uint64_t>(low.integer) < static_cast<uint64_t>(high.integer);
+            } else {
+                replace = low.integer < high.integer;
+            }
+            if (replace) {
+                into.integer = from.integer;
+                into.real = from.real;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    into.count += from.count;
+}
+
+// Folds one batch column into the states of the groups its rows belong to.
+// The function is dispatched once per batch, leaving a tight loop per value.
+template <typename T>
+void accumulate(const AggregatePlan& plan, const arrow::Array& array, const T* values,
+                const uint32_t* groups, int64_t rows, std::vector<AggState>& states, size_t stride, size_t slot) {
+    bool has_nulls = array.null_count() > 0;
+    auto for_each = [&](auto&& update) {
+        for (int64_t i = 0; i < rows; i++) {
+            if (groups[i] == kNoGroup || (has_nulls && array.IsNull(i))) {
+                continue;
+            }
+            update(states[groups[i] * stride + slot], values[i]);
+        }
+    };
+
+    switch (plan.function) {
+        case AGGREGATE_SUM:
+        case AGGREGATE_AVG:
+            for_each([](AggState& state, T value) {
+                if constexpr (std::is_floating_point<T>::value) {
+                    state.real += value;
+                } else {
+                    state.integer = static_cast<int64_t>(static_cast<uint64_t>(state.integer) +
+                                                         static_cast<uint64_t>(static_cast<int64_t>(value)));
+                }
+                state.count++;
+            });
+            break;
+        case AGGREGATE_MIN:
+        case AGGREGATE_MAX: {
+            bool minimum = plan.function == AGGREGATE_MIN;
+            for_each([minimum](AggState& state, T value) {
+                if (value != value) {
+                    return;  // NaN has no place in an ordering
+                }
+                if (state.count == 0 || (minimum ? value < current<T>(state) : current<T>(state) < value)) {
+                    store(state, value);
+                }
+                state.count++;
+            });
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void accumulate(const AggregatePlan& plan, const arrow::Array& array, const uint32_t* groups, int64_t rows,
+                std::vector<AggState>& states, size_t stride, size_t slot, std::vector<uint8_t>& scratch) {
+    if (plan.function == AGGREGATE_COUNT) {
+        bool has_nulls = array.null_count() > 0;
+        for (int64_t i = 0; i < rows; i++) {
+            if (groups[i] != kNoGroup && !(has_nulls && array.IsNull(i))) {
+                states[groups[i] * stride + slot].count++;
+            }
+        }
+        return;
+    }
+
+    const uint8_t* values = plan.layout.kind == ValueKind::Boolean
+        ? nullptr
+        : array.data()->buffers[1]->data() + array.offset() * plan.layout.width;
+    switch (plan.layout.kind) {
+        case ValueKind::Boolean: {
+            const auto& booleans = static_cast<const arrow::BooleanArray&>(array);
+            scratch.resize(static_cast<size_t>(rows));
+            for (int64_t i = 0; i < rows; i++) {
+                scratch[i] = booleans.Value(i) ? 1 : 0;
+            }
+            return accumulate(plan, array, scratch.data(), groups, rows, states, stride, slot);
+        }
+        case ValueKind::Signed:
+            switch (plan.layout.width) {
+                case 1: return accumulate(plan, array, reinterpret_cast<const int8_t*>(values), groups, rows, states, stride, slot);
+                case 2: return accumulate(plan, array, reinterpret_cast<const int16_t*>(values), groups, rows, states, stride, slot);
+                case 4: return accumulate(plan, array, reinterpret_cast<const int32_t*>(values), groups, rows, states, stride, slot);
+                default: return accumulate(plan, array, reinterpret_cast<const int64_t*>(values), groups, rows, states, stride, slot);
+            }
+        case ValueKind::Unsigned:
+            switch (plan.layout.width) {
+                case 1: return accumulate(plan, array, reinterpret_cast<const uint8_t*>(values), groups, rows, states, stride, slot);
+                case 2: return accumulate(plan, array, reinterpret_cast<const uint16_t*>(values), groups, rows, states, stride, slot);
+                case 4: return accumulate(plan, array, reinterpret_cast<const uint32_t*>(values), groups, rows, states, stride, slot);
+                default: return accumulate(plan, array, reinterpret_cast<const uint64_t*>(values), groups, rows, states, stride, slot);
+            }
+        case ValueKind::Float:
+            if (plan.layout.width == 4) {
+                return accumulate(plan, array, reinterpret_cast<const float*>(values), groups, rows, states, stride, slot);
+            }
+            return accumulate(plan, array, reinterpret_cast<const double*>(values), groups, rows, states, stride, slot);
+        default:
+            break;
+    }
+}
+
+// MARK: - Group table
+
+// Open-addressing hash table from encoded key to group number. Slots hold
+// only a hash tag and the group, eight bytes each, so probing stays within
+// a cache line or two; keys live in one arena and states in one flat array.
+class GroupTable {
+public:
+    explicit GroupTable(size_t aggregate_count) : stride_(std::max<size_t>(aggregate_count, 1)) {
+        slots_.assign(1024, Slot{0, kNoGroup});
+        offsets_.push_back(0);
+    }
+
+    size_t size() const { return hashes_.size(); }
+    size_t stride() const { return stride_; }
+    uint64_t hash(uint32_t group) const { return hashes_[group]; }
+    std::string key(uint32_t group) const {
+        return arena_.substr(offsets_[group], offsets_[group + 1] - offsets_[group]);
+    }
+    const AggState* states(uint32_t group) const { return &states_[group * stride_]; }
+    std::vector<AggState>& states() { return states_; }
+
+    size_t memory_usage() const {
+        return arena_.capacity() + hashes_.capacity() * sizeof(uint64_t) + offsets_.capacity() * sizeof(uint64_t) +
+               states_.capacity() * sizeof(AggState) + slots_.capacity() * sizeof(Slot);
+    }
+
+    uint32_t find_or_insert(uint64_t hash, const char* key, size_t length) {
+        if ((hashes_.size() + 1) * 2 > slots_.size()) {
+            grow();
+        }
+        uint32_t tag = static_cast<uint32_t>(hash >> 32);
+        size_t mask = slots_.size() - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            Slot& slot = slots_[i];
+            if (slot.group == kNoGroup) {
+                slot = Slot{tag, static_cast<uint32_t>(hashes_.size())};
+                hashes_.push_back(hash);
+                arena_.append(key, length);
+                offsets_.push_back(arena_.size());
+                states_.resize(states_.size() + stride_);
+                return slot.group;
+            }
+            if (slot.tag == tag && offsets_[slot.group + 1] - offsets_[slot.group] == length &&
+                std::memcmp(arena_.data() + offsets_[slot.group], key, length) == 0) {
+                return slot.group;
+            }
+        }
+    }
+
+    // Folds one group of another table (or a spill record) into this one
+    void merge(uint64_t hash, const char* key, size_t length, const AggState* states,
+               const std::vector<AggregatePlan>& plans) {
+        uint32_t group = find_or_insert(hash, key, length);
+        for (size_t a = 0; a < plans.size(); a++) {
+            merge_state(plans[a], states_[group * stride_ + a], states[a]);
+        }
+    }
+
+    void clear() {
+        // Release the memory rather than keep the capacity: a cleared table
+        // is one that grew past its budget
+        std::string().swap(arena_);
+        std::vector<uint64_t>().swap(hashes_);
+        std::vector<uint64_t>{0}.swap(offsets_);
+        std::vector<AggState>().swap(states_);
+        std::vector<Slot>(1024, Slot{0, kNoGroup}).swap(slots_);
+    }
+
+private:
+    struct Slot {
+        uint32_t tag;
+        uint32_t group;
+    };
+
+    void grow() {
+        std::vector<Slot> slots(slots_.size() * 2, Slot{0, kNoGroup});
+        size_t mask = slots.size() - 1;
+        for (uint32_t group = 0; group < hashes_.size(); group++) {
+            size_t i = hashes_[group] & mask;
+            while (slots[i].group != kNoGroup) {
+                i = (i + 1) & mask;
+            }
+            slots[i] = Slot{static_cast<uint32_t>(hashes_[group] >> 32), group};
+        }
+        slots_.swap(slots);
+    }
+
+    size_t stride_;
+    std::string arena_;
+    std::vector<uint64_t> hashes_;
+    std::vector<uint64_t> offsets_;
+    std::vector<AggState> states_;
+    std::vector<Slot> slots_;
+};
+
+int partition_of(uint64_t hash) {
+    return static_cast<int>(hash >> (64 - kPartitionBits));
+}
+
+// MARK: - Spilling
+
+// Groups written out by one thread, one anonymous temporary file per hash
+// partition. A record is the hash, the key length and key, then the states.
+class SpillFiles {
+public:
+    SpillFiles() { files_.fill(nullptr); }
+    ~SpillFiles() {
+        for (auto* file : files_) {
+            if (file) {
+                std::fclose(file);
+            }
+        }
+    }
+    SpillFiles(const SpillFiles&) = delete;
+    SpillFiles& operator=(const SpillFiles&) = delete;
+
+    bool empty() const {
+        return std::all_of(files_.begin(), files_.end(), [](std::FILE* file) { return file == nullptr; });
+    }
+
+    bool write(const GroupTable& table) {
+        size_t state_bytes = table.stride() * sizeof(AggState);
+        for (uint32_t group = 0; group < table.size(); group++) {
+            uint64_t hash = table.hash(group);
+            std::FILE*& file = files_[partition_of(hash)];
+            if (!file && !(file = std::tmpfile())) {
+                return false;
+            }
+            std::string key = table.key(group);
+            uint32_t length = static_cast<uint32_t>(key.size());
+            if (std::fwrite(&hash, sizeof(hash), 1, file) != 1 ||
+                std::fwrite(&length, sizeof(length), 1, file) != 1 ||
+                std::fwrite(key.data(), 1, key.size(), file) != key.size() ||
+                std::fwrite(table.states(group), 1, state_bytes, file) != state_bytes) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Merges every record of one partition into table
+    bool read(int partition, GroupTable& table, const std::vector<AggregatePlan>& plans) {
+        std::FILE* file = files_[partition];
+        if (!file) {
+            return true;
+        }
+        if (std::fflush(file) != 0 || std::fseek(file, 0, SEEK_SET) != 0) {
+            return false;
+        }
+        std::string key;
+        std::vector<AggState> states(table.stride());
+        size_t state_bytes = states.size() * sizeof(AggState);
+        uint64_t hash;
+        while (std::fread(&hash, sizeof(hash), 1, file) == 1) {
+            uint32_t length;
+            if (std::fread(&length, sizeof(length), 1, file) != 1) {
+                return false;
+            }
+            key.resize(length);
+            if (std::fread(&key[0], 1, length, file) != length ||
+                std::fread(states.data(), 1, state_bytes, file) != state_bytes) {
+                return false;
+            }
+            table.merge(hash, key.data(), key.size(), states.data(), plans);
+        }
+        return std::ferror(file) == 0;
+    }
+
+private:
+    std::array<std::FILE*, kPartitions> files_;
+};
+
+// MARK: - Scan
+
+// One thread's share of the work: its own table, and its own spill files
+// once the table outgrows the thread's share of the memory limit
+struct Partial {
+    explicit Partial(size_t aggregate_count) : table(aggregate_count) {}
+
+    GroupTable table;
+    SpillFiles spill;
+    bool ok = true;
+    long long rows = 0;
+};
+
+struct ScanPlan {
+    std::vector<int> leaves;                // parquet columns read per row group
+    std::vector<int> key_inputs;            // position of each group column among them
+    std::vector<ColumnLayout> key_layouts;
+    std::vector<AggregatePlan> aggregates;
+    size_t memory_budget = 0;               // per thread
+};
+
+void consume(const ScanPlan& plan, const arrow::RecordBatch& batch, int64_t first_row,
+             const parqview::RowSelection& selection, Partial& partial,
+             std::vector<uint32_t>& groups, std::vector<uint8_t>& scratch) {
+    int64_t rows = batch.num_rows();
+    std::vector<std::shared_ptr<arrow::Array>> columns;
+    for (int i = 0; i < batch.num_columns(); i++) {
+        columns.push_back(decode_dictionary(batch.column(i)));
+    }
+    std::vector<KeyColumn> keys;
+    keys.reserve(plan.key_inputs.size());
+    for (size_t k = 0; k < plan.key_inputs.size(); k++) {
+        keys.emplace_back(*columns[plan.key_inputs[k]], plan.key_layouts[k]);
+    }
+
+    // Rows to groups first, then each aggregate over the whole batch
+    groups.resize(static_cast<size_t>(rows));
+    std::string key;
+    for (int64_t i = 0; i < rows; i++) {
+        if (!selection.contains(first_row + i)) {
+            groups[i] = kNoGroup;
+            continue;
+        }
+        key.clear();
+        for (const auto& column : keys) {
+            column.append(i, key);
+        }
+        groups[i] = partial.table.find_or_insert(parqview::hash_bytes(key.data(), key.size()), key.data(), key.size());
+        partial.rows++;
+    }
+
+    auto& states = partial.table.states();
+    size_t stride = partial.table.stride();
+    for (size_t a = 0; a < plan.aggregates.size(); a++) {
+        const auto& aggregate = plan.aggregates[a];
+        if (aggregate.input < 0) {
+            for (int64_t i = 0; i < rows; i++) {
+                if (groups[i] != kNoGroup) {
+                    states[groups[i] * stride + a].count++;
+                }
+            }
+            continue;
+        }
+        accumulate(aggregate, *columns[aggregate.input], groups.data(), rows, states, stride, a, scratch);
+    }
+}
+
+bool scan_row_group(const ScanPlan& plan, parquet::arrow::FileReader& reader, int rg,
+                    const parqview::RowSelection& selection, Partial& partial,
+                    std::vector<uint32_t>& groups, std::vector<uint8_t>& scratch) {
+    auto run = [&](const arrow::RecordBatch& batch, int64_t first_row) {
+        consume(plan, batch, first_row, selection, partial, groups, scratch);
+        if (partial.table.memory_usage() <= plan.memory_budget) {
+            return true;
+        }
+        if (!partial.spill.write(partial.table)) {
+            std::cerr << "Error spilling partial aggregates" << std::endl;
+            return false;
+        }
+        partial.table.clear();
+        return true;
+    };
+
+    // count(*) without keys reads no column at all
+    if (plan.leaves.empty()) {
+        int64_t rows = reader.parquet_reader()->metadata()->RowGroup(rg)->num_rows();
+        auto batch = arrow::RecordBatch::Make(arrow::schema({}), rows, std::vector<std::shared_ptr<arrow::Array>>{});
+        return run(*batch, 0);
+    }
+
+    std::shared_ptr<arrow::Table> table;
+    auto status = reader.ReadRowGroup(rg, plan.leaves, &table);
+    if (!status.ok()) {
+        std::cerr << "Error reading row group " << rg << ": " << status.ToString() << std::endl;
+        return false;
+    }
+    // Columns may be chunked differently; the batch reader lines them up
+    arrow::TableBatchReader batches(*table);
+    batches.set_chunksize(kBatch);
+    int64_t first_row = 0;
+    std::shared_ptr<arrow::RecordBatch> batch;
+    while (true) {
+        status = batches.ReadNext(&batch);
+        if (!status.ok()) {
+            std::cerr << "Error reading row group " << rg << ": " << status.ToString() << std::endl;
+            return false;
+        }
+        if (!batch) {
+            return true;
+        }
+        if (!run(*batch, first_row)) {
+            return false;
+        }
+        first_row += batch->num_rows();
+    }
+}
+
+// MARK: - Output
+
+struct OutputGroup {
+    std::string key;
+    std::vector<AggState> states;
+};
+
+// Orders finished groups: by the chosen result column, then by every key so
+// equal rows come out the same on every run
+struct OutputOrder {
+    const ScanPlan* plan;
+    int order_by;
+    bool descending;
+
+    int compare_aggregate(const AggregatePlan& aggregate, const AggState& a, const AggState& b) const {
+        if (aggregate.function == AGGREGATE_COUNT) {
+            return a.count < b.count ? -1 : (a.count > b.count ? 1 : 0);
+        }
+        if (a.count == 0 || b.count == 0) {
+            return 0;
+        }
+        if (aggregate.function == AGGREGATE_AVG) {
+            double x = aggregate.layout.kind == ValueKind::Float ? a.real / a.count : static_cast<double>(a.integer) / a.count;
+            double y = aggregate.layout.kind == ValueKind::Float ? b.real / b.count : static_cast<double>(b.integer) / b.count;
+            return x < y ? -1 : (x > y ? 1 : 0);
+        }
+        if (aggregate.layout.kind == ValueKind::Float) {
+            return a.real < b.real ? -1 : (a.real > b.real ? 1 : 0);
+        }
+        if (aggregate.layout.kind == ValueKind::Unsigned) {
+            auto x = static_cast<uint64_t>(a.integer);
+            auto y = static_cast<uint64_t>(b.integer);
+            return x < y ? -1 : (x > y ? 1 : 0);
+        }
+        return a.integer < b.integer ? -1 : (a.integer > b.integer ? 1 : 0);
+    }
+
+    bool operator()(const OutputGroup& a, const OutputGroup& b) const {
+        int key_count = static_cast<int>(plan->key_layouts.size());
+        int order = 0;
+        if (order_by >= key_count) {
+            const auto& aggregate = plan->aggregates[order_by - key_count];
+            const AggState& x = a.states[order_by - key_count];
+            const AggState& y = b.states[order_by - key_count];
+            // Empty aggregates (NULL) last either way
+            bool x_empty = aggregate.function != AGGREGATE_COUNT && x.count == 0;
+            bool y_empty = aggregate.function != AGGREGATE_COUNT && y.count == 0;
+            if (x_empty != y_empty) {
+                return y_empty;
+            }
+            order = compare_aggregate(aggregate, x, y);
+        } else if (order_by >= 0) {
+            order = compare_keys(plan->key_layouts, a.key, b.key, order_by);
+        }
+        if (descending) {
+            order = -order;
+        }
+        if (order == 0) {
+            order = compare_keys(plan->key_layouts, a.key, b.key, -1);
+        }
+        return order < 0;
+    }
+};
+
+// Moves a finished table's groups to the output, keeping only the best
+// limit of them when there is a limit
+void collect(GroupTable& table, const OutputOrder& order, int limit, std::vector<OutputGroup>& output) {
+    for (uint32_t group = 0; group < table.size(); group++) {
+        const AggState* states = table.states(group);
+        output.push_back(OutputGroup{table.key(group),
+                                     std::vector<AggState>(states, states + order.plan->aggregates.size())});
+    }
+    if (limit > 0 && output.size() > static_cast<size_t>(limit)) {
+        std::nth_element(output.begin(), output.begin() + limit, output.end(), order);
+        output.resize(static_cast<size_t>(limit));
+    }
+}
+
+std::string aggregate_label(const AggregatePlan& aggregate, const AggState& state) {
+    if (aggregate.function == AGGREGATE_COUNT) {
+        return std::to_string(state.count);
+    }
+    if (state.count == 0) {
+        return "NULL";
+    }
+    bool real = aggregate.layout.kind == ValueKind::Float;
+    switch (aggregate.function) {
+        case AGGREGATE_SUM:
+            if (real) {
+                return format_real(state.real);
+            }
+            if (aggregate.layout.kind == ValueKind::Unsigned) {
+                return std::to_string(static_cast<uint64_t>(state.integer));
+            }
+            return std::to_string(state.integer);
+        case AGGREGATE_AVG:
+            if (real) {
+                return format_real(state.real / state.count);
+            }
+            if (aggregate.layout.kind == ValueKind::Unsigned) {
+                return format_real(static_cast<double>(static_cast<uint64_t>(state.integer)) / state.count);
+            }
+            return format_real(static_cast<double>(state.integer) / state.count);
+        default: {
+            // Integer-like values sit in the low bytes of integer (little endian)
+            if (real && aggregate.layout.width == 4) {
+                float value = static_cast<float>(state.real);
+                return value_label(aggregate.type, aggregate.layout, &value, sizeof(value));
+            }
+            const void* data = real ? static_cast<const void*>(&state.real) : static_cast<const void*>(&state.integer);
+            return value_label(aggregate.type, aggregate.layout, data, static_cast<size_t>(aggregate.layout.width));
+        }
+    }
+}
+
+const char* function_name(AggregateFunction function) {
+    switch (function) {
+        case AGGREGATE_COUNT: return "count";
+        case AGGREGATE_SUM: return "sum";
+        case AGGREGATE_MIN: return "min";
+        case AGGREGATE_MAX: return "max";
+        case AGGREGATE_AVG: return "avg";
+    }
+    return "?";
+}
+
+std::string aggregate_type(const AggregatePlan& aggregate) {
+    switch (aggregate.function) {
+        case AGGREGATE_COUNT:
+            return "int64";
+        case AGGREGATE_SUM:
+            if (aggregate.layout.kind == ValueKind::Float) {
+                return "double";
+            }
+            return aggregate.layout.kind == ValueKind::Unsigned ? "uint64" : "int64";
+        case AGGREGATE_AVG:
+            return "double";
+        default:
+            return aggregate.type->ToString();
+    }
+}
+
+// Checks that a function fits its column's type
+bool accepts(AggregateFunction function, const ColumnLayout& layout) {
+    switch (function) {
+        case AGGREGATE_COUNT:
+            return true;
+        case AGGREGATE_SUM:
+        case AGGREGATE_AVG:
+            return !layout.temporal && (layout.kind == ValueKind::Signed || layout.kind == ValueKind::Unsigned ||
+                                        layout.kind == ValueKind::Float || layout.kind == ValueKind::Boolean);
+        case AGGREGATE_MIN:
+        case AGGREGATE_MAX:
+            return layout.kind == ValueKind::Signed || layout.kind == ValueKind::Unsigned ||
+                   layout.kind == ValueKind::Float || layout.kind == ValueKind::Boolean;
+    }
+    return false;
+}
+
+} // namespace
+
+extern "C" {
+
+AggregateResult* read_parquet_aggregate(const char* file_path, const AggregateRequest* request) {
+    if (!request) {
+        return nullptr;
+    }
+
+    try {
+        auto reader_ptr = get_cached_reader(file_path);
+        if (!reader_ptr || !(*reader_ptr)) {
+            return nullptr;
+        }
+        auto& reader = *reader_ptr;
+        auto metadata = reader->parquet_reader()->metadata();
+        const auto& manifest = reader->manifest();
+        int field_count = static_cast<int>(manifest.schema_fields.size());
+        int num_row_groups = metadata->num_row_groups();
+
+        // Only flat columns: one leaf per field, one value per row
+        auto flat_field = [&](int field) {
+            if (field < 0 || field >= field_count) {
+                return false;
+            }
+            const auto& schema_field = manifest.schema_fields[field];
+            return schema_field.is_leaf() &&
+                   manifest.descr->Column(schema_field.column_index)->max_repetition_level() == 0;
+        };
+
+        ScanPlan plan;
+        std::vector<int> group_fields;
+        std::vector<int> read_fields;
+        for (int k = 0; k < request->group_count; k++) {
+            int field = request->group_columns[k];
+            ColumnLayout layout;
+            if (!flat_field(field) || !classify(*value_type(manifest.schema_fields[field].field->type()), &layout)) {
+                std::cerr << "Cannot group by column " << field << std::endl;
+                return nullptr;
+            }
+            group_fields.push_back(field);
+            plan.key_layouts.push_back(layout);
+            read_fields.push_back(field);
+        }
+        for (int a = 0; a < request->aggregate_count; a++) {
+            const auto& spec = request->aggregates[a];
+            AggregatePlan aggregate;
+            aggregate.function = spec.function;
+            aggregate.field = spec.column_index;
+            if (spec.column_index < 0 && spec.function == AGGREGATE_COUNT) {
+                plan.aggregates.push_back(aggregate);
+                continue;
+            }
+            if (!flat_field(spec.column_index)) {
+                std::cerr << "Cannot aggregate column " << spec.column_index << std::endl;
+                return nullptr;
+            }
+            aggregate.type = value_type(manifest.schema_fields[spec.column_index].field->type());
+            bool known = classify(*aggregate.type, &aggregate.layout);
+            if (!(known || spec.function == AGGREGATE_COUNT) || !accepts(spec.function, aggregate.layout)) {
+                std::cerr << function_name(spec.function) << " does not apply to column " << spec.column_index
+                          << " of type " << aggregate.type->ToString() << std::endl;
+                return nullptr;
+            }
+            plan.aggregates.push_back(aggregate);
+            read_fields.push_back(spec.column_index);
+        }
+        int key_count = static_cast<int>(group_fields.size());
+        int column_count = key_count + static_cast<int>(plan.aggregates.size());
+        if (request->order_by < -1 || request->order_by >= column_count) {
+            std::cerr << "Order column " << request->order_by << " out of range" << std::endl;
+            return nullptr;
+        }
+
+        // Each field is read once; flat fields come back in leaf order
+        std::sort(read_fields.begin(), read_fields.end());
+        read_fields.erase(std::unique(read_fields.begin(), read_fields.end()), read_fields.end());
+        std::map<int, int> input_of;
+        for (int field : read_fields) {
+            input_of[field] = static_cast<int>(plan.leaves.size());
+            plan.leaves.push_back(manifest.schema_fields[field].column_index);
+        }
+        for (int field : group_fields) {
+            plan.key_inputs.push_back(input_of[field]);
+        }
+        for (auto& aggregate : plan.aggregates) {
+            aggregate.input = aggregate.field < 0 ? -1 : input_of[aggregate.field];
+        }
+
+        std::vector<parqview::RowSelection> selections(num_row_groups);
+        long long input_rows = metadata->num_rows();
+        if (request->predicate_count > 0) {
+            auto bitmap = parqview::match_predicates(file_path, *reader, request->predicates,
+                                                     request->predicate_count, nullptr);
+            if (!bitmap) {
+                return nullptr;
+            }
+            input_rows = static_cast<long long>(bitmap->cardinality());
+            selections = parqview::select_row_groups(*bitmap, *metadata);
+        }
+
+        // One partial table per thread, each pulling row groups as it goes
+        int workers = std::max(1, std::min<int>(num_row_groups, std::max(1u, std::thread::hardware_concurrency())));
+        long long memory_limit = request->memory_limit > 0 ? request->memory_limit : kDefaultMemoryLimit;
+        plan.memory_budget = static_cast<size_t>(memory_limit / workers);
+        std::vector<std::unique_ptr<Partial>> partials;
+        for (int w = 0; w < workers; w++) {
+            partials.push_back(std::make_unique<Partial>(plan.aggregates.size()));
+        }
+
+        std::atomic<int> next_row_group{0};
+        parqview::parallel_for(workers, [&](int w) {
+            Partial& partial = *partials[w];
+            try {
+                parquet::ArrowReaderProperties props;
+                props.set_use_threads(false);  // Row groups are already spread across threads
+                props.set_batch_size(kBatch);
+                auto worker_reader = parqview::open_reader(file_path, metadata, props);
+                if (!worker_reader) {
+                    partial.ok = false;
+                    return;
+                }
+                std::vector<uint32_t> groups;
+                std::vector<uint8_t> scratch;
+                for (int rg = next_row_group++; rg < num_row_groups && partial.ok; rg = next_row_group++) {
+                    if (selections[rg].empty()) {
+                        continue;
+                    }
+                    partial.ok = scan_row_group(plan, *worker_reader, rg, selections[rg], partial, groups, scratch);
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "Error aggregating: " << e.what() << std::endl;
+                partial.ok = false;
+            }
+        });
+
+        bool spilled = false;
+        for (const auto& partial : partials) {
+            if (!partial->ok) {
+                return nullptr;
+            }
+            spilled = spilled || !partial->spill.empty();
+        }
+
+        OutputOrder order{&plan, request->order_by, request->descending != 0};
+        std::vector<OutputGroup> output;
+        long long group_count = 0;
+        auto merge_into = [&](GroupTable& into, const GroupTable& from, int partition) {
+            for (uint32_t group = 0; group < from.size(); group++) {
+                if (partition < 0 || partition_of(from.hash(group)) == partition) {
+                    std::string key = from.key(group);
+                    into.merge(from.hash(group), key.data(), key.size(), from.states(group), plan.aggregates);
+                }
+            }
+        };
+
+        if (!spilled) {
+            // Fold every partial into the largest
+            auto largest = std::max_element(partials.begin(), partials.end(), [](const auto& a, const auto& b) {
+                return a->table.size() < b->table.size();
+            });
+            std::swap(*largest, partials.front());
+            for (size_t w = 1; w < partials.size(); w++) {
+                merge_into(partials[0]->table, partials[w]->table, -1);
+                partials[w]->table.clear();
+            }
+            group_count = static_cast<long long>(partials[0]->table.size());
+            collect(partials[0]->table, order, request->limit, output);
+        } else {
+            // Hash partitions are disjoint, so each is merged and finished on
+            // its own and only one is ever held whole in memory
+            for (int partition = 0; partition < kPartitions; partition++) {
+                GroupTable merged(plan.aggregates.size());
+                for (const auto& partial : partials) {
+                    if (!partial->spill.read(partition, merged, plan.aggregates)) {
+                        std::cerr << "Error reading spilled aggregates" << std::endl;
+                        return nullptr;
+                    }
+                    merge_into(merged, partial->table, partition);
+                }
+                group_count += static_cast<long long>(merged.size());
+                collect(merged, order, request->limit, output);
+            }
+        }
+
+        // A query without keys always has its one row, even over no rows
+        if (key_count == 0 && output.empty()) {
+            output.push_back(OutputGroup{std::string(), std::vector<AggState>(plan.aggregates.size())});
+            group_count = 1;
+        }
+        std::sort(output.begin(), output.end(), order);
+
+        auto* result = new AggregateResult;
+        result->group_count = group_count;
+        result->input_rows = input_rows;
+        result->spilled = spilled ? 1 : 0;
+        result->column_count = column_count;
+        result->columns = new ColumnInfo[column_count];
+        for (int k = 0; k < key_count; k++) {
+            const auto& field = manifest.schema_fields[group_fields[k]].field;
+            result->columns[k].name = strdup(field->name().c_str());
+            result->columns[k].type = strdup(value_type(field->type())->ToString().c_str());
+        }
+        for (size_t a = 0; a < plan.aggregates.size(); a++) {
+            const auto& aggregate = plan.aggregates[a];
+            std::string argument = aggregate.field < 0 ? "*" : manifest.schema_fields[aggregate.field].field->name();
+            std::string name = std::string(function_name(aggregate.function)) + "(" + argument + ")";
+            result->columns[key_count + a].name = strdup(name.c_str());
+            result->columns[key_count + a].type = strdup(aggregate_type(aggregate).c_str());
+        }
+
+        result->rows = parqview::allocate_table_data(static_cast<int>(output.size()), column_count);
+        for (size_t row = 0; row < output.size(); row++) {
+            const char* position = output[row].key.data();
+            for (int k = 0; k < key_count; k++) {
+                const char* value;
+                size_t length;
+                position = read_key_field(plan.key_layouts[k], position, &value, &length);
+                std::string text = value ? value_label(value_type(manifest.schema_fields[group_fields[k]].field->type()),
+                                                       plan.key_layouts[k], value, length)
+                                         : "NULL";
+                result->rows->data[row][k] = strdup(text.c_str());
+            }
+            for (size_t a = 0; a < plan.aggregates.size(); a++) {
+                result->rows->data[row][key_count + a] =
+                    strdup(aggregate_label(plan.aggregates[a], output[row].states[a]).c_str());
+            }
+        }
+        return result;
+    } catch (const std::exception& e) {
+        std::cerr << "Error aggregating: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+void free_aggregate_result(AggregateResult* result) {
+    if (result) {
+        for (int i = 0; i < result->column_count; i++) {
+            free(result->columns[i].name);
+            free(result->columns[i].type);
+        }
+        delete[] result->columns;
+        free_table_data(result->rows);
+        delete result;
+    }
+}
+
+} // extern "C"
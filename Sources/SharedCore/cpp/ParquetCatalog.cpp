@@ -0,0 +1,296 @@
+#include "../include/ParquetCatalog.h"
+#include "ReaderInternal.h"
+#include <fcntl.h>
+#include <glob.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <unordered_map>
+
+namespace {
+
+// Bytes read from the end of a file before the footer length is known.
+// Footers of files up to a few hundred columns fit, so one read usually
+// suffices.
+constexpr int64_t kFooterReadSize = 64 * 1024;
+
+// Footer length (4 bytes, little endian) and "PAR1"
+constexpr int64_t kFooterTrailerSize = 8;
+
+class FileDescriptor {
+public:
+    explicit FileDescriptor(int fd) : fd_(fd) {}
+    ~FileDescriptor() {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+    int get() const { return fd_; }
+
+private:
+    int fd_;
+};
+
+// pread until length bytes arrive, retrying short and interrupted reads
+bool read_exactly(int fd, uint8_t* buffer, int64_t length, int64_t offset) {
+    while (length > 0) {
+        ssize_t count = pread(fd, buffer, static_cast<size_t>(length), static_cast<off_t>(offset));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        buffer += count;
+        length -= count;
+        offset += count;
+    }
+    return true;
+}
+
+bool is_hidden(const std::string& name) {
+    return name.empty() || name[0] == '.' || name[0] == '_';
+}
+
+std::string leaf_type(const parquet::ColumnDescriptor& descr) {
+    const auto& logical = descr.logical_type();
+    if (logical && !logical->is_none()) {
+        return logical->ToString();
+    }
+    return parquet::TypeToString(descr.physical_type());
+}
+
+// "name: type" per leaf, so files with the same columns share a schema
+std::string schema_summary(const parquet::SchemaDescriptor& schema) {
+    std::string summary;
+    for (int i = 0; i < schema.num_columns(); i++) {
+        const auto* descr = schema.Column(i);
+        if (i > 0) {
+            summary += ", ";
+        }
+        summary += descr->path()->ToDotString();
+        summary += ": ";
+        summary += leaf_type(*descr);
+    }
+    return summary;
+}
+
+struct FileSummary {
+    int64_t size = 0;
+    int64_t rows = 0;
+    int row_groups = 0;
+    int columns = 0;
+    std::string created_by;
+    std::string schema;
+    std::string error;
+    bool readable = false;
+};
+
+} // namespace
+
+namespace parqview {
+
+std::vector<std::string> list_dataset_files(const std::string& pattern, std::string* root) {
+    namespace fs = std::filesystem;
+    std::vector<std::string> paths;
+
+    if (pattern.find_first_of("*?[") != std::string::npos) {
+        // Partition directories are read relative to the last directory
+        // before the first wildcard
+        size_t wildcard = pattern.find_first_of("*?[");
+        size_t slash = pattern.rfind('/', wildcard);
+        *root = slash == std::string::npos ? "" : pattern.substr(0, slash);
+
+        glob_t matches;
+        if (glob(pattern.c_str(), 0, nullptr, &matches) == 0) {
+            for (size_t i = 0; i < matches.gl_pathc; i++) {
+                std::error_code error;
+                if (fs::is_regular_file(matches.gl_pathv[i], error)) {
+                    paths.emplace_back(matches.gl_pathv[i]);
+                }
+            }
+        }
+        globfree(&matches);
+    } else if (fs::is_directory(pattern)) {
+        *root = pattern;
+        std::error_code error;
+        for (auto it = fs::recursive_directory_iterator(pattern, fs::directory_options::skip_permission_denied, error);
+             it != fs::recursive_directory_iterator(); it.increment(error)) {
+            if (error) {
+                break;
+            }
+            if (is_hidden(it->path().filename().string())) {
+                if (it->is_directory()) {
+                    it.disable_recursion_pending();
+                }
+                continue;
+            }
+            if (it->is_regular_file()) {
+                paths.push_back(it->path().string());
+            }
+        }
+    } else if (std::error_code error; fs::is_regular_file(pattern, error)) {
+        *root = fs::path(pattern).parent_path().string();
+        paths.push_back(pattern);
+    }
+
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+std::shared_ptr<parquet::FileMetaData> read_footer(const std::string& path, int64_t* file_size, std::string* error) {
+    FileDescriptor file(open(path.c_str(), O_RDONLY));
+    struct stat info;
+    if (file.get() < 0 || fstat(file.get(), &info) != 0) {
+        *error = std::strerror(errno);
+        return nullptr;
+    }
+    int64_t size = info.st_size;
+    *file_size = size;
+    if (size < kFooterTrailerSize + 4) {
+        *error = "too small to be a Parquet file";
+        return nullptr;
+    }
+
+    int64_t tail_size = std::min(size, kFooterReadSize);
+    std::vector<uint8_t> tail(static_cast<size_t>(tail_size));
+    if (!read_exactly(file.get(), tail.data(), tail_size, size - tail_size)) {
+        *error = std::strerror(errno);
+        return nullptr;
+    }
+    const uint8_t* trailer = tail.data() + tail_size - kFooterTrailerSize;
+    if (std::memcmp(trailer + 4, "PARE", 4) == 0) {
+        *error = "encrypted footers are not supported";
+        return nullptr;
+    }
+    if (std::memcmp(trailer + 4, "PAR1", 4) != 0) {
+        *error = "not a Parquet file";
+        return nullptr;
+    }
+    uint32_t footer_size = static_cast<uint32_t>(trailer[0]) | static_cast<uint32_t>(trailer[1]) << 8 |
+                           static_cast<uint32_t>(trailer[2]) << 16 | static_cast<uint32_t>(trailer[3]) << 24;
+    if (static_cast<int64_t>(footer_size) + kFooterTrailerSize + 4 > size) {
+        *error = "footer length exceeds the file size";
+        return nullptr;
+    }
+
+    const uint8_t* footer = trailer - footer_size;
+    std::vector<uint8_t> exact;
+    if (static_cast<int64_t>(footer_size) + kFooterTrailerSize > tail_size) {
+        exact.resize(footer_size);
+        if (!read_exactly(file.get(), exact.data(), footer_size, size - kFooterTrailerSize - footer_size)) {
+            *error = std::strerror(errno);
+            return nullptr;
+        }
+        footer = exact.data();
+    }
+
+    uint32_t parsed = footer_size;
+    try {
+        return parquet::FileMetaData::Make(footer, &parsed);
+    } catch (const std::exception& e) {
+        *error = e.what();
+        return nullptr;
+    }
+}
+
+} // namespace parqview
+
+extern "C" {
+
+CatalogResult* read_parquet_catalog(const char* path, int max_concurrent_reads) {
+    try {
+        std::string root;
+        auto paths = parqview::list_dataset_files(path, &root);
+        if (paths.empty()) {
+            return nullptr;
+        }
+        if (max_concurrent_reads <= 0) {
+            max_concurrent_reads = parqview::kMaxConcurrentFooterReads;
+        }
+
+        std::vector<FileSummary> summaries(paths.size());
+        parqview::parallel_for(static_cast<int>(paths.size()), max_concurrent_reads, [&](int i) {
+            auto& summary = summaries[i];
+            try {
+                auto metadata = parqview::read_footer(paths[i], &summary.size, &summary.error);
+                if (!metadata) {
+                    return;
+                }
+                summary.rows = metadata->num_rows();
+                summary.row_groups = metadata->num_row_groups();
+                summary.columns = metadata->num_columns();
+                summary.created_by = metadata->created_by();
+                summary.schema = schema_summary(*metadata->schema());
+                summary.readable = true;
+            } catch (const std::exception& e) {
+                summary.error = e.what();
+            }
+        });
+
+        auto* result = new CatalogResult();
+        result->file_count = static_cast<int>(paths.size());
+        result->files = new CatalogFile[paths.size()];
+
+        std::unordered_map<std::string, int> schema_indices;
+        std::vector<const std::string*> schemas;
+        for (size_t i = 0; i < paths.size(); i++) {
+            const auto& summary = summaries[i];
+            auto& file = result->files[i];
+            file.file_path = strdup(paths[i].c_str());
+            file.file_size = summary.size;
+            file.row_count = summary.rows;
+            file.row_group_count = summary.row_groups;
+            file.column_count = summary.columns;
+            file.schema_index = -1;
+            file.created_by = summary.created_by.empty() ? nullptr : strdup(summary.created_by.c_str());
+            file.error = summary.readable ? nullptr : strdup(summary.error.c_str());
+            result->total_bytes += summary.size;
+            if (!summary.readable) {
+                result->unreadable_count++;
+                continue;
+            }
+            result->total_rows += summary.rows;
+            auto inserted = schema_indices.emplace(summary.schema, static_cast<int>(schemas.size()));
+            if (inserted.second) {
+                schemas.push_back(&inserted.first->first);
+            }
+            file.schema_index = inserted.first->second;
+        }
+
+        result->schema_count = static_cast<int>(schemas.size());
+        result->schemas = new char*[schemas.size()];
+        for (size_t i = 0; i < schemas.size(); i++) {
+            result->schemas[i] = strdup(schemas[i]->c_str());
+        }
+        return result;
+    } catch (const std::exception& e) {
+        std::cerr << "Error reading catalog: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+void free_catalog_result(CatalogResult* result) {
+    if (result) {
+        for (int i = 0; i < result->file_count; i++) {
+            free(result->files[i].file_path);
+            free(result->files[i].created_by);
+            free(result->files[i].error);
+        }
+        delete[] result->files;
+        for (int i = 0; i < result->schema_count; i++) {
+            free(result->schemas[i]);
+        }
+        delete[] result->schemas;
+        delete result;
+    }
+}
+
+} // extern "C"
@@ -0,0 +1,543 @@
+#include "../include/ParquetDataset.h"
+#include "ReaderInternal.h"
+#include <parquet/arrow/schema.h>
+#include <parquet/file_reader.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+const char* const kHiveNull = "__HIVE_DEFAULT_PARTITION__";
+
+struct DatasetFile {
+    std::string path;
+    int64_t size = 0;
+    std::shared_ptr<parquet::FileMetaData> metadata;
+    std::vector<int64_t> row_group_offsets;   // first row of each row group, then the row count
+    std::vector<int> fields;                  // file field behind each dataset column, -1 when missing
+    std::vector<std::string> partition_values;
+    std::vector<bool> partition_nulls;        // value absent, or the hive null marker
+};
+
+struct PartitionColumn {
+    std::string name;
+    bool integer = true;
+};
+
+struct Dataset {
+    std::vector<DatasetFile> files;           // in path order
+    std::vector<std::string> names;           // file columns, unified by name
+    std::vector<std::string> types;
+    std::vector<PartitionColumn> partitions;
+
+    int column_count() const { return static_cast<int>(names.size() + partitions.size()); }
+};
+
+// The files left after pruning, with a prefix sum of their row counts so a
+// dataset row resolves to its file by binary search
+struct DatasetView {
+    std::vector<int> files;
+    std::vector<int64_t> offsets;             // first row of each file, then the row count
+
+    int file_of(int64_t row) const {
+        return static_cast<int>(std::upper_bound(offsets.begin(), offsets.end(), row) - offsets.begin()) - 1;
+    }
+};
+
+// An opened dataset and the listing it was opened from
+struct CachedDataset {
+    std::string listing;
+    std::shared_ptr<const Dataset> dataset;
+};
+
+std::mutex dataset_mutex;
+std::unordered_map<std::string, CachedDataset> dataset_cache;
+
+// MARK: - Partitions
+
+// Hive escapes special characters in partition values as %XX
+std::string unescape(const std::string& value) {
+    std::string result;
+    for (size_t i = 0; i < value.size(); i++) {
+        if (value[i] == '%' && i + 2 < value.size() && std::isxdigit(static_cast<unsigned char>(value[i + 1])) &&
+            std::isxdigit(static_cast<unsigned char>(value[i + 2]))) {
+            result.push_back(static_cast<char>(std::stoi(value.substr(i + 1, 2), nullptr, 16)));
+            i += 2;
+        } else {
+            result.push_back(value[i]);
+        }
+    }
+    return result;
+}
+
+// key=value directories between the root and the file
+std::vector<std::pair<std::string, std::string>> partition_pairs(const std::string& root, const std::string& path) {
+    namespace fs = std::filesystem;
+    std::vector<std::pair<std::string, std::string>> pairs;
+    auto relative = root.empty() ? fs::path(path) : fs::path(path).lexically_relative(root);
+    for (const auto& part : relative.parent_path()) {
+        std::string component = part.string();
+        size_t equals = component.find('=');
+        if (equals != std::string::npos && equals > 0) {
+            pairs.emplace_back(unescape(component.substr(0, equals)), unescape(component.substr(equals + 1)));
+        }
+    }
+    return pairs;
+}
+
+bool is_integer(const std::string& text) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    std::strtoll(text.c_str(), &end, 10);
+    return errno == 0 && *end == '\0';
+}
+
+// MARK: - Opening
+
+// Identifies a listing's current contents: the fingerprint of each file,
+// in path order, so an added, removed or rewritten file changes it
+std::string listing_fingerprint(const std::vector<std::string>& paths) {
+    std::string listing;
+    for (const auto& path : paths) {
+        listing += parqview::file_fingerprint(path.c_str());
+        listing += '\n';
+    }
+    return listing;
+}
+
+std::shared_ptr<const Dataset> open_dataset(const std::vector<std::string>& paths, const std::string& root) {
+
+    // Footers and Arrow columns, from sidecars where the footer cache has
+    // them and otherwise read in parallel
+    std::vector<DatasetFile> files(paths.size());
+    std::vector<std::vector<std::pair<std::string, std::string>>> columns(paths.size());
+    parqview::parallel_for(static_cast<int>(paths.size()), parqview::kMaxConcurrentFooterReads, [&](int i) {
+        try {
+            const char* path = paths[i].c_str();
+            std::string fingerprint = parqview::file_fingerprint(path);
+            parqview::FooterSidecar sidecar;
+            std::shared_ptr<parquet::FileMetaData> metadata;
+            if (parqview::load_footer_sidecar(path, fingerprint, true, &sidecar)) {
+                metadata = parqview::sidecar_metadata(sidecar);
+            }
+
+            int64_t size = 0;
+            if (metadata) {
+                std::error_code error;
+                size = static_cast<int64_t>(std::filesystem::file_size(paths[i], error));
+            } else {
+                std::string error;
+                metadata = parqview::read_footer(paths[i], &size, &error);
+                std::shared_ptr<arrow::Schema> schema;
+                if (!metadata || !parquet::arrow::FromParquetSchema(metadata->schema(), parquet::ArrowReaderProperties(),
+                                                                    metadata->key_value_metadata(), &schema).ok()) {
+                    return;
+                }
+                sidecar.columns.clear();
+                for (const auto& field : schema->fields()) {
+                    sidecar.columns.emplace_back(field->name(), field->type()->ToString());
+                }
+                sidecar.row_group_offsets = parqview::row_group_offsets(*metadata);
+                parqview::store_footer_sidecar(path, fingerprint, *metadata, *schema);
+            }
+            files[i].path = paths[i];
+            files[i].size = size;
+            files[i].metadata = metadata;
+            files[i].row_group_offsets = std::move(sidecar.row_group_offsets);
+            columns[i] = std::move(sidecar.columns);
+        } catch (const std::exception& e) {
+            std::cerr << "Skipping " << paths[i] << ": " << e.what() << std::endl;
+        }
+    });
+
+    auto dataset = std::make_shared<Dataset>();
+    std::unordered_map<std::string, int> column_of;
+    std::unordered_map<std::string, int> partition_of;
+    for (size_t i = 0; i < files.size(); i++) {
+        if (!files[i].metadata) {
+            continue;
+        }
+        DatasetFile& file = files[i];
+
+        // Columns are unified by name; a name whose type differs between
+        // files is shown as text, which every value formats to anyway
+        for (const auto& column : columns[i]) {
+            const std::string& type = column.second;
+            auto it = column_of.find(column.first);
+            if (it == column_of.end()) {
+                column_of[column.first] = static_cast<int>(dataset->names.size());
+                dataset->names.push_back(column.first);
+                dataset->types.push_back(type);
+            } else if (dataset->types[it->second] != type) {
+                dataset->types[it->second] = "string";
+            }
+        }
+
+        for (const auto& pair : partition_pairs(root, file.path)) {
+            auto it = partition_of.find(pair.first);
+            int index;
+            if (it == partition_of.end()) {
+                index = static_cast<int>(dataset->partitions.size());
+                partition_of[pair.first] = index;
+                dataset->partitions.push_back(PartitionColumn{pair.first, true});
+            } else {
+                index = it->second;
+            }
+            file.partition_values.resize(dataset->partitions.size());
+            file.partition_nulls.resize(dataset->partitions.size(), true);
+            bool null = pair.second == kHiveNull;
+            file.partition_values[index] = pair.second;
+            file.partition_nulls[index] = null;
+            if (!null && !is_integer(pair.second)) {
+                dataset->partitions[index].integer = false;
+            }
+        }
+        // Compacts columns alongside files; a self-move would empty them
+        size_t kept = dataset->files.size();
+        dataset->files.push_back(std::move(file));
+        if (kept != i) {
+            columns[kept] = std::move(columns[i]);
+        }
+    }
+    if (dataset->files.empty()) {
+        return nullptr;
+    }
+
+    for (size_t i = 0; i < dataset->files.size(); i++) {
+        auto& file = dataset->files[i];
+        file.fields.assign(dataset->names.size(), -1);
+        for (size_t f = 0; f < columns[i].size(); f++) {
+            file.fields[column_of[columns[i][f].first]] = static_cast<int>(f);
+        }
+        file.partition_values.resize(dataset->partitions.size());
+        file.partition_nulls.resize(dataset->partitions.size(), true);
+    }
+    return dataset;
+}
+
+// The cached dataset while its listing is unchanged, and otherwise a fresh
+// one. Listing and stat'ing the files is far cheaper than their footers.
+std::shared_ptr<const Dataset> get_dataset(const char* dataset_path) {
+    std::string key(dataset_path);
+    std::string root;
+    auto paths = parqview::list_dataset_files(key, &root);
+    if (paths.empty()) {
+        return nullptr;
+    }
+    std::string listing = listing_fingerprint(paths);
+    {
+        std::lock_guard<std::mutex> lock(dataset_mutex);
+        auto it = dataset_cache.find(key);
+        if (it != dataset_cache.end() && it->second.listing == listing) {
+            return it->second.dataset;
+        }
+    }
+
+    // Opened outside the lock: footers can take a while
+    auto dataset = open_dataset(paths, root);
+    if (dataset) {
+        std::lock_guard<std::mutex> lock(dataset_mutex);
+        dataset_cache[key] = CachedDataset{std::move(listing), dataset};
+    }
+    return dataset;
+}
+
+// MARK: - Pruning
+
+// Compares a partition value with a predicate operand, as integers when
+// the column is integral. False when the operand does not parse.
+bool compare_partition(const PartitionColumn& column, const std::string& value, const char* operand, int* order) {
+    if (!operand) {
+        return false;
+    }
+    if (column.integer) {
+        if (!is_integer(operand)) {
+            return false;
+        }
+        long long x = std::strtoll(value.c_str(), nullptr, 10);
+        long long y = std::strtoll(operand, nullptr, 10);
+        *order = x < y ? -1 : (x > y ? 1 : 0);
+    } else {
+        int compared = value.compare(operand);
+        *order = compared < 0 ? -1 : (compared > 0 ? 1 : 0);
+    }
+    return true;
+}
+
+// Whether a file's partition value passes one predicate; -1 when the
+// predicate is malformed
+int partition_matches(const PartitionColumn& column, const std::string& value, bool null,
+                      const ColumnPredicate& predicate) {
+    if (predicate.op == PREDICATE_IS_NULL || predicate.op == PREDICATE_IS_NOT_NULL) {
+        return null == (predicate.op == PREDICATE_IS_NULL) ? 1 : 0;
+    }
+
+    int needed = predicate.op == PREDICATE_BETWEEN ? 2 : 1;
+    if (predicate.value_count < needed || !predicate.values) {
+        return -1;
+    }
+    std::vector<int> orders;
+    int count = predicate.op == PREDICATE_IN ? predicate.value_count : needed;
+    for (int i = 0; i < count; i++) {
+        int order = 0;
+        if (!compare_partition(column, null ? std::string() : value, predicate.values[i], &order)) {
+            return -1;
+        }
+        orders.push_back(order);
+    }
+    if (null) {
+        return 0;
+    }
+
+    switch (predicate.op) {
+        case PREDICATE_EQ: return orders[0] == 0;
+        case PREDICATE_NE: return orders[0] != 0;
+        case PREDICATE_LT: return orders[0] < 0;
+        case PREDICATE_LE: return orders[0] <= 0;
+        case PREDICATE_GT: return orders[0] > 0;
+        case PREDICATE_GE: return orders[0] >= 0;
+        case PREDICATE_BETWEEN: return orders[0] >= 0 && orders[1] <= 0;
+        case PREDICATE_IN: return std::find(orders.begin(), orders.end(), 0) != orders.end();
+        default: return -1;
+    }
+}
+
+bool prune(const Dataset& dataset, const ColumnPredicate* predicates, int predicate_count, DatasetView* view) {
+    int file_columns = static_cast<int>(dataset.names.size());
+    for (int p = 0; p < predicate_count; p++) {
+        int partition = predicates[p].column_index - file_columns;
+        if (partition < 0 || partition >= static_cast<int>(dataset.partitions.size())) {
+            std::cerr << "Dataset predicates apply to partition columns only" << std::endl;
+            return false;
+        }
+    }
+
+    view->offsets.push_back(0);
+    for (int f = 0; f < static_cast<int>(dataset.files.size()); f++) {
+        const auto& file = dataset.files[f];
+        bool keep = true;
+        for (int p = 0; p < predicate_count && keep; p++) {
+            int partition = predicates[p].column_index - file_columns;
+            int match = partition_matches(dataset.partitions[partition], file.partition_values[partition],
+                                          file.partition_nulls[partition], predicates[p]);
+            if (match < 0) {
+                std::cerr << "Predicate does not fit partition column " << dataset.partitions[partition].name << std::endl;
+                return false;
+            }
+            keep = match == 1;
+        }
+        if (keep) {
+            view->files.push_back(f);
+            view->offsets.push_back(view->offsets.back() + file.row_group_offsets.back());
+        }
+    }
+    return true;
+}
+
+// MARK: - Reading
+
+// Formats rows [first, first + count) of one file into data from out_row on
+bool read_file_rows(const Dataset& dataset, const DatasetFile& file, int64_t first, int64_t count,
+                    TableData* data, int out_row) {
+    parquet::ArrowReaderProperties props;
+    props.set_batch_size(65536);
+    auto reader = parqview::open_reader(file.path.c_str(), file.metadata, props);
+    if (!reader) {
+        return false;
+    }
+
+    const auto& offsets = file.row_group_offsets;
+    int first_group = static_cast<int>(std::upper_bound(offsets.begin(), offsets.end(), first) - offsets.begin()) - 1;
+    std::vector<int> row_groups;
+    for (int rg = first_group; rg + 1 < static_cast<int>(offsets.size()) && offsets[rg] < first + count; rg++) {
+        row_groups.push_back(rg);
+    }
+
+    std::shared_ptr<arrow::Table> table;
+    auto status = reader->ReadRowGroups(row_groups, &table);
+    if (!status.ok()) {
+        std::cerr << "Error reading " << file.path << ": " << status.ToString() << std::endl;
+        return false;
+    }
+    auto slice = table->Slice(first - offsets[first_group], count);
+
+    std::vector<int64_t> positions(static_cast<size_t>(count));
+    for (int64_t i = 0; i < count; i++) {
+        positions[i] = i;
+    }
+    for (size_t c = 0; c < dataset.names.size(); c++) {
+        if (file.fields[c] >= 0) {
+            parqview::fill_column_rows(data, out_row, static_cast<int>(c), *slice->column(file.fields[c]), positions);
+        }
+    }
+    for (size_t p = 0; p < dataset.partitions.size(); p++) {
+        int column = static_cast<int>(dataset.names.size() + p);
+        for (int64_t i = 0; i < count; i++) {
+            data->data[out_row + i][column] = strdup(file.partition_nulls[p] ? "NULL" : file.partition_values[p].c_str());
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+namespace parqview {
+
+void clear_dataset_cache(const char* dataset_path) {
+    std::lock_guard<std::mutex> lock(dataset_mutex);
+    if (dataset_path) {
+        dataset_cache.erase(dataset_path);
+    } else {
+        dataset_cache.clear();
+    }
+}
+
+} // namespace parqview
+
+extern "C" {
+
+DatasetInfo* read_dataset_info(const char* dataset_path,
+                               const ColumnPredicate* partition_predicates, int predicate_count) {
+    try {
+        auto dataset = get_dataset(dataset_path);
+        DatasetView view;
+        if (!dataset || !prune(*dataset, partition_predicates, predicate_count, &view)) {
+            return nullptr;
+        }
+
+        auto* info = new DatasetInfo;
+        info->column_count = dataset->column_count();
+        info->partition_column_count = static_cast<int>(dataset->partitions.size());
+        info->file_count = static_cast<int>(view.files.size());
+        info->row_count = view.offsets.back();
+        info->total_bytes = 0;
+        for (int f : view.files) {
+            info->total_bytes += dataset->files[f].size;
+        }
+        info->columns = new ColumnInfo[info->column_count];
+        for (size_t c = 0; c < dataset->names.size(); c++) {
+            info->columns[c].name = strdup(dataset->names[c].c_str());
+            info->columns[c].type = strdup(dataset->types[c].c_str());
+        }
+        for (size_t p = 0; p < dataset->partitions.size(); p++) {
+            auto& column = info->columns[dataset->names.size() + p];
+            column.name = strdup(dataset->partitions[p].name.c_str());
+            column.type = strdup(dataset->partitions[p].integer ? "int64" : "string");
+        }
+        return info;
+    } catch (const std::exception& e) {
+        std::cerr << "Error opening dataset: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+TableData* read_dataset_data(const char* dataset_path,
+                             const ColumnPredicate* partition_predicates, int predicate_count,
+                             long long start_row, int num_rows) {
+    try {
+        auto dataset = get_dataset(dataset_path);
+        DatasetView view;
+        if (!dataset || !prune(*dataset, partition_predicates, predicate_count, &view)) {
+            return nullptr;
+        }
+
+        int64_t total = view.offsets.back();
+        start_row = std::max<long long>(start_row, 0);
+        int count = static_cast<int>(std::max<int64_t>(0, std::min<int64_t>(num_rows, total - start_row)));
+        auto* data = parqview::allocate_table_data(count, dataset->column_count());
+
+        // Walk the files holding the range, each contributing a contiguous run
+        int out_row = 0;
+        int64_t row = start_row;
+        while (out_row < count) {
+            int f = view.file_of(row);
+            const auto& file = dataset->files[view.files[f]];
+            int64_t local = row - view.offsets[f];
+            int64_t take = std::min<int64_t>(count - out_row, view.offsets[f + 1] - row);
+            if (!read_file_rows(*dataset, file, local, take, data, out_row)) {
+                free_table_data(data);
+                return nullptr;
+            }
+            out_row += static_cast<int>(take);
+            row += take;
+        }
+
+        for (int r = 0; r < data->row_count; r++) {
+            for (int c = 0; c < data->column_count; c++) {
+                if (!data->data[r][c]) {
+                    data->data[r][c] = strdup("NULL");
+                }
+            }
+        }
+        return data;
+    } catch (const std::exception& e) {
+        std::cerr << "Error reading dataset: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+DatasetRowLocation* locate_dataset_row(const char* dataset_path,
+                                       const ColumnPredicate* partition_predicates, int predicate_count,
+                                       long long row) {
+    try {
+        auto dataset = get_dataset(dataset_path);
+        DatasetView view;
+        if (!dataset || !prune(*dataset, partition_predicates, predicate_count, &view)) {
+            return nullptr;
+        }
+        if (row < 0 || row >= view.offsets.back()) {
+            return nullptr;
+        }
+
+        int f = view.file_of(row);
+        const auto& file = dataset->files[view.files[f]];
+        int64_t local = row - view.offsets[f];
+        const auto& offsets = file.row_group_offsets;
+        int rg = static_cast<int>(std::upper_bound(offsets.begin(), offsets.end(), local) - offsets.begin()) - 1;
+
+        auto* location = new DatasetRowLocation;
+        location->file_path = strdup(file.path.c_str());
+        location->file_index = f;
+        location->row_group = rg;
+        location->row_in_group = local - offsets[rg];
+        location->row_in_file = local;
+        return location;
+    } catch (const std::exception& e) {
+        std::cerr << "Error locating dataset row: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+void free_dataset_info(DatasetInfo* info) {
+    if (info) {
+        for (int i = 0; i < info->column_count; i++) {
+            free(info->columns[i].name);
+            free(info->columns[i].type);
+        }
+        delete[] info->columns;
+        delete info;
+    }
+}
+
+void free_dataset_row_location(DatasetRowLocation* location) {
+    if (location) {
+        free(location->file_path);
+        delete location;
+    }
+}
+
+void clear_dataset_cache(const char* dataset_path) {
+    parqview::clear_dataset_cache(dataset_path);
+}
+
+} // extern "C"
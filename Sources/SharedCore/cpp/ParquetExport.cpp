@@ -0,0 +1,1106 @@
+#include "../include/ParquetExport.h"
+#include "PageHeader.h"
+#include "ReaderInternal.h"
+#include "RowBitmap.h"
+#include "RowOrder.h"
+#include <arrow/array/concatenate.h>
+#include <arrow/csv/writer.h>
+#include <arrow/io/file.h>
+#include <arrow/io/memory.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/util/base64.h>
+#include <parquet/arrow/writer.h>
+#include <parquet/page_index.h>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <optional>
+
+namespace {
+
+namespace fs = std::filesystem;
+
+// Matching rows read and written as one unit, at least; a unit is whole
+// row groups, so a large row group makes a larger unit
+constexpr int64_t kUnitRows = 65536;
+
+// Rows per chunk when writing out a sorted table
+constexpr int64_t kSortedChunkRows = 65536;
+
+// Largest row group a re-encoded Parquet export writes
+constexpr int64_t kRowGroupRows = 131072;
+
+// Where parquet::arrow keeps the Arrow schema a file was written from
+constexpr const char* kArrowSchemaKey = "ARROW:schema";
+
+// Bytes read and written at a time when copying column chunks
+constexpr int64_t kCopyPieceBytes = 4 * 1024 * 1024;
+
+// One unit of output, formatted on a worker and written in turn
+struct Chunk {
+    std::string text;                       // CSV and NDJSON
+    std::shared_ptr<arrow::Table> table;    // Arrow IPC
+    int64_t rows = 0;
+};
+
+// A cell as the table shows it, falling back to Arrow's own text for
+// types the table has no format for. Binary values are written whole, as
+// base64, rather than cut to the table's preview.
+std::string cell_text(const arrow::Array& array, int64_t row) {
+    switch (array.type_id()) {
+        case arrow::Type::BINARY:
+            return parqview::encode_base64(static_cast<const arrow::BinaryArray&>(array).GetView(row));
+        case arrow::Type::LARGE_BINARY:
+            return parqview::encode_base64(static_cast<const arrow::LargeBinaryArray&>(array).GetView(row));
+        case arrow::Type::FIXED_SIZE_BINARY:
+            return parqview::encode_base64(static_cast<const arrow::FixedSizeBinaryArray&>(array).GetView(row));
+        default:
+            break;
+    }
+    std::string text = parqview::format_value(array, row);
+    if (text != "UNSUPPORTED") {
+        return text;
+    }
+    auto scalar = array.GetScalar(row);
+    return scalar.ok() ? (*scalar)->ToString() : text;
+}
+
+void append_json_string(std::string& out, std::string_view value) {
+    out += '"';
+    for (char c : value) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+}
+
+// The shortest form that reads back as the same value; JSON has no NaN
+// or infinity, so those become null
+template <typename T>
+void append_json_number(std::string& out, T value) {
+    if (!std::isfinite(value)) {
+        out += "null";
+        return;
+    }
+    constexpr int max_digits = std::numeric_limits<T>::max_digits10;
+    char buffer[32];
+    for (int digits = max_digits - 2; digits <= max_digits; digits++) {
+        snprintf(buffer, sizeof(buffer), "%.*g", digits, static_cast<double>(value));
+        if (static_cast<T>(strtod(buffer, nullptr)) == value) {
+            break;
+        }
+    }
+    out += buffer;
+}
+
+template <typename ArrayType>
+void append_json_integer(std::string& out, const arrow::Array& array, int64_t row) {
+    out += std::to_string(static_cast<const ArrayType&>(array).Value(row));
+}
+
+void append_json_value(std::string& out, const arrow::Array& array, int64_t row);
+
+template <typename ListArrayType>
+void append_json_list(std::string& out, const arrow::Array& array, int64_t row) {
+    const auto& list = static_cast<const ListArrayType&>(array);
+    int64_t start = list.value_offset(row);
+    int64_t end = start + list.value_length(row);
+    out += '[';
+    for (int64_t i = start; i < end; i++) {
+        if (i > start) {
+            out += ',';
+        }
+        append_json_value(out, *list.values(), i);
+    }
+    out += ']';
+}
+
+// Nested values as JSON arrays and objects; map keys become strings
+void append_json_value(std::string& out, const arrow::Array& array, int64_t row) {
+    if (array.IsNull(row)) {
+        out += "null";
+        return;
+    }
+    switch (array.type_id()) {
+        case arrow::Type::BOOL:
+            out += static_cast<const arrow::BooleanArray&>(array).Value(row) ? "true" : "false";
+            break;
+        case arrow::Type::INT8: append_json_integer<arrow::Int8Array>(out, array, row); break;
+        case arrow::Type::INT16: append_json_integer<arrow::Int16Array>(out, array, row); break;
+        case arrow::Type::INT32: append_json_integer<arrow::Int32Array>(out, array, row); break;
+        case arrow::Type::INT64: append_json_integer<arrow::Int64Array>(out, array, row); break;
+        case arrow::Type::UINT8: append_json_integer<arrow::UInt8Array>(out, array, row); break;
+        case arrow::Type::UINT16: append_json_integer<arrow::UInt16Array>(out, array, row); break;
+        case arrow::Type::UINT32: append_json_integer<arrow::UInt32Array>(out, array, row); break;
+        case arrow::Type::UINT64: append_json_integer<arrow::UInt64Array>(out, array, row); break;
+        case arrow::Type::FLOAT:
+            append_json_number(out, static_cast<const arrow::FloatArray&>(array).Value(row));
+            break;
+        case arrow::Type::DOUBLE:
+            append_json_number(out, static_cast<const arrow::DoubleArray&>(array).Value(row));
+            break;
+        case arrow::Type::STRING:
+            append_json_string(out, static_cast<const arrow::StringArray&>(array).GetView(row));
+            break;
+        case arrow::Type::LARGE_STRING:
+            append_json_string(out, static_cast<const arrow::LargeStringArray&>(array).GetView(row));
+            break;
+        case arrow::Type::TIMESTAMP: {
+            // The table shows whole seconds; an export keeps the fraction
+            auto scalar = array.GetScalar(row);
+            append_json_string(out, scalar.ok() ? (*scalar)->ToString() : cell_text(array, row));
+            break;
+        }
+        case arrow::Type::LIST: append_json_list<arrow::ListArray>(out, array, row); break;
+        case arrow::Type::LARGE_LIST: append_json_list<arrow::LargeListArray>(out, array, row); break;
+        case arrow::Type::FIXED_SIZE_LIST: append_json_list<arrow::FixedSizeListArray>(out, array, row); break;
+        case arrow::Type::MAP: {
+            const auto& map = static_cast<const arrow::MapArray&>(array);
+            int64_t start = map.value_offset(row);
+            int64_t end = start + map.value_length(row);
+            out += '{';
+            for (int64_t i = start; i < end; i++) {
+                if (i > start) {
+                    out += ',';
+                }
+                append_json_string(out, cell_text(*map.keys(), i));
+                out += ':';
+                append_json_value(out, *map.items(), i);
+            }
+            out += '}';
+            break;
+        }
+        case arrow::Type::STRUCT: {
+            const auto& record = static_cast<const arrow::StructArray&>(array);
+            out += '{';
+            for (int i = 0; i < record.num_fields(); i++) {
+                if (i > 0) {
+                    out += ',';
+                }
+                append_json_string(out, record.type()->field(i)->name());
+                out += ':';
+                append_json_value(out, *record.field(i), row);
+            }
+            out += '}';
+            break;
+        }
+        default:
+            // Dates, decimals and the rest as the table shows them
+            append_json_string(out, cell_text(array, row));
+    }
+}
+
+// A CSV cell for a column Arrow's CSV writer cannot cast to text: nested
+// values as JSON, binary as base64 rather than as raw bytes, which need not
+// be valid UTF-8, and UUIDs in their canonical form
+bool needs_text(const arrow::DataType& type) {
+    switch (type.id()) {
+        case arrow::Type::BINARY:
+        case arrow::Type::LARGE_BINARY:
+        case arrow::Type::FIXED_SIZE_BINARY:
+        case arrow::Type::EXTENSION:
+            return true;
+        default:
+            return arrow::is_nested(type.id());
+    }
+}
+
+std::shared_ptr<arrow::ChunkedArray> as_text(const arrow::ChunkedArray& column) {
+    bool nested = arrow::is_nested(column.type()->id());
+    arrow::ArrayVector chunks;
+    for (const auto& chunk : column.chunks()) {
+        arrow::StringBuilder builder;
+        std::string cell;
+        for (int64_t i = 0; i < chunk->length(); i++) {
+            if (chunk->IsNull(i)) {
+                if (!builder.AppendNull().ok()) {
+                    throw std::runtime_error("out of memory formatting " + column.type()->ToString());
+                }
+                continue;
+            }
+            cell.clear();
+            if (nested) {
+                append_json_value(cell, *chunk, i);
+            } else {
+                cell = cell_text(*chunk, i);
+            }
+            if (!builder.Append(cell).ok()) {
+                throw std::runtime_error("out of memory formatting " + column.type()->ToString());
+            }
+        }
+        std::shared_ptr<arrow::Array> text;
+        if (!builder.Finish(&text).ok()) {
+            throw std::runtime_error("out of memory formatting " + column.type()->ToString());
+        }
+        chunks.push_back(text);
+    }
+    return std::make_shared<arrow::ChunkedArray>(chunks, arrow::utf8());
+}
+
+// Writes one format. open and write are called in turn from one thread at
+// a time; format is called concurrently from the workers.
+class ExportSink {
+public:
+    explicit ExportSink(std::shared_ptr<arrow::io::OutputStream> output) : output_(std::move(output)) {}
+    virtual ~ExportSink() = default;
+
+    virtual arrow::Status open(const arrow::Schema&) { return arrow::Status::OK(); }
+    virtual Chunk format(const std::shared_ptr<arrow::Table>& table) const = 0;
+    virtual arrow::Status write(const Chunk& chunk) { return output_->Write(chunk.text.data(), chunk.text.size()); }
+    virtual arrow::Status close() { return output_->Close(); }
+
+protected:
+    std::shared_ptr<arrow::io::OutputStream> output_;
+};
+
+class CsvSink : public ExportSink {
+public:
+    using ExportSink::ExportSink;
+
+    arrow::Status open(const arrow::Schema& schema) override {
+        std::string header;
+        for (int i = 0; i < schema.num_fields(); i++) {
+            if (i > 0) {
+                header += ',';
+            }
+            const auto& name = schema.field(i)->name();
+            if (name.find_first_of(",\"\r\n") == std::string::npos) {
+                header += name;
+                continue;
+            }
+            header += '"';
+            for (char c : name) {
+                header += c;
+                if (c == '"') {
+                    header += '"';
+                }
+            }
+            header += '"';
+        }
+        header += '\n';
+        return output_->Write(header.data(), header.size());
+    }
+
+    Chunk format(const std::shared_ptr<arrow::Table>& table) const override {
+        std::vector<std::shared_ptr<arrow::Field>> fields;
+        std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+        for (int i = 0; i < table->num_columns(); i++) {
+            auto column = parqview::decode_dictionary(table->column(i));
+            if (needs_text(*column->type())) {
+                column = as_text(*column);
+            }
+            fields.push_back(arrow::field(table->field(i)->name(), column->type()));
+            columns.push_back(column);
+        }
+        auto cells = arrow::Table::Make(arrow::schema(fields), columns, table->num_rows());
+
+        auto options = arrow::csv::WriteOptions::Defaults();
+        options.include_header = false;
+        auto buffer = arrow::io::BufferOutputStream::Create();
+        if (!buffer.ok()) {
+            throw std::runtime_error(buffer.status().ToString());
+        }
+        auto status = arrow::csv::WriteCSV(*cells, options, buffer->get());
+        auto written = status.ok() ? (*buffer)->Finish() : arrow::Result<std::shared_ptr<arrow::Buffer>>(status);
+        if (!written.ok()) {
+            throw std::runtime_error(written.status().ToString());
+        }
+        Chunk chunk;
+        chunk.text = (*written)->ToString();
+        chunk.rows = table->num_rows();
+        return chunk;
+    }
+};
+
+class NdjsonSink : public ExportSink {
+public:
+    using ExportSink::ExportSink;
+
+    arrow::Status open(const arrow::Schema& schema) override {
+        // Keys are the same on every line, so they are escaped once
+        keys_.clear();
+        for (int i = 0; i < schema.num_fields(); i++) {
+            std::string key = i == 0 ? "{" : ",";
+            append_json_string(key, schema.field(i)->name());
+            key += ':';
+            keys_.push_back(key);
+        }
+        return arrow::Status::OK();
+    }
+
+    Chunk format(const std::shared_ptr<arrow::Table>& table) const override {
+        std::vector<std::shared_ptr<arrow::Array>> columns;
+        for (int i = 0; i < table->num_columns(); i++) {
+            auto column = parqview::decode_dictionary(table->column(i));
+            auto combined = arrow::Concatenate(column->chunks());
+            if (!combined.ok()) {
+                throw std::runtime_error(combined.status().ToString());
+            }
+            columns.push_back(*combined);
+        }
+        Chunk chunk;
+        chunk.rows = table->num_rows();
+        for (int64_t row = 0; row < chunk.rows; row++) {
+            if (columns.empty()) {
+                chunk.text += '{';
+            }
+            for (size_t i = 0; i < columns.size(); i++) {
+                chunk.text += keys_[i];
+                append_json_value(chunk.text, *columns[i], row);
+            }
+            chunk.text += "}\n";
+        }
+        return chunk;
+    }
+
+private:
+    std::vector<std::string> keys_;
+};
+
+class IpcSink : public ExportSink {
+public:
+    using ExportSink::ExportSink;
+
+    arrow::Status open(const arrow::Schema& schema) override {
+        // An IPC file holds one dictionary per column, so values are written plain
+        std::vector<std::shared_ptr<arrow::Field>> fields;
+        for (const auto& field : schema.fields()) {
+            const auto& type = field->type();
+            fields.push_back(type->id() == arrow::Type::DICTIONARY
+                                 ? field->WithType(static_cast<const arrow::DictionaryType&>(*type).value_type())
+                                 : field);
+        }
+        schema_ = arrow::schema(fields, schema.metadata());
+        ARROW_ASSIGN_OR_RAISE(writer_, arrow::ipc::MakeFileWriter(output_, schema_));
+        return arrow::Status::OK();
+    }
+
+    Chunk format(const std::shared_ptr<arrow::Table>& table) const override {
+        std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+        for (const auto& column : table->columns()) {
+            columns.push_back(parqview::decode_dictionary(column));
+        }
+        Chunk chunk;
+        chunk.table = arrow::Table::Make(schema_, columns, table->num_rows());
+        chunk.rows = table->num_rows();
+        return chunk;
+    }
+
+    arrow::Status write(const Chunk& chunk) override { return writer_->WriteTable(*chunk.table); }
+
+    arrow::Status close() override {
+        ARROW_RETURN_NOT_OK(writer_->Close());
+        return output_->Close();
+    }
+
+private:
+    std::shared_ptr<arrow::Schema> schema_;
+    std::shared_ptr<arrow::ipc::RecordBatchWriter> writer_;
+};
+
+class ParquetSink : public ExportSink {
+public:
+    ParquetSink(std::shared_ptr<arrow::io::OutputStream> output, std::shared_ptr<parquet::WriterProperties> props)
+        : ExportSink(std::move(output)), props_(std::move(props)) {}
+
+    arrow::Status open(const arrow::Schema& schema) override {
+        // Columns of each row group are encoded in parallel while workers decode the next units
+        auto arrow_props = parquet::ArrowWriterProperties::Builder().store_schema()->set_use_threads(true)->build();
+        ARROW_ASSIGN_OR_RAISE(writer_, parquet::arrow::FileWriter::Open(schema, arrow::default_memory_pool(),
+                                                                        output_, props_, arrow_props));
+        return arrow::Status::OK();
+    }
+
+    Chunk format(const std::shared_ptr<arrow::Table>& table) const override {
+        Chunk chunk;
+        chunk.table = table;
+        chunk.rows = table->num_rows();
+        return chunk;
+    }
+
+    arrow::Status write(const Chunk& chunk) override { return writer_->WriteTable(*chunk.table, kRowGroupRows); }
+
+    arrow::Status close() override {
+        ARROW_RETURN_NOT_OK(writer_->Close());
+        return output_->Close();
+    }
+
+private:
+    std::shared_ptr<parquet::WriterProperties> props_;
+    std::unique_ptr<parquet::arrow::FileWriter> writer_;
+};
+
+// parquet_props is used only for EXPORT_FORMAT_PARQUET
+std::unique_ptr<ExportSink> make_sink(ExportFormat format, std::shared_ptr<arrow::io::OutputStream> output,
+                                      std::shared_ptr<parquet::WriterProperties> parquet_props) {
+    switch (format) {
+        case EXPORT_FORMAT_CSV: return std::make_unique<CsvSink>(std::move(output));
+        case EXPORT_FORMAT_NDJSON: return std::make_unique<NdjsonSink>(std::move(output));
+        case EXPORT_FORMAT_ARROW_IPC: return std::make_unique<IpcSink>(std::move(output));
+        case EXPORT_FORMAT_PARQUET: return std::make_unique<ParquetSink>(std::move(output), std::move(parquet_props));
+    }
+    throw std::invalid_argument("unknown export format " + std::to_string(static_cast<int>(format)));
+}
+
+// Re-encoded Parquet keeps each column's codec, taken from the first row
+// group, and gains a page index
+std::shared_ptr<parquet::WriterProperties> reencode_properties(const parquet::FileMetaData& metadata,
+                                                              const std::vector<int>& leaves) {
+    parquet::WriterProperties::Builder builder;
+    builder.enable_write_page_index();
+    if (metadata.num_row_groups() > 0) {
+        auto row_group = metadata.RowGroup(0);
+        for (size_t i = 0; i < leaves.size(); i++) {
+            auto chunk = row_group->ColumnChunk(leaves[i]);
+            if (i == 0) {
+                builder.compression(chunk->compression());
+            }
+            builder.compression(chunk->path_in_schema(), chunk->compression());
+        }
+    }
+    return builder.build();
+}
+
+// A copy of node and its children, detached from the source schema.
+// Annotations older writers left only as converted types are kept as such.
+parquet::schema::NodePtr copy_node(const parquet::schema::Node& node) {
+    using namespace parquet::schema;
+    bool logical = node.logical_type() && !node.logical_type()->is_none();
+    if (node.is_primitive()) {
+        const auto& primitive = static_cast<const PrimitiveNode&>(node);
+        if (logical) {
+            return PrimitiveNode::Make(node.name(), node.repetition(), node.logical_type(),
+                                       primitive.physical_type(), primitive.type_length(), node.field_id());
+        }
+        return PrimitiveNode::Make(node.name(), node.repetition(), primitive.physical_type(), node.converted_type(),
+                                   primitive.type_length(), primitive.decimal_metadata().precision,
+                                   primitive.decimal_metadata().scale, node.field_id());
+    }
+    const auto& group = static_cast<const GroupNode&>(node);
+    NodeVector children;
+    for (int i = 0; i < group.field_count(); i++) {
+        children.push_back(copy_node(*group.field(i)));
+    }
+    if (logical) {
+        return GroupNode::Make(node.name(), node.repetition(), children, node.logical_type(), node.field_id());
+    }
+    return GroupNode::Make(node.name(), node.repetition(), children, node.converted_type(), node.field_id());
+}
+
+// Appends [offset, offset + length) of source to output a piece at a time
+void copy_range(arrow::io::RandomAccessFile& source, int64_t offset, int64_t length, arrow::io::OutputStream& output) {
+    while (length > 0) {
+        int64_t piece = std::min(length, kCopyPieceBytes);
+        auto buffer = source.ReadAt(offset, piece);
+        if (!buffer.ok()) {
+            throw std::runtime_error(buffer.status().ToString());
+        }
+        if ((*buffer)->size() != piece) {
+            throw std::runtime_error("the source ends inside a column chunk");
+        }
+        auto status = output.Write(*buffer);
+        if (!status.ok()) {
+            throw std::runtime_error(status.ToString());
+        }
+        offset += piece;
+        length -= piece;
+    }
+}
+
+int64_t tell(arrow::io::OutputStream& output) {
+    auto position = output.Tell();
+    if (!position.ok()) {
+        throw std::runtime_error(position.status().ToString());
+    }
+    return *position;
+}
+
+// True when fields' column chunks can be copied as stored: each column
+// keeps one codec across row groups, since the writer properties the
+// footer is built from hold one codec per column
+bool can_copy_chunks(const parquet::FileMetaData& metadata, const std::vector<int>& fields,
+                     const std::vector<int>& leaves) {
+    std::vector<int> unique = fields;
+    std::sort(unique.begin(), unique.end());
+    if (std::adjacent_find(unique.begin(), unique.end()) != unique.end()) {
+        return false;
+    }
+    for (int rg = 1; rg < metadata.num_row_groups(); rg++) {
+        for (int leaf : leaves) {
+            if (metadata.RowGroup(rg)->ColumnChunk(leaf)->compression() !=
+                metadata.RowGroup(0)->ColumnChunk(leaf)->compression()) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Writes a Parquet file holding fields of every row group by copying
+// their column chunks byte for byte, with no decoding or encoding, then a
+// footer with the chunks' new offsets. Statistics, the page index and
+// bloom filters are carried over; offset indexes are rebuilt, since they
+// hold absolute offsets. Returns false when progress cancelled.
+bool copy_column_chunks(const char* source_path, const parquet::FileMetaData& metadata,
+                        const std::vector<int>& fields, const std::vector<int>& leaves,
+                        const arrow::Schema& arrow_schema,
+                        arrow::io::OutputStream& output, const ExportRequest& request, long long* rows_written) {
+    auto opened = arrow::io::ReadableFile::Open(source_path);
+    if (!opened.ok()) {
+        throw std::runtime_error(opened.status().ToString());
+    }
+    auto& source = **opened;
+
+    const auto& source_schema = *metadata.schema();
+    parquet::schema::NodeVector nodes;
+    for (int field : fields) {
+        nodes.push_back(copy_node(*source_schema.group_node()->field(field)));
+    }
+    parquet::SchemaDescriptor schema;
+    schema.Init(parquet::schema::GroupNode::Make(source_schema.group_node()->name(), parquet::Repetition::REQUIRED,
+                                                 nodes));
+    auto props = reencode_properties(metadata, leaves);
+    auto footer = parquet::FileMetaDataBuilder::Make(&schema, props);
+
+    auto status = output.Write("PAR1", 4);
+    if (!status.ok()) {
+        throw std::runtime_error(status.ToString());
+    }
+    struct IndexToCopy {
+        parquet::ColumnChunkId chunk;
+        parquet::IndexLocation source;
+        int64_t shift;  // added to page offsets in an offset index
+    };
+    std::vector<IndexToCopy> column_indexes, offset_indexes, bloom_filters;
+    for (int rg = 0; rg < metadata.num_row_groups(); rg++) {
+        auto row_group = metadata.RowGroup(rg);
+        auto* row_group_builder = footer->AppendRowGroup();
+        row_group_builder->set_num_rows(row_group->num_rows());
+        int64_t uncompressed = 0;
+        for (size_t i = 0; i < leaves.size(); i++) {
+            auto chunk = row_group->ColumnChunk(leaves[i]);
+            int64_t start = parqview::chunk_start_offset(*chunk);
+            int64_t position = tell(output);
+            int64_t shift = position - start;
+            copy_range(source, start, chunk->total_compressed_size(), output);
+
+            auto* chunk_builder = row_group_builder->NextColumnChunk();
+            if (auto statistics = chunk->encoded_statistics()) {
+                chunk_builder->SetStatistics(*statistics);
+            }
+            if (auto sizes = chunk->size_statistics()) {
+                chunk_builder->SetSizeStatistics(*sizes);
+            }
+            std::map<parquet::Encoding::type, int32_t> dictionary_encodings, data_encodings;
+            for (const auto& pages : chunk->encoding_stats()) {
+                auto& counts = pages.page_type == parquet::PageType::DICTIONARY_PAGE ? dictionary_encodings
+                                                                                     : data_encodings;
+                counts[pages.encoding] += pages.count;
+            }
+            if (chunk->encoding_stats().empty()) {
+                // Older writers record only which encodings appear
+                for (auto encoding : chunk->encodings()) {
+                    data_encodings[encoding] = 1;
+                }
+                if (chunk->has_dictionary_page()) {
+                    dictionary_encodings[parquet::Encoding::PLAIN] = 1;
+                }
+            }
+            bool fallback = chunk->has_dictionary_page() && data_encodings.count(parquet::Encoding::PLAIN) > 0;
+            chunk_builder->Finish(chunk->num_values(),
+                                  chunk->has_dictionary_page() ? chunk->dictionary_page_offset() + shift : 0, -1,
+                                  chunk->data_page_offset() + shift, chunk->total_compressed_size(),
+                                  chunk->total_uncompressed_size(), chunk->has_dictionary_page(), fallback,
+                                  dictionary_encodings, data_encodings);
+            uncompressed += chunk->total_uncompressed_size();
+
+            parquet::ColumnChunkId id{rg, static_cast<int32_t>(i)};
+            if (auto location = chunk->GetColumnIndexLocation()) {
+                column_indexes.push_back({id, *location, 0});
+            }
+            if (auto location = chunk->GetOffsetIndexLocation()) {
+                offset_indexes.push_back({id, *location, shift});
+            }
+            if (chunk->bloom_filter_offset() && chunk->bloom_filter_length()) {
+                parquet::IndexLocation location{*chunk->bloom_filter_offset(),
+                                                static_cast<int32_t>(*chunk->bloom_filter_length())};
+                bloom_filters.push_back({id, location, 0});
+            }
+        }
+        row_group_builder->Finish(uncompressed);
+
+        *rows_written += row_group->num_rows();
+        if (request.progress && request.progress(*rows_written, metadata.num_rows(), request.progress_context)) {
+            return false;
+        }
+    }
+
+    // Indexes follow the row groups, as a writer lays them out
+    auto copy_indexes = [&](const std::vector<IndexToCopy>& indexes, parquet::IndexKind kind) {
+        parquet::IndexLocations locations;
+        for (const auto& index : indexes) {
+            int64_t position = tell(output);
+            if (kind != parquet::IndexKind::kOffsetIndex) {
+                copy_range(source, index.source.offset, index.source.length, output);
+            } else {
+                auto bytes = source.ReadAt(index.source.offset, index.source.length);
+                if (!bytes.ok()) {
+                    throw std::runtime_error(bytes.status().ToString());
+                }
+                auto pages = parquet::OffsetIndex::Make((*bytes)->data(), (*bytes)->size(),
+                                                        parquet::default_reader_properties());
+                auto builder = parquet::OffsetIndexBuilder::Make();
+                const auto& unencoded = pages->unencoded_byte_array_data_bytes();
+                for (size_t p = 0; p < pages->page_locations().size(); p++) {
+                    const auto& page = pages->page_locations()[p];
+                    std::optional<int64_t> unencoded_bytes;
+                    if (p < unencoded.size()) {
+                        unencoded_bytes = unencoded[p];
+                    }
+                    builder->AddPage(page.offset + index.shift, page.compressed_page_size, page.first_row_index,
+                                     unencoded_bytes);
+                }
+                builder->Finish(0);
+                builder->WriteTo(&output);
+            }
+            locations.push_back({index.chunk, {position, static_cast<int32_t>(tell(output) - position)}});
+        }
+        footer->SetIndexLocations(kind, locations);
+    };
+    copy_indexes(bloom_filters, parquet::IndexKind::kBloomFilter);
+    copy_indexes(column_indexes, parquet::IndexKind::kColumnIndex);
+    copy_indexes(offset_indexes, parquet::IndexKind::kOffsetIndex);
+
+    // The stored Arrow schema, which restores types such as dictionaries,
+    // is replaced by one describing only the copied columns
+    std::shared_ptr<const arrow::KeyValueMetadata> key_values = metadata.key_value_metadata();
+    if (key_values && key_values->Contains(kArrowSchemaKey)) {
+        auto serialized = arrow::ipc::SerializeSchema(arrow_schema);
+        if (!serialized.ok()) {
+            throw std::runtime_error(serialized.status().ToString());
+        }
+        auto replaced = key_values->Copy();
+        status = replaced->Set(kArrowSchemaKey, arrow::util::base64_encode((*serialized)->ToString()));
+        if (!status.ok()) {
+            throw std::runtime_error(status.ToString());
+        }
+        key_values = replaced;
+    }
+    auto written = footer->Finish(key_values);
+    int64_t footer_start = tell(output);
+    written->WriteTo(&output);
+    uint32_t footer_length = static_cast<uint32_t>(tell(output) - footer_start);
+    uint8_t trailer[8] = {static_cast<uint8_t>(footer_length), static_cast<uint8_t>(footer_length >> 8),
+                          static_cast<uint8_t>(footer_length >> 16), static_cast<uint8_t>(footer_length >> 24),
+                          'P', 'A', 'R', '1'};
+    status = output.Write(trailer, sizeof(trailer));
+    if (!status.ok()) {
+        throw std::runtime_error(status.ToString());
+    }
+    return true;
+}
+
+// Narrows selection to the rows other also selects
+void intersect_selection(parqview::RowSelection& selection, const parqview::RowSelection& other) {
+    if (other.all) {
+        return;
+    }
+    if (selection.all) {
+        selection = other;
+        return;
+    }
+    selection.count = 0;
+    for (size_t i = 0; i < selection.words.size(); i++) {
+        selection.words[i] &= other.words[i];
+        selection.count += __builtin_popcountll(selection.words[i]);
+    }
+}
+
+// Produces the table of unit i on one worker; each worker makes its own
+using UnitReader = std::function<std::shared_ptr<arrow::Table>(int)>;
+
+// Reads and formats units on up to max_workers threads and writes them in
+// order. A worker holding a formatted unit waits for its turn before
+// taking another, so at most one unit per worker is in memory.
+struct OrderedExport {
+    ExportSink& sink;
+    const ExportRequest& request;
+    long long rows_total = 0;
+    long long rows_written = 0;
+    bool cancelled = false;
+
+    void run(int unit_count, int max_workers, const std::function<UnitReader()>& make_reader) {
+        std::mutex mutex;
+        std::condition_variable turn;
+        int next_to_write = 0;
+        std::string error;
+        std::atomic<bool> stop{false};
+        std::atomic<int> next_unit{0};
+
+        int workers = std::max(1, std::min(unit_count, max_workers));
+        parqview::parallel_for(workers, workers, [&](int) {
+            UnitReader read_unit;
+            for (int i = next_unit++; i < unit_count; i = next_unit++) {
+                Chunk chunk;
+                std::string failure;
+                if (!stop) {
+                    try {
+                        if (!read_unit) {
+                            read_unit = make_reader();
+                        }
+                        chunk = sink.format(read_unit(i));
+                    } catch (const std::exception& e) {
+                        failure = e.what();
+                    }
+                }
+
+                std::unique_lock<std::mutex> lock(mutex);
+                turn.wait(lock, [&] { return next_to_write == i; });
+                if (!stop && !failure.empty()) {
+                    error = failure;
+                    stop = true;
+                } else if (!stop && chunk.rows > 0) {
+                    auto status = sink.write(chunk);
+                    if (!status.ok()) {
+                        error = status.ToString();
+                        stop = true;
+                    } else {
+                        rows_written += chunk.rows;
+                        if (request.progress && request.progress(rows_written, rows_total, request.progress_context)) {
+                            cancelled = true;
+                            stop = true;
+                        }
+                    }
+                }
+                next_to_write++;
+                turn.notify_all();
+            }
+        });
+        if (!error.empty()) {
+            throw std::runtime_error(error);
+        }
+    }
+};
+
+} // namespace
+
+extern "C" {
+
+ExportResult* export_parquet_file(const char* source_path, const char* output_path,
+                                  const ExportRequest* request) {
+    auto* result = new ExportResult();
+    fs::path temp;
+    try {
+        std::error_code error;
+        if (fs::equivalent(source_path, output_path, error)) {
+            throw std::invalid_argument("the output would overwrite the source");
+        }
+        auto reader_ptr = get_cached_reader(source_path);
+        if (!reader_ptr || !(*reader_ptr)) {
+            throw std::runtime_error("cannot open " + std::string(source_path));
+        }
+        auto& reader = *reader_ptr;
+        auto metadata = reader->parquet_reader()->metadata();
+        const auto& manifest = reader->manifest();
+        int field_count = static_cast<int>(manifest.schema_fields.size());
+        int num_row_groups = metadata->num_row_groups();
+
+        // Output columns, then any sort columns not among them
+        std::vector<int> output_fields;
+        if (request->columns) {
+            output_fields.assign(request->columns, request->columns + request->column_count);
+        } else {
+            for (int i = 0; i < field_count; i++) {
+                output_fields.push_back(i);
+            }
+        }
+        std::vector<int> wanted = output_fields;
+        for (int i = 0; i < request->sort_column_count; i++) {
+            if (std::find(wanted.begin(), wanted.end(), request->sort_columns[i]) == wanted.end()) {
+                wanted.push_back(request->sort_columns[i]);
+            }
+        }
+        for (int field : wanted) {
+            if (field < 0 || field >= field_count) {
+                throw std::invalid_argument("column " + std::to_string(field) + " out of range");
+            }
+        }
+
+        // Each field is read once; fields come back in schema order
+        std::vector<int> read_fields = wanted;
+        std::sort(read_fields.begin(), read_fields.end());
+        read_fields.erase(std::unique(read_fields.begin(), read_fields.end()), read_fields.end());
+        std::map<int, int> input_of;
+        std::vector<int> leaves;
+        for (int field : read_fields) {
+            input_of[field] = static_cast<int>(input_of.size());
+            parqview::collect_leaf_columns(manifest.schema_fields[field], leaves);
+        }
+        std::vector<int> wanted_inputs;
+        for (int field : wanted) {
+            wanted_inputs.push_back(input_of[field]);
+        }
+
+        // The predicates and the text search each select rows from their
+        // cached bitmaps; both together keep the rows in both
+        std::vector<parqview::RowSelection> selections(num_row_groups);
+        long long rows_total = metadata->num_rows();
+        bool filtered = request->predicate_count > 0 || (request->filter_text && *request->filter_text);
+        if (request->predicate_count > 0) {
+            auto bitmap = parqview::match_predicates(source_path, *reader, request->predicates,
+                                                     request->predicate_count, nullptr);
+            if (!bitmap) {
+                throw std::invalid_argument("the predicates do not fit the file's columns");
+            }
+            selections = parqview::select_row_groups(*bitmap, *metadata);
+        }
+        if (request->filter_text && *request->filter_text) {
+            auto bitmap = parqview::match_text_filter(source_path, *reader, request->filter_text, nullptr, 0);
+            if (!bitmap) {
+                throw std::runtime_error("cannot search " + std::string(source_path));
+            }
+            auto matches = parqview::select_row_groups(*bitmap, *metadata);
+            for (int rg = 0; rg < num_row_groups; rg++) {
+                intersect_selection(selections[rg], matches[rg]);
+            }
+        }
+        if (filtered) {
+            rows_total = 0;
+            for (const auto& selection : selections) {
+                rows_total += selection.count;
+            }
+        }
+
+        // Runs of row groups holding at least kUnitRows matching rows, so a
+        // file of many small row groups is not read and written row group by
+        // row group
+        std::vector<std::vector<int>> units;
+        int64_t unit_rows = 0;
+        for (int rg = 0; rg < num_row_groups; rg++) {
+            if (selections[rg].empty()) {
+                continue;
+            }
+            if (units.empty() || unit_rows >= kUnitRows) {
+                units.emplace_back();
+                unit_rows = 0;
+            }
+            units.back().push_back(rg);
+            unit_rows += selections[rg].all ? metadata->RowGroup(rg)->num_rows() : selections[rg].count;
+        }
+
+        // Projected to wanted, in that order, and filtered to the selection
+        auto read_unit = [&](parquet::arrow::FileReader& worker_reader, const std::vector<int>& row_groups) {
+            std::shared_ptr<arrow::Table> table;
+            auto status = worker_reader.ReadRowGroups(row_groups, leaves, &table);
+            if (!status.ok()) {
+                throw std::runtime_error(status.ToString());
+            }
+            auto projected = table->SelectColumns(wanted_inputs);
+            if (!projected.ok()) {
+                throw std::runtime_error(projected.status().ToString());
+            }
+            table = *projected;
+            // Text outputs write UUIDs the way the table shows them
+            for (int i = 0; request->format != EXPORT_FORMAT_PARQUET && i < table->num_columns(); i++) {
+                auto column = parqview::with_uuid_type(table->column(i), manifest, wanted[i]);
+                if (column == table->column(i)) {
+                    continue;
+                }
+                auto replaced = table->SetColumn(i, table->field(i)->WithType(column->type()), column);
+                if (!replaced.ok()) {
+                    throw std::runtime_error(replaced.status().ToString());
+                }
+                table = *replaced;
+            }
+            if (!filtered) {
+                return table;
+            }
+            std::vector<int64_t> rows;
+            int64_t first = 0;
+            for (int rg : row_groups) {
+                const auto& selection = selections[rg];
+                int64_t count = metadata->RowGroup(rg)->num_rows();
+                for (int64_t row = 0; row < count; row++) {
+                    if (selection.contains(row)) {
+                        rows.push_back(first + row);
+                    }
+                }
+                first += count;
+            }
+            return parqview::take_row_order(table, rows);
+        };
+        auto make_worker_reader = [&]() {
+            parquet::ArrowReaderProperties props;
+            props.set_use_threads(false);  // Row groups are already spread across threads
+            std::shared_ptr<parquet::arrow::FileReader> worker_reader(parqview::open_reader(source_path, metadata, props));
+            if (!worker_reader) {
+                throw std::runtime_error("cannot open " + std::string(source_path));
+            }
+            return worker_reader;
+        };
+
+        std::shared_ptr<arrow::Schema> schema;
+        if (!reader->GetSchema(&schema).ok()) {
+            throw std::runtime_error("cannot read the schema of " + std::string(source_path));
+        }
+        std::vector<std::shared_ptr<arrow::Field>> output_schema_fields;
+        for (int field : output_fields) {
+            output_schema_fields.push_back(schema->field(field));
+        }
+        auto output_schema = arrow::schema(output_schema_fields);
+
+        int max_workers = request->max_workers > 0
+                              ? request->max_workers
+                              : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+        // Written beside the output and renamed over it when complete
+        temp = fs::path(output_path);
+        temp += ".tmp-" + std::to_string(reinterpret_cast<uintptr_t>(result));
+        auto output = arrow::io::FileOutputStream::Open(temp.string());
+        if (!output.ok()) {
+            throw std::runtime_error(output.status().ToString());
+        }
+
+        // Output leaves in output order, for Parquet column paths and chunk copies
+        std::vector<int> output_leaves;
+        for (int field : output_fields) {
+            parqview::collect_leaf_columns(manifest.schema_fields[field], output_leaves);
+        }
+
+        arrow::Status status;
+        bool cancelled = false;
+        long long rows_written = 0;
+        if (request->format == EXPORT_FORMAT_PARQUET && !filtered && request->sort_column_count == 0 &&
+            can_copy_chunks(*metadata, output_fields, output_leaves)) {
+            // Nothing to filter or order, so the stored chunks are the output
+            cancelled = !copy_column_chunks(source_path, *metadata, output_fields, output_leaves, *output_schema,
+                                            **output, *request, &rows_written);
+            status = (*output)->Close();
+        } else {
+            auto sink = make_sink(request->format, *output, reencode_properties(*metadata, output_leaves));
+            status = sink->open(*output_schema);
+            if (!status.ok()) {
+                throw std::runtime_error(status.ToString());
+            }
+            OrderedExport ordered{*sink, *request};
+            ordered.rows_total = rows_total;
+
+            if (request->sort_column_count == 0) {
+                ordered.run(static_cast<int>(units.size()), max_workers, [&]() -> UnitReader {
+                    auto worker_reader = make_worker_reader();
+                    return [&, worker_reader](int unit) { return read_unit(*worker_reader, units[unit]); };
+                });
+            } else {
+                // Gather every matching row, sort, and write the result in slices
+                int unit_count = static_cast<int>(units.size());
+                std::vector<std::shared_ptr<arrow::Table>> gathered(unit_count);
+                std::atomic<int> next_unit{0};
+                std::string failure;
+                std::mutex failure_mutex;
+                int workers = std::max(1, std::min(unit_count, max_workers));
+                parqview::parallel_for(workers, workers, [&](int) {
+                    try {
+                        auto worker_reader = make_worker_reader();
+                        for (int unit = next_unit++; unit < unit_count; unit = next_unit++) {
+                            gathered[unit] = read_unit(*worker_reader, units[unit]);
+                        }
+                    } catch (const std::exception& e) {
+                        std::lock_guard<std::mutex> lock(failure_mutex);
+                        failure = e.what();
+                    }
+                });
+                if (!failure.empty()) {
+                    throw std::runtime_error(failure);
+                }
+                std::shared_ptr<arrow::Table> table;
+                if (gathered.empty()) {
+                    table = arrow::Table::MakeEmpty(output_schema).ValueOrDie();
+                } else {
+                    auto combined = arrow::ConcatenateTables(gathered);
+                    if (!combined.ok()) {
+                        throw std::runtime_error(combined.status().ToString());
+                    }
+                    gathered.clear();
+
+                    std::vector<parqview::SortKey> keys;
+                    for (int i = 0; i < request->sort_column_count; i++) {
+                        int position = static_cast<int>(
+                            std::find(wanted.begin(), wanted.end(), request->sort_columns[i]) - wanted.begin());
+                        keys.push_back({position, request->sort_descending && request->sort_descending[i]});
+                    }
+                    auto sorted = parqview::take_row_order(*combined, parqview::sort_row_order(**combined, keys));
+                    std::vector<int> output_positions(output_fields.size());
+                    std::iota(output_positions.begin(), output_positions.end(), 0);
+                    auto projected = sorted->SelectColumns(output_positions);
+                    if (!projected.ok()) {
+                        throw std::runtime_error(projected.status().ToString());
+                    }
+                    table = *projected;
+                }
+                int slice_count = static_cast<int>((table->num_rows() + kSortedChunkRows - 1) / kSortedChunkRows);
+                ordered.run(slice_count, max_workers, [&]() -> UnitReader {
+                    return [&](int slice) { return table->Slice(slice * kSortedChunkRows, kSortedChunkRows); };
+                });
+            }
+
+            cancelled = ordered.cancelled;
+            rows_written = ordered.rows_written;
+            status = sink->close();
+        }
+
+        if (cancelled) {
+            std::error_code ignored;
+            fs::remove(temp, ignored);
+            temp.clear();
+            result->cancelled = 1;
+            result->row_count = rows_written;
+            return result;
+        }
+        if (!status.ok()) {
+            throw std::runtime_error(status.ToString());
+        }
+        fs::rename(temp, output_path);
+        temp.clear();
+        result->row_count = rows_written;
+        result->bytes_written = static_cast<long long>(fs::file_size(output_path));
+    } catch (const std::exception& e) {
+        std::cerr << "Error exporting file: " << e.what() << std::endl;
+        result->error = strdup(e.what());
+        if (!temp.empty()) {
+            std::error_code ignored;
+            fs::remove(temp, ignored);
+        }
+    }
+    return result;
+}
+
+void free_export_result(ExportResult* result) {
+    if (result) {
+        free(result->error);
+        delete result;
+    }
+}
+
+} // extern "C"
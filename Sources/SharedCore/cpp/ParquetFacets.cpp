@@ -0,0 +1,414 @@
+#include "../include/ParquetFacets.h"
+#include "FrequencySketch.h"
+#include "ReaderInternal.h"
+#include "RowBitmap.h"
+#include <parquet/column_reader.h>
+#include <parquet/statistics.h>
+#include <parquet/types.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+
+namespace {
+
+constexpr int64_t kBatch = 8192;
+
+using parqview::RowSelection;
+
+struct ChunkFacets {
+    bool ok = true;
+    long long null_count = 0;
+    parqview::FrequencySummary summary;
+};
+
+// MARK: - Keys
+
+// Values are counted by their physical bytes and only the winners are
+// formatted, so the hot loop never builds display strings
+template <typename T>
+void key_bytes(const T& value, int, const void** data, size_t* length) {
+    *data = &value;
+    *length = sizeof(T);
+}
+
+void key_bytes(const parquet::ByteArray& value, int, const void** data, size_t* length) {
+    *data = value.ptr;
+    *length = value.len;
+}
+
+void key_bytes(const parquet::FixedLenByteArray& value, int type_length, const void** data, size_t* length) {
+    *data = value.ptr;
+    *length = static_cast<size_t>(type_length);
+}
+
+template <typename T>
+std::string key_string(const T& value, int type_length) {
+    const void* data;
+    size_t length;
+    key_bytes(value, type_length, &data, &length);
+    return std::string(static_cast<const char*>(data), length);
+}
+
+// -0.0 and 0.0 are the same value
+float normalize(float value) { return value == 0.0f ? 0.0f : value; }
+double normalize(double value) { return value == 0.0 ? 0.0 : value; }
+template <typename T>
+const T& normalize(const T& value) { return value; }
+
+template <typename DType>
+typename DType::c_type value_from_key(const std::string& key, const parquet::ColumnDescriptor&) {
+    typename DType::c_type value;
+    std::memcpy(&value, key.data(), sizeof(value));
+    return value;
+}
+
+template <>
+parquet::ByteArray value_from_key<parquet::ByteArrayType>(const std::string& key, const parquet::ColumnDescriptor&) {
+    return parquet::ByteArray(static_cast<uint32_t>(key.size()), reinterpret_cast<const uint8_t*>(key.data()));
+}
+
+template <>
+parquet::FixedLenByteArray value_from_key<parquet::FLBAType>(const std::string& key, const parquet::ColumnDescriptor&) {
+    return parquet::FixedLenByteArray(reinterpret_cast<const uint8_t*>(key.data()));
+}
+
+// Formats a key the way the table shows the column: the value goes through
+// a one-value Statistics object so Arrow applies the logical type (dates,
+// timestamps, decimals, unsigned ints) exactly as it does for the footer
+template <typename DType>
+std::string display_value(const parquet::ColumnDescriptor& descr, const std::string& key) {
+    auto value = value_from_key<DType>(key, descr);
+    auto stats = parquet::MakeStatistics<DType>(&descr);
+    stats->Update(&value, 1, 0);
+    std::shared_ptr<arrow::Scalar> min;
+    std::shared_ptr<arrow::Scalar> max;
+    if (stats->HasMinMax() && parquet::arrow::StatisticsAsScalars(*stats, &min, &max).ok() && min) {
+        return parqview::format_scalar(*min);
+    }
+    if constexpr (std::is_same_v<DType, parquet::FloatType> || std::is_same_v<DType, parquet::DoubleType>) {
+        return "NaN";
+    }
+    if constexpr (std::is_same_v<DType, parquet::Int96Type>) {
+        arrow::TimestampScalar timestamp(parquet::Int96GetNanoSeconds(value), arrow::timestamp(arrow::TimeUnit::NANO));
+        return parqview::format_scalar(timestamp);
+    }
+    return key;
+}
+
+// MARK: - Counting
+
+// Walks the levels of one batch, calling fn(value_index) for every selected
+// non-null row and counting the selected nulls
+template <typename Fn>
+void visit_batch(const int16_t* def_levels, int16_t max_def, int64_t levels_read, int64_t first_row,
+                 const RowSelection& selection, ChunkFacets& facets, Fn&& fn) {
+    int64_t value_index = 0;
+    for (int64_t level = 0; level < levels_read; level++) {
+        bool present = max_def == 0 || def_levels[level] == max_def;
+        if (selection.contains(first_row + level)) {
+            if (present) {
+                fn(value_index);
+            } else {
+                facets.null_count++;
+            }
+        }
+        value_index += present ? 1 : 0;
+    }
+}
+
+// Exact counts by dictionary index, for chunks whose data pages are all
+// dictionary encoded
+template <typename DType>
+bool count_dictionary(parquet::RowGroupReader& row_group, int leaf, const parquet::ColumnDescriptor& descr,
+                      const RowSelection& selection, ChunkFacets& facets) {
+    using T = typename DType::c_type;
+
+    auto reader = row_group.ColumnWithExposeEncoding(leaf, parquet::ExposedEncoding::DICTIONARY);
+    if (reader->GetExposedEncoding() != parquet::ExposedEncoding::DICTIONARY) {
+        return false;
+    }
+    auto* typed = static_cast<parquet::TypedColumnReader<DType>*>(reader.get());
+    int16_t max_def = descr.max_definition_level();
+
+    std::vector<int16_t> def_levels(kBatch);
+    std::vector<int32_t> indices(kBatch);
+    std::vector<long long> counts;
+    const T* dictionary = nullptr;
+    int32_t dictionary_length = 0;
+    int64_t row = 0;
+    while (typed->HasNext()) {
+        int64_t indices_read = 0;
+        const T* batch_dictionary = nullptr;
+        int32_t batch_length = 0;
+        int64_t levels_read = typed->ReadBatchWithDictionary(
+            kBatch, max_def > 0 ? def_levels.data() : nullptr, nullptr, indices.data(), &indices_read,
+            &batch_dictionary, &batch_length);
+        if (levels_read <= 0) {
+            break;
+        }
+        if (batch_dictionary) {
+            dictionary = batch_dictionary;
+            dictionary_length = batch_length;
+            counts.resize(static_cast<size_t>(dictionary_length), 0);
+        }
+        visit_batch(def_levels.data(), max_def, levels_read, row, selection, facets,
+                    [&](int64_t i) { counts[indices[i]]++; });
+        row += levels_read;
+    }
+
+    // Entries may share a key once normalized (0.0 and -0.0), and the format
+    // does not forbid repeated entries, so counts are added, not assigned
+    for (int32_t i = 0; i < dictionary_length; i++) {
+        if (counts[i] > 0) {
+            facets.summary.counters[key_string(normalize(dictionary[i]), descr.type_length())].count += counts[i];
+        }
+    }
+    return true;
+}
+
+template <typename DType>
+void count_values(parquet::RowGroupReader& row_group, int leaf, const parquet::ColumnDescriptor& descr,
+                  const RowSelection& selection, size_t capacity, ChunkFacets& facets) {
+    using T = typename DType::c_type;
+
+    auto reader = row_group.Column(leaf);
+    auto* typed = static_cast<parquet::TypedColumnReader<DType>*>(reader.get());
+    int16_t max_def = descr.max_definition_level();
+    int type_length = descr.type_length();
+
+    parqview::SpaceSaving sketch(capacity);
+    std::vector<int16_t> def_levels(kBatch);
+    std::unique_ptr<T[]> values(new T[kBatch]);
+    int64_t row = 0;
+    while (typed->HasNext()) {
+        int64_t values_read = 0;
+        int64_t levels_read = typed->ReadBatch(kBatch, max_def > 0 ? def_levels.data() : nullptr,
+                                               nullptr, values.get(), &values_read);
+        if (levels_read <= 0) {
+            break;
+        }
+        visit_batch(def_levels.data(), max_def, levels_read, row, selection, facets, [&](int64_t i) {
+            const auto& value = normalize(values[i]);
+            const void* data;
+            size_t length;
+            key_bytes(value, type_length, &data, &length);
+            sketch.add(data, length);
+        });
+        row += levels_read;
+    }
+    facets.summary = sketch.summary();
+}
+
+template <typename DType>
+void count_chunk(parquet::ParquetFileReader& file, int rg, int leaf, const RowSelection& selection,
+                 size_t capacity, ChunkFacets& facets) {
+    const auto& descr = *file.metadata()->schema()->Column(leaf);
+    auto row_group = file.RowGroup(rg);
+    if (!count_dictionary<DType>(*row_group, leaf, descr, selection, facets)) {
+        facets.null_count = 0;
+        count_values<DType>(*row_group, leaf, descr, selection, capacity, facets);
+    }
+}
+
+void count_chunk(parquet::ParquetFileReader& file, int rg, int leaf, const RowSelection& selection,
+                 size_t capacity, ChunkFacets& facets) {
+    switch (file.metadata()->schema()->Column(leaf)->physical_type()) {
+        case parquet::Type::BOOLEAN:
+            return count_chunk<parquet::BooleanType>(file, rg, leaf, selection, capacity, facets);
+        case parquet::Type::INT32:
+            return count_chunk<parquet::Int32Type>(file, rg, leaf, selection, capacity, facets);
+        case parquet::Type::INT64:
+            return count_chunk<parquet::Int64Type>(file, rg, leaf, selection, capacity, facets);
+        case parquet::Type::INT96:
+            return count_chunk<parquet::Int96Type>(file, rg, leaf, selection, capacity, facets);
+        case parquet::Type::FLOAT:
+            return count_chunk<parquet::FloatType>(file, rg, leaf, selection, capacity, facets);
+        case parquet::Type::DOUBLE:
+            return count_chunk<parquet::DoubleType>(file, rg, leaf, selection, capacity, facets);
+        case parquet::Type::BYTE_ARRAY:
+            return count_chunk<parquet::ByteArrayType>(file, rg, leaf, selection, capacity, facets);
+        case parquet::Type::FIXED_LEN_BYTE_ARRAY:
+            return count_chunk<parquet::FLBAType>(file, rg, leaf, selection, capacity, facets);
+        default:
+            facets.ok = false;
+    }
+}
+
+std::string display_value(const parquet::ColumnDescriptor& descr, const std::string& key) {
+    switch (descr.physical_type()) {
+        case parquet::Type::BOOLEAN:
+            return display_value<parquet::BooleanType>(descr, key);
+        case parquet::Type::INT32:
+            return display_value<parquet::Int32Type>(descr, key);
+        case parquet::Type::INT64:
+            return display_value<parquet::Int64Type>(descr, key);
+        case parquet::Type::INT96:
+            return display_value<parquet::Int96Type>(descr, key);
+        case parquet::Type::FLOAT:
+            return display_value<parquet::FloatType>(descr, key);
+        case parquet::Type::DOUBLE:
+            return display_value<parquet::DoubleType>(descr, key);
+        case parquet::Type::BYTE_ARRAY:
+            return display_value<parquet::ByteArrayType>(descr, key);
+        case parquet::Type::FIXED_LEN_BYTE_ARRAY:
+            return display_value<parquet::FLBAType>(descr, key);
+        default:
+            return key;
+    }
+}
+
+void fill_facets(const parquet::ColumnDescriptor& descr, const parqview::FrequencySummary& summary,
+                 long long null_count, int top_n, ColumnFacets* out) {
+    std::vector<std::pair<const std::string*, parqview::FrequencySummary::Counter>> ranked;
+    ranked.reserve(summary.counters.size());
+    for (const auto& entry : summary.counters) {
+        ranked.emplace_back(&entry.first, entry.second);
+    }
+    size_t keep = std::min(ranked.size(), static_cast<size_t>(top_n));
+    std::partial_sort(ranked.begin(), ranked.begin() + keep, ranked.end(), [](const auto& a, const auto& b) {
+        return a.second.count != b.second.count ? a.second.count > b.second.count : *a.first < *b.first;
+    });
+
+    out->supported = 1;
+    out->null_count = null_count;
+    out->value_count = static_cast<int>(keep);
+    out->values = new FacetValue[std::max<size_t>(keep, 1)];
+    bool exact = summary.missing_bound == 0;
+    for (size_t i = 0; i < keep; i++) {
+        out->values[i].value = strdup(display_value(descr, *ranked[i].first).c_str());
+        out->values[i].count = ranked[i].second.count;
+        out->values[i].error = ranked[i].second.error;
+        exact = exact && ranked[i].second.error == 0;
+    }
+    out->is_exact = exact ? 1 : 0;
+}
+
+} // namespace
+
+extern "C" {
+
+FacetResult* read_parquet_facets(const char* file_path,
+                                 const int* column_indices, int column_count, int top_n,
+                                 const ColumnPredicate* predicates, int predicate_count) {
+    try {
+        auto reader_ptr = get_cached_reader(file_path);
+        if (!reader_ptr || !(*reader_ptr)) {
+            return nullptr;
+        }
+        auto& reader = *reader_ptr;
+        auto metadata = reader->parquet_reader()->metadata();
+        const auto& manifest = reader->manifest();
+        int field_count = static_cast<int>(manifest.schema_fields.size());
+        int num_row_groups = metadata->num_row_groups();
+        top_n = std::max(top_n, 1);
+        // Every value above total / capacity is guaranteed a counter
+        size_t capacity = std::max<size_t>(1024, static_cast<size_t>(top_n) * 64);
+
+        std::vector<int> fields;
+        if (column_count <= 0 || !column_indices) {
+            for (int i = 0; i < field_count; i++) {
+                fields.push_back(i);
+            }
+        } else {
+            for (int i = 0; i < column_count; i++) {
+                if (column_indices[i] < 0 || column_indices[i] >= field_count) {
+                    std::cerr << "Facet column " << column_indices[i] << " out of range" << std::endl;
+                    return nullptr;
+                }
+                fields.push_back(column_indices[i]);
+            }
+        }
+
+        // Flat columns only: a leaf per field, one level per row
+        std::vector<int> leaves(fields.size(), -1);
+        std::vector<size_t> counted;
+        for (size_t i = 0; i < fields.size(); i++) {
+            const auto& field = manifest.schema_fields[fields[i]];
+            if (field.is_leaf() && manifest.descr->Column(field.column_index)->max_repetition_level() == 0) {
+                leaves[i] = field.column_index;
+                counted.push_back(i);
+            }
+        }
+
+        // The filter becomes one bitset per row group; row groups without a
+        // match are never read
+        std::vector<RowSelection> selections(num_row_groups);
+        long long row_count = metadata->num_rows();
+        if (predicate_count > 0) {
+            auto bitmap = parqview::match_predicates(file_path, *reader, predicates, predicate_count, nullptr);
+            if (!bitmap) {
+                return nullptr;
+            }
+            row_count = static_cast<long long>(bitmap->cardinality());
+            selections = parqview::select_row_groups(*bitmap, *metadata);
+        }
+
+        int task_count = num_row_groups * static_cast<int>(counted.size());
+        std::vector<ChunkFacets> chunks(task_count);
+        parqview::parallel_for(task_count, [&](int task) {
+            int rg = task / static_cast<int>(counted.size());
+            size_t column = counted[task % static_cast<int>(counted.size())];
+            if (selections[rg].empty()) {
+                return;
+            }
+            try {
+                auto file = parqview::open_parquet_file(file_path, metadata);
+                if (!file) {
+                    chunks[task].ok = false;
+                    return;
+                }
+                count_chunk(*file, rg, leaves[column], selections[rg], capacity, chunks[task]);
+            } catch (const std::exception& e) {
+                std::cerr << "Error counting values in row group " << rg << ": " << e.what() << std::endl;
+                chunks[task].ok = false;
+            }
+        });
+
+        auto* result = new FacetResult;
+        result->row_count = row_count;
+        result->column_count = static_cast<int>(fields.size());
+        result->columns = new ColumnFacets[fields.size()]();
+        for (size_t i = 0; i < fields.size(); i++) {
+            result->columns[i].column_index = fields[i];
+        }
+
+        for (size_t c = 0; c < counted.size(); c++) {
+            parqview::FrequencySummary merged;
+            long long null_count = 0;
+            for (int rg = 0; rg < num_row_groups; rg++) {
+                auto& chunk = chunks[rg * static_cast<int>(counted.size()) + static_cast<int>(c)];
+                if (!chunk.ok) {
+                    free_facet_result(result);
+                    return nullptr;
+                }
+                merged.merge(chunk.summary);
+                merged.prune(capacity);
+                null_count += chunk.null_count;
+            }
+            size_t i = counted[c];
+            fill_facets(*metadata->schema()->Column(leaves[i]), merged, null_count, top_n, &result->columns[i]);
+        }
+        return result;
+    } catch (const std::exception& e) {
+        std::cerr << "Error reading facets: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+void free_facet_result(FacetResult* result) {
+    if (result) {
+        for (int i = 0; i < result->column_count; i++) {
+            auto& column = result->columns[i];
+            for (int v = 0; v < column.value_count; v++) {
+                free(column.values[v].value);
+            }
+            delete[] column.values;
+        }
+        delete[] result->columns;
+        delete result;
+    }
+}
+
+} // extern "C"
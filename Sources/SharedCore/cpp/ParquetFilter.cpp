@@ -0,0 +1,632 @@
+#include "../include/ParquetFilter.h"
+#include "FormatReader.h"
+#include "ReaderInternal.h"
+#include "RowBitmap.h"
+#include <arrow/io/api.h>
+#include <parquet/column_page.h>
+#include <parquet/column_reader.h>
+#include <parquet/file_reader.h>
+#include <iostream>
+#include <cstring>
+#include <string_view>
+
+namespace {
+
+// Rows a CSV, NDJSON or Arrow file is searched in at a time
+constexpr int64_t kFormatScanRows = 65536;
+
+// A top-level field the search runs over
+struct SearchColumn {
+    int field_index;
+    std::vector<int> leaves;
+    // Flat BYTE_ARRAY string column: read with dictionaries preserved and
+    // eligible for dictionary-page pruning
+    bool is_dictionary_candidate;
+};
+
+// Decodes the UTF-8 sequence at s[i] and advances i past it. A byte that
+// does not start a valid sequence decodes to 0xDC00 + byte, which no valid
+// text produces, so malformed input still compares byte for byte.
+char32_t decode_utf8(std::string_view s, size_t& i) {
+    unsigned char c = static_cast<unsigned char>(s[i++]);
+    if (c < 0x80) {
+        return c;
+    }
+    int extra = c >= 0xF0 && c < 0xF5 ? 3 : c >= 0xE0 ? 2 : c >= 0xC2 && c < 0xE0 ? 1 : -1;
+    if (extra < 0 || i + extra > s.size()) {
+        return 0xDC00 + c;
+    }
+    char32_t code = c & (0x3F >> extra);
+    for (int k = 0; k < extra; k++) {
+        unsigned char next = static_cast<unsigned char>(s[i + k]);
+        if ((next & 0xC0) != 0x80) {
+            return 0xDC00 + c;
+        }
+        code = (code << 6) | (next & 0x3F);
+    }
+    i += extra;
+    return code;
+}
+
+void encode_utf8(char32_t code, std::string& out) {
+    if (code >= 0xDC80 && code <= 0xDCFF) {
+        out += static_cast<char>(code - 0xDC00);
+    } else if (code < 0x80) {
+        out += static_cast<char>(code);
+    } else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+// Simple lowercase mapping of the Latin, Greek and Cyrillic letters; other
+// code points are returned as they are
+char32_t to_lower(char32_t c) {
+    if (c < 0x80) {
+        return c >= 'A' && c <= 'Z' ? c + 0x20 : c;
+    }
+    // Dotted capital I sits in the paired range below but lowercases to 'i'
+    if (c == 0x130) {
+        return 'i';
+    }
+    if ((c >= 0xC0 && c <= 0xDE && c != 0xD7) || (c >= 0x391 && c <= 0x3AB && c != 0x3A2) ||
+        (c >= 0x410 && c <= 0x42F)) {
+        return c + 0x20;
+    }
+    if ((c >= 0x100 && c <= 0x137) || (c >= 0x14A && c <= 0x177) || (c >= 0x460 && c <= 0x481) ||
+        (c >= 0x48A && c <= 0x4BF) || (c >= 0x1E00 && c <= 0x1E95) || (c >= 0x1EA0 && c <= 0x1EFF)) {
+        return c | 1;
+    }
+    if ((c >= 0x139 && c <= 0x148) || (c >= 0x179 && c <= 0x17E)) {
+        return c & 1 ? c + 1 : c;
+    }
+    if (c >= 0x400 && c <= 0x40F) {
+        return c + 0x50;
+    }
+    switch (c) {
+        case 0x178: return 0xFF;
+        case 0x386: return 0x3AC;
+        case 0x388: case 0x389: case 0x38A: return c + 0x25;
+        case 0x38C: return 0x3CC;
+        case 0x38E: case 0x38F: return c + 0x3F;
+        case 0x1E9E: return 0xDF;
+        default: return c;
+    }
+}
+
+// filter_text lowercased the way contains_ci compares
+std::string lowercase_needle(std::string_view text) {
+    std::string lower;
+    lower.reserve(text.size());
+    for (size_t i = 0; i < text.size();) {
+        encode_utf8(to_lower(decode_utf8(text, i)), lower);
+    }
+    return lower;
+}
+
+// Whether haystack, lowercased, holds needle at byte offset start
+bool matches_at(std::string_view haystack, size_t start, std::string_view needle) {
+    size_t h = start;
+    size_t n = 0;
+    while (n < needle.size()) {
+        if (h >= haystack.size() || to_lower(decode_utf8(haystack, h)) != decode_utf8(needle, n)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Case-insensitive substring test over UTF-8. needle must come from
+// lowercase_needle. ASCII positions are screened on their first byte; only
+// candidates are decoded.
+bool contains_ci(std::string_view haystack, const std::string& needle) {
+    if (needle.empty()) {
+        return true;
+    }
+
+    // Lowercasing never lengthens text, so a shorter haystack cannot match
+    if (haystack.size() < needle.size()) {
+        return false;
+    }
+
+    const unsigned char first = static_cast<unsigned char>(needle[0]);
+    for (size_t i = 0; i < haystack.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(haystack[i]);
+        if (c < 0x80) {
+            if (c != first && (c < 'A' || c > 'Z' || c + 0x20 != first)) {
+                continue;
+            }
+        } else if ((c & 0xC0) == 0x80) {
+            continue;  // inside a sequence
+        }
+        if (matches_at(haystack, i, needle)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// True when the chunk is dictionary-encoded throughout and no dictionary entry
+// contains the needle, so the chunk cannot match and its indices are never decoded
+bool dictionary_rules_out(parquet::ParquetFileReader& file, int row_group, int leaf,
+                          const std::string& needle, bool null_matches) {
+    auto chunk = file.metadata()->RowGroup(row_group)->ColumnChunk(leaf);
+    if (!parqview::is_fully_dictionary_encoded(*chunk)) {
+        return false;
+    }
+
+    // A NULL cell renders as "NULL" and may match on its own
+    if (null_matches) {
+        auto stats = chunk->statistics();
+        if (!stats || !stats->HasNullCount() || stats->null_count() > 0) {
+            return false;
+        }
+    }
+
+    auto pager = file.RowGroup(row_group)->GetColumnPageReader(leaf);
+    auto page = pager->NextPage();
+    if (!page || page->type() != parquet::PageType::DICTIONARY_PAGE) {
+        return false;
+    }
+
+    // Dictionary pages are PLAIN: a 4-byte little-endian length before each value
+    const auto& dict_page = static_cast<const parquet::DictionaryPage&>(*page);
+    const uint8_t* pos = dict_page.data();
+    const uint8_t* end = pos + dict_page.size();
+    for (int i = 0; i < dict_page.num_values(); i++) {
+        uint32_t length;
+        if (end - pos < 4) {
+            return false;
+        }
+        std::memcpy(&length, pos, sizeof(length));
+        pos += 4;
+        if (static_cast<size_t>(end - pos) < length) {
+            return false;
+        }
+        if (contains_ci(std::string_view(reinterpret_cast<const char*>(pos), length), needle)) {
+            return false;
+        }
+        pos += length;
+    }
+    return true;
+}
+
+// hits[i] |= code_hits[codes[i]]: one table lookup per row, no string work.
+// Written branch-free so the compiler can emit vector gathers.
+template <typename IndexType>
+void gather_code_hits(const IndexType* codes, int64_t length, const uint8_t* code_hits,
+                      uint8_t* hits) {
+    for (int64_t i = 0; i < length; i++) {
+        hits[i] |= code_hits[codes[i]];
+    }
+}
+
+template <typename IndexType>
+void gather_code_hits_nullable(const arrow::Array& indices, const IndexType* codes,
+                               const uint8_t* code_hits, uint8_t null_hit, uint8_t* hits) {
+    for (int64_t i = 0; i < indices.length(); i++) {
+        hits[i] |= indices.IsValid(i) ? code_hits[codes[i]] : null_hit;
+    }
+}
+
+class ChunkMatcher {
+public:
+    explicit ChunkMatcher(std::string needle)
+        : needle_(std::move(needle)), null_hit_(contains_ci("NULL", needle_) ? 1 : 0) {}
+
+    bool null_matches() const { return null_hit_ != 0; }
+    const std::string& needle() const { return needle_; }
+
+    // ORs the per-row match result of chunk into hits
+    void match(const arrow::Array& chunk, uint8_t* hits) {
+        switch (chunk.type_id()) {
+            case arrow::Type::DICTIONARY:
+                match_dictionary(static_cast<const arrow::DictionaryArray&>(chunk), hits);
+                break;
+            case arrow::Type::STRING: {
+                const auto& typed = static_cast<const arrow::StringArray&>(chunk);
+                for (int64_t i = 0; i < typed.length(); i++) {
+                    hits[i] |= typed.IsNull(i) ? null_hit_ : contains_ci(typed.GetView(i), needle_);
+                }
+                break;
+            }
+            default:
+                for (int64_t i = 0; i < chunk.length(); i++) {
+                    hits[i] |= contains_ci(parqview::format_value(chunk, i), needle_);
+                }
+                break;
+        }
+    }
+
+private:
+    void match_dictionary(const arrow::DictionaryArray& chunk, uint8_t* hits) {
+        // Evaluate the predicate once per dictionary entry. Consecutive chunks
+        // of a column chunk share their dictionary, so keep the last result.
+        const auto& dictionary = chunk.dictionary();
+        if (dictionary.get() != last_dictionary_) {
+            code_hits_.assign(dictionary->length(), 0);
+            for (int64_t i = 0; i < dictionary->length(); i++) {
+                code_hits_[i] = contains_ci(parqview::format_value(*dictionary, i), needle_);
+            }
+            last_dictionary_ = dictionary.get();
+        }
+
+        const auto& indices = *chunk.indices();
+        switch (indices.type_id()) {
+            case arrow::Type::INT8:
+                gather(indices, static_cast<const arrow::Int8Array&>(indices).raw_values(), hits);
+                break;
+            case arrow::Type::INT16:
+                gather(indices, static_cast<const arrow::Int16Array&>(indices).raw_values(), hits);
+                break;
+            case arrow::Type::INT32:
+                gather(indices, static_cast<const arrow::Int32Array&>(indices).raw_values(), hits);
+                break;
+            case arrow::Type::INT64:
+                gather(indices, static_cast<const arrow::Int64Array&>(indices).raw_values(), hits);
+                break;
+            default:
+                for (int64_t i = 0; i < chunk.length(); i++) {
+                    hits[i] |= contains_ci(parqview::format_value(chunk, i), needle_);
+                }
+                break;
+        }
+    }
+
+    template <typename IndexType>
+    void gather(const arrow::Array& indices, const IndexType* codes, uint8_t* hits) {
+        // Index slots under nulls are unspecified, so only the null-free case
+        // may look them up unconditionally
+        if (indices.null_count() == 0) {
+            gather_code_hits(codes, indices.length(), code_hits_.data(), hits);
+        } else {
+            gather_code_hits_nullable(indices, codes, code_hits_.data(), null_hit_, hits);
+        }
+    }
+
+    std::string needle_;
+    uint8_t null_hit_;
+    const arrow::Array* last_dictionary_ = nullptr;
+    std::vector<uint8_t> code_hits_;
+};
+
+// The fields searched: the valid column_indices, sorted and distinct, or
+// every field when there are none
+std::vector<int> search_fields(int field_count, const int* column_indices, int column_count) {
+    std::vector<int> fields;
+    if (column_indices && column_count > 0) {
+        for (int i = 0; i < column_count; i++) {
+            if (column_indices[i] >= 0 && column_indices[i] < field_count) {
+                fields.push_back(column_indices[i]);
+            }
+        }
+        std::sort(fields.begin(), fields.end());
+        fields.erase(std::unique(fields.begin(), fields.end()), fields.end());
+    } else {
+        for (int i = 0; i < field_count; i++) {
+            fields.push_back(i);
+        }
+    }
+    return fields;
+}
+
+std::vector<SearchColumn> plan_search_columns(const parquet::arrow::FileReader& reader,
+                                              const int* column_indices, int column_count) {
+    const auto& manifest = reader.manifest();
+    int field_count = static_cast<int>(manifest.schema_fields.size());
+
+    std::vector<SearchColumn> columns;
+    for (int field_index : search_fields(field_count, column_indices, column_count)) {
+        const auto& field = manifest.schema_fields[field_index];
+        SearchColumn column;
+        column.field_index = field_index;
+        parqview::collect_leaf_columns(field, column.leaves);
+        column.is_dictionary_candidate =
+            field.is_leaf() && field.field->type()->id() == arrow::Type::STRING &&
+            manifest.descr->Column(field.column_index)->physical_type() == parquet::Type::BYTE_ARRAY;
+        columns.push_back(std::move(column));
+    }
+    return columns;
+}
+
+// Matching rows of one row group, as global row numbers
+struct RowGroupMatches {
+    parqview::RowBitmap rows;
+    bool ok = true;
+};
+
+RowGroupMatches match_row_group(const char* file_path,
+                                const std::shared_ptr<parquet::FileMetaData>& metadata,
+                                const std::vector<SearchColumn>& columns,
+                                const std::string& needle, int row_group, int64_t first_row) {
+    RowGroupMatches result;
+
+    parquet::ArrowReaderProperties props;
+    props.set_use_threads(false);  // Row groups are already spread across threads
+    props.set_batch_size(65536);
+    for (const auto& column : columns) {
+        if (column.is_dictionary_candidate) {
+            props.set_read_dictionary(column.leaves[0], true);
+        }
+    }
+
+    auto reader = parqview::open_reader(file_path, metadata, props);
+    if (!reader) {
+        result.ok = false;
+        return result;
+    }
+
+    ChunkMatcher matcher(needle);
+    std::vector<int> leaves;
+    std::vector<int> read_fields;  // field of each table column, in leaf order
+    for (const auto& column : columns) {
+        if (column.is_dictionary_candidate &&
+            dictionary_rules_out(*reader->parquet_reader(), row_group, column.leaves[0],
+                                 needle, matcher.null_matches())) {
+            continue;
+        }
+        leaves.insert(leaves.end(), column.leaves.begin(), column.leaves.end());
+        read_fields.push_back(column.field_index);
+    }
+
+    // Every searched column was ruled out by its dictionary: skip the row group
+    if (leaves.empty()) {
+        return result;
+    }
+
+    std::shared_ptr<arrow::Table> table;
+    auto status = reader->ReadRowGroup(row_group, leaves, &table);
+    if (!status.ok()) {
+        result.ok = false;
+        return result;
+    }
+
+    // Matched against the text the table shows, UUIDs included
+    std::vector<uint8_t> hits(table->num_rows(), 0);
+    for (int col = 0; col < table->num_columns(); col++) {
+        int64_t offset = 0;
+        auto values = parqview::with_uuid_type(table->column(col), reader->manifest(), read_fields[col]);
+        for (const auto& chunk : values->chunks()) {
+            matcher.match(*chunk, hits.data() + offset);
+            offset += chunk->length();
+        }
+    }
+
+    parqview::RowBitmap::Builder builder;
+    for (size_t i = 0; i < hits.size(); i++) {
+        if (hits[i]) {
+            builder.add(static_cast<uint64_t>(first_row) + i);
+        }
+    }
+    result.rows = builder.finish();
+    return result;
+}
+
+// Scans every row group in parallel and merges the matches in row order.
+// Returns nullptr if any row group fails to read.
+std::shared_ptr<const parqview::RowBitmap> evaluate_filter(
+        const char* file_path, const std::shared_ptr<parquet::FileMetaData>& metadata,
+        const std::vector<SearchColumn>& columns, const std::string& needle) {
+    auto offsets = parqview::row_group_offsets(*metadata);
+    int num_row_groups = metadata->num_row_groups();
+    std::vector<RowGroupMatches> matches(num_row_groups);
+
+    parqview::parallel_for(num_row_groups, [&](int rg) {
+        try {
+            matches[rg] = match_row_group(file_path, metadata, columns, needle, rg, offsets[rg]);
+        } catch (const std::exception& e) {
+            std::cerr << "Error filtering row group " << rg << ": " << e.what() << std::endl;
+            matches[rg].ok = false;
+        }
+    });
+
+    auto bitmap = std::make_shared<parqview::RowBitmap>();
+    for (auto& rg_matches : matches) {
+        if (!rg_matches.ok) {
+            return nullptr;
+        }
+        bitmap->append(std::move(rg_matches.rows));
+    }
+    return bitmap;
+}
+
+// Searches a CSV, NDJSON or Arrow file in windows of rows, in parallel.
+// Returns nullptr if any window fails to read.
+std::shared_ptr<const parqview::RowBitmap> evaluate_format_filter(
+        parqview::FormatReader& reader, const std::vector<SearchColumn>& columns, const std::string& needle) {
+    int64_t rows = reader.row_count();
+    int windows = static_cast<int>((rows + kFormatScanRows - 1) / kFormatScanRows);
+    std::vector<RowGroupMatches> matches(windows);
+
+    parqview::parallel_for(windows, [&](int w) {
+        try {
+            int64_t first_row = static_cast<int64_t>(w) * kFormatScanRows;
+            auto table = reader.read_rows(first_row, kFormatScanRows);
+            ChunkMatcher matcher(needle);
+            std::vector<uint8_t> hits(table->num_rows(), 0);
+            for (const auto& column : columns) {
+                int64_t offset = 0;
+                for (const auto& chunk : table->column(column.field_index)->chunks()) {
+                    matcher.match(*chunk, hits.data() + offset);
+                    offset += chunk->length();
+                }
+            }
+            parqview::RowBitmap::Builder builder;
+            for (size_t i = 0; i < hits.size(); i++) {
+                if (hits[i]) {
+                    builder.add(static_cast<uint64_t>(first_row) + i);
+                }
+            }
+            matches[w].rows = builder.finish();
+        } catch (const std::exception& e) {
+            std::cerr << "Error filtering rows from " << w * kFormatScanRows << ": " << e.what() << std::endl;
+            matches[w].ok = false;
+        }
+    });
+
+    auto bitmap = std::make_shared<parqview::RowBitmap>();
+    for (auto& window_matches : matches) {
+        if (!window_matches.ok) {
+            return nullptr;
+        }
+        bitmap->append(std::move(window_matches.rows));
+    }
+    return bitmap;
+}
+
+std::string filter_cache_key(const std::string& fingerprint, const std::string& needle,
+                             const std::vector<SearchColumn>& columns) {
+    std::string key = fingerprint;
+    key += '\0';
+    key += needle;
+    key += '\0';
+    for (const auto& column : columns) {
+        key += std::to_string(column.field_index);
+        key += ',';
+    }
+    return key;
+}
+
+// read_parquet_filtered_page for a CSV, NDJSON or Arrow file: the same
+// search and bitmap cache, over windows of rows rather than row groups
+TableData* filter_format_rows(const char* file_path, const std::string& needle,
+                              const int* column_indices, int column_count,
+                              long long offset, int limit, int max_cell_bytes,
+                              long long* total_matches, long long* row_numbers) {
+    auto reader = parqview::get_format_reader(file_path);
+    if (!reader) {
+        return nullptr;
+    }
+    if (needle.empty()) {
+        if (total_matches) {
+            *total_matches = reader->row_count();
+        }
+        auto* data = parqview::read_format_rows(*reader, offset, limit, max_cell_bytes);
+        parqview::copy_row_numbers(data, {}, offset, row_numbers);
+        return data;
+    }
+
+    std::vector<SearchColumn> columns;
+    for (int field_index : search_fields(reader->schema()->num_fields(), column_indices, column_count)) {
+        columns.push_back({field_index, {}, false});
+    }
+    std::string fingerprint = parqview::file_fingerprint(file_path);
+    std::string key = filter_cache_key(fingerprint, needle, columns);
+    auto bitmap = fingerprint.empty() ? nullptr : parqview::row_bitmap_cache().find(key);
+    if (!bitmap) {
+        bitmap = evaluate_format_filter(*reader, columns, needle);
+        if (!bitmap) {
+            return nullptr;
+        }
+        if (!fingerprint.empty()) {
+            parqview::row_bitmap_cache().insert(key, bitmap);
+        }
+    }
+
+    if (total_matches) {
+        *total_matches = static_cast<long long>(bitmap->cardinality());
+    }
+    std::vector<int64_t> rows;
+    if (offset >= 0 && limit > 0) {
+        std::vector<uint64_t> selected;
+        bitmap->select_range(static_cast<uint64_t>(offset), static_cast<uint64_t>(limit), selected);
+        rows.assign(selected.begin(), selected.end());
+    }
+    auto* data = parqview::take_format_rows(*reader, rows, max_cell_bytes);
+    parqview::copy_row_numbers(data, rows, 0, row_numbers);
+    return data;
+}
+
+} // namespace
+
+namespace parqview {
+
+std::shared_ptr<const RowBitmap> match_text_filter(const char* file_path, parquet::arrow::FileReader& reader,
+                                                   const char* filter_text, const int* column_indices,
+                                                   int column_count) {
+    std::string needle = lowercase_needle(filter_text ? filter_text : "");
+    auto metadata = reader.parquet_reader()->metadata();
+    auto columns = plan_search_columns(reader, column_indices, column_count);
+
+    // Only cache when the file can be fingerprinted; a stale bitmap
+    // for a rewritten file would silently return the wrong rows
+    std::string fingerprint = file_fingerprint(file_path);
+    std::string key = filter_cache_key(fingerprint, needle, columns);
+    auto bitmap = fingerprint.empty() ? nullptr : row_bitmap_cache().find(key);
+    if (!bitmap) {
+        bitmap = evaluate_filter(file_path, metadata, columns, needle);
+        if (bitmap && !fingerprint.empty()) {
+            row_bitmap_cache().insert(key, bitmap);
+        }
+    }
+    return bitmap;
+}
+
+} // namespace parqview
+
+extern "C" {
+
+TableData* read_parquet_filtered_page(const char* file_path, const char* filter_text,
+                                      const int* column_indices, int column_count,
+                                      long long offset, int limit, int max_cell_bytes,
+                                      long long* total_matches, long long* row_numbers) {
+    try {
+        std::string needle = lowercase_needle(filter_text ? filter_text : "");
+
+        if (detect_file_format(file_path) != FILE_FORMAT_PARQUET) {
+            return filter_format_rows(file_path, needle, column_indices, column_count, offset, limit,
+                                      max_cell_bytes, total_matches, row_numbers);
+        }
+
+        auto reader_ptr = get_cached_reader(file_path);
+        if (!reader_ptr || !(*reader_ptr)) {
+            return nullptr;
+        }
+        auto& reader = *reader_ptr;
+        auto metadata = reader->parquet_reader()->metadata();
+
+        // An empty search matches everything
+        if (needle.empty()) {
+            if (total_matches) {
+                *total_matches = metadata->num_rows();
+            }
+            auto* data = read_parquet_page(file_path, offset, limit, max_cell_bytes);
+            parqview::copy_row_numbers(data, {}, offset, row_numbers);
+            return data;
+        }
+
+        auto bitmap = parqview::match_text_filter(file_path, *reader, filter_text, column_indices, column_count);
+        if (!bitmap) {
+            return nullptr;
+        }
+
+        if (total_matches) {
+            *total_matches = static_cast<long long>(bitmap->cardinality());
+        }
+
+        // Select the page's rows by rank, then take them from their row groups
+        std::vector<int64_t> rows;
+        if (offset >= 0 && limit > 0) {
+            std::vector<uint64_t> selected;
+            bitmap->select_range(static_cast<uint64_t>(offset), static_cast<uint64_t>(limit), selected);
+            rows.assign(selected.begin(), selected.end());
+        }
+        auto* data = parqview::take_rows(file_path, reader->parquet_reader()->metadata(), rows, {}, max_cell_bytes);
+        parqview::copy_row_numbers(data, rows, 0, row_numbers);
+        return data;
+    } catch (const std::exception& e) {
+        std::cerr << "Error filtering data: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+} // extern "C"
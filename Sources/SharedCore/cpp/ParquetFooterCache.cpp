@@ -0,0 +1,230 @@
+#include "../include/ParquetFooterCache.h"
+#include "CacheDirectory.h"
+#include "DistinctCounter.h"
+#include "ReaderInternal.h"
+#include <arrow/io/memory.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr uint32_t kSidecarMagic = 0x46565150;  // "PQVF"
+constexpr uint32_t kSidecarVersion = 1;
+constexpr long long kDefaultMaxBytes = 256LL * 1024 * 1024;
+
+parqview::CacheDirectory& footer_directory() {
+    static parqview::CacheDirectory directory(".footer");
+    return directory;
+}
+
+class SidecarWriter {
+public:
+    template <typename T>
+    void put(T value) {
+        bytes_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void put_string(const std::string& value) {
+        put(static_cast<uint32_t>(value.size()));
+        bytes_ += value;
+    }
+
+    std::string take() { return std::move(bytes_); }
+
+private:
+    std::string bytes_;
+};
+
+// Bounds-checked reads over a sidecar's bytes; any overrun fails the load
+class SidecarReader {
+public:
+    SidecarReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+    template <typename T>
+    bool get(T* value) {
+        if (size_ - offset_ < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(value, data_ + offset_, sizeof(T));
+        offset_ += sizeof(T);
+        return true;
+    }
+
+    bool get_string(std::string* value) {
+        uint32_t length = 0;
+        if (!get(&length) || size_ - offset_ < length) {
+            return false;
+        }
+        value->assign(data_ + offset_, length);
+        offset_ += length;
+        return true;
+    }
+
+    bool at_end() const { return offset_ == size_; }
+
+private:
+    const char* data_;
+    size_t size_;
+    size_t offset_ = 0;
+};
+
+// A sidecar is two sections, each its length, bytes and checksum: the
+// summary (fingerprint, row offsets, columns), then the serialized footer.
+// The summary alone answers a schema request, so it is read without
+// touching the footer section behind it.
+void write_section(std::ofstream& output, const std::string& bytes) {
+    uint64_t length = bytes.size();
+    uint64_t checksum = parqview::hash_bytes(bytes.data(), bytes.size());
+    output.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    output.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    output.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+}
+
+bool read_section(std::ifstream& input, uint64_t file_size, std::string* bytes) {
+    uint64_t length = 0;
+    uint64_t checksum = 0;
+    if (!input.read(reinterpret_cast<char*>(&length), sizeof(length)) || length > file_size) {
+        return false;
+    }
+    bytes->resize(length);
+    if (!input.read(&(*bytes)[0], static_cast<std::streamsize>(length)) ||
+        !input.read(reinterpret_cast<char*>(&checksum), sizeof(checksum))) {
+        return false;
+    }
+    return checksum == parqview::hash_bytes(bytes->data(), bytes->size());
+}
+
+} // namespace
+
+namespace parqview {
+
+bool load_footer_sidecar(const char* file_path, const std::string& fingerprint, bool with_metadata,
+                         FooterSidecar* sidecar) {
+    auto path = footer_directory().entry_path(file_path);
+    if (path.empty() || fingerprint.empty()) {
+        return false;
+    }
+
+    std::error_code error;
+    auto file_size = static_cast<uint64_t>(fs::file_size(path, error));
+    std::ifstream input(path, std::ios::binary);
+    std::string summary;
+    if (error || !input || !read_section(input, file_size, &summary)) {
+        return false;
+    }
+
+    SidecarReader reader(summary.data(), summary.size());
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    std::string stored_fingerprint;
+    if (!reader.get(&magic) || magic != kSidecarMagic || !reader.get(&version) || version != kSidecarVersion ||
+        !reader.get_string(&stored_fingerprint) || stored_fingerprint != fingerprint) {
+        return false;
+    }
+
+    uint32_t offset_count = 0;
+    uint32_t column_count = 0;
+    if (!reader.get(&sidecar->row_count) || !reader.get(&offset_count)) {
+        return false;
+    }
+    sidecar->row_group_offsets.resize(offset_count);
+    for (auto& offset : sidecar->row_group_offsets) {
+        if (!reader.get(&offset)) {
+            return false;
+        }
+    }
+    if (!reader.get(&column_count)) {
+        return false;
+    }
+    sidecar->columns.resize(column_count);
+    for (auto& column : sidecar->columns) {
+        if (!reader.get_string(&column.first) || !reader.get_string(&column.second)) {
+            return false;
+        }
+    }
+    if (!reader.at_end() || (with_metadata && !read_section(input, file_size, &sidecar->metadata))) {
+        return false;
+    }
+
+    footer_directory().touch(path);
+    return true;
+}
+
+std::shared_ptr<parquet::FileMetaData> sidecar_metadata(const FooterSidecar& sidecar) {
+    uint32_t length = static_cast<uint32_t>(sidecar.metadata.size());
+    try {
+        return parquet::FileMetaData::Make(sidecar.metadata.data(), &length);
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+void store_footer_sidecar(const char* file_path, const std::string& fingerprint,
+                          const parquet::FileMetaData& metadata, const arrow::Schema& schema) {
+    auto path = footer_directory().entry_path(file_path);
+    if (path.empty() || fingerprint.empty()) {
+        return;
+    }
+
+    try {
+        auto stream = arrow::io::BufferOutputStream::Create();
+        if (!stream.ok()) {
+            return;
+        }
+        metadata.WriteTo(stream->get());
+        auto serialized = (*stream)->Finish();
+        if (!serialized.ok()) {
+            return;
+        }
+
+        SidecarWriter writer;
+        writer.put(kSidecarMagic);
+        writer.put(kSidecarVersion);
+        writer.put_string(fingerprint);
+        writer.put(static_cast<int64_t>(metadata.num_rows()));
+        auto offsets = row_group_offsets(metadata);
+        writer.put(static_cast<uint32_t>(offsets.size()));
+        for (int64_t offset : offsets) {
+            writer.put(offset);
+        }
+        writer.put(static_cast<uint32_t>(schema.num_fields()));
+        for (const auto& field : schema.fields()) {
+            writer.put_string(field->name());
+            writer.put_string(field->type()->ToString());
+        }
+        std::string summary = writer.take();
+        std::string footer = (*serialized)->ToString();
+
+        auto temp = footer_directory().temp_path(path);
+        std::ofstream output(temp, std::ios::binary | std::ios::trunc);
+        write_section(output, summary);
+        write_section(output, footer);
+        output.close();
+        if (!output) {
+            std::error_code error;
+            fs::remove(temp, error);
+            return;
+        }
+        footer_directory().commit(temp, path);
+    } catch (const std::exception& e) {
+        std::cerr << "Error writing footer sidecar for " << file_path << ": " << e.what() << std::endl;
+    }
+}
+
+} // namespace parqview
+
+extern "C" {
+
+int set_footer_cache_directory(const char* directory, long long max_bytes) {
+    return footer_directory().configure(directory, max_bytes > 0 ? max_bytes : kDefaultMaxBytes) ? 1 : 0;
+}
+
+void clear_footer_cache(void) {
+    footer_directory().clear();
+}
+
+} // extern "C"
@@ -0,0 +1,179 @@
+#include "../include/ParquetLayout.h"
+#include "PageHeader.h"
+#include "ReaderInternal.h"
+#include <arrow/io/file.h>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+int size_bucket(int32_t size) {
+    int bucket = 0;
+    for (int32_t limit = 8 << 10; bucket < PARQUET_PAGE_SIZE_BUCKETS - 1 && size >= limit; limit <<= 1) {
+        bucket++;
+    }
+    return bucket;
+}
+
+void add_page(const parqview::PageHeader& header, bool chunk_has_dictionary, PageLayout* layout) {
+    layout->header_bytes += header.header_size;
+    layout->compressed_size += header.compressed_size;
+    layout->uncompressed_size += header.uncompressed_size;
+    if (header.has_crc) {
+        layout->checksummed_page_count++;
+    }
+    if (header.kind() == parqview::PageKind::DictionaryPage) {
+        layout->dictionary_page_count++;
+        layout->dictionary_size += header.uncompressed_size;
+        return;
+    }
+    if (!header.is_data()) {
+        return;
+    }
+
+    int32_t size = header.uncompressed_size;
+    layout->min_page_size = layout->data_page_count == 0 ? size : std::min(layout->min_page_size, size);
+    layout->max_page_size = std::max(layout->max_page_size, size);
+    layout->data_page_count++;
+    layout->page_size_histogram[size_bucket(size)]++;
+    layout->value_count += header.value_count;
+    if (header.kind() == parqview::PageKind::DataPageV2) {
+        layout->v2_page_count++;
+    }
+    if (header.encoding >= 0 && header.encoding < 32) {
+        layout->data_encodings |= 1u << header.encoding;
+    }
+    bool dictionary_encoded = header.encoding == static_cast<int>(parquet::Encoding::PLAIN_DICTIONARY) ||
+                              header.encoding == static_cast<int>(parquet::Encoding::RLE_DICTIONARY);
+    if (chunk_has_dictionary && !dictionary_encoded) {
+        layout->fallback_page_count++;
+    }
+}
+
+void merge_pages(const PageLayout& from, PageLayout* into) {
+    if (from.data_page_count > 0) {
+        into->min_page_size = into->data_page_count == 0 ? from.min_page_size
+                                                         : std::min(into->min_page_size, from.min_page_size);
+    }
+    into->max_page_size = std::max(into->max_page_size, from.max_page_size);
+    into->data_page_count += from.data_page_count;
+    into->dictionary_page_count += from.dictionary_page_count;
+    into->v2_page_count += from.v2_page_count;
+    into->checksummed_page_count += from.checksummed_page_count;
+    into->fallback_page_count += from.fallback_page_count;
+    into->value_count += from.value_count;
+    into->header_bytes += from.header_bytes;
+    into->compressed_size += from.compressed_size;
+    into->uncompressed_size += from.uncompressed_size;
+    into->dictionary_size += from.dictionary_size;
+    for (int b = 0; b < PARQUET_PAGE_SIZE_BUCKETS; b++) {
+        into->page_size_histogram[b] += from.page_size_histogram[b];
+    }
+    into->data_encodings |= from.data_encodings;
+}
+
+} // namespace
+
+extern "C" {
+
+LayoutReport* read_parquet_layout(const char* file_path, int max_concurrent_reads) {
+    try {
+        auto reader_ptr = get_cached_reader(file_path);
+        if (!reader_ptr || !(*reader_ptr)) {
+            return nullptr;
+        }
+        auto metadata = (*reader_ptr)->parquet_reader()->metadata();
+        auto file = arrow::io::ReadableFile::Open(file_path);
+        if (!file.ok()) {
+            std::cerr << "Error opening file for layout: " << file.status().ToString() << std::endl;
+            return nullptr;
+        }
+        std::shared_ptr<arrow::io::RandomAccessFile> input = *file;
+
+        int columns = metadata->num_columns();
+        int row_groups = metadata->num_row_groups();
+        auto* report = new LayoutReport();
+        report->column_count = columns;
+        report->row_group_count = row_groups;
+        report->columns = new ColumnLayout[columns]();
+        report->row_groups = new RowGroupLayout[row_groups]();
+        report->chunks = new ColumnChunkLayout[static_cast<size_t>(row_groups) * columns]();
+
+        // Chunks are independent, so each worker walks whole chunks through
+        // positional reads on the shared file
+        int chunk_count = row_groups * columns;
+        int workers = max_concurrent_reads > 0
+                          ? max_concurrent_reads
+                          : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        parqview::parallel_for(chunk_count, workers, [&](int i) {
+            int rg = i / columns;
+            auto column_chunk = metadata->RowGroup(rg)->ColumnChunk(i % columns);
+            auto& out = report->chunks[i];
+            out.codec = parqview::codec_of(column_chunk->compression());
+            out.has_column_index = column_chunk->GetColumnIndexLocation().has_value();
+            out.has_offset_index = column_chunk->GetOffsetIndexLocation().has_value();
+
+            bool has_dictionary = column_chunk->has_dictionary_page();
+            std::string error;
+            bool walked = parqview::walk_chunk_pages(
+                *input, *column_chunk,
+                [&](const parqview::PageHeader& header, int64_t) {
+                    if (header.kind() == parqview::PageKind::DictionaryPage) {
+                        has_dictionary = true;
+                    }
+                    add_page(header, has_dictionary, &out.pages);
+                    return true;
+                },
+                &error);
+            if (!walked) {
+                out.error = strdup(error.c_str());
+            }
+        });
+
+        const auto* schema = metadata->schema();
+        for (int c = 0; c < columns; c++) {
+            report->columns[c].path = strdup(schema->Column(c)->path()->ToDotString().c_str());
+        }
+        for (int rg = 0; rg < row_groups; rg++) {
+            report->row_groups[rg].row_count = metadata->RowGroup(rg)->num_rows();
+            for (int c = 0; c < columns; c++) {
+                const auto& chunk = report->chunks[static_cast<size_t>(rg) * columns + c];
+                auto& column = report->columns[c];
+                merge_pages(chunk.pages, &column.pages);
+                merge_pages(chunk.pages, &report->row_groups[rg].pages);
+                merge_pages(chunk.pages, &report->total);
+                if (chunk.pages.fallback_page_count > 0) {
+                    column.fallback_chunk_count++;
+                }
+                if (chunk.has_column_index && chunk.has_offset_index) {
+                    column.indexed_chunk_count++;
+                }
+                if (chunk.error) {
+                    report->error_count++;
+                }
+            }
+        }
+        return report;
+    } catch (const std::exception& e) {
+        std::cerr << "Error reading layout: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+void free_layout_report(LayoutReport* report) {
+    if (report) {
+        for (int c = 0; c < report->column_count; c++) {
+            free(report->columns[c].path);
+        }
+        size_t chunk_count = static_cast<size_t>(report->row_group_count) * report->column_count;
+        for (size_t i = 0; i < chunk_count; i++) {
+            free(report->chunks[i].error);
+        }
+        delete[] report->columns;
+        delete[] report->row_groups;
+        delete[] report->chunks;
+        delete report;
+    }
+}
+
+} // extern "C"
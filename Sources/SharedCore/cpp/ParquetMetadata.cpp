@@ -0,0 +1,191 @@
+#include "../include/ParquetMetadata.h"
+#include "ReaderInternal.h"
+#include <parquet/statistics.h>
+#include <cstring>
+#include <iostream>
+
+namespace parqview {
+
+ParquetCodec codec_of(parquet::Compression::type compression) {
+    switch (compression) {
+        case parquet::Compression::UNCOMPRESSED: return PARQUET_CODEC_UNCOMPRESSED;
+        case parquet::Compression::SNAPPY: return PARQUET_CODEC_SNAPPY;
+        case parquet::Compression::GZIP: return PARQUET_CODEC_GZIP;
+        case parquet::Compression::LZO: return PARQUET_CODEC_LZO;
+        case parquet::Compression::BROTLI: return PARQUET_CODEC_BROTLI;
+        case parquet::Compression::LZ4_HADOOP: return PARQUET_CODEC_LZ4;
+        case parquet::Compression::ZSTD: return PARQUET_CODEC_ZSTD;
+        case parquet::Compression::LZ4: return PARQUET_CODEC_LZ4_RAW;
+        default: return PARQUET_CODEC_OTHER;
+    }
+}
+
+parquet::Compression::type compression_of(ParquetCodec codec) {
+    switch (codec) {
+        case PARQUET_CODEC_SNAPPY: return parquet::Compression::SNAPPY;
+        case PARQUET_CODEC_GZIP: return parquet::Compression::GZIP;
+        case PARQUET_CODEC_LZO: return parquet::Compression::LZO;
+        case PARQUET_CODEC_BROTLI: return parquet::Compression::BROTLI;
+        case PARQUET_CODEC_LZ4: return parquet::Compression::LZ4_HADOOP;
+        case PARQUET_CODEC_ZSTD: return parquet::Compression::ZSTD;
+        case PARQUET_CODEC_LZ4_RAW: return parquet::Compression::LZ4;
+        default: return parquet::Compression::UNCOMPRESSED;
+    }
+}
+
+} // namespace parqview
+
+namespace {
+
+// Appends NUL-terminated text to the string pool, returning its offset
+long long intern(std::string& strings, const std::string& text) {
+    auto offset = static_cast<long long>(strings.size());
+    strings += text;
+    strings.push_back('\0');
+    return offset;
+}
+
+void fill_chunk(const parquet::ColumnChunkMetaData& chunk, bool include_statistics, std::string& strings,
+                ColumnChunkMetadata* out) {
+    out->file_offset = chunk.file_offset();
+    out->data_page_offset = chunk.data_page_offset();
+    out->dictionary_page_offset = chunk.has_dictionary_page() ? chunk.dictionary_page_offset() : -1;
+    auto column_index = chunk.GetColumnIndexLocation();
+    auto offset_index = chunk.GetOffsetIndexLocation();
+    out->column_index_offset = column_index ? column_index->offset : -1;
+    out->offset_index_offset = offset_index ? offset_index->offset : -1;
+    out->compressed_size = chunk.total_compressed_size();
+    out->uncompressed_size = chunk.total_uncompressed_size();
+    out->value_count = chunk.num_values();
+    out->null_count = -1;
+    out->distinct_count = -1;
+    out->min_value = -1;
+    out->max_value = -1;
+    out->codec = parqview::codec_of(chunk.compression());
+    out->encodings = 0;
+    for (auto encoding : chunk.encodings()) {
+        if (encoding >= 0 && encoding < 32) {
+            out->encodings |= 1u << encoding;
+        }
+    }
+
+    if (!chunk.is_stats_set()) {
+        return;
+    }
+    auto encoded = chunk.encoded_statistics();
+    if (encoded && encoded->has_null_count) {
+        out->null_count = encoded->null_count;
+    }
+    if (encoded && encoded->has_distinct_count) {
+        out->distinct_count = encoded->distinct_count;
+    }
+    if (!include_statistics) {
+        return;
+    }
+    auto stats = chunk.statistics();
+    std::shared_ptr<arrow::Scalar> min;
+    std::shared_ptr<arrow::Scalar> max;
+    if (stats && stats->HasMinMax() && parquet::arrow::StatisticsAsScalars(*stats, &min, &max).ok() && min && max) {
+        out->min_value = intern(strings, parqview::format_scalar(*min));
+        out->max_value = intern(strings, parqview::format_scalar(*max));
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+ParquetFileMetadata* read_parquet_metadata(const char* file_path, int include_statistics) {
+    try {
+        auto reader_ptr = get_cached_reader(file_path);
+        if (!reader_ptr || !(*reader_ptr)) {
+            return nullptr;
+        }
+        auto metadata = (*reader_ptr)->parquet_reader()->metadata();
+        const auto* schema = metadata->schema();
+
+        auto* result = new ParquetFileMetadata();
+        result->created_by = metadata->created_by().empty() ? nullptr : strdup(metadata->created_by().c_str());
+        result->format_version = metadata->version() == parquet::ParquetVersion::PARQUET_1_0 ? 1 : 2;
+        result->row_count = metadata->num_rows();
+
+        const auto& key_values = metadata->key_value_metadata();
+        result->key_value_count = key_values ? static_cast<int>(key_values->size()) : 0;
+        result->keys = new char*[result->key_value_count];
+        result->values = new char*[result->key_value_count];
+        for (int i = 0; i < result->key_value_count; i++) {
+            result->keys[i] = strdup(key_values->key(i).c_str());
+            result->values[i] = strdup(key_values->value(i).c_str());
+        }
+
+        result->column_count = schema->num_columns();
+        result->column_paths = new char*[result->column_count];
+        result->physical_types = new char*[result->column_count];
+        for (int c = 0; c < result->column_count; c++) {
+            const auto* descr = schema->Column(c);
+            result->column_paths[c] = strdup(descr->path()->ToDotString().c_str());
+            result->physical_types[c] = strdup(parquet::TypeToString(descr->physical_type()).c_str());
+        }
+
+        int row_groups = metadata->num_row_groups();
+        result->row_group_count = row_groups;
+        result->row_groups = new RowGroupMetadata[row_groups];
+        result->column_chunks = new ColumnChunkMetadata[static_cast<size_t>(row_groups) * result->column_count];
+        std::vector<SortingColumnMetadata> sorting_columns;
+        std::string strings;
+        for (int rg = 0; rg < row_groups; rg++) {
+            auto row_group = metadata->RowGroup(rg);
+            auto& out = result->row_groups[rg];
+            out.row_count = row_group->num_rows();
+            out.total_byte_size = row_group->total_byte_size();
+            out.total_compressed_size = row_group->total_compressed_size();
+            out.file_offset = row_group->file_offset();
+            out.first_sorting_column = static_cast<int>(sorting_columns.size());
+            for (const auto& sorting : row_group->sorting_columns()) {
+                sorting_columns.push_back(SortingColumnMetadata{sorting.column_idx, sorting.descending, sorting.nulls_first});
+            }
+            out.sorting_column_count = static_cast<int>(sorting_columns.size()) - out.first_sorting_column;
+
+            for (int c = 0; c < result->column_count; c++) {
+                fill_chunk(*row_group->ColumnChunk(c), include_statistics != 0, strings,
+                           &result->column_chunks[static_cast<size_t>(rg) * result->column_count + c]);
+            }
+        }
+
+        result->sorting_column_count = static_cast<int>(sorting_columns.size());
+        result->sorting_columns = new SortingColumnMetadata[sorting_columns.size()];
+        std::copy(sorting_columns.begin(), sorting_columns.end(), result->sorting_columns);
+        result->strings_size = static_cast<long long>(strings.size());
+        result->strings = new char[strings.size() + 1];
+        std::memcpy(result->strings, strings.c_str(), strings.size() + 1);
+        return result;
+    } catch (const std::exception& e) {
+        std::cerr << "Error reading metadata: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+void free_parquet_metadata(ParquetFileMetadata* metadata) {
+    if (metadata) {
+        free(metadata->created_by);
+        for (int i = 0; i < metadata->key_value_count; i++) {
+            free(metadata->keys[i]);
+            free(metadata->values[i]);
+        }
+        delete[] metadata->keys;
+        delete[] metadata->values;
+        for (int c = 0; c < metadata->column_count; c++) {
+            free(metadata->column_paths[c]);
+            free(metadata->physical_types[c]);
+        }
+        delete[] metadata->column_paths;
+        delete[] metadata->physical_types;
+        delete[] metadata->row_groups;
+        delete[] metadata->column_chunks;
+        delete[] metadata->sorting_columns;
+        delete[] metadata->strings;
+        delete metadata;
+    }
+}
+
+} // extern "C"
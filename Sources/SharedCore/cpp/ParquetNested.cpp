@@ -0,0 +1,317 @@
+#include "../include/ParquetNested.h"
+#include "FormatReader.h"
+#include "ReaderInternal.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+struct Node {
+    std::string name;
+    std::string path;
+    std::shared_ptr<arrow::DataType> type;
+    int parent;
+    int child_count = 0;
+    int leaf_column = -1;
+};
+
+// Appends field and its descendants depth first. schema_field, when the
+// file is Parquet, is the matching node of the reader's manifest and
+// supplies leaf column indices; otherwise leaves are numbered in order.
+void add_field(std::vector<Node>& nodes, const std::shared_ptr<arrow::Field>& field, int parent,
+               const parquet::arrow::SchemaField* schema_field, int* next_leaf) {
+    int index = static_cast<int>(nodes.size());
+    Node node;
+    node.name = field->name();
+    node.path = parent < 0 ? field->name() : nodes[parent].path + "." + field->name();
+    node.type = field->type();
+    node.parent = parent;
+    nodes.push_back(node);
+    if (parent >= 0) {
+        nodes[parent].child_count++;
+    }
+
+    auto child_schema = [&](size_t i) -> const parquet::arrow::SchemaField* {
+        return schema_field && i < schema_field->children.size() ? &schema_field->children[i] : nullptr;
+    };
+    const auto& type = *field->type();
+    switch (type.id()) {
+        case arrow::Type::STRUCT:
+            for (int i = 0; i < type.num_fields(); i++) {
+                add_field(nodes, type.field(i), index, child_schema(static_cast<size_t>(i)), next_leaf);
+            }
+            break;
+        case arrow::Type::LIST:
+        case arrow::Type::LARGE_LIST:
+        case arrow::Type::FIXED_SIZE_LIST:
+            add_field(nodes, type.field(0), index, child_schema(0), next_leaf);
+            break;
+        case arrow::Type::MAP: {
+            // Keys and values sit directly under the map, without the
+            // entries struct between them
+            const auto& map = static_cast<const arrow::MapType&>(type);
+            const auto* entries = child_schema(0);
+            auto entry_schema = [&](size_t i) -> const parquet::arrow::SchemaField* {
+                return entries && i < entries->children.size() ? &entries->children[i] : nullptr;
+            };
+            add_field(nodes, map.key_field(), index, entry_schema(0), next_leaf);
+            add_field(nodes, map.item_field(), index, entry_schema(1), next_leaf);
+            break;
+        }
+        default:
+            if (arrow::is_nested(type.id())) {
+                break;  // unions and the like: shown, not expanded
+            }
+            nodes[index].leaf_column = schema_field ? schema_field->column_index : (*next_leaf)++;
+            break;
+    }
+}
+
+std::vector<Node> field_tree(const char* file_path, std::shared_ptr<parqview::FormatReader>* format_reader) {
+    std::vector<Node> nodes;
+    int next_leaf = 0;
+    if (detect_file_format(file_path) != FILE_FORMAT_PARQUET) {
+        *format_reader = parqview::get_format_reader(file_path);
+        if (!*format_reader) {
+            throw std::runtime_error("cannot open " + std::string(file_path));
+        }
+        for (const auto& field : (*format_reader)->schema()->fields()) {
+            add_field(nodes, field, -1, nullptr, &next_leaf);
+        }
+        return nodes;
+    }
+
+    auto reader_ptr = get_cached_reader(file_path);
+    if (!reader_ptr || !(*reader_ptr)) {
+        throw std::runtime_error("cannot open " + std::string(file_path));
+    }
+    for (const auto& schema_field : (*reader_ptr)->manifest().schema_fields) {
+        add_field(nodes, schema_field.field, -1, &schema_field, &next_leaf);
+    }
+    return nodes;
+}
+
+// The same list offsets and validity over different values
+std::shared_ptr<arrow::Array> relist(const arrow::Array& list, const std::string& name,
+                                     const std::shared_ptr<arrow::Array>& values) {
+    auto field = arrow::field(name, values->type());
+    auto data = list.data()->Copy();
+    switch (list.type_id()) {
+        case arrow::Type::LARGE_LIST:
+            data->type = arrow::large_list(field);
+            break;
+        case arrow::Type::FIXED_SIZE_LIST:
+            data->type = arrow::fixed_size_list(field, static_cast<const arrow::FixedSizeListType&>(*list.type()).list_size());
+            break;
+        default:
+            // A map shares a list's layout, its entries one field of the pair
+            data->type = arrow::list(field);
+            break;
+    }
+    data->child_data = {values->data()};
+    return arrow::MakeArray(data);
+}
+
+std::shared_ptr<arrow::Array> flattened_field(const arrow::StructArray& array, int index) {
+    auto field = array.GetFlattenedField(index);
+    if (!field.ok()) {
+        throw std::runtime_error(field.status().ToString());
+    }
+    return *field;
+}
+
+// The values of the field names[from:] below array: a struct's child with
+// the struct's nulls, or under a list or map, a list of that field
+std::shared_ptr<arrow::Array> project(const std::shared_ptr<arrow::Array>& array,
+                                      const std::vector<std::string>& names, size_t from) {
+    if (from == names.size()) {
+        return array;
+    }
+    const auto& name = names[from];
+    switch (array->type_id()) {
+        case arrow::Type::STRUCT: {
+            const auto& structs = static_cast<const arrow::StructArray&>(*array);
+            int index = static_cast<const arrow::StructType&>(*array->type()).GetFieldIndex(name);
+            if (index < 0) {
+                break;
+            }
+            return project(flattened_field(structs, index), names, from + 1);
+        }
+        case arrow::Type::LIST: {
+            const auto& list = static_cast<const arrow::ListArray&>(*array);
+            if (list.values()->type_id() == arrow::Type::STRUCT &&
+                static_cast<const arrow::StructType&>(*list.values()->type()).GetFieldIndex(name) >= 0) {
+                // A map read without its keys comes back as a list of
+                // entries structs, which its paths skip
+                return relist(*array, name, project(list.values(), names, from));
+            }
+            return relist(*array, name, project(list.values(), names, from + 1));
+        }
+        case arrow::Type::LARGE_LIST:
+            return relist(*array, name,
+                          project(static_cast<const arrow::LargeListArray&>(*array).values(), names, from + 1));
+        case arrow::Type::FIXED_SIZE_LIST:
+            return relist(*array, name,
+                          project(static_cast<const arrow::FixedSizeListArray&>(*array).values(), names, from + 1));
+        case arrow::Type::MAP: {
+            const auto& map = static_cast<const arrow::MapArray&>(*array);
+            const auto& entries = static_cast<const arrow::StructArray&>(*map.values());
+            int index = static_cast<const arrow::StructType&>(*entries.type()).GetFieldIndex(name);
+            if (index < 0) {
+                break;
+            }
+            return relist(*array, name, project(flattened_field(entries, index), names, from + 1));
+        }
+        default:
+            break;
+    }
+    throw std::invalid_argument("no field " + name + " under " + array->type()->ToString());
+}
+
+// Names from the top-level column down to node
+std::vector<std::string> names_to(const std::vector<Node>& nodes, int node) {
+    std::vector<std::string> names;
+    for (int i = node; i >= 0; i = nodes[i].parent) {
+        names.insert(names.begin(), nodes[i].name);
+    }
+    return names;
+}
+
+} // namespace
+
+extern "C" {
+
+FieldTree* read_parquet_field_tree(const char* file_path) {
+    try {
+        std::shared_ptr<parqview::FormatReader> format_reader;
+        auto nodes = field_tree(file_path, &format_reader);
+        auto* tree = new FieldTree;
+        tree->node_count = static_cast<int>(nodes.size());
+        tree->nodes = new FieldNode[nodes.size()];
+        for (size_t i = 0; i < nodes.size(); i++) {
+            tree->nodes[i].name = strdup(nodes[i].name.c_str());
+            tree->nodes[i].path = strdup(nodes[i].path.c_str());
+            tree->nodes[i].type = strdup(nodes[i].type->ToString().c_str());
+            tree->nodes[i].parent = nodes[i].parent;
+            tree->nodes[i].child_count = nodes[i].child_count;
+            tree->nodes[i].leaf_column = nodes[i].leaf_column;
+        }
+        return tree;
+    } catch (const std::exception& e) {
+        std::cerr << "Error reading field tree: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+void free_field_tree(FieldTree* tree) {
+    if (tree) {
+        for (int i = 0; i < tree->node_count; i++) {
+            free(tree->nodes[i].name);
+            free(tree->nodes[i].path);
+            free(tree->nodes[i].type);
+        }
+        delete[] tree->nodes;
+        delete tree;
+    }
+}
+
+TableData* read_parquet_field_paths(const char* file_path, const char* const* paths, int path_count,
+                                    long long start_row, int num_rows) {
+    try {
+        if (path_count <= 0 || !paths) {
+            throw std::invalid_argument("no field paths given");
+        }
+        std::shared_ptr<parqview::FormatReader> format_reader;
+        auto nodes = field_tree(file_path, &format_reader);
+
+        // Each path's node, and the leaves below every path
+        std::vector<int> targets;
+        std::vector<int> leaves;
+        for (int p = 0; p < path_count; p++) {
+            auto it = std::find_if(nodes.begin(), nodes.end(), [&](const Node& node) { return node.path == paths[p]; });
+            if (it == nodes.end()) {
+                throw std::invalid_argument("no field " + std::string(paths[p]));
+            }
+            int target = static_cast<int>(it - nodes.begin());
+            targets.push_back(target);
+            // Descendants follow their ancestor until the next node outside it
+            for (int i = target; i < static_cast<int>(nodes.size()); i++) {
+                int ancestor = i;
+                while (ancestor > target) {
+                    ancestor = nodes[ancestor].parent;
+                }
+                if (ancestor != target) {
+                    break;
+                }
+                if (nodes[i].leaf_column >= 0) {
+                    leaves.push_back(nodes[i].leaf_column);
+                }
+            }
+        }
+        std::sort(leaves.begin(), leaves.end());
+        leaves.erase(std::unique(leaves.begin(), leaves.end()), leaves.end());
+
+        std::shared_ptr<arrow::Table> table;
+        if (format_reader) {
+            table = format_reader->read_rows(start_row, num_rows);
+        } else {
+            auto reader_ptr = get_cached_reader(file_path);
+            if (!reader_ptr || !(*reader_ptr)) {
+                return nullptr;
+            }
+            auto& reader = *reader_ptr;
+            auto metadata = reader->parquet_reader()->metadata();
+            auto offsets = parqview::row_group_offsets(*metadata);
+            int64_t end_row = std::min<int64_t>(start_row + std::max(num_rows, 0), offsets.back());
+            if (end_row <= start_row) {
+                return parqview::allocate_table_data(0, path_count);
+            }
+
+            // Only the row groups holding the rows, and only the leaves
+            // under the paths: the reader prunes every other struct child
+            std::vector<int> row_groups;
+            for (int rg = 0; rg < metadata->num_row_groups(); rg++) {
+                if (offsets[rg + 1] > start_row && offsets[rg] < end_row) {
+                    row_groups.push_back(rg);
+                }
+            }
+            auto status = reader->ReadRowGroups(row_groups, leaves, &table);
+            if (!status.ok()) {
+                throw std::runtime_error(status.ToString());
+            }
+            table = table->Slice(start_row - offsets[row_groups.front()], end_row - start_row);
+        }
+
+        // Projected before anything is formatted, so a bad path leaks nothing
+        std::vector<arrow::ArrayVector> columns;
+        for (int p = 0; p < path_count; p++) {
+            auto names = names_to(nodes, targets[p]);
+            auto column = table->GetColumnByName(names.front());
+            if (!column) {
+                throw std::runtime_error("column " + names.front() + " was not read");
+            }
+            arrow::ArrayVector chunks;
+            for (const auto& chunk : column->chunks()) {
+                chunks.push_back(project(chunk, names, 1));
+            }
+            columns.push_back(std::move(chunks));
+        }
+
+        auto* data = parqview::allocate_table_data(static_cast<int>(table->num_rows()), path_count);
+        for (int p = 0; p < path_count; p++) {
+            int64_t row = 0;
+            for (const auto& values : columns[p]) {
+                for (int64_t i = 0; i < values->length(); i++) {
+                    data->data[row++][p] = strdup(parqview::format_value(*values, i).c_str());
+                }
+            }
+        }
+        return data;
+    } catch (const std::exception& e) {
+        std::cerr << "Error reading field paths: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+} // extern "C"
@@ -0,0 +1,1212 @@
+#include "../include/ParquetPredicate.h"
+#include "ReaderInternal.h"
+#include "RowBitmap.h"
+#include <arrow/util/decimal.h>
+#include <parquet/bloom_filter.h>
+#include <parquet/bloom_filter_reader.h>
+#include <parquet/column_reader.h>
+#include <parquet/file_reader.h>
+#include <parquet/page_index.h>
+#include <parquet/statistics.h>
+#include <parquet/types.h>
+#include <algorithm>
+#include <iostream>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+namespace {
+
+// How a column's values compare: the physical value is widened to one of
+// int64_t, uint64_t, double, std::string_view or, for decimals stored as
+// byte arrays, arrow::Decimal128 before comparing
+enum class Domain { Signed, Unsigned, Floating, Bytes, Decimal };
+
+// A predicate resolved against its column, with operands parsed
+struct PredicatePlan {
+    int field_index;
+    int leaf;
+    const parquet::ColumnDescriptor* descr;
+    PredicateOp op;
+    Domain domain;
+    std::vector<int64_t> signed_values;
+    std::vector<uint64_t> unsigned_values;
+    std::vector<double> float_values;
+    std::vector<std::string> byte_values;
+    std::vector<arrow::Decimal128> decimal_values;
+};
+
+// MARK: - Operand parsing
+
+bool parse_int(const std::string& text, int64_t* out) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    long long value = std::strtoll(text.c_str(), &end, 10);
+    if (errno != 0 || *end != '\0') {
+        return false;
+    }
+    *out = value;
+    return true;
+}
+
+bool parse_uint(const std::string& text, uint64_t* out) {
+    if (text.empty() || text[0] == '-') {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+    if (errno != 0 || *end != '\0') {
+        return false;
+    }
+    *out = value;
+    return true;
+}
+
+bool parse_double(const std::string& text, double* out) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    double value = std::strtod(text.c_str(), &end);
+    if (*end != '\0') {
+        return false;
+    }
+    *out = value;
+    return true;
+}
+
+bool parse_bool(const std::string& text, int64_t* out) {
+    if (text == "true" || text == "TRUE" || text == "1") {
+        *out = 1;
+        return true;
+    }
+    if (text == "false" || text == "FALSE" || text == "0") {
+        *out = 0;
+        return true;
+    }
+    return false;
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date
+int64_t days_from_civil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+// Parses "YYYY-MM-DD" with an optional " HH:MM[:SS[.fraction]]" or
+// "THH:MM..." time and optional trailing "Z". Times are taken as UTC.
+bool parse_datetime(const std::string& text, int64_t* days, int64_t* seconds, int64_t* nanos) {
+    int year, month, day, consumed = 0;
+    if (std::sscanf(text.c_str(), "%5d-%2d-%2d%n", &year, &month, &day, &consumed) != 3 ||
+        month < 1 || month > 12 || day < 1 || day > 31) {
+        return false;
+    }
+    *days = days_from_civil(year, static_cast<unsigned>(month), static_cast<unsigned>(day));
+    *seconds = 0;
+    *nanos = 0;
+
+    const char* pos = text.c_str() + consumed;
+    if (*pos == ' ' || *pos == 'T') {
+        int hour, minute, second = 0, time_consumed = 0;
+        if (std::sscanf(pos + 1, "%2d:%2d%n", &hour, &minute, &time_consumed) != 2) {
+            return false;
+        }
+        pos += 1 + time_consumed;
+        if (*pos == ':') {
+            int second_consumed = 0;
+            if (std::sscanf(pos + 1, "%2d%n", &second, &second_consumed) != 1) {
+                return false;
+            }
+            pos += 1 + second_consumed;
+        }
+        *seconds = hour * 3600 + minute * 60 + second;
+
+        if (*pos == '.') {
+            int64_t scale = 100000000;
+            for (pos++; *pos >= '0' && *pos <= '9'; pos++) {
+                *nanos += (*pos - '0') * scale;
+                scale /= 10;
+            }
+        }
+    }
+    if (*pos == 'Z') {
+        pos++;
+    }
+    return *pos == '\0';
+}
+
+// Parses "123.45" into an unscaled integer for a decimal with the given scale
+bool parse_decimal(const std::string& text, int scale, int64_t* out) {
+    size_t pos = 0;
+    bool negative = false;
+    if (pos < text.size() && (text[pos] == '-' || text[pos] == '+')) {
+        negative = text[pos] == '-';
+        pos++;
+    }
+
+    int64_t value = 0;
+    int fraction_digits = -1;
+    bool any_digit = false;
+    for (; pos < text.size(); pos++) {
+        char c = text[pos];
+        if (c == '.' && fraction_digits < 0) {
+            fraction_digits = 0;
+            continue;
+        }
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        any_digit = true;
+        if (fraction_digits >= scale) {
+            continue;  // Truncate digits beyond the column's scale
+        }
+        if (value > (INT64_MAX - 9) / 10) {
+            return false;
+        }
+        value = value * 10 + (c - '0');
+        if (fraction_digits >= 0) {
+            fraction_digits++;
+        }
+    }
+    if (!any_digit) {
+        return false;
+    }
+    for (int i = std::max(fraction_digits, 0); i < scale; i++) {
+        if (value > INT64_MAX / 10) {
+            return false;
+        }
+        value *= 10;
+    }
+    *out = negative ? -value : value;
+    return true;
+}
+
+// Parses "123.45" into an unscaled 128-bit decimal with the given scale,
+// truncating digits beyond it as parse_decimal does
+bool parse_decimal128(const std::string& text, int scale, arrow::Decimal128* out) {
+    arrow::Decimal128 value;
+    int32_t precision = 0;
+    int32_t text_scale = 0;
+    if (!arrow::Decimal128::FromString(text, &value, &precision, &text_scale).ok()) {
+        return false;
+    }
+    if (text_scale > scale) {
+        value = arrow::Decimal128(value.ReduceScaleBy(text_scale - scale, false));
+    } else if (text_scale < scale) {
+        if (!value.FitsInPrecision(38 - (scale - text_scale))) {
+            return false;
+        }
+        value = arrow::Decimal128(value.IncreaseScaleBy(scale - text_scale));
+    }
+    *out = value;
+    return true;
+}
+
+// A big-endian two's complement decimal, as FIXED_LEN_BYTE_ARRAY and
+// BYTE_ARRAY columns store them
+bool decode_decimal(const uint8_t* bytes, int32_t length, arrow::Decimal128* out) {
+    auto value = arrow::Decimal128::FromBigEndian(bytes, length);
+    if (!value.ok()) {
+        return false;
+    }
+    *out = *value;
+    return true;
+}
+
+// Parses one operand for a Signed-domain column, honouring its logical type
+bool parse_signed_operand(const std::string& text, const parquet::ColumnDescriptor& descr,
+                          int64_t* out) {
+    const auto& logical = descr.logical_type();
+    if (descr.physical_type() == parquet::Type::BOOLEAN) {
+        return parse_bool(text, out);
+    }
+    if (logical && logical->is_decimal()) {
+        const auto& decimal = static_cast<const parquet::DecimalLogicalType&>(*logical);
+        return parse_decimal(text, decimal.scale(), out);
+    }
+    if (parse_int(text, out)) {
+        return true;
+    }
+
+    int64_t days, seconds, nanos;
+    if (logical && logical->is_date() && parse_datetime(text, &days, &seconds, &nanos)) {
+        *out = days;
+        return true;
+    }
+    if (logical && logical->is_timestamp() && parse_datetime(text, &days, &seconds, &nanos)) {
+        const auto& timestamp = static_cast<const parquet::TimestampLogicalType&>(*logical);
+        int64_t whole_seconds = days * 86400 + seconds;
+        switch (timestamp.time_unit()) {
+            case parquet::LogicalType::TimeUnit::MILLIS:
+                *out = whole_seconds * 1000 + nanos / 1000000;
+                return true;
+            case parquet::LogicalType::TimeUnit::MICROS:
+                *out = whole_seconds * 1000000 + nanos / 1000;
+                return true;
+            case parquet::LogicalType::TimeUnit::NANOS:
+                *out = whole_seconds * 1000000000 + nanos;
+                return true;
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+
+size_t required_operands(PredicateOp op, int value_count) {
+    switch (op) {
+        case PREDICATE_IS_NULL:
+        case PREDICATE_IS_NOT_NULL:
+            return 0;
+        case PREDICATE_BETWEEN:
+            return 2;
+        case PREDICATE_IN:
+            return value_count > 0 ? static_cast<size_t>(value_count) : 1;
+        default:
+            return 1;
+    }
+}
+
+// Resolves a C predicate against the file schema. Returns false with a
+// message on stderr when the column or operands don't fit.
+bool resolve_predicate(const parquet::arrow::FileReader& reader, const ColumnPredicate& predicate,
+                       PredicatePlan* plan) {
+    const auto& manifest = reader.manifest();
+    if (predicate.column_index < 0 ||
+        predicate.column_index >= static_cast<int>(manifest.schema_fields.size())) {
+        std::cerr << "Predicate column " << predicate.column_index << " out of range" << std::endl;
+        return false;
+    }
+    const auto& field = manifest.schema_fields[predicate.column_index];
+    if (!field.is_leaf() || manifest.descr->Column(field.column_index)->max_repetition_level() > 0) {
+        std::cerr << "Predicates on nested column " << field.field->name() << " are not supported" << std::endl;
+        return false;
+    }
+
+    plan->field_index = predicate.column_index;
+    plan->leaf = field.column_index;
+    plan->descr = manifest.descr->Column(field.column_index);
+    plan->op = predicate.op;
+
+    const auto& logical = plan->descr->logical_type();
+    switch (plan->descr->physical_type()) {
+        case parquet::Type::BOOLEAN:
+            plan->domain = Domain::Signed;
+            break;
+        case parquet::Type::INT32:
+        case parquet::Type::INT64: {
+            bool is_unsigned = logical && logical->is_int() &&
+                               !static_cast<const parquet::IntLogicalType&>(*logical).is_signed();
+            plan->domain = is_unsigned ? Domain::Unsigned : Domain::Signed;
+            break;
+        }
+        case parquet::Type::FLOAT:
+        case parquet::Type::DOUBLE:
+            plan->domain = Domain::Floating;
+            break;
+        case parquet::Type::BYTE_ARRAY:
+            plan->domain = logical && logical->is_decimal() ? Domain::Decimal : Domain::Bytes;
+            break;
+        case parquet::Type::FIXED_LEN_BYTE_ARRAY:
+            // Precision above 38 takes more than 16 bytes
+            if (logical && logical->is_decimal() && plan->descr->type_length() <= 16) {
+                plan->domain = Domain::Decimal;
+                break;
+            }
+            std::cerr << "Predicates on column " << field.field->name() << " of type "
+                      << parquet::TypeToString(plan->descr->physical_type()) << " are not supported" << std::endl;
+            return false;
+        default:
+            std::cerr << "Predicates on column " << field.field->name() << " of type "
+                      << parquet::TypeToString(plan->descr->physical_type()) << " are not supported" << std::endl;
+            return false;
+    }
+
+    size_t needed = required_operands(predicate.op, predicate.value_count);
+    if (static_cast<size_t>(std::max(predicate.value_count, 0)) < needed || (needed > 0 && !predicate.values)) {
+        std::cerr << "Predicate on " << field.field->name() << " is missing values" << std::endl;
+        return false;
+    }
+
+    for (size_t i = 0; i < needed; i++) {
+        std::string text = predicate.values[i] ? predicate.values[i] : "";
+        bool ok = true;
+        switch (plan->domain) {
+            case Domain::Signed: {
+                int64_t value = 0;
+                ok = parse_signed_operand(text, *plan->descr, &value);
+                plan->signed_values.push_back(value);
+                break;
+            }
+            case Domain::Unsigned: {
+                uint64_t value = 0;
+                ok = parse_uint(text, &value);
+                plan->unsigned_values.push_back(value);
+                break;
+            }
+            case Domain::Floating: {
+                double value = 0;
+                ok = parse_double(text, &value);
+                // A float column shows its values at float precision, so "0.1"
+                // means the float nearest 0.1, not the double
+                if (plan->descr->physical_type() == parquet::Type::FLOAT) {
+                    value = static_cast<float>(value);
+                }
+                plan->float_values.push_back(value);
+                break;
+            }
+            case Domain::Bytes:
+                plan->byte_values.push_back(text);
+                break;
+            case Domain::Decimal: {
+                arrow::Decimal128 value;
+                const auto& decimal = static_cast<const parquet::DecimalLogicalType&>(*logical);
+                ok = parse_decimal128(text, decimal.scale(), &value);
+                plan->decimal_values.push_back(value);
+                break;
+            }
+        }
+        if (!ok) {
+            std::cerr << "Cannot compare column " << field.field->name() << " with '" << text << "'" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// MARK: - Comparison
+
+template <typename V>
+std::vector<V> operands_of(const PredicatePlan& plan) {
+    if constexpr (std::is_same_v<V, int64_t>) {
+        return plan.signed_values;
+    } else if constexpr (std::is_same_v<V, uint64_t>) {
+        return plan.unsigned_values;
+    } else if constexpr (std::is_same_v<V, double>) {
+        return plan.float_values;
+    } else if constexpr (std::is_same_v<V, arrow::Decimal128>) {
+        return plan.decimal_values;
+    } else {
+        return std::vector<std::string_view>(plan.byte_values.begin(), plan.byte_values.end());
+    }
+}
+
+template <typename V>
+class Matcher {
+public:
+    Matcher(PredicateOp op, std::vector<V> values) : op_(op), values_(std::move(values)) {
+        if (op_ == PREDICATE_IN) {
+            std::sort(values_.begin(), values_.end());
+            values_.erase(std::unique(values_.begin(), values_.end()), values_.end());
+        }
+    }
+
+    PredicateOp op() const { return op_; }
+
+    // Exact test for a non-null value
+    bool test(const V& v) const {
+        switch (op_) {
+            case PREDICATE_EQ: return v == values_[0];
+            case PREDICATE_NE: return v != values_[0];
+            case PREDICATE_LT: return v < values_[0];
+            case PREDICATE_LE: return v <= values_[0];
+            case PREDICATE_GT: return v > values_[0];
+            case PREDICATE_GE: return v >= values_[0];
+            case PREDICATE_BETWEEN: return v >= values_[0] && v <= values_[1];
+            case PREDICATE_IN: return std::binary_search(values_.begin(), values_.end(), v);
+            case PREDICATE_IS_NOT_NULL: return true;
+            default: return false;
+        }
+    }
+
+    // Whether any non-null value in [min, max] could pass
+    bool may_match(const V& min, const V& max) const {
+        switch (op_) {
+            case PREDICATE_EQ: return values_[0] >= min && values_[0] <= max;
+            case PREDICATE_NE: return !(min == max && min == values_[0]);
+            case PREDICATE_LT: return min < values_[0];
+            case PREDICATE_LE: return min <= values_[0];
+            case PREDICATE_GT: return max > values_[0];
+            case PREDICATE_GE: return max >= values_[0];
+            case PREDICATE_BETWEEN: return max >= values_[0] && min <= values_[1];
+            case PREDICATE_IN: {
+                auto it = std::lower_bound(values_.begin(), values_.end(), min);
+                return it != values_.end() && *it <= max;
+            }
+            case PREDICATE_IS_NOT_NULL: return true;
+            default: return false;
+        }
+    }
+
+    const std::vector<V>& values() const { return values_; }
+
+private:
+    PredicateOp op_;
+    std::vector<V> values_;
+};
+
+// Decodes a PLAIN-encoded statistic (min/max) into the comparison domain
+template <typename V>
+bool decode_statistic(const std::string& encoded, parquet::Type::type physical, V* out) {
+    if constexpr (std::is_same_v<V, std::string_view>) {
+        *out = std::string_view(encoded);
+        return true;
+    } else if constexpr (std::is_same_v<V, arrow::Decimal128>) {
+        return decode_decimal(reinterpret_cast<const uint8_t*>(encoded.data()),
+                              static_cast<int32_t>(encoded.size()), out);
+    } else if constexpr (std::is_same_v<V, double>) {
+        if (physical == parquet::Type::FLOAT && encoded.size() == sizeof(float)) {
+            float value;
+            std::memcpy(&value, encoded.data(), sizeof(value));
+            *out = value;
+            return !std::isnan(value);
+        }
+        if (physical == parquet::Type::DOUBLE && encoded.size() == sizeof(double)) {
+            std::memcpy(out, encoded.data(), sizeof(double));
+            return !std::isnan(*out);
+        }
+        return false;
+    } else {
+        if (physical == parquet::Type::BOOLEAN && encoded.size() == 1) {
+            *out = static_cast<V>(encoded[0] != 0);
+            return true;
+        }
+        if (physical == parquet::Type::INT32 && encoded.size() == sizeof(int32_t)) {
+            int32_t value;
+            std::memcpy(&value, encoded.data(), sizeof(value));
+            *out = std::is_same_v<V, uint64_t> ? static_cast<V>(static_cast<uint32_t>(value))
+                                               : static_cast<V>(value);
+            return true;
+        }
+        if (physical == parquet::Type::INT64 && encoded.size() == sizeof(int64_t)) {
+            int64_t value;
+            std::memcpy(&value, encoded.data(), sizeof(value));
+            *out = static_cast<V>(value);
+            return true;
+        }
+        return false;
+    }
+}
+
+// Widens a decoded physical value into the comparison domain; type_length
+// is the width of a FIXED_LEN_BYTE_ARRAY value
+template <typename V, typename T>
+V widen(const T& value, int type_length) {
+    if constexpr (std::is_same_v<V, arrow::Decimal128>) {
+        arrow::Decimal128 decimal;
+        if constexpr (std::is_same_v<T, parquet::ByteArray>) {
+            decode_decimal(value.ptr, static_cast<int32_t>(value.len), &decimal);
+        } else if constexpr (std::is_same_v<T, parquet::FixedLenByteArray>) {
+            decode_decimal(value.ptr, type_length, &decimal);
+        }
+        return decimal;
+    } else if constexpr (std::is_same_v<T, parquet::ByteArray>) {
+        return std::string_view(reinterpret_cast<const char*>(value.ptr), value.len);
+    } else if constexpr (std::is_same_v<V, uint64_t> && std::is_same_v<T, int32_t>) {
+        return static_cast<uint32_t>(value);
+    } else {
+        return static_cast<V>(value);
+    }
+}
+
+// MARK: - Row ranges
+
+// Row-group-local half-open row range
+struct RowRange {
+    int64_t begin;
+    int64_t end;
+};
+using RowRanges = std::vector<RowRange>;
+
+void add_range(RowRanges& ranges, int64_t begin, int64_t end) {
+    if (begin >= end) {
+        return;
+    }
+    if (!ranges.empty() && ranges.back().end >= begin) {
+        ranges.back().end = std::max(ranges.back().end, end);
+    } else {
+        ranges.push_back({begin, end});
+    }
+}
+
+RowRanges intersect_ranges(const RowRanges& a, const RowRanges& b) {
+    RowRanges result;
+    size_t i = 0, j = 0;
+    while (i < a.size() && j < b.size()) {
+        add_range(result, std::max(a[i].begin, b[j].begin), std::min(a[i].end, b[j].end));
+        if (a[i].end < b[j].end) {
+            i++;
+        } else {
+            j++;
+        }
+    }
+    return result;
+}
+
+// Candidate rows of a row group, one bit per row
+class Selection {
+public:
+    Selection(int64_t rows, const RowRanges& ranges) : words_((rows + 63) / 64, 0) {
+        for (const auto& range : ranges) {
+            for (int64_t row = range.begin; row < range.end; row++) {
+                words_[row >> 6] |= uint64_t(1) << (row & 63);
+            }
+        }
+    }
+
+    bool test(int64_t row) const { return (words_[row >> 6] >> (row & 63)) & 1; }
+    void clear(int64_t row) { words_[row >> 6] &= ~(uint64_t(1) << (row & 63)); }
+
+    RowRanges ranges() const {
+        RowRanges result;
+        for (size_t word = 0; word < words_.size(); word++) {
+            uint64_t bits = words_[word];
+            while (bits) {
+                int64_t row = static_cast<int64_t>(word * 64 + __builtin_ctzll(bits));
+                bits &= bits - 1;
+                add_range(result, row, row + 1);
+            }
+        }
+        return result;
+    }
+
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (size_t word = 0; word < words_.size(); word++) {
+            uint64_t bits = words_[word];
+            while (bits) {
+                fn(static_cast<int64_t>(word * 64 + __builtin_ctzll(bits)));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+private:
+    std::vector<uint64_t> words_;
+};
+
+// MARK: - Pruning
+
+template <typename V>
+bool row_group_may_match(const Matcher<V>& matcher, const PredicatePlan& plan,
+                         const parquet::ColumnChunkMetaData& chunk) {
+    if (!chunk.is_stats_set()) {
+        return true;
+    }
+    auto stats = chunk.encoded_statistics();
+    if (!stats) {
+        return true;
+    }
+
+    bool all_null = stats->has_null_count && stats->null_count >= chunk.num_values();
+    if (matcher.op() == PREDICATE_IS_NULL) {
+        return !stats->has_null_count || stats->null_count > 0;
+    }
+    if (all_null) {
+        return false;
+    }
+    if (!stats->has_min || !stats->has_max) {
+        return true;
+    }
+
+    V min, max;
+    if (!decode_statistic(stats->min(), plan.descr->physical_type(), &min) ||
+        !decode_statistic(stats->max(), plan.descr->physical_type(), &max)) {
+        return true;
+    }
+    return matcher.may_match(min, max);
+}
+
+// Rows of the pages whose column index statistics allow a match
+template <typename V>
+RowRanges page_candidates(const Matcher<V>& matcher, const PredicatePlan& plan,
+                          const parquet::ColumnIndex& column_index,
+                          const parquet::OffsetIndex& offset_index, int64_t rg_rows) {
+    const auto& pages = offset_index.page_locations();
+    const auto& null_pages = column_index.null_pages();
+    const auto& mins = column_index.encoded_min_values();
+    const auto& maxes = column_index.encoded_max_values();
+
+    RowRanges ranges;
+    for (size_t i = 0; i < pages.size(); i++) {
+        int64_t begin = pages[i].first_row_index;
+        int64_t end = i + 1 < pages.size() ? pages[i + 1].first_row_index : rg_rows;
+
+        bool may_match = true;
+        if (i < null_pages.size()) {
+            if (matcher.op() == PREDICATE_IS_NULL) {
+                may_match = null_pages[i] || !column_index.has_null_counts() ||
+                            column_index.null_counts()[i] > 0;
+            } else if (null_pages[i]) {
+                may_match = false;
+            } else if (i < mins.size() && i < maxes.size()) {
+                V min, max;
+                if (decode_statistic(mins[i], plan.descr->physical_type(), &min) &&
+                    decode_statistic(maxes[i], plan.descr->physical_type(), &max)) {
+                    may_match = matcher.may_match(min, max);
+                }
+            }
+        }
+        if (may_match) {
+            add_range(ranges, begin, end);
+        }
+    }
+    return ranges;
+}
+
+// Whether a bloom filter may hold value, hashed as the column stores it.
+// Values the physical type cannot represent are definitely absent.
+template <typename V>
+bool bloom_may_contain(const parquet::BloomFilter& filter, const parquet::ColumnDescriptor& descr, const V& value) {
+    parquet::Type::type physical = descr.physical_type();
+    if constexpr (std::is_same_v<V, arrow::Decimal128>) {
+        // BYTE_ARRAY decimals may be written at any length, so only the
+        // fixed width is hashed; the dropped leading bytes must be the sign
+        if (physical != parquet::Type::FIXED_LEN_BYTE_ARRAY) {
+            return true;
+        }
+        auto little_endian = value.ToBytes();
+        uint8_t big_endian[16];
+        std::reverse_copy(little_endian.begin(), little_endian.end(), big_endian);
+        int width = descr.type_length();
+        uint8_t sign = value.IsNegative() ? 0xFF : 0x00;
+        for (int i = 0; i < 16 - width; i++) {
+            if (big_endian[i] != sign) {
+                return false;
+            }
+        }
+        if (width < 16 && ((big_endian[16 - width] & 0x80) != 0) != value.IsNegative()) {
+            return false;
+        }
+        parquet::FixedLenByteArray bytes(big_endian + 16 - width);
+        return filter.FindHash(filter.Hash(&bytes, static_cast<uint32_t>(width)));
+    } else if constexpr (std::is_same_v<V, std::string_view>) {
+        parquet::ByteArray bytes(static_cast<uint32_t>(value.size()),
+                                 reinterpret_cast<const uint8_t*>(value.data()));
+        return filter.FindHash(filter.Hash(&bytes));
+    } else if constexpr (std::is_same_v<V, double>) {
+        // -0.0 equals 0.0 but hashes differently; NaN never equals anything
+        if (value == 0 || std::isnan(value)) {
+            return value == 0;
+        }
+        if (physical == parquet::Type::FLOAT) {
+            float narrowed = static_cast<float>(value);
+            return narrowed == value && filter.FindHash(filter.Hash(narrowed));
+        }
+        return filter.FindHash(filter.Hash(value));
+    } else {
+        if (physical == parquet::Type::INT32) {
+            if (std::is_same_v<V, uint64_t> ? value > UINT32_MAX
+                                            : (static_cast<int64_t>(value) < INT32_MIN ||
+                                               static_cast<int64_t>(value) > INT32_MAX)) {
+                return false;
+            }
+            return filter.FindHash(filter.Hash(static_cast<int32_t>(value)));
+        }
+        if (physical == parquet::Type::INT64) {
+            return filter.FindHash(filter.Hash(static_cast<int64_t>(value)));
+        }
+        return true;
+    }
+}
+
+// Equality and IN can rule out a row group when none of their values is in
+// the column chunk's bloom filter; min/max cannot for high-cardinality keys
+template <typename V>
+bool bloom_may_match(const Matcher<V>& matcher, const PredicatePlan& plan,
+                     const parquet::BloomFilter& filter) {
+    if (matcher.op() != PREDICATE_EQ && matcher.op() != PREDICATE_IN) {
+        return true;
+    }
+    for (const auto& value : matcher.values()) {
+        if (bloom_may_contain(filter, *plan.descr, value)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// MARK: - Exact evaluation
+
+struct RowGroupResult {
+    parqview::RowBitmap rows;
+    bool read = false;
+    long long pages_read = 0;
+    long long pages_skipped = 0;
+    bool bloom_skipped = false;
+    bool ok = true;
+};
+
+// Decodes only the pages of the predicate column that overlap the current
+// candidates, clearing rows that fail the predicate
+template <typename DType, typename V>
+void evaluate_column(parquet::RowGroupReader& rg_reader, const PredicatePlan& plan,
+                     const Matcher<V>& matcher, const parquet::OffsetIndex* offset_index,
+                     int64_t rg_rows, Selection& selection, RowGroupResult& result) {
+    using T = typename DType::c_type;
+    RowRanges candidates = selection.ranges();
+
+    // Row spans of the pages that will be decoded, in order
+    RowRanges decoded_spans;
+    std::vector<bool> keep_page;
+    if (offset_index) {
+        const auto& pages = offset_index->page_locations();
+        size_t c = 0;
+        for (size_t i = 0; i < pages.size(); i++) {
+            int64_t begin = pages[i].first_row_index;
+            int64_t end = i + 1 < pages.size() ? pages[i + 1].first_row_index : rg_rows;
+            while (c < candidates.size() && candidates[c].end <= begin) {
+                c++;
+            }
+            bool keep = c < candidates.size() && candidates[c].begin < end;
+            keep_page.push_back(keep);
+            if (keep) {
+                decoded_spans.push_back({begin, end});
+            }
+        }
+    } else {
+        decoded_spans.push_back({0, rg_rows});
+    }
+
+    auto pager = rg_reader.GetColumnPageReader(plan.leaf);
+    size_t page_ordinal = 0;
+    pager->set_data_page_filter([&](const parquet::DataPageStats&) {
+        bool keep = !offset_index || (page_ordinal < keep_page.size() && keep_page[page_ordinal]);
+        page_ordinal++;
+        if (keep) {
+            result.pages_read++;
+        } else {
+            result.pages_skipped++;
+        }
+        return !keep;
+    });
+
+    auto column_reader = parquet::ColumnReader::Make(plan.descr, std::move(pager));
+    auto* typed = static_cast<parquet::TypedColumnReader<DType>*>(column_reader.get());
+
+    const int16_t max_def = plan.descr->max_definition_level();
+    constexpr int64_t kBatch = 4096;
+    // Not std::vector: vector<bool> has no contiguous storage for BOOLEAN
+    std::unique_ptr<T[]> values(new T[kBatch]);
+    std::vector<int16_t> def_levels(kBatch);
+
+    size_t span = 0;
+    int64_t row = decoded_spans.empty() ? rg_rows : decoded_spans[0].begin;
+    while (typed->HasNext() && span < decoded_spans.size()) {
+        int64_t values_read = 0;
+        int64_t levels_read = typed->ReadBatch(kBatch, max_def > 0 ? def_levels.data() : nullptr,
+                                               nullptr, values.get(), &values_read);
+        if (levels_read <= 0) {
+            break;
+        }
+
+        int64_t value_index = 0;
+        for (int64_t level = 0; level < levels_read; level++) {
+            // Consecutive decoded pages may not be adjacent rows
+            while (span < decoded_spans.size() && row >= decoded_spans[span].end) {
+                span++;
+                if (span < decoded_spans.size()) {
+                    row = decoded_spans[span].begin;
+                }
+            }
+            if (span >= decoded_spans.size()) {
+                break;
+            }
+
+            bool is_null = max_def > 0 && def_levels[level] < max_def;
+            if (selection.test(row)) {
+                bool pass;
+                if (is_null) {
+                    pass = matcher.op() == PREDICATE_IS_NULL;
+                } else {
+                    pass = matcher.op() != PREDICATE_IS_NULL &&
+                           matcher.test(widen<V>(values[value_index], plan.descr->type_length()));
+                }
+                if (!pass) {
+                    selection.clear(row);
+                }
+            }
+            if (!is_null) {
+                value_index++;
+            }
+            row++;
+        }
+    }
+}
+
+template <typename V>
+bool evaluate_plan(parquet::RowGroupReader& rg_reader, const PredicatePlan& plan,
+                   const Matcher<V>& matcher, const parquet::OffsetIndex* offset_index,
+                   int64_t rg_rows, Selection& selection, RowGroupResult& result) {
+    switch (plan.descr->physical_type()) {
+        case parquet::Type::BOOLEAN:
+            if constexpr (std::is_same_v<V, int64_t>) {
+                evaluate_column<parquet::BooleanType, V>(rg_reader, plan, matcher, offset_index, rg_rows, selection, result);
+                return true;
+            }
+            break;
+        case parquet::Type::INT32:
+            if constexpr (std::is_integral_v<V>) {
+                evaluate_column<parquet::Int32Type, V>(rg_reader, plan, matcher, offset_index, rg_rows, selection, result);
+                return true;
+            }
+            break;
+        case parquet::Type::INT64:
+            if constexpr (std::is_integral_v<V>) {
+                evaluate_column<parquet::Int64Type, V>(rg_reader, plan, matcher, offset_index, rg_rows, selection, result);
+                return true;
+            }
+            break;
+        case parquet::Type::FLOAT:
+            if constexpr (std::is_same_v<V, double>) {
+                evaluate_column<parquet::FloatType, V>(rg_reader, plan, matcher, offset_index, rg_rows, selection, result);
+                return true;
+            }
+            break;
+        case parquet::Type::DOUBLE:
+            if constexpr (std::is_same_v<V, double>) {
+                evaluate_column<parquet::DoubleType, V>(rg_reader, plan, matcher, offset_index, rg_rows, selection, result);
+                return true;
+            }
+            break;
+        case parquet::Type::BYTE_ARRAY:
+            if constexpr (std::is_same_v<V, std::string_view> || std::is_same_v<V, arrow::Decimal128>) {
+                evaluate_column<parquet::ByteArrayType, V>(rg_reader, plan, matcher, offset_index, rg_rows, selection, result);
+                return true;
+            }
+            break;
+        case parquet::Type::FIXED_LEN_BYTE_ARRAY:
+            if constexpr (std::is_same_v<V, arrow::Decimal128>) {
+                evaluate_column<parquet::FLBAType, V>(rg_reader, plan, matcher, offset_index, rg_rows, selection, result);
+                return true;
+            }
+            break;
+        default:
+            break;
+    }
+    return false;
+}
+
+// Type-erased per-predicate operations, so a row group can walk a mixed list
+class PlanEvaluator {
+public:
+    virtual ~PlanEvaluator() = default;
+    virtual bool row_group_may_match(const parquet::ColumnChunkMetaData& chunk) const = 0;
+    virtual bool bloom_may_match(const parquet::BloomFilter& filter) const = 0;
+    virtual RowRanges page_candidates(const parquet::ColumnIndex& column_index,
+                                      const parquet::OffsetIndex& offset_index,
+                                      int64_t rg_rows) const = 0;
+    virtual bool evaluate(parquet::RowGroupReader& rg_reader,
+                          const parquet::OffsetIndex* offset_index, int64_t rg_rows,
+                          Selection& selection, RowGroupResult& result) const = 0;
+    virtual const PredicatePlan& plan() const = 0;
+};
+
+template <typename V>
+class TypedPlanEvaluator : public PlanEvaluator {
+public:
+    explicit TypedPlanEvaluator(PredicatePlan plan)
+        : plan_(std::move(plan)), matcher_(plan_.op, operands_of<V>(plan_)) {}
+
+    bool row_group_may_match(const parquet::ColumnChunkMetaData& chunk) const override {
+        return ::row_group_may_match(matcher_, plan_, chunk);
+    }
+
+    bool bloom_may_match(const parquet::BloomFilter& filter) const override {
+        return ::bloom_may_match(matcher_, plan_, filter);
+    }
+
+    RowRanges page_candidates(const parquet::ColumnIndex& column_index,
+                              const parquet::OffsetIndex& offset_index,
+                              int64_t rg_rows) const override {
+        return ::page_candidates(matcher_, plan_, column_index, offset_index, rg_rows);
+    }
+
+    bool evaluate(parquet::RowGroupReader& rg_reader, const parquet::OffsetIndex* offset_index,
+                  int64_t rg_rows, Selection& selection, RowGroupResult& result) const override {
+        return evaluate_plan(rg_reader, plan_, matcher_, offset_index, rg_rows, selection, result);
+    }
+
+    const PredicatePlan& plan() const override { return plan_; }
+
+private:
+    PredicatePlan plan_;
+    Matcher<V> matcher_;
+};
+
+std::unique_ptr<PlanEvaluator> make_evaluator(PredicatePlan plan) {
+    switch (plan.domain) {
+        case Domain::Signed:
+            return std::make_unique<TypedPlanEvaluator<int64_t>>(std::move(plan));
+        case Domain::Unsigned:
+            return std::make_unique<TypedPlanEvaluator<uint64_t>>(std::move(plan));
+        case Domain::Floating:
+            return std::make_unique<TypedPlanEvaluator<double>>(std::move(plan));
+        case Domain::Bytes:
+            return std::make_unique<TypedPlanEvaluator<std::string_view>>(std::move(plan));
+        case Domain::Decimal:
+            return std::make_unique<TypedPlanEvaluator<arrow::Decimal128>>(std::move(plan));
+    }
+    return nullptr;
+}
+
+using Evaluators = std::vector<std::unique_ptr<PlanEvaluator>>;
+
+RowGroupResult scan_row_group(parquet::ParquetFileReader& file, const Evaluators& evaluators,
+                              int row_group, int64_t first_row) {
+    RowGroupResult result;
+    auto rg_metadata = file.metadata()->RowGroup(row_group);
+    int64_t rg_rows = rg_metadata->num_rows();
+    if (rg_rows == 0) {
+        return result;
+    }
+
+    // Footer statistics: rule out the whole row group without touching pages
+    for (const auto& evaluator : evaluators) {
+        if (!evaluator->row_group_may_match(*rg_metadata->ColumnChunk(evaluator->plan().leaf))) {
+            return result;
+        }
+    }
+
+    // Bloom filters: point lookups on keys whose min/max span everything
+    std::shared_ptr<parquet::RowGroupBloomFilterReader> rg_blooms;
+    for (const auto& evaluator : evaluators) {
+        PredicateOp op = evaluator->plan().op;
+        if (op != PREDICATE_EQ && op != PREDICATE_IN) {
+            continue;
+        }
+        if (!rg_blooms) {
+            rg_blooms = file.GetBloomFilterReader().RowGroup(row_group);
+        }
+        auto filter = rg_blooms ? rg_blooms->GetColumnBloomFilter(evaluator->plan().leaf) : nullptr;
+        if (filter && !evaluator->bloom_may_match(*filter)) {
+            result.bloom_skipped = true;
+            return result;
+        }
+    }
+
+    // Page index: narrow to the rows of pages that may match every predicate
+    RowRanges candidates{{0, rg_rows}};
+    std::vector<std::shared_ptr<parquet::OffsetIndex>> offset_indexes(evaluators.size());
+    auto page_index = file.GetPageIndexReader();
+    auto rg_page_index = page_index ? page_index->RowGroup(row_group) : nullptr;
+    if (rg_page_index) {
+        for (size_t p = 0; p < evaluators.size(); p++) {
+            int leaf = evaluators[p]->plan().leaf;
+            auto column_index = rg_page_index->GetColumnIndex(leaf);
+            offset_indexes[p] = rg_page_index->GetOffsetIndex(leaf);
+            if (column_index && offset_indexes[p]) {
+                candidates = intersect_ranges(
+                    candidates, evaluators[p]->page_candidates(*column_index, *offset_indexes[p], rg_rows));
+            }
+        }
+    }
+    if (candidates.empty()) {
+        return result;
+    }
+
+    // Exact evaluation, one predicate column at a time. Each column only
+    // decodes pages overlapping rows that survived the previous ones.
+    Selection selection(rg_rows, candidates);
+    auto rg_reader = file.RowGroup(row_group);
+    result.read = true;
+    for (size_t p = 0; p < evaluators.size(); p++) {
+        if (!evaluators[p]->evaluate(*rg_reader, offset_indexes[p].get(), rg_rows, selection, result)) {
+            result.ok = false;
+            return result;
+        }
+    }
+
+    parqview::RowBitmap::Builder builder;
+    selection.for_each([&](int64_t row) { builder.add(static_cast<uint64_t>(first_row + row)); });
+    result.rows = builder.finish();
+    return result;
+}
+
+std::string predicate_cache_key(const std::string& fingerprint, const Evaluators& evaluators) {
+    std::string key = fingerprint;
+    key += std::string("\0predicate", 10);
+    for (const auto& evaluator : evaluators) {
+        const auto& plan = evaluator->plan();
+        key += '\0';
+        key += std::to_string(plan.field_index);
+        key += ':';
+        key += std::to_string(static_cast<int>(plan.op));
+        for (auto value : plan.signed_values) {
+            key += '\x1f' + std::to_string(value);
+        }
+        for (auto value : plan.unsigned_values) {
+            key += '\x1f' + std::to_string(value);
+        }
+        for (auto value : plan.float_values) {
+            char buffer[32];
+            snprintf(buffer, sizeof(buffer), "%.17g", value);
+            key += '\x1f';
+            key += buffer;
+        }
+        for (const auto& value : plan.byte_values) {
+            key += '\x1f' + value;
+        }
+        for (const auto& value : plan.decimal_values) {
+            key += '\x1f' + value.ToIntegerString();
+        }
+    }
+    return key;
+}
+
+// Stats of the scans behind the predicate bitmaps in the row bitmap cache,
+// so a cached hit reports what its scan read and skipped. Keys carry the
+// file fingerprint, so an entry that outlives its bitmap is never wrong,
+// only unused; the map is emptied whenever it reaches kScanStatsLimit.
+constexpr size_t kScanStatsLimit = 4096;
+std::mutex scan_stats_mutex;
+std::unordered_map<std::string, PredicateScanStats> scan_stats;
+
+} // namespace
+
+namespace parqview {
+
+std::shared_ptr<const RowBitmap> match_predicates(const char* file_path, parquet::arrow::FileReader& reader,
+                                                  const ColumnPredicate* predicates, int predicate_count,
+                                                  PredicateScanStats* stats) {
+    auto metadata = reader.parquet_reader()->metadata();
+    int num_row_groups = metadata->num_row_groups();
+
+    if (stats) {
+        *stats = PredicateScanStats{num_row_groups, 0, 0, 0, 0};
+    }
+
+    Evaluators evaluators;
+    for (int i = 0; i < predicate_count; i++) {
+        PredicatePlan plan;
+        if (!resolve_predicate(reader, predicates[i], &plan)) {
+            return nullptr;
+        }
+        evaluators.push_back(make_evaluator(std::move(plan)));
+    }
+
+    std::string fingerprint = file_fingerprint(file_path);
+    std::string key = predicate_cache_key(fingerprint, evaluators);
+    auto bitmap = fingerprint.empty() ? nullptr : row_bitmap_cache().find(key);
+    if (bitmap) {
+        if (stats) {
+            std::lock_guard<std::mutex> lock(scan_stats_mutex);
+            auto it = scan_stats.find(key);
+            if (it != scan_stats.end()) {
+                *stats = it->second;
+            }
+        }
+        return bitmap;
+    }
+
+    auto offsets = row_group_offsets(*metadata);
+    std::vector<RowGroupResult> results(num_row_groups);
+    parallel_for(num_row_groups, [&](int rg) {
+        try {
+            auto file = open_parquet_file(file_path, metadata);
+            if (!file) {
+                results[rg].ok = false;
+                return;
+            }
+            results[rg] = scan_row_group(*file, evaluators, rg, offsets[rg]);
+        } catch (const std::exception& e) {
+            std::cerr << "Error scanning row group " << rg << ": " << e.what() << std::endl;
+            results[rg].ok = false;
+        }
+    });
+
+    auto merged = std::make_shared<RowBitmap>();
+    PredicateScanStats scanned{num_row_groups, 0, 0, 0, 0};
+    for (auto& result : results) {
+        if (!result.ok) {
+            return nullptr;
+        }
+        scanned.row_groups_read += result.read ? 1 : 0;
+        scanned.row_groups_bloom_skipped += result.bloom_skipped ? 1 : 0;
+        scanned.pages_read += result.pages_read;
+        scanned.pages_skipped += result.pages_skipped;
+        merged->append(std::move(result.rows));
+    }
+    if (stats) {
+        *stats = scanned;
+    }
+    if (!fingerprint.empty()) {
+        row_bitmap_cache().insert(key, merged);
+        std::lock_guard<std::mutex> lock(scan_stats_mutex);
+        if (scan_stats.size() >= kScanStatsLimit) {
+            scan_stats.clear();
+        }
+        scan_stats[key] = scanned;
+    }
+    return merged;
+}
+
+} // namespace parqview
+
+extern "C" {
+
+TableData* read_parquet_predicate_page(const char* file_path,
+                                       const ColumnPredicate* predicates, int predicate_count,
+                                       long long offset, int limit, int max_cell_bytes,
+                                       long long* total_matches, PredicateScanStats* stats,
+                                       long long* row_numbers) {
+    try {
+        auto reader_ptr = get_cached_reader(file_path);
+        if (!reader_ptr || !(*reader_ptr)) {
+            return nullptr;
+        }
+        auto& reader = *reader_ptr;
+
+        // No predicates: every row matches
+        if (predicate_count <= 0) {
+            int num_row_groups = reader->parquet_reader()->metadata()->num_row_groups();
+            if (stats) {
+                *stats = PredicateScanStats{num_row_groups, 0, 0, 0, 0};
+            }
+            if (total_matches) {
+                *total_matches = reader->parquet_reader()->metadata()->num_rows();
+            }
+            auto* data = read_parquet_page(file_path, offset, limit, max_cell_bytes);
+            parqview::copy_row_numbers(data, {}, offset, row_numbers);
+            return data;
+        }
+
+        auto bitmap = parqview::match_predicates(file_path, *reader, predicates, predicate_count, stats);
+        if (!bitmap) {
+            return nullptr;
+        }
+
+        if (total_matches) {
+            *total_matches = static_cast<long long>(bitmap->cardinality());
+        }
+
+        std::vector<int64_t> rows;
+        if (offset >= 0 && limit > 0) {
+            std::vector<uint64_t> selected;
+            bitmap->select_range(static_cast<uint64_t>(offset), static_cast<uint64_t>(limit), selected);
+            rows.assign(selected.begin(), selected.end());
+        }
+        auto* data = parqview::take_rows(file_path, reader->parquet_reader()->metadata(), rows, {}, max_cell_bytes);
+        parqview::copy_row_numbers(data, rows, 0, row_numbers);
+        return data;
+    } catch (const std::exception& e) {
+        std::cerr << "Error evaluating predicates: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+} // extern "C"
@@ -0,0 +1,474 @@
+#include "../include/ParquetProfile.h"
+#include "ReaderInternal.h"
+#include "TDigest.h"
+#include <parquet/column_reader.h>
+#include <parquet/statistics.h>
+#include <parquet/types.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+constexpr int64_t kBatch = 8192;
+
+// A numeric or temporal column, with how to turn its physical values into
+// doubles in the column's own units
+struct ProfileColumn {
+    int field_index;
+    int leaf;
+    parquet::Type::type physical;
+    bool is_unsigned = false;
+    double divisor = 1;  // 10^scale for decimals
+    std::shared_ptr<arrow::DataType> type;
+
+    double to_double(int32_t value) const {
+        return (is_unsigned ? static_cast<double>(static_cast<uint32_t>(value)) : value) / divisor;
+    }
+    double to_double(int64_t value) const {
+        return (is_unsigned ? static_cast<double>(static_cast<uint64_t>(value)) : static_cast<double>(value)) /
+               divisor;
+    }
+    double to_double(float value) const { return value; }
+    double to_double(double value) const { return value; }
+};
+
+// Quantile sketch plus histogram of one column, mergeable across row groups
+struct Sketch {
+    parqview::TDigest digest;
+    long long count = 0;
+    // Equal-width bins over [lo, hi], sized from the footer before the scan.
+    // Empty when the footer had no range.
+    std::vector<long long> bins;
+    double lo = 0;
+    double hi = 0;
+
+    void add(double value) {
+        if (std::isnan(value)) {
+            return;
+        }
+        digest.add(value);
+        count++;
+        if (!bins.empty()) {
+            int last = static_cast<int>(bins.size()) - 1;
+            int bin = hi > lo ? static_cast<int>((value - lo) / (hi - lo) * bins.size()) : 0;
+            bins[std::min(last, std::max(0, bin))]++;
+        }
+    }
+
+    void merge(const Sketch& other) {
+        digest.merge(other.digest);
+        count += other.count;
+        for (size_t i = 0; i < bins.size() && i < other.bins.size(); i++) {
+            bins[i] += other.bins[i];
+        }
+    }
+};
+
+std::mutex profile_mutex;
+std::unordered_map<std::string, std::shared_ptr<const Sketch>> profile_cache;
+
+// MARK: - Columns
+
+// Resolves a top-level field to a profile column. False for nested,
+// non-numeric and INT96 / byte-array backed columns.
+bool resolve_column(const parquet::arrow::FileReader& reader, int field_index, ProfileColumn* column) {
+    const auto& manifest = reader.manifest();
+    const auto& field = manifest.schema_fields[field_index];
+    if (!field.is_leaf()) {
+        return false;
+    }
+    const auto* descr = manifest.descr->Column(field.column_index);
+    if (descr->max_repetition_level() > 0) {
+        return false;
+    }
+
+    column->field_index = field_index;
+    column->leaf = field.column_index;
+    column->physical = descr->physical_type();
+    column->type = field.field->type();
+
+    switch (column->physical) {
+        case parquet::Type::INT32:
+        case parquet::Type::INT64:
+        case parquet::Type::FLOAT:
+        case parquet::Type::DOUBLE:
+            break;
+        default:
+            return false;
+    }
+
+    const auto& logical = descr->logical_type();
+    if (logical && logical->is_int()) {
+        column->is_unsigned = !static_cast<const parquet::IntLogicalType&>(*logical).is_signed();
+    }
+    if (logical && logical->is_decimal()) {
+        column->divisor = std::pow(10.0, static_cast<const parquet::DecimalLogicalType&>(*logical).scale());
+    }
+
+    switch (column->type->id()) {
+        case arrow::Type::INT8: case arrow::Type::INT16: case arrow::Type::INT32: case arrow::Type::INT64:
+        case arrow::Type::UINT8: case arrow::Type::UINT16: case arrow::Type::UINT32: case arrow::Type::UINT64:
+        case arrow::Type::FLOAT: case arrow::Type::DOUBLE: case arrow::Type::DECIMAL128:
+        case arrow::Type::DATE32: case arrow::Type::DATE64: case arrow::Type::TIME32: case arrow::Type::TIME64:
+        case arrow::Type::TIMESTAMP: case arrow::Type::DURATION:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Value range from the footer statistics, when every row group has one
+bool footer_range(const parquet::FileMetaData& metadata, const ProfileColumn& column, double* lo, double* hi) {
+    bool found = false;
+    for (int rg = 0; rg < metadata.num_row_groups(); rg++) {
+        auto chunk = metadata.RowGroup(rg)->ColumnChunk(column.leaf);
+        auto stats = chunk->is_stats_set() ? chunk->statistics() : nullptr;
+        if (!stats) {
+            return false;
+        }
+        if (!stats->HasMinMax()) {
+            // An all-null chunk has no range and adds nothing to the file's
+            if (stats->HasNullCount() && stats->null_count() == chunk->num_values()) {
+                continue;
+            }
+            return false;
+        }
+
+        double min = 0;
+        double max = 0;
+        switch (column.physical) {
+            case parquet::Type::INT32: {
+                const auto& typed = static_cast<const parquet::Int32Statistics&>(*stats);
+                min = column.to_double(typed.min());
+                max = column.to_double(typed.max());
+                break;
+            }
+            case parquet::Type::INT64: {
+                const auto& typed = static_cast<const parquet::Int64Statistics&>(*stats);
+                min = column.to_double(typed.min());
+                max = column.to_double(typed.max());
+                break;
+            }
+            case parquet::Type::FLOAT: {
+                const auto& typed = static_cast<const parquet::FloatStatistics&>(*stats);
+                min = typed.min();
+                max = typed.max();
+                break;
+            }
+            case parquet::Type::DOUBLE: {
+                const auto& typed = static_cast<const parquet::DoubleStatistics&>(*stats);
+                min = typed.min();
+                max = typed.max();
+                break;
+            }
+            default:
+                return false;
+        }
+        if (std::isnan(min) || std::isnan(max)) {
+            return false;
+        }
+        *lo = found ? std::min(*lo, min) : min;
+        *hi = found ? std::max(*hi, max) : max;
+        found = true;
+    }
+    return found;
+}
+
+// MARK: - Scanning
+
+template <typename DType>
+void scan_chunk(parquet::ParquetFileReader& file, int rg, const ProfileColumn& column, Sketch& sketch) {
+    using T = typename DType::c_type;
+
+    auto reader = file.RowGroup(rg)->Column(column.leaf);
+    auto* typed = static_cast<parquet::TypedColumnReader<DType>*>(reader.get());
+    bool nullable = file.metadata()->schema()->Column(column.leaf)->max_definition_level() > 0;
+
+    std::vector<int16_t> def_levels(kBatch);
+    std::vector<T> values(kBatch);
+    while (typed->HasNext()) {
+        int64_t values_read = 0;
+        int64_t levels_read = typed->ReadBatch(kBatch, nullable ? def_levels.data() : nullptr,
+                                               nullptr, values.data(), &values_read);
+        if (levels_read <= 0) {
+            break;
+        }
+        for (int64_t i = 0; i < values_read; i++) {
+            sketch.add(column.to_double(values[i]));
+        }
+    }
+}
+
+void scan_chunk(parquet::ParquetFileReader& file, int rg, const ProfileColumn& column, Sketch& sketch) {
+    switch (column.physical) {
+        case parquet::Type::INT32:
+            return scan_chunk<parquet::Int32Type>(file, rg, column, sketch);
+        case parquet::Type::INT64:
+            return scan_chunk<parquet::Int64Type>(file, rg, column, sketch);
+        case parquet::Type::FLOAT:
+            return scan_chunk<parquet::FloatType>(file, rg, column, sketch);
+        case parquet::Type::DOUBLE:
+            return scan_chunk<parquet::DoubleType>(file, rg, column, sketch);
+        default:
+            return;
+    }
+}
+
+// MARK: - Results
+
+// Formats a value in the column's units the way the table shows the column
+std::string format_label(const ProfileColumn& column, double value) {
+    char buffer[64];
+    int64_t ticks = static_cast<int64_t>(std::llround(value));
+    std::shared_ptr<arrow::Scalar> scalar;
+    switch (column.type->id()) {
+        case arrow::Type::DATE32:
+            scalar = std::make_shared<arrow::Date32Scalar>(static_cast<int32_t>(ticks));
+            break;
+        case arrow::Type::DATE64:
+            scalar = std::make_shared<arrow::Date64Scalar>(ticks);
+            break;
+        case arrow::Type::TIME32:
+            scalar = std::make_shared<arrow::Time32Scalar>(static_cast<int32_t>(ticks), column.type);
+            break;
+        case arrow::Type::TIME64:
+            scalar = std::make_shared<arrow::Time64Scalar>(ticks, column.type);
+            break;
+        case arrow::Type::TIMESTAMP:
+            scalar = std::make_shared<arrow::TimestampScalar>(ticks, column.type);
+            break;
+        case arrow::Type::DURATION:
+            scalar = std::make_shared<arrow::DurationScalar>(ticks, column.type);
+            break;
+        case arrow::Type::FLOAT:
+        case arrow::Type::DOUBLE:
+        case arrow::Type::DECIMAL128:
+            snprintf(buffer, sizeof(buffer), "%.6g", value);
+            return buffer;
+        default:
+            // Integers: interpolated quantiles may fall between two values
+            if (std::fabs(value) < 1e15) {
+                snprintf(buffer, sizeof(buffer), "%.15g", std::round(value * 100) / 100);
+            } else {
+                snprintf(buffer, sizeof(buffer), "%.6g", value);
+            }
+            return buffer;
+    }
+    return parqview::format_scalar(*scalar);
+}
+
+void fill_profile(const ProfileColumn& column, const Sketch& sketch,
+                  const double* probabilities, int probability_count, int bin_count, ColumnProfile* out) {
+    out->supported = 1;
+    out->value_count = sketch.count;
+    bool empty = sketch.count == 0;
+    double nan = std::numeric_limits<double>::quiet_NaN();
+
+    out->min = empty ? nan : sketch.digest.min();
+    out->max = empty ? nan : sketch.digest.max();
+    out->min_label = empty ? nullptr : strdup(format_label(column, out->min).c_str());
+    out->max_label = empty ? nullptr : strdup(format_label(column, out->max).c_str());
+
+    out->quantile_count = probability_count;
+    out->quantiles = new double[std::max(probability_count, 1)];
+    out->quantile_labels = new char*[std::max(probability_count, 1)];
+    for (int i = 0; i < probability_count; i++) {
+        double value = empty ? nan : sketch.digest.quantile(probabilities[i]);
+        out->quantiles[i] = value;
+        out->quantile_labels[i] = empty ? nullptr : strdup(format_label(column, value).c_str());
+    }
+
+    out->bin_count = bin_count;
+    out->bin_edges = new double[bin_count + 1];
+    out->bin_counts = new long long[std::max(bin_count, 1)];
+    bool exact = !sketch.bins.empty();
+    double lo = exact ? sketch.lo : (empty ? 0 : out->min);
+    double hi = exact ? sketch.hi : (empty ? 0 : out->max);
+    for (int i = 0; i <= bin_count; i++) {
+        out->bin_edges[i] = lo + (hi - lo) * i / bin_count;
+    }
+    for (int i = 0; i < bin_count; i++) {
+        if (exact || empty) {
+            out->bin_counts[i] = exact ? sketch.bins[i] : 0;
+            continue;
+        }
+        // Without a range up front, each bin's share is read off the digest
+        double below = i == 0 ? 0 : sketch.digest.cdf(out->bin_edges[i]);
+        double upto = i == bin_count - 1 ? 1 : sketch.digest.cdf(out->bin_edges[i + 1]);
+        out->bin_counts[i] = std::llround((upto - below) * sketch.count);
+    }
+    out->histogram_is_estimate = exact || empty ? 0 : 1;
+}
+
+} // namespace
+
+namespace parqview {
+
+void clear_profile_cache(const char* file_path) {
+    std::lock_guard<std::mutex> lock(profile_mutex);
+    if (!file_path) {
+        profile_cache.clear();
+        return;
+    }
+    // Keys start with the file fingerprint, which starts with "path|"
+    std::string prefix = std::string(file_path) + "|";
+    for (auto it = profile_cache.begin(); it != profile_cache.end();) {
+        if (it->first.compare(0, prefix.size(), prefix) == 0) {
+            it = profile_cache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace parqview
+
+extern "C" {
+
+ProfileResult* read_parquet_profile(const char* file_path,
+                                    const int* column_indices, int column_count,
+                                    const double* probabilities, int probability_count,
+                                    int bin_count) {
+    try {
+        auto reader_ptr = get_cached_reader(file_path);
+        if (!reader_ptr || !(*reader_ptr)) {
+            return nullptr;
+        }
+        auto& reader = *reader_ptr;
+        auto metadata = reader->parquet_reader()->metadata();
+        int field_count = static_cast<int>(reader->manifest().schema_fields.size());
+        bin_count = std::max(bin_count, 1);
+        probability_count = probabilities ? std::max(probability_count, 0) : 0;
+
+        std::vector<int> fields;
+        if (column_count <= 0 || !column_indices) {
+            for (int i = 0; i < field_count; i++) {
+                fields.push_back(i);
+            }
+        } else {
+            for (int i = 0; i < column_count; i++) {
+                if (column_indices[i] < 0 || column_indices[i] >= field_count) {
+                    std::cerr << "Profile column " << column_indices[i] << " out of range" << std::endl;
+                    return nullptr;
+                }
+                fields.push_back(column_indices[i]);
+            }
+        }
+
+        // Cached sketches answer straight away; the rest share one scan
+        std::string fingerprint = parqview::file_fingerprint(file_path);
+        std::vector<ProfileColumn> columns(fields.size());
+        std::vector<bool> supported(fields.size(), false);
+        std::vector<std::shared_ptr<const Sketch>> sketches(fields.size());
+        std::vector<std::string> keys(fields.size());
+        std::vector<size_t> pending;
+        for (size_t i = 0; i < fields.size(); i++) {
+            supported[i] = resolve_column(*reader, fields[i], &columns[i]);
+            if (!supported[i]) {
+                continue;
+            }
+            keys[i] = fingerprint + "#profile#" + std::to_string(fields[i]) + "#" + std::to_string(bin_count);
+            if (!fingerprint.empty()) {
+                std::lock_guard<std::mutex> lock(profile_mutex);
+                auto it = profile_cache.find(keys[i]);
+                if (it != profile_cache.end()) {
+                    sketches[i] = it->second;
+                    continue;
+                }
+            }
+            pending.push_back(i);
+        }
+
+        if (!pending.empty()) {
+            int num_row_groups = metadata->num_row_groups();
+            std::vector<Sketch> templates(pending.size());
+            for (size_t p = 0; p < pending.size(); p++) {
+                auto& sketch = templates[p];
+                if (footer_range(*metadata, columns[pending[p]], &sketch.lo, &sketch.hi)) {
+                    sketch.bins.assign(bin_count, 0);
+                }
+            }
+
+            // One task per (row group, column), so a file with a single
+            // large row group still spreads over every core
+            int task_count = num_row_groups * static_cast<int>(pending.size());
+            std::vector<Sketch> partials(task_count);
+            std::vector<char> failed(task_count, 0);
+            parqview::parallel_for(task_count, [&](int task) {
+                int rg = task / static_cast<int>(pending.size());
+                size_t p = static_cast<size_t>(task % static_cast<int>(pending.size()));
+                try {
+                    auto file = parqview::open_parquet_file(file_path, metadata);
+                    if (!file) {
+                        failed[task] = 1;
+                        return;
+                    }
+                    partials[task] = templates[p];
+                    scan_chunk(*file, rg, columns[pending[p]], partials[task]);
+                } catch (const std::exception& e) {
+                    std::cerr << "Error profiling row group " << rg << ": " << e.what() << std::endl;
+                    failed[task] = 1;
+                }
+            });
+
+            for (size_t p = 0; p < pending.size(); p++) {
+                auto merged = std::make_shared<Sketch>(templates[p]);
+                for (int rg = 0; rg < num_row_groups; rg++) {
+                    int task = rg * static_cast<int>(pending.size()) + static_cast<int>(p);
+                    if (failed[task]) {
+                        return nullptr;
+                    }
+                    merged->merge(partials[task]);
+                }
+                size_t i = pending[p];
+                sketches[i] = merged;
+                if (!fingerprint.empty()) {
+                    std::lock_guard<std::mutex> lock(profile_mutex);
+                    profile_cache[keys[i]] = merged;
+                }
+            }
+        }
+
+        auto* result = new ProfileResult;
+        result->column_count = static_cast<int>(fields.size());
+        result->columns = new ColumnProfile[fields.size()]();
+        for (size_t i = 0; i < fields.size(); i++) {
+            auto& out = result->columns[i];
+            out.column_index = fields[i];
+            if (supported[i]) {
+                fill_profile(columns[i], *sketches[i], probabilities, probability_count, bin_count, &out);
+            }
+        }
+        return result;
+    } catch (const std::exception& e) {
+        std::cerr << "Error profiling file: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+void free_profile_result(ProfileResult* result) {
+    if (result) {
+        for (int i = 0; i < result->column_count; i++) {
+            auto& column = result->columns[i];
+            free(column.min_label);
+            free(column.max_label);
+            for (int q = 0; q < column.quantile_count; q++) {
+                free(column.quantile_labels[q]);
+            }
+            delete[] column.quantiles;
+            delete[] column.quantile_labels;
+            delete[] column.bin_edges;
+            delete[] column.bin_counts;
+        }
+        delete[] result->columns;
+        delete result;
+    }
+}
+
+} // extern "C"
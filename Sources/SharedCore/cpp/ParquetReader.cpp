@@ -1,21 +1,614 @@
 #include "../include/ParquetReader.h"
+#include "../include/ParquetNested.h"
+#include "FormatReader.h"
+#include "ReaderInternal.h"
+#include "RowBitmap.h"
 #include <arrow/api.h>
+#include <arrow/extension_type.h>
 #include <arrow/io/api.h>
 #include <arrow/compute/api.h>
 #include <parquet/arrow/reader.h>
 #include <parquet/arrow/writer.h>
 #include <parquet/metadata.h>
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <memory>
 #include <cstring>
 #include <ctime>
 #include <unordered_map>
 #include <mutex>
+#include <sys/stat.h>
 
 // Global cache for open file readers to avoid repeated file opens
 static std::unordered_map<std::string, std::unique_ptr<parquet::arrow::FileReader>> reader_cache;
 static std::mutex cache_mutex;
 
+// How binary cells are shown; see set_binary_format
+static std::atomic<int> binary_format{BINARY_FORMAT_HEX};
+static std::atomic<int> binary_preview_bytes{PARQUET_BINARY_PREVIEW_BYTES};
+
+namespace {
+
+// Both hex digits of every byte value, so each byte is a single lookup
+struct HexPairs {
+    char digits[256][2];
+
+    HexPairs() {
+        const char* hex = "0123456789abcdef";
+        for (int i = 0; i < 256; i++) {
+            digits[i][0] = hex[i >> 4];
+            digits[i][1] = hex[i & 15];
+        }
+    }
+};
+
+void write_hex(const uint8_t* data, size_t size, char* out) {
+    static const HexPairs pairs;
+    for (size_t i = 0; i < size; i++) {
+        memcpy(out + 2 * i, pairs.digits[data[i]], 2);
+    }
+}
+
+// Both base64 digits of every 12-bit value, so three bytes take two lookups
+struct Base64Pairs {
+    char digits[4096][2];
+
+    Base64Pairs() {
+        const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        for (int i = 0; i < 4096; i++) {
+            digits[i][0] = alphabet[i >> 6];
+            digits[i][1] = alphabet[i & 63];
+        }
+    }
+};
+
+size_t base64_length(size_t size) {
+    return (size + 2) / 3 * 4;
+}
+
+void write_base64(const uint8_t* data, size_t size, char* out) {
+    static const Base64Pairs pairs;
+    size_t i = 0;
+    for (; i + 3 <= size; i += 3, out += 4) {
+        uint32_t word = (uint32_t{data[i]} << 16) | (uint32_t{data[i + 1]} << 8) | data[i + 2];
+        memcpy(out, pairs.digits[word >> 12], 2);
+        memcpy(out + 2, pairs.digits[word & 0xFFF], 2);
+    }
+    if (i < size) {
+        // One or two bytes left, padded with '='
+        uint32_t word = uint32_t{data[i]} << 16;
+        if (i + 1 < size) {
+            word |= uint32_t{data[i + 1]} << 8;
+        }
+        memcpy(out, pairs.digits[word >> 12], 2);
+        memcpy(out + 2, pairs.digits[word & 0xFFF], 2);
+        out[3] = '=';
+        if (i + 1 == size) {
+            out[2] = '=';
+        }
+    }
+}
+
+// 0123abcd-0123-4567-89ab-0123456789ab
+std::string format_uuid(std::string_view bytes) {
+    if (bytes.size() != 16) {
+        return parqview::format_binary(bytes);
+    }
+    char hex[32];
+    write_hex(reinterpret_cast<const uint8_t*>(bytes.data()), 16, hex);
+    std::string text(hex, 8);
+    text.append("-").append(hex + 8, 4).append("-").append(hex + 12, 4).append("-").append(hex + 16, 4);
+    return text.append("-").append(hex + 20, 12);
+}
+
+// An entry of a nested value; text inside one is quoted so that commas
+// and brackets in it read as part of the value
+std::string format_item(const arrow::Array& array, int64_t index) {
+    std::string text = parqview::format_value(array, index);
+    auto id = array.type_id();
+    if (array.IsValid(index) && (id == arrow::Type::STRING || id == arrow::Type::LARGE_STRING)) {
+        return "\"" + text + "\"";
+    }
+    return text;
+}
+
+// The first PARQUET_NESTED_PREVIEW_ITEMS entries of a list or map, and its
+// length when there are more; the rest are never formatted
+template <typename ListArrayType>
+std::string format_list(const ListArrayType& list, int64_t index, const arrow::Array* keys,
+                        const arrow::Array& values) {
+    int64_t first = list.value_offset(index);
+    int64_t length = list.value_length(index);
+    int64_t shown = std::min<int64_t>(length, PARQUET_NESTED_PREVIEW_ITEMS);
+    std::string text = keys ? "{" : "[";
+    for (int64_t i = 0; i < shown; i++) {
+        text += i > 0 ? ", " : "";
+        if (keys) {
+            text += format_item(*keys, first + i) + ": ";
+        }
+        text += format_item(values, first + i);
+    }
+    if (length > shown) {
+        text += ", …";
+    }
+    text += keys ? "}" : "]";
+    if (length > shown) {
+        text += " (" + std::to_string(length) + (keys ? " entries)" : " items)");
+    }
+    return text;
+}
+
+// The length of the longest prefix of text, at most max_bytes long, that
+// ends on a UTF-8 character boundary. Only the bytes around the cut are
+// looked at, however long the text.
+size_t utf8_prefix(std::string_view text, size_t max_bytes) {
+    if (text.size() <= max_bytes) {
+        return text.size();
+    }
+    size_t end = max_bytes;
+    // Back off over continuation bytes to the lead byte of the character
+    // the cut would split
+    while (end > 0 && (static_cast<unsigned char>(text[end]) & 0xC0) == 0x80) {
+        end--;
+    }
+    return end;
+}
+
+// A cell's text cut to max_bytes; strings are viewed in place, so only the
+// kept prefix is ever copied
+std::string format_preview(const arrow::Array& array, int64_t index, size_t max_bytes, bool* cut) {
+    std::string_view view;
+    switch (array.IsValid(index) ? array.type_id() : arrow::Type::NA) {
+        case arrow::Type::STRING:
+            view = static_cast<const arrow::StringArray&>(array).GetView(index);
+            break;
+        case arrow::Type::LARGE_STRING:
+            view = static_cast<const arrow::LargeStringArray&>(array).GetView(index);
+            break;
+        case arrow::Type::DICTIONARY: {
+            const auto& typed = static_cast<const arrow::DictionaryArray&>(array);
+            return format_preview(*typed.dictionary(), typed.GetValueIndex(index), max_bytes, cut);
+        }
+        default: {
+            std::string text = parqview::format_value(array, index);
+            size_t keep = utf8_prefix(text, max_bytes);
+            *cut = keep < text.size();
+            text.resize(keep);
+            return text;
+        }
+    }
+    size_t keep = utf8_prefix(view, max_bytes);
+    *cut = keep < view.size();
+    return std::string(view.substr(0, keep));
+}
+
+} // namespace
+
+namespace parqview {
+
+// Formats a single cell as display text. Shared by every code path that
+// hands rows to Swift so filtering matches exactly what the table shows.
+std::string format_value(const arrow::Array& array, int64_t index) {
+    if (array.IsNull(index)) {
+        return "NULL";
+    }
+
+    // Use visitor pattern for efficient type dispatch
+    switch (array.type_id()) {
+        case arrow::Type::STRING: {
+            const auto& typed = static_cast<const arrow::StringArray&>(array);
+            return std::string(typed.GetView(index));
+        }
+        case arrow::Type::LARGE_STRING: {
+            const auto& typed = static_cast<const arrow::LargeStringArray&>(array);
+            return std::string(typed.GetView(index));
+        }
+        case arrow::Type::INT64: {
+            const auto& typed = static_cast<const arrow::Int64Array&>(array);
+            return std::to_string(typed.Value(index));
+        }
+        case arrow::Type::INT32: {
+            const auto& typed = static_cast<const arrow::Int32Array&>(array);
+            return std::to_string(typed.Value(index));
+        }
+        case arrow::Type::DOUBLE: {
+            const auto& typed = static_cast<const arrow::DoubleArray&>(array);
+            // Format double with limited precision
+            char buffer[32];
+            snprintf(buffer, sizeof(buffer), "%.6g", typed.Value(index));
+            return buffer;
+        }
+        case arrow::Type::FLOAT: {
+            const auto& typed = static_cast<const arrow::FloatArray&>(array);
+            char buffer[32];
+            snprintf(buffer, sizeof(buffer), "%.6g", typed.Value(index));
+            return buffer;
+        }
+        case arrow::Type::BOOL: {
+            const auto& typed = static_cast<const arrow::BooleanArray&>(array);
+            return typed.Value(index) ? "true" : "false";
+        }
+        case arrow::Type::DECIMAL128: {
+            const auto& typed = static_cast<const arrow::Decimal128Array&>(array);
+            return typed.FormatValue(index);
+        }
+        case arrow::Type::DECIMAL256: {
+            const auto& typed = static_cast<const arrow::Decimal256Array&>(array);
+            return typed.FormatValue(index);
+        }
+        case arrow::Type::TIMESTAMP: {
+            const auto& typed = static_cast<const arrow::TimestampArray&>(array);
+            // Convert timestamp to ISO string
+            auto timestamp = typed.Value(index);
+            int64_t per_second = 1;
+            switch (static_cast<const arrow::TimestampType&>(*array.type()).unit()) {
+                case arrow::TimeUnit::SECOND: per_second = 1; break;
+                case arrow::TimeUnit::MILLI: per_second = 1000; break;
+                case arrow::TimeUnit::MICRO: per_second = 1000000; break;
+                case arrow::TimeUnit::NANO: per_second = 1000000000; break;
+            }
+            // Round towards negative infinity so pre-1970 instants stay on the right second
+            time_t seconds = timestamp / per_second - (timestamp % per_second < 0 ? 1 : 0);
+            auto tm = *std::gmtime(&seconds);
+            char buffer[64];
+            strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm);
+            return buffer;
+        }
+        case arrow::Type::DATE32: {
+            const auto& typed = static_cast<const arrow::Date32Array&>(array);
+            // Date32 is days since epoch
+            auto days = typed.Value(index);
+            time_t seconds = days * 86400;
+            auto tm = *std::gmtime(&seconds);
+            char buffer[32];
+            strftime(buffer, sizeof(buffer), "%Y-%m-%d", &tm);
+            return buffer;
+        }
+        case arrow::Type::DATE64: {
+            const auto& typed = static_cast<const arrow::Date64Array&>(array);
+            // Date64 is milliseconds since epoch
+            auto millis = typed.Value(index);
+            time_t seconds = millis / 1000;
+            auto tm = *std::gmtime(&seconds);
+            char buffer[32];
+            strftime(buffer, sizeof(buffer), "%Y-%m-%d", &tm);
+            return buffer;
+        }
+        case arrow::Type::BINARY: {
+            const auto& typed = static_cast<const arrow::BinaryArray&>(array);
+            return format_binary(typed.GetView(index));
+        }
+        case arrow::Type::LARGE_BINARY: {
+            const auto& typed = static_cast<const arrow::LargeBinaryArray&>(array);
+            return format_binary(typed.GetView(index));
+        }
+        case arrow::Type::FIXED_SIZE_BINARY: {
+            const auto& typed = static_cast<const arrow::FixedSizeBinaryArray&>(array);
+            return format_binary(typed.GetView(index));
+        }
+        case arrow::Type::EXTENSION: {
+            // UUIDs in their canonical form, other extension types as the
+            // values they are stored as
+            const auto& typed = static_cast<const arrow::ExtensionArray&>(array);
+            if (typed.extension_type()->extension_name() == "arrow.uuid") {
+                return format_uuid(static_cast<const arrow::FixedSizeBinaryArray&>(*typed.storage()).GetView(index));
+            }
+            return format_value(*typed.storage(), index);
+        }
+        case arrow::Type::DICTIONARY: {
+            // Dictionary-encoded columns (read with dictionaries preserved)
+            // render as their decoded value
+            const auto& typed = static_cast<const arrow::DictionaryArray&>(array);
+            return format_value(*typed.dictionary(), typed.GetValueIndex(index));
+        }
+        case arrow::Type::LIST: {
+            const auto& typed = static_cast<const arrow::ListArray&>(array);
+            return format_list(typed, index, nullptr, *typed.values());
+        }
+        case arrow::Type::LARGE_LIST: {
+            const auto& typed = static_cast<const arrow::LargeListArray&>(array);
+            return format_list(typed, index, nullptr, *typed.values());
+        }
+        case arrow::Type::FIXED_SIZE_LIST: {
+            const auto& typed = static_cast<const arrow::FixedSizeListArray&>(array);
+            return format_list(typed, index, nullptr, *typed.values());
+        }
+        case arrow::Type::MAP: {
+            const auto& typed = static_cast<const arrow::MapArray&>(array);
+            return format_list(typed, index, typed.keys().get(), *typed.items());
+        }
+        case arrow::Type::STRUCT: {
+            const auto& typed = static_cast<const arrow::StructArray&>(array);
+            std::string text = "{";
+            for (int i = 0; i < typed.num_fields(); i++) {
+                text += i > 0 ? ", " : "";
+                text += typed.type()->field(i)->name() + ": " + format_item(*typed.field(i), index);
+            }
+            return text + "}";
+        }
+        default:
+            // For unsupported types, try to get string representation
+            return "UNSUPPORTED";
+    }
+}
+
+std::string format_binary(std::string_view bytes) {
+    size_t shown = bytes.size();
+    int preview = binary_preview_bytes.load(std::memory_order_relaxed);
+    if (preview > 0) {
+        shown = std::min(shown, static_cast<size_t>(preview));
+    }
+    const auto* data = reinterpret_cast<const uint8_t*>(bytes.data());
+    std::string text;
+    if (binary_format.load(std::memory_order_relaxed) == BINARY_FORMAT_BASE64) {
+        text.resize(base64_length(shown));
+        write_base64(data, shown, &text[0]);
+    } else {
+        text.resize(2 + 2 * shown);
+        text[0] = '0';
+        text[1] = 'x';
+        write_hex(data, shown, &text[2]);
+    }
+    if (shown < bytes.size()) {
+        text += "… (" + std::to_string(bytes.size()) + " bytes)";
+    }
+    return text;
+}
+
+std::string encode_base64(std::string_view bytes) {
+    std::string text(base64_length(bytes.size()), '\0');
+    if (!bytes.empty()) {
+        write_base64(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size(), &text[0]);
+    }
+    return text;
+}
+
+std::string format_scalar(const arrow::Scalar& scalar) {
+    auto array = arrow::MakeArrayFromScalar(scalar, 1);
+    if (array.ok()) {
+        std::string text = format_value(**array, 0);
+        if (text != "UNSUPPORTED") {
+            return text;
+        }
+    }
+    return scalar.ToString();
+}
+
+void set_cell(TableData* data, int row, int column, const arrow::Array& array, int64_t index, int max_cell_bytes) {
+    if (max_cell_bytes <= 0) {
+        data->data[row][column] = strdup(format_value(array, index).c_str());
+        return;
+    }
+    bool cut = false;
+    data->data[row][column] = strdup(format_preview(array, index, static_cast<size_t>(max_cell_bytes), &cut).c_str());
+    if (cut) {
+        if (!data->truncated) {
+            data->truncated = static_cast<unsigned char*>(
+                calloc(static_cast<size_t>(data->row_count) * data->column_count, 1));
+        }
+        data->truncated[static_cast<size_t>(row) * data->column_count + column] = 1;
+    }
+}
+
+std::unique_ptr<parquet::arrow::FileReader> open_reader(
+        const char* file_path,
+        const std::shared_ptr<parquet::FileMetaData>& metadata,
+        const parquet::ArrowReaderProperties& arrow_props) {
+    auto result = arrow::io::MemoryMappedFile::Open(file_path, arrow::io::FileMode::READ);
+    if (!result.ok()) {
+        return nullptr;
+    }
+
+    // Reusing the already parsed footer skips the thrift decode on every open
+    parquet::arrow::FileReaderBuilder builder;
+    auto status = builder.Open(result.ValueOrDie(), parquet::default_reader_properties(), metadata);
+    if (!status.ok()) {
+        return nullptr;
+    }
+    builder.properties(arrow_props);
+
+    std::unique_ptr<parquet::arrow::FileReader> reader;
+    status = builder.Build(&reader);
+    if (!status.ok()) {
+        return nullptr;
+    }
+    return reader;
+}
+
+std::unique_ptr<parquet::ParquetFileReader> open_parquet_file(
+        const char* file_path,
+        const std::shared_ptr<parquet::FileMetaData>& metadata) {
+    auto result = arrow::io::MemoryMappedFile::Open(file_path, arrow::io::FileMode::READ);
+    if (!result.ok()) {
+        return nullptr;
+    }
+    return parquet::ParquetFileReader::Open(result.ValueOrDie(), parquet::default_reader_properties(), metadata);
+}
+
+std::string file_fingerprint(const char* file_path) {
+    struct stat st;
+    if (stat(file_path, &st) != 0) {
+        return "";
+    }
+#ifdef __APPLE__
+    long long mtime_ns = static_cast<long long>(st.st_mtimespec.tv_sec) * 1000000000LL + st.st_mtimespec.tv_nsec;
+#else
+    long long mtime_ns = static_cast<long long>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+#endif
+    return std::string(file_path) + "|" + std::to_string(static_cast<long long>(st.st_size)) + "|" +
+           std::to_string(mtime_ns) + "|" + std::to_string(static_cast<long long>(st.st_ino));
+}
+
+std::vector<int64_t> row_group_offsets(const parquet::FileMetaData& metadata) {
+    std::vector<int64_t> offsets;
+    offsets.reserve(metadata.num_row_groups() + 1);
+    int64_t row = 0;
+    for (int rg = 0; rg < metadata.num_row_groups(); rg++) {
+        offsets.push_back(row);
+        row += metadata.RowGroup(rg)->num_rows();
+    }
+    offsets.push_back(row);
+    return offsets;
+}
+
+std::vector<RowSelection> select_row_groups(const RowBitmap& rows, const parquet::FileMetaData& metadata) {
+    auto offsets = row_group_offsets(metadata);
+    int num_row_groups = metadata.num_row_groups();
+    std::vector<RowSelection> selections(num_row_groups);
+    for (int rg = 0; rg < num_row_groups; rg++) {
+        selections[rg].all = false;
+        selections[rg].words.assign(static_cast<size_t>((offsets[rg + 1] - offsets[rg] + 63) / 64), 0);
+    }
+    int rg = 0;
+    rows.for_each([&](uint64_t row) {
+        while (static_cast<int64_t>(row) >= offsets[rg + 1]) {
+            rg++;
+        }
+        uint64_t local = row - static_cast<uint64_t>(offsets[rg]);
+        selections[rg].words[local >> 6] |= uint64_t(1) << (local & 63);
+        selections[rg].count++;
+    });
+    return selections;
+}
+
+bool is_fully_dictionary_encoded(const parquet::ColumnChunkMetaData& chunk) {
+    if (!chunk.has_dictionary_page()) {
+        return false;
+    }
+
+    // Writers fall back to PLAIN once the dictionary grows too large; those
+    // pages hold values the dictionary never saw
+    const auto& encoding_stats = chunk.encoding_stats();
+    if (encoding_stats.empty()) {
+        return false;
+    }
+    for (const auto& stats : encoding_stats) {
+        bool is_data_page = stats.page_type == parquet::PageType::DATA_PAGE ||
+                            stats.page_type == parquet::PageType::DATA_PAGE_V2;
+        if (is_data_page && stats.encoding != parquet::Encoding::PLAIN_DICTIONARY &&
+            stats.encoding != parquet::Encoding::RLE_DICTIONARY) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void collect_leaf_columns(const parquet::arrow::SchemaField& field, std::vector<int>& leaves) {
+    if (field.is_leaf()) {
+        leaves.push_back(field.column_index);
+        return;
+    }
+    for (const auto& child : field.children) {
+        collect_leaf_columns(child, leaves);
+    }
+}
+
+std::shared_ptr<arrow::DataType> with_uuid_type(const std::shared_ptr<arrow::DataType>& type,
+                                                const parquet::arrow::SchemaManifest& manifest, int field) {
+    // Registered with Arrow's other canonical extension types (Arrow 18 on)
+    static const auto uuid = arrow::GetExtensionType("arrow.uuid");
+    if (!uuid || type->id() != arrow::Type::FIXED_SIZE_BINARY) {
+        return type;
+    }
+    const auto& schema_field = manifest.schema_fields[field];
+    if (!schema_field.is_leaf()) {
+        return type;
+    }
+    const auto* descr = manifest.descr->Column(schema_field.column_index);
+    const auto& logical = descr->logical_type();
+    if (descr->type_length() != 16 || !logical || !logical->is_UUID()) {
+        return type;
+    }
+    return uuid;
+}
+
+std::shared_ptr<arrow::Array> with_uuid_type(const std::shared_ptr<arrow::Array>& array,
+                                             const parquet::arrow::SchemaManifest& manifest, int field) {
+    auto type = with_uuid_type(array->type(), manifest, field);
+    if (type == array->type()) {
+        return array;
+    }
+    return arrow::ExtensionType::WrapArray(type, array);
+}
+
+std::shared_ptr<arrow::ChunkedArray> with_uuid_type(const std::shared_ptr<arrow::ChunkedArray>& column,
+                                                    const parquet::arrow::SchemaManifest& manifest, int field) {
+    if (column->type()->id() != arrow::Type::FIXED_SIZE_BINARY || column->num_chunks() == 0) {
+        return column;
+    }
+    arrow::ArrayVector chunks;
+    for (const auto& chunk : column->chunks()) {
+        chunks.push_back(with_uuid_type(chunk, manifest, field));
+    }
+    return std::make_shared<arrow::ChunkedArray>(std::move(chunks));
+}
+
+void copy_row_numbers(const TableData* data, const std::vector<int64_t>& rows, int64_t first_row,
+                      long long* row_numbers) {
+    if (!data || !row_numbers) {
+        return;
+    }
+    for (int i = 0; i < data->row_count; i++) {
+        row_numbers[i] = rows.empty() ? first_row + i : rows[i];
+    }
+}
+
+SchemaInfo* schema_info(const arrow::Schema& schema, int64_t row_count) {
+    auto* info = new SchemaInfo;
+    info->column_count = schema.num_fields();
+    info->row_count = row_count;
+    info->columns = new ColumnInfo[info->column_count];
+    for (int i = 0; i < info->column_count; i++) {
+        info->columns[i].name = strdup(schema.field(i)->name().c_str());
+        info->columns[i].type = strdup(schema.field(i)->type()->ToString().c_str());
+    }
+    return info;
+}
+
+TableData* allocate_table_data(int row_count, int column_count) {
+    auto* data = new TableData;
+    data->row_count = row_count;
+    data->column_count = column_count;
+    data->data = nullptr;
+    data->truncated = nullptr;
+    if (row_count <= 0) {
+        data->row_count = 0;
+        return data;
+    }
+
+    data->data = new char**[row_count];
+    for (int i = 0; i < row_count; i++) {
+        data->data[i] = new char*[column_count];
+        for (int j = 0; j < column_count; j++) {
+            data->data[i][j] = nullptr;
+        }
+    }
+    return data;
+}
+
+void fill_column_rows(TableData* data, int first_row, int column, const arrow::ChunkedArray& values,
+                      const std::vector<int64_t>& rows, int max_cell_bytes) {
+    const auto& chunks = values.chunks();
+
+    // Rows are ascending, so walk the chunks alongside them
+    size_t chunk_idx = 0;
+    int64_t chunk_start = 0;
+    for (size_t r = 0; r < rows.size(); r++) {
+        while (chunk_idx < chunks.size() &&
+               rows[r] >= chunk_start + chunks[chunk_idx]->length()) {
+            chunk_start += chunks[chunk_idx]->length();
+            chunk_idx++;
+        }
+        if (chunk_idx >= chunks.size()) {
+            break;
+        }
+        set_cell(data, first_row + static_cast<int>(r), column, *chunks[chunk_idx], rows[r] - chunk_start, max_cell_bytes);
+    }
+}
+
+} // namespace parqview
+
 extern "C" {
 
 // Helper function to get or create a cached reader
@@ -39,8 +632,17 @@ std::unique_ptr<parquet::arrow::FileReader>* get_cached_reader(const char* file_
         }
         infile = result.ValueOrDie();
         
+        // A footer sidecar from an earlier session saves reading the footer
+        std::string fingerprint = parqview::file_fingerprint(file_path);
+        parqview::FooterSidecar sidecar;
+        std::shared_ptr<parquet::FileMetaData> metadata;
+        if (parqview::load_footer_sidecar(file_path, fingerprint, true, &sidecar)) {
+            metadata = parqview::sidecar_metadata(sidecar);
+        }
+        bool from_sidecar = metadata != nullptr;
+
         parquet::arrow::FileReaderBuilder builder;
-        auto status = builder.Open(infile);
+        auto status = builder.Open(infile, parquet::default_reader_properties(), metadata);
         if (!status.ok()) {
             return nullptr;
         }
@@ -56,6 +658,11 @@ std::unique_ptr<parquet::arrow::FileReader>* get_cached_reader(const char* file_
         if (!status.ok()) {
             return nullptr;
         }
+
+        std::shared_ptr<arrow::Schema> schema;
+        if (!from_sidecar && reader->GetSchema(&schema).ok()) {
+            parqview::store_footer_sidecar(file_path, fingerprint, *reader->parquet_reader()->metadata(), *schema);
+        }
         
         reader_cache[path_str] = std::move(reader);
         return &reader_cache[path_str];
@@ -66,6 +673,35 @@ std::unique_ptr<parquet::arrow::FileReader>* get_cached_reader(const char* file_
 
 SchemaInfo* read_parquet_schema(const char* file_path) {
     try {
+        auto format = detect_file_format(file_path);
+        if (format != FILE_FORMAT_PARQUET) {
+            // Every row read asks for the schema; counting text rows would
+            // index the whole file first
+            auto reader = parqview::get_format_reader(file_path);
+            bool text = format == FILE_FORMAT_CSV || format == FILE_FORMAT_NDJSON;
+            return reader ? parqview::schema_info(*reader->schema(), text ? -1 : reader->row_count()) : nullptr;
+        }
+
+        // A file not opened yet this session may be answered from its
+        // footer sidecar without touching the file
+        bool opened;
+        {
+            std::lock_guard<std::mutex> lock(cache_mutex);
+            opened = reader_cache.count(file_path) > 0;
+        }
+        parqview::FooterSidecar sidecar;
+        if (!opened && parqview::load_footer_sidecar(file_path, parqview::file_fingerprint(file_path), false, &sidecar)) {
+            auto* info = new SchemaInfo;
+            info->column_count = static_cast<int>(sidecar.columns.size());
+            info->row_count = sidecar.row_count;
+            info->columns = new ColumnInfo[info->column_count];
+            for (int i = 0; i < info->column_count; i++) {
+                info->columns[i].name = strdup(sidecar.columns[i].first.c_str());
+                info->columns[i].type = strdup(sidecar.columns[i].second.c_str());
+            }
+            return info;
+        }
+
         auto reader_ptr = get_cached_reader(file_path);
         if (!reader_ptr || !(*reader_ptr)) {
             return nullptr;
@@ -78,206 +714,90 @@ SchemaInfo* read_parquet_schema(const char* file_path) {
             return nullptr;
         }
 
-        auto* info = new SchemaInfo;
-        info->column_count = schema->num_fields();
-        info->row_count = reader->parquet_reader()->metadata()->num_rows();
-        info->columns = new ColumnInfo[info->column_count];
-
-        for (int i = 0; i < info->column_count; i++) {
-            auto field = schema->field(i);
-            info->columns[i].name = strdup(field->name().c_str());
-            info->columns[i].type = strdup(field->type()->ToString().c_str());
-        }
-
-        return info;
+        return parqview::schema_info(*schema, reader->parquet_reader()->metadata()->num_rows());
     } catch (const std::exception& e) {
         std::cerr << "Error reading schema: " << e.what() << std::endl;
         return nullptr;
     }
 }
 
+long long read_row_count(const char* file_path) {
+    try {
+        if (detect_file_format(file_path) != FILE_FORMAT_PARQUET) {
+            auto reader = parqview::get_format_reader(file_path);
+            return reader ? reader->row_count() : -1;
+        }
+        SchemaInfo* info = read_parquet_schema(file_path);
+        long long rows = info ? info->row_count : -1;
+        free_schema_info(info);
+        return rows;
+    } catch (const std::exception& e) {
+        std::cerr << "Error counting rows: " << e.what() << std::endl;
+        return -1;
+    }
+}
+
 TableData* read_parquet_data(const char* file_path, int start_row, int num_rows) {
+    return read_parquet_page(file_path, start_row, num_rows, 0);
+}
+
+TableData* read_parquet_page(const char* file_path, long long start_row, int num_rows, int max_cell_bytes) {
     try {
+        if (detect_file_format(file_path) != FILE_FORMAT_PARQUET) {
+            auto reader = parqview::get_format_reader(file_path);
+            return reader ? parqview::read_format_rows(*reader, start_row, num_rows, max_cell_bytes) : nullptr;
+        }
+
+        // An Arrow copy is sliced without decoding any Parquet pages
+        if (auto* data = parqview::read_accelerated_rows(file_path, start_row, num_rows, max_cell_bytes)) {
+            return data;
+        }
+
         auto reader_ptr = get_cached_reader(file_path);
         if (!reader_ptr || !(*reader_ptr)) {
             return nullptr;
         }
         auto& reader = *reader_ptr;
         
-        // Get metadata
-        auto file_metadata = reader->parquet_reader()->metadata();
-        int64_t total_rows = file_metadata->num_rows();
-        int num_row_groups = file_metadata->num_row_groups();
-        
         // Calculate actual rows to read
-        int64_t end_row = std::min(static_cast<int64_t>(start_row + num_rows), total_rows);
-        
-        auto* data = new TableData;
-        data->row_count = end_row - start_row;
-        
-        if (data->row_count <= 0) {
-            data->column_count = 0;
-            data->data = nullptr;
-            return data;
+        auto file_metadata = reader->parquet_reader()->metadata();
+        auto offsets = parqview::row_group_offsets(*file_metadata);
+        int64_t end_row = std::min<int64_t>(start_row + std::max(num_rows, 0), offsets.back());
+        if (end_row <= start_row) {
+            return parqview::allocate_table_data(0, 0);
         }
         
         // Find which row groups we need to read
         std::vector<int> row_groups_to_read;
-        int64_t current_row = 0;
-        
-        for (int rg = 0; rg < num_row_groups; rg++) {
-            int64_t rg_row_count = file_metadata->RowGroup(rg)->num_rows();
-            
-            // Check if this row group contains any rows we need
-            if (current_row + rg_row_count > start_row && current_row < end_row) {
+        for (int rg = 0; rg < file_metadata->num_row_groups(); rg++) {
+            if (offsets[rg + 1] > start_row && offsets[rg] < end_row) {
                 row_groups_to_read.push_back(rg);
             }
-            
-            current_row += rg_row_count;
-            
-            // Stop if we've passed the end row
-            if (current_row >= end_row) {
-                break;
-            }
         }
         
         // Read only the necessary row groups
         std::shared_ptr<arrow::Table> table;
-        if (row_groups_to_read.size() == num_row_groups) {
+        arrow::Status status;
+        if (static_cast<int>(row_groups_to_read.size()) == file_metadata->num_row_groups()) {
             // If we need all row groups, just read the whole table
-            auto status = reader->ReadTable(&table);
-            if (!status.ok()) {
-                delete data;
-                return nullptr;
-            }
+            status = reader->ReadTable(&table);
         } else {
-            // Read only selected row groups
-            auto status = reader->ReadRowGroups(row_groups_to_read, &table);
-            if (!status.ok()) {
-                delete data;
-                return nullptr;
-            }
+            status = reader->ReadRowGroups(row_groups_to_read, &table);
         }
-        
-        // Now slice the table to get exact range
-        if (table->num_rows() > data->row_count) {
-            // Calculate offset within the combined row groups
-            int64_t offset_in_table = 0;
-            current_row = 0;
-            
-            for (int rg : row_groups_to_read) {
-                int64_t rg_row_count = file_metadata->RowGroup(rg)->num_rows();
-                if (current_row + rg_row_count > start_row) {
-                    offset_in_table = start_row - current_row;
-                    break;
-                }
-                current_row += rg_row_count;
-            }
-            
-            table = table->Slice(offset_in_table, data->row_count);
+        if (!status.ok()) {
+            return nullptr;
         }
         
-        data->column_count = table->num_columns();
+        // The table starts at the first row group read, not at row 0
+        table = table->Slice(start_row - offsets[row_groups_to_read.front()], end_row - start_row);
         
-        // Allocate memory for data
-        data->data = new char**[data->row_count];
-        for (int i = 0; i < data->row_count; i++) {
-            data->data[i] = new char*[data->column_count];
-        }
-        
-        // Convert data to strings more efficiently
+        auto* data = parqview::allocate_table_data(static_cast<int>(table->num_rows()), table->num_columns());
         for (int col = 0; col < data->column_count; col++) {
-            auto column = table->column(col);
-            
-            // Process entire column at once
             int row_idx = 0;
+            auto column = parqview::with_uuid_type(table->column(col), reader->manifest(), col);
             for (auto& chunk : column->chunks()) {
                 for (int64_t i = 0; i < chunk->length() && row_idx < data->row_count; i++) {
-                    std::string value;
-                    
-                    if (chunk->IsNull(i)) {
-                        value = "NULL";
-                    } else {
-                        // Use visitor pattern for efficient type dispatch
-                        switch (chunk->type_id()) {
-                            case arrow::Type::STRING: {
-                                auto array = std::static_pointer_cast<arrow::StringArray>(chunk);
-                                value = std::string(array->GetView(i));
-                                break;
-                            }
-                            case arrow::Type::INT64: {
-                                auto array = std::static_pointer_cast<arrow::Int64Array>(chunk);
-                                value = std::to_string(array->Value(i));
-                                break;
-                            }
-                            case arrow::Type::INT32: {
-                                auto array = std::static_pointer_cast<arrow::Int32Array>(chunk);
-                                value = std::to_string(array->Value(i));
-                                break;
-                            }
-                            case arrow::Type::DOUBLE: {
-                                auto array = std::static_pointer_cast<arrow::DoubleArray>(chunk);
-                                // Format double with limited precision
-                                char buffer[32];
-                                snprintf(buffer, sizeof(buffer), "%.6g", array->Value(i));
-                                value = buffer;
-                                break;
-                            }
-                            case arrow::Type::FLOAT: {
-                                auto array = std::static_pointer_cast<arrow::FloatArray>(chunk);
-                                char buffer[32];
-                                snprintf(buffer, sizeof(buffer), "%.6g", array->Value(i));
-                                value = buffer;
-                                break;
-                            }
-                            case arrow::Type::BOOL: {
-                                auto array = std::static_pointer_cast<arrow::BooleanArray>(chunk);
-                                value = array->Value(i) ? "true" : "false";
-                                break;
-                            }
-                            case arrow::Type::TIMESTAMP: {
-                                auto array = std::static_pointer_cast<arrow::TimestampArray>(chunk);
-                                // Convert timestamp to ISO string
-                                auto timestamp = array->Value(i);
-                                // Timestamps are usually in microseconds or milliseconds
-                                time_t seconds = timestamp / 1000000;  // Assuming microseconds
-                                auto tm = *std::gmtime(&seconds);
-                                char buffer[64];
-                                strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm);
-                                value = buffer;
-                                break;
-                            }
-                            case arrow::Type::DATE32: {
-                                auto array = std::static_pointer_cast<arrow::Date32Array>(chunk);
-                                // Date32 is days since epoch
-                                auto days = array->Value(i);
-                                time_t seconds = days * 86400;
-                                auto tm = *std::gmtime(&seconds);
-                                char buffer[32];
-                                strftime(buffer, sizeof(buffer), "%Y-%m-%d", &tm);
-                                value = buffer;
-                                break;
-                            }
-                            case arrow::Type::DATE64: {
-                                auto array = std::static_pointer_cast<arrow::Date64Array>(chunk);
-                                // Date64 is milliseconds since epoch
-                                auto millis = array->Value(i);
-                                time_t seconds = millis / 1000;
-                                auto tm = *std::gmtime(&seconds);
-                                char buffer[32];
-                                strftime(buffer, sizeof(buffer), "%Y-%m-%d", &tm);
-                                value = buffer;
-                                break;
-                            }
-                            default:
-                                // For unsupported types, try to get string representation
-                                value = "UNSUPPORTED";
-                                break;
-                        }
-                    }
-                    
-                    data->data[row_idx][col] = strdup(value.c_str());
-                    row_idx++;
+                    parqview::set_cell(data, row_idx++, col, *chunk, i, max_cell_bytes);
                 }
             }
         }
@@ -289,6 +809,106 @@ TableData* read_parquet_data(const char* file_path, int start_row, int num_rows)
     }
 }
 
+TableData* read_parquet_rows(const char* file_path, const long long* rows, int row_count, int max_cell_bytes) {
+    try {
+        if (row_count < 0 || (row_count > 0 && !rows) || detect_file_format(file_path) != FILE_FORMAT_PARQUET) {
+            return nullptr;
+        }
+
+        auto reader_ptr = get_cached_reader(file_path);
+        if (!reader_ptr || !(*reader_ptr)) {
+            return nullptr;
+        }
+        auto& reader = *reader_ptr;
+
+        // take_rows reads distinct rows in file order; each requested row
+        // then copies the cells of its place in that order
+        std::vector<int64_t> ordered(rows, rows + row_count);
+        std::sort(ordered.begin(), ordered.end());
+        ordered.erase(std::unique(ordered.begin(), ordered.end()), ordered.end());
+        if (!ordered.empty() &&
+            (ordered.front() < 0 || ordered.back() >= reader->parquet_reader()->metadata()->num_rows())) {
+            return nullptr;
+        }
+        auto* taken = parqview::take_rows(file_path, reader->parquet_reader()->metadata(), ordered, {},
+                                          max_cell_bytes);
+        if (!taken || ordered.empty()) {
+            return taken;
+        }
+
+        auto* data = parqview::allocate_table_data(row_count, taken->column_count);
+        for (int i = 0; i < row_count; i++) {
+            size_t from = std::lower_bound(ordered.begin(), ordered.end(), rows[i]) - ordered.begin();
+            for (int col = 0; col < data->column_count; col++) {
+                const char* cell = taken->data[from][col];
+                data->data[i][col] = cell ? strdup(cell) : nullptr;
+                if (taken->truncated && taken->truncated[from * taken->column_count + col]) {
+                    if (!data->truncated) {
+                        data->truncated = static_cast<unsigned char*>(
+                            calloc(static_cast<size_t>(data->row_count) * data->column_count, 1));
+                    }
+                    data->truncated[static_cast<size_t>(i) * data->column_count + col] = 1;
+                }
+            }
+        }
+        free_table_data(taken);
+        return data;
+    } catch (const std::exception& e) {
+        std::cerr << "Error reading rows: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+char* read_parquet_cell(const char* file_path, long long row, int column) {
+    try {
+        if (row < 0 || column < 0) {
+            return nullptr;
+        }
+        if (detect_file_format(file_path) != FILE_FORMAT_PARQUET) {
+            auto reader = parqview::get_format_reader(file_path);
+            if (!reader || column >= reader->schema()->num_fields()) {
+                return nullptr;
+            }
+            auto table = reader->read_rows(row, 1);
+            for (const auto& chunk : table->column(column)->chunks()) {
+                if (chunk->length() > 0) {
+                    return strdup(parqview::format_value(*chunk, 0).c_str());
+                }
+            }
+            return nullptr;
+        }
+
+        auto reader_ptr = get_cached_reader(file_path);
+        if (!reader_ptr || !(*reader_ptr)) {
+            return nullptr;
+        }
+        auto& reader = *reader_ptr;
+        if (row >= reader->parquet_reader()->metadata()->num_rows() ||
+            column >= static_cast<int>(reader->manifest().schema_fields.size())) {
+            return nullptr;
+        }
+
+        // Only the page of the one column holding the row, where it can be
+        auto* data = parqview::take_rows(file_path, reader->parquet_reader()->metadata(), {row}, {column});
+        if (!data) {
+            return nullptr;
+        }
+        char* text = data->row_count > 0 ? data->data[0][0] : nullptr;
+        if (text) {
+            data->data[0][0] = nullptr;
+        }
+        free_table_data(data);
+        return text;
+    } catch (const std::exception& e) {
+        std::cerr << "Error reading cell: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+void free_parquet_cell(char* text) {
+    free(text);
+}
+
 void free_schema_info(SchemaInfo* info) {
     if (info) {
         for (int i = 0; i < info->column_count; i++) {
@@ -311,6 +931,7 @@ void free_table_data(TableData* data) {
             }
             delete[] data->data;
         }
+        free(data->truncated);
         delete data;
     }
 }
@@ -319,11 +940,30 @@ void clear_parquet_cache(const char* file_path) {
     std::lock_guard<std::mutex> lock(cache_mutex);
     std::string path_str(file_path);
     reader_cache.erase(path_str);
+    parqview::row_bitmap_cache().clear(file_path);
+    parqview::clear_column_stats_cache(file_path);
+    parqview::clear_profile_cache(file_path);
+    parqview::clear_accelerated_cache(file_path);
+    parqview::clear_format_reader_cache(file_path);
+}
+
+void set_binary_format(BinaryFormat format, int preview_bytes) {
+    binary_format = format;
+    binary_preview_bytes = std::max(preview_bytes, 0);
+    parqview::row_bitmap_cache().clear(nullptr);
+    parqview::clear_column_stats_cache(nullptr);
+    parqview::clear_profile_cache(nullptr);
 }
 
 void clear_all_parquet_cache() {
     std::lock_guard<std::mutex> lock(cache_mutex);
     reader_cache.clear();
+    parqview::row_bitmap_cache().clear(nullptr);
+    parqview::clear_column_stats_cache(nullptr);
+    parqview::clear_profile_cache(nullptr);
+    parqview::clear_dataset_cache(nullptr);
+    parqview::clear_accelerated_cache(nullptr);
+    parqview::clear_format_reader_cache(nullptr);
 }
 
 } // extern "C"
\ No newline at end of file
@@ -0,0 +1,232 @@
+#include "../include/ParquetRewrite.h"
+#include "DistinctCounter.h"
+#include "ReaderInternal.h"
+#include "RowOrder.h"
+#include <arrow/io/file.h>
+#include <parquet/arrow/writer.h>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr int64_t kDefaultRowGroupRows = 131072;
+constexpr int64_t kDefaultPageBytes = 64 * 1024;
+constexpr int64_t kDefaultMaxRowsPerPage = 20000;
+
+// Rows decoded per batch from the source
+constexpr int64_t kReadBatchRows = 65536;
+
+// Random single-row reads timed on each side
+constexpr int kLatencySamples = 8;
+
+// Mean milliseconds to read one row at a spread of positions, through a
+// fresh reader over an already parsed footer, as the table does on a jump
+double random_read_latency(const char* file_path, const std::shared_ptr<parquet::FileMetaData>& metadata) {
+    int64_t rows = metadata->num_rows();
+    auto reader = parqview::open_reader(file_path, metadata, parquet::default_arrow_reader_properties());
+    if (!reader || rows == 0) {
+        return 0;
+    }
+    double total = 0;
+    for (int i = 0; i < kLatencySamples; i++) {
+        int64_t row = static_cast<int64_t>(parqview::hash_u64(static_cast<uint64_t>(i) + 1) % static_cast<uint64_t>(rows));
+        auto start = std::chrono::steady_clock::now();
+        auto* data = parqview::take_rows(*reader, {row});
+        total += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        free_table_data(data);
+    }
+    return total / kLatencySamples;
+}
+
+std::shared_ptr<parquet::WriterProperties> writer_properties(const RewriteOptions& options,
+                                                             const parquet::arrow::SchemaManifest& manifest,
+                                                             const parquet::SchemaDescriptor& schema) {
+    parquet::WriterProperties::Builder builder;
+    builder.compression(parqview::compression_of(options.codec))
+        ->max_row_group_length(options.row_group_rows > 0 ? options.row_group_rows : kDefaultRowGroupRows)
+        ->data_pagesize(options.data_page_bytes > 0 ? options.data_page_bytes : kDefaultPageBytes)
+        ->max_rows_per_page(options.max_rows_per_page > 0 ? options.max_rows_per_page : kDefaultMaxRowsPerPage);
+    if (options.write_page_index) {
+        builder.enable_write_page_index();
+    } else {
+        builder.disable_write_page_index();
+    }
+    if (options.dictionary_encoding) {
+        builder.enable_dictionary();
+    } else {
+        builder.disable_dictionary();
+    }
+
+    for (int i = 0; i < options.bloom_filter_column_count; i++) {
+        std::vector<int> leaves;
+        parqview::collect_leaf_columns(manifest.schema_fields.at(options.bloom_filter_columns[i]), leaves);
+        for (int leaf : leaves) {
+            const auto* descr = schema.Column(leaf);
+            if (descr->physical_type() != parquet::Type::BOOLEAN) {
+                builder.enable_bloom_filter(descr->path()->ToDotString(), parquet::BloomFilterOptions());
+            }
+        }
+    }
+
+    std::vector<parquet::SortingColumn> sorting;
+    for (int i = 0; i < options.sort_column_count; i++) {
+        const auto& field = manifest.schema_fields.at(options.sort_columns[i]);
+        if (!field.is_leaf()) {
+            throw std::invalid_argument("sort column " + field.field->name() + " is not a primitive column");
+        }
+        parquet::SortingColumn column;
+        column.column_idx = field.column_index;
+        column.descending = options.sort_descending && options.sort_descending[i];
+        column.nulls_first = false;
+        sorting.push_back(column);
+    }
+    builder.set_sorting_columns(std::move(sorting));
+    return builder.build();
+}
+
+// Streams the source into writer. Unsorted, batches go straight to the
+// writer, which cuts row groups at its maximum length and holds only the
+// encoded row group in progress; sorted, one row group of decoded rows is
+// gathered, sorted and written at a time.
+arrow::Status copy_rows(arrow::RecordBatchReader& batches, parquet::arrow::FileWriter& writer,
+                        const RewriteOptions& options, int64_t row_group_rows) {
+    if (options.sort_column_count == 0) {
+        std::shared_ptr<arrow::RecordBatch> batch;
+        while (true) {
+            ARROW_RETURN_NOT_OK(batches.ReadNext(&batch));
+            if (!batch) {
+                return arrow::Status::OK();
+            }
+            ARROW_RETURN_NOT_OK(writer.WriteRecordBatch(*batch));
+        }
+    }
+
+    // Nulls last, as the footer records
+    std::vector<parqview::SortKey> keys;
+    for (int i = 0; i < options.sort_column_count; i++) {
+        keys.push_back({options.sort_columns[i], options.sort_descending && options.sort_descending[i]});
+    }
+    arrow::RecordBatchVector pending;
+    int64_t pending_rows = 0;
+    auto flush = [&](int64_t rows) -> arrow::Status {
+        ARROW_ASSIGN_OR_RAISE(auto table, arrow::Table::FromRecordBatches(batches.schema(), pending));
+        auto group = table->Slice(0, rows);
+        auto sorted = parqview::take_row_order(group, parqview::sort_row_order(*group, keys));
+        ARROW_RETURN_NOT_OK(writer.WriteTable(*sorted, row_group_rows));
+        pending.clear();
+        pending_rows -= rows;
+        if (pending_rows > 0) {
+            ARROW_ASSIGN_OR_RAISE(auto rest, arrow::TableBatchReader(*table->Slice(rows)).ToRecordBatches());
+            pending = std::move(rest);
+        }
+        return arrow::Status::OK();
+    };
+    std::shared_ptr<arrow::RecordBatch> batch;
+    while (true) {
+        ARROW_RETURN_NOT_OK(batches.ReadNext(&batch));
+        if (!batch) {
+            break;
+        }
+        pending.push_back(batch);
+        pending_rows += batch->num_rows();
+        while (pending_rows >= row_group_rows) {
+            ARROW_RETURN_NOT_OK(flush(row_group_rows));
+        }
+    }
+    return pending_rows > 0 ? flush(pending_rows) : arrow::Status::OK();
+}
+
+} // namespace
+
+extern "C" {
+
+RewriteResult* rewrite_parquet_file(const char* source_path, const char* output_path,
+                                    const RewriteOptions* options) {
+    auto* result = new RewriteResult();
+    fs::path temp;
+    try {
+        std::error_code error;
+        if (fs::equivalent(source_path, output_path, error)) {
+            throw std::invalid_argument("the output would overwrite the source");
+        }
+        auto reader_ptr = get_cached_reader(source_path);
+        if (!reader_ptr || !(*reader_ptr)) {
+            throw std::runtime_error("cannot open " + std::string(source_path));
+        }
+        auto metadata = (*reader_ptr)->parquet_reader()->metadata();
+
+        // A reader of its own: the cached one serves the table meanwhile
+        parquet::ArrowReaderProperties read_props;
+        read_props.set_batch_size(kReadBatchRows);
+        auto reader = parqview::open_reader(source_path, metadata, read_props);
+        std::shared_ptr<arrow::Schema> schema;
+        if (!reader || !reader->GetSchema(&schema).ok()) {
+            throw std::runtime_error("cannot read the schema of " + std::string(source_path));
+        }
+        int64_t row_group_rows = options->row_group_rows > 0 ? options->row_group_rows : kDefaultRowGroupRows;
+        auto props = writer_properties(*options, reader->manifest(), *metadata->schema());
+        auto arrow_props = parquet::ArrowWriterProperties::Builder().store_schema()->build();
+
+        // Written beside the output and renamed over it when complete
+        temp = fs::path(output_path);
+        temp += ".tmp-" + std::to_string(reinterpret_cast<uintptr_t>(result));
+        auto output = arrow::io::FileOutputStream::Open(temp.string());
+        if (!output.ok()) {
+            throw std::runtime_error(output.status().ToString());
+        }
+        auto writer = parquet::arrow::FileWriter::Open(*schema, arrow::default_memory_pool(), *output, props,
+                                                       arrow_props);
+        if (!writer.ok()) {
+            throw std::runtime_error(writer.status().ToString());
+        }
+        auto batches = reader->GetRecordBatchReader();
+        if (!batches.ok()) {
+            throw std::runtime_error(batches.status().ToString());
+        }
+        auto status = copy_rows(**batches, **writer, *options, row_group_rows);
+        if (status.ok()) {
+            status = (*writer)->Close();
+        }
+        if (status.ok()) {
+            status = (*output)->Close();
+        }
+        if (!status.ok()) {
+            throw std::runtime_error(status.ToString());
+        }
+        fs::rename(temp, output_path);
+        temp.clear();
+
+        std::string footer_error;
+        int64_t output_bytes = 0;
+        auto written = parqview::read_footer(output_path, &output_bytes, &footer_error);
+        if (!written) {
+            throw std::runtime_error(footer_error);
+        }
+        result->row_count = written->num_rows();
+        result->row_group_count = written->num_row_groups();
+        result->output_bytes = output_bytes;
+        result->source_latency_ms = random_read_latency(source_path, metadata);
+        result->output_latency_ms = random_read_latency(output_path, written);
+    } catch (const std::exception& e) {
+        std::cerr << "Error rewriting file: " << e.what() << std::endl;
+        result->error = strdup(e.what());
+        if (!temp.empty()) {
+            std::error_code ignored;
+            fs::remove(temp, ignored);
+        }
+    }
+    return result;
+}
+
+void free_rewrite_result(RewriteResult* result) {
+    if (result) {
+        free(result->error);
+        delete result;
+    }
+}
+
+} // extern "C"
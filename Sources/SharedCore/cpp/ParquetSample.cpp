@@ -0,0 +1,126 @@
+#include "../include/ParquetSample.h"
+#include "DistinctCounter.h"
+#include "ReaderInternal.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <unordered_set>
+
+namespace {
+
+// SplitMix64 (a counter through a strong mixer): small, fast and the same
+// on every platform, so a seed draws the same rows wherever it is replayed,
+// which std distributions do not promise
+class SampleRandom {
+public:
+    explicit SampleRandom(uint64_t seed) : state_(seed) {}
+
+    uint64_t next() { return parqview::hash_u64(state_++); }
+
+    // Uniform in [0, bound), without modulo bias
+    uint64_t below(uint64_t bound) {
+        uint64_t threshold = (0 - bound) % bound;
+        while (true) {
+            uint64_t value = next();
+            if (value >= threshold) {
+                return value % bound;
+            }
+        }
+    }
+
+private:
+    uint64_t state_;
+};
+
+// Floyd's algorithm: count distinct values from [first, first + range),
+// every subset equally likely, in O(count) time whatever the range
+void draw(SampleRandom& random, int64_t first, int64_t range, int64_t count, std::vector<int64_t>& out) {
+    if (count >= range) {
+        for (int64_t row = 0; row < range; row++) {
+            out.push_back(first + row);
+        }
+        return;
+    }
+    std::unordered_set<int64_t> chosen;
+    chosen.reserve(static_cast<size_t>(count) * 2);
+    for (int64_t j = range - count; j < range; j++) {
+        auto pick = static_cast<int64_t>(random.below(static_cast<uint64_t>(j) + 1));
+        if (!chosen.insert(pick).second) {
+            chosen.insert(j);
+        }
+    }
+    for (int64_t row : chosen) {
+        out.push_back(first + row);
+    }
+}
+
+// Splits count across row groups in proportion to their sizes, handing
+// the rounding remainder to the largest fractional shares
+std::vector<int64_t> allocate(const std::vector<int64_t>& offsets, int64_t count) {
+    size_t groups = offsets.size() - 1;
+    int64_t total = offsets.back();
+    std::vector<int64_t> shares(groups, 0);
+    std::vector<std::pair<double, size_t>> remainders;
+    int64_t assigned = 0;
+    for (size_t rg = 0; rg < groups; rg++) {
+        double exact = static_cast<double>(count) * static_cast<double>(offsets[rg + 1] - offsets[rg]) /
+                       static_cast<double>(total);
+        shares[rg] = static_cast<int64_t>(exact);
+        assigned += shares[rg];
+        remainders.emplace_back(exact - static_cast<double>(shares[rg]), rg);
+    }
+    std::sort(remainders.begin(), remainders.end(), [](const auto& a, const auto& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+    for (size_t i = 0; assigned < count && i < remainders.size(); i++) {
+        shares[remainders[i].second]++;
+        assigned++;
+    }
+    return shares;
+}
+
+} // namespace
+
+extern "C" {
+
+TableData* read_parquet_sample(const char* file_path, int sample_size, unsigned long long seed,
+                               int stratified, int max_cell_bytes, long long* row_numbers) {
+    try {
+        auto reader_ptr = get_cached_reader(file_path);
+        if (!reader_ptr || !(*reader_ptr)) {
+            return nullptr;
+        }
+        auto& reader = *reader_ptr;
+        auto offsets = parqview::row_group_offsets(*reader->parquet_reader()->metadata());
+        int64_t total = offsets.back();
+        int64_t count = std::min<int64_t>(std::max(sample_size, 0), total);
+
+        if (seed == 0) {
+            seed = static_cast<unsigned long long>(std::random_device{}()) ^
+                   static_cast<unsigned long long>(std::chrono::steady_clock::now().time_since_epoch().count());
+        }
+        SampleRandom random(seed);
+
+        std::vector<int64_t> rows;
+        rows.reserve(static_cast<size_t>(count));
+        if (stratified && count > 0 && count < total) {
+            auto shares = allocate(offsets, count);
+            for (size_t rg = 0; rg < shares.size(); rg++) {
+                draw(random, offsets[rg], offsets[rg + 1] - offsets[rg], shares[rg], rows);
+            }
+        } else {
+            draw(random, 0, total, count, rows);
+        }
+        std::sort(rows.begin(), rows.end());
+
+        auto* data = parqview::take_rows(file_path, reader->parquet_reader()->metadata(), rows, {}, max_cell_bytes);
+        parqview::copy_row_numbers(data, rows, 0, row_numbers);
+        return data;
+    } catch (const std::exception& e) {
+        std::cerr << "Error sampling rows: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+} // extern "C"
@@ -0,0 +1,376 @@
+#include "../include/ParquetStats.h"
+#include "DistinctCounter.h"
+#include "ReaderInternal.h"
+#include <parquet/column_page.h>
+#include <parquet/column_reader.h>
+#include <parquet/encoding.h>
+#include <parquet/statistics.h>
+#include <parquet/types.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+constexpr int64_t kBatch = 8192;
+
+// What read_parquet_column_stats reports, kept per fingerprint and column
+struct StatsResult {
+    bool complete = false;          // computed with scanning allowed
+    long long count = 0;
+    long long null_count = -1;
+    long long distinct_count = -1;
+    bool distinct_is_estimate = false;
+    bool scanned = false;
+    bool has_min_max = false;
+    std::string min_value;
+    std::string max_value;
+};
+
+std::mutex stats_mutex;
+std::unordered_map<std::string, StatsResult> stats_cache;
+
+// MARK: - Hashing
+
+uint64_t value_hash(bool value, int) {
+    return parqview::hash_u64(value ? 1 : 0);
+}
+
+uint64_t value_hash(int32_t value, int) {
+    return parqview::hash_u64(static_cast<uint64_t>(static_cast<int64_t>(value)));
+}
+
+uint64_t value_hash(int64_t value, int) {
+    return parqview::hash_u64(static_cast<uint64_t>(value));
+}
+
+uint64_t value_hash(float value, int) {
+    // -0.0 and 0.0 are the same value
+    if (value == 0.0f) {
+        value = 0.0f;
+    }
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return parqview::hash_u64(bits);
+}
+
+uint64_t value_hash(double value, int) {
+    if (value == 0.0) {
+        value = 0.0;
+    }
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return parqview::hash_u64(bits);
+}
+
+uint64_t value_hash(const parquet::Int96& value, int) {
+    return parqview::hash_bytes(&value.value[0], sizeof(value.value));
+}
+
+uint64_t value_hash(const parquet::ByteArray& value, int) {
+    return parqview::hash_bytes(value.ptr, value.len);
+}
+
+uint64_t value_hash(const parquet::FixedLenByteArray& value, int type_length) {
+    return parqview::hash_bytes(value.ptr, static_cast<size_t>(type_length));
+}
+
+// MARK: - Per row group work
+
+template <typename DType>
+struct ChunkSummary {
+    bool ok = true;
+    bool distinct_known = true;
+    bool scanned = false;
+    parqview::DistinctCounter distinct;
+    // Only filled when data pages had to be scanned for null count and min/max
+    std::shared_ptr<parquet::TypedStatistics<DType>> stats;
+};
+
+// The dictionary page of a fully dictionary-encoded chunk holds each of its
+// distinct values once, so hashing it counts distinct values without
+// touching the data pages
+template <typename DType>
+bool count_dictionary(parquet::ParquetFileReader& file, int rg, int leaf,
+                      const parquet::ColumnDescriptor& descr, parqview::DistinctCounter& counter) {
+    using T = typename DType::c_type;
+
+    auto pages = file.RowGroup(rg)->GetColumnPageReader(leaf);
+    auto page = pages->NextPage();
+    if (!page || page->type() != parquet::PageType::DICTIONARY_PAGE) {
+        return false;
+    }
+    const auto& dictionary = static_cast<const parquet::DictionaryPage&>(*page);
+    int count = dictionary.num_values();
+
+    auto decoder = parquet::MakeTypedDecoder<DType>(parquet::Encoding::PLAIN, &descr);
+    decoder->SetData(count, dictionary.data(), static_cast<int>(dictionary.size()));
+    std::unique_ptr<T[]> values(new T[std::max(count, 1)]);
+    int decoded = decoder->Decode(values.get(), count);
+    for (int i = 0; i < decoded; i++) {
+        counter.add(value_hash(values[i], descr.type_length()));
+    }
+    return true;
+}
+
+// Decodes every value of the chunk, feeding whichever of stats and counter
+// are given
+template <typename DType>
+void scan_chunk(parquet::ParquetFileReader& file, int rg, int leaf, const parquet::ColumnDescriptor& descr,
+                parquet::TypedStatistics<DType>* stats, parqview::DistinctCounter* counter) {
+    using T = typename DType::c_type;
+
+    auto column = file.RowGroup(rg)->Column(leaf);
+    auto* typed = static_cast<parquet::TypedColumnReader<DType>*>(column.get());
+    bool nullable = descr.max_definition_level() > 0;
+
+    std::vector<int16_t> def_levels(kBatch);
+    std::unique_ptr<T[]> values(new T[kBatch]);
+    while (typed->HasNext()) {
+        int64_t values_read = 0;
+        int64_t levels_read = typed->ReadBatch(kBatch, nullable ? def_levels.data() : nullptr,
+                                               nullptr, values.get(), &values_read);
+        if (levels_read <= 0) {
+            break;
+        }
+        if (stats) {
+            stats->Update(values.get(), values_read, levels_read - values_read);
+        }
+        if (counter) {
+            for (int64_t i = 0; i < values_read; i++) {
+                counter->add(value_hash(values[i], descr.type_length()));
+            }
+        }
+    }
+}
+
+// MARK: - Formatting
+
+// Converts min/max through the column's logical type, so a timestamp reads
+// as a timestamp rather than its raw int64
+void set_min_max(const parquet::Statistics& stats, StatsResult* result) {
+    if (!stats.HasMinMax()) {
+        return;
+    }
+    std::shared_ptr<arrow::Scalar> min;
+    std::shared_ptr<arrow::Scalar> max;
+    if (!parquet::arrow::StatisticsAsScalars(stats, &min, &max).ok() || !min || !max) {
+        return;
+    }
+    result->has_min_max = true;
+    result->min_value = parqview::format_scalar(*min);
+    result->max_value = parqview::format_scalar(*max);
+}
+
+// MARK: - Column statistics
+
+template <typename DType>
+bool compute_stats(const char* file_path, const std::shared_ptr<parquet::FileMetaData>& metadata,
+                   int leaf, bool allow_scan, StatsResult* result) {
+    const auto* descr = metadata->schema()->Column(leaf);
+    int num_row_groups = metadata->num_row_groups();
+
+    // Footer statistics are usable only if every row group has them: a null
+    // count, plus min/max unless the chunk is entirely null
+    auto footer = parquet::MakeStatistics<DType>(descr);
+    bool footer_complete = true;
+    for (int rg = 0; rg < num_row_groups && footer_complete; rg++) {
+        auto chunk = metadata->RowGroup(rg)->ColumnChunk(leaf);
+        auto stats = chunk->is_stats_set() ? chunk->statistics() : nullptr;
+        if (!stats || !stats->HasNullCount() ||
+            (!stats->HasMinMax() && stats->null_count() < chunk->num_values())) {
+            footer_complete = false;
+            break;
+        }
+        footer->Merge(static_cast<const parquet::TypedStatistics<DType>&>(*stats));
+    }
+
+    std::vector<ChunkSummary<DType>> chunks(num_row_groups);
+    parqview::parallel_for(num_row_groups, [&](int rg) {
+        auto& chunk = chunks[rg];
+        try {
+            bool from_dictionary = parqview::is_fully_dictionary_encoded(*metadata->RowGroup(rg)->ColumnChunk(leaf));
+            bool need_scan = !footer_complete || !from_dictionary;
+            if (!from_dictionary && !allow_scan) {
+                chunk.distinct_known = false;
+                return;
+            }
+
+            auto file = parqview::open_parquet_file(file_path, metadata);
+            if (!file) {
+                chunk.ok = false;
+                return;
+            }
+            if (from_dictionary && !count_dictionary<DType>(*file, rg, leaf, *descr, chunk.distinct)) {
+                // Metadata promised a dictionary the chunk does not start with
+                from_dictionary = false;
+                need_scan = true;
+                chunk.distinct = parqview::DistinctCounter();
+                chunk.distinct_known = allow_scan;
+            }
+            if (need_scan && allow_scan) {
+                if (!footer_complete) {
+                    chunk.stats = parquet::MakeStatistics<DType>(descr);
+                }
+                scan_chunk<DType>(*file, rg, leaf, *descr, chunk.stats.get(),
+                                  from_dictionary ? nullptr : &chunk.distinct);
+                chunk.scanned = true;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error reading statistics for row group " << rg << ": " << e.what() << std::endl;
+            chunk.ok = false;
+        }
+    });
+
+    parqview::DistinctCounter distinct;
+    bool distinct_known = true;
+    auto scanned_stats = parquet::MakeStatistics<DType>(descr);
+    for (auto& chunk : chunks) {
+        if (!chunk.ok) {
+            return false;
+        }
+        distinct_known = distinct_known && chunk.distinct_known;
+        distinct.merge(chunk.distinct);
+        result->scanned = result->scanned || chunk.scanned;
+        if (chunk.stats) {
+            scanned_stats->Merge(*chunk.stats);
+        }
+    }
+
+    result->complete = allow_scan;
+    result->count = metadata->num_rows();
+    if (footer_complete) {
+        result->null_count = footer->null_count();
+        set_min_max(*footer, result);
+    } else if (allow_scan) {
+        result->null_count = scanned_stats->null_count();
+        set_min_max(*scanned_stats, result);
+    }
+    if (distinct_known) {
+        // The HyperLogLog estimate can overshoot; a column never has more
+        // distinct values than non-null ones
+        long long values = result->count - std::max(result->null_count, 0LL);
+        result->distinct_count = std::min(static_cast<long long>(distinct.estimate()), values);
+        result->distinct_is_estimate = !distinct.is_exact();
+    }
+    return true;
+}
+
+bool compute_stats(const char* file_path, const std::shared_ptr<parquet::FileMetaData>& metadata,
+                   int leaf, bool allow_scan, StatsResult* result) {
+    switch (metadata->schema()->Column(leaf)->physical_type()) {
+        case parquet::Type::BOOLEAN:
+            return compute_stats<parquet::BooleanType>(file_path, metadata, leaf, allow_scan, result);
+        case parquet::Type::INT32:
+            return compute_stats<parquet::Int32Type>(file_path, metadata, leaf, allow_scan, result);
+        case parquet::Type::INT64:
+            return compute_stats<parquet::Int64Type>(file_path, metadata, leaf, allow_scan, result);
+        case parquet::Type::INT96:
+            return compute_stats<parquet::Int96Type>(file_path, metadata, leaf, allow_scan, result);
+        case parquet::Type::FLOAT:
+            return compute_stats<parquet::FloatType>(file_path, metadata, leaf, allow_scan, result);
+        case parquet::Type::DOUBLE:
+            return compute_stats<parquet::DoubleType>(file_path, metadata, leaf, allow_scan, result);
+        case parquet::Type::BYTE_ARRAY:
+            return compute_stats<parquet::ByteArrayType>(file_path, metadata, leaf, allow_scan, result);
+        case parquet::Type::FIXED_LEN_BYTE_ARRAY:
+            return compute_stats<parquet::FLBAType>(file_path, metadata, leaf, allow_scan, result);
+        default:
+            return false;
+    }
+}
+
+ColumnStats* to_column_stats(const StatsResult& result) {
+    auto* stats = new ColumnStats;
+    stats->count = result.count;
+    stats->null_count = result.null_count;
+    stats->distinct_count = result.distinct_count;
+    stats->distinct_is_estimate = result.distinct_is_estimate ? 1 : 0;
+    stats->min_value = result.has_min_max ? strdup(result.min_value.c_str()) : nullptr;
+    stats->max_value = result.has_min_max ? strdup(result.max_value.c_str()) : nullptr;
+    stats->scanned = result.scanned ? 1 : 0;
+    return stats;
+}
+
+} // namespace
+
+namespace parqview {
+
+void clear_column_stats_cache(const char* file_path) {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    if (!file_path) {
+        stats_cache.clear();
+        return;
+    }
+    // Keys start with the file fingerprint, which starts with "path|"
+    std::string prefix = std::string(file_path) + "|";
+    for (auto it = stats_cache.begin(); it != stats_cache.end();) {
+        if (it->first.compare(0, prefix.size(), prefix) == 0) {
+            it = stats_cache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace parqview
+
+extern "C" {
+
+ColumnStats* read_parquet_column_stats(const char* file_path, int column_index, int allow_scan) {
+    try {
+        auto reader_ptr = get_cached_reader(file_path);
+        if (!reader_ptr || !(*reader_ptr)) {
+            return nullptr;
+        }
+        auto& reader = *reader_ptr;
+        auto metadata = reader->parquet_reader()->metadata();
+
+        const auto& manifest = reader->manifest();
+        if (column_index < 0 || column_index >= static_cast<int>(manifest.schema_fields.size())) {
+            std::cerr << "Statistics column " << column_index << " out of range" << std::endl;
+            return nullptr;
+        }
+        const auto& field = manifest.schema_fields[column_index];
+        if (!field.is_leaf() || manifest.descr->Column(field.column_index)->max_repetition_level() > 0) {
+            std::cerr << "Statistics for nested column " << field.field->name() << " are not supported" << std::endl;
+            return nullptr;
+        }
+
+        std::string fingerprint = parqview::file_fingerprint(file_path);
+        std::string key = fingerprint + "#" + std::to_string(column_index);
+        if (!fingerprint.empty()) {
+            std::lock_guard<std::mutex> lock(stats_mutex);
+            auto it = stats_cache.find(key);
+            // A metadata-only result cannot answer a request that allows scanning
+            if (it != stats_cache.end() && (it->second.complete || !allow_scan)) {
+                return to_column_stats(it->second);
+            }
+        }
+
+        StatsResult result;
+        if (!compute_stats(file_path, metadata, field.column_index, allow_scan != 0, &result)) {
+            return nullptr;
+        }
+        if (!fingerprint.empty()) {
+            std::lock_guard<std::mutex> lock(stats_mutex);
+            stats_cache[key] = result;
+        }
+        return to_column_stats(result);
+    } catch (const std::exception& e) {
+        std::cerr << "Error reading column statistics: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+void free_column_stats(ColumnStats* stats) {
+    if (stats) {
+        free(stats->min_value);
+        free(stats->max_value);
+        delete stats;
+    }
+}
+
+} // extern "C"
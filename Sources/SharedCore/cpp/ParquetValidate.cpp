@@ -0,0 +1,318 @@
+#include "../include/ParquetValidate.h"
+#include "PageHeader.h"
+#include "ReaderInternal.h"
+#include <arrow/io/file.h>
+#include <parquet/column_reader.h>
+#include <parquet/page_index.h>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+
+namespace {
+
+// Values decoded per ReadBatch call
+constexpr int64_t kDecodeBatch = 4096;
+
+// Counts the pages handed to a ColumnReader, so that a failure while
+// decoding can be traced to the page that caused it
+class CountingPageReader : public parquet::PageReader {
+public:
+    explicit CountingPageReader(std::unique_ptr<parquet::PageReader> inner) : inner_(std::move(inner)) {}
+
+    std::shared_ptr<parquet::Page> NextPage() override {
+        requested_++;
+        return inner_->NextPage();
+    }
+
+    void set_max_page_header_size(uint32_t size) override { inner_->set_max_page_header_size(size); }
+
+    // Ordinal of the page last requested, which is the one being read or
+    // decoded when an error surfaces
+    int current_page() const { return requested_ - 1; }
+
+private:
+    std::unique_ptr<parquet::PageReader> inner_;
+    int requested_ = 0;
+};
+
+// Decodes every value of a column chunk, returning the levels read and
+// counting rows as the levels that start a new record
+template <typename DType>
+int64_t decode_chunk(parquet::ColumnReader& column, int64_t* rows) {
+    auto& reader = static_cast<parquet::TypedColumnReader<DType>&>(column);
+    bool repeated = column.descr()->max_repetition_level() > 0;
+    auto values = std::make_unique<typename DType::c_type[]>(kDecodeBatch);
+    std::vector<int16_t> def_levels(kDecodeBatch);
+    std::vector<int16_t> rep_levels(kDecodeBatch);
+    int64_t levels = 0;
+    while (reader.HasNext()) {
+        int64_t values_read = 0;
+        int64_t read = reader.ReadBatch(kDecodeBatch, def_levels.data(), rep_levels.data(), values.get(),
+                                        &values_read);
+        if (read == 0) {
+            break;
+        }
+        levels += read;
+        if (repeated) {
+            *rows += std::count(rep_levels.begin(), rep_levels.begin() + read, 0);
+        } else {
+            *rows += read;
+        }
+    }
+    return levels;
+}
+
+int64_t decode_chunk(parquet::ColumnReader& column, int64_t* rows) {
+    switch (column.type()) {
+        case parquet::Type::BOOLEAN: return decode_chunk<parquet::BooleanType>(column, rows);
+        case parquet::Type::INT32: return decode_chunk<parquet::Int32Type>(column, rows);
+        case parquet::Type::INT64: return decode_chunk<parquet::Int64Type>(column, rows);
+        case parquet::Type::INT96: return decode_chunk<parquet::Int96Type>(column, rows);
+        case parquet::Type::FLOAT: return decode_chunk<parquet::FloatType>(column, rows);
+        case parquet::Type::DOUBLE: return decode_chunk<parquet::DoubleType>(column, rows);
+        case parquet::Type::BYTE_ARRAY: return decode_chunk<parquet::ByteArrayType>(column, rows);
+        case parquet::Type::FIXED_LEN_BYTE_ARRAY: return decode_chunk<parquet::FLBAType>(column, rows);
+        default: throw parquet::ParquetException("unsupported physical type");
+    }
+}
+
+struct ChunkResult {
+    bool checked = false;
+    int64_t pages = 0;
+    int64_t checksummed_pages = 0;
+    int64_t bytes = 0;
+    int error_page = -1;
+    int64_t error_offset = -1;
+    std::string error;
+};
+
+void check_chunk(parquet::ParquetFileReader& reader, arrow::io::RandomAccessFile& file,
+                 const parquet::FileMetaData& metadata, int rg, int c, ChunkResult* result) {
+    result->checked = true;
+    auto row_group = metadata.RowGroup(rg);
+    auto chunk = row_group->ColumnChunk(c);
+
+    // First the structure, from the page headers alone: every page must
+    // fit inside the chunk and the pages must hold the values the footer
+    // promises
+    std::vector<int64_t> page_offsets;
+    std::vector<bool> page_checksummed;
+    std::vector<int> data_pages;  // ordinals of the data pages
+    int64_t next_offset = parqview::chunk_start_offset(*chunk);
+    int64_t values = 0;
+    std::string error;
+    bool walked = parqview::walk_chunk_pages(
+        file, *chunk,
+        [&](const parqview::PageHeader& header, int64_t body) {
+            if (header.is_data()) {
+                data_pages.push_back(static_cast<int>(page_offsets.size()));
+                values += header.value_count;
+            }
+            page_offsets.push_back(next_offset);
+            page_checksummed.push_back(header.has_crc);
+            result->bytes += header.header_size + header.compressed_size;
+            next_offset = body + header.compressed_size;
+            return true;
+        },
+        &error);
+    if (!walked) {
+        result->error_page = static_cast<int>(page_offsets.size());
+        result->error_offset = next_offset;
+        result->error = error;
+        return;
+    }
+    if (values != chunk->num_values()) {
+        result->error = "pages hold " + std::to_string(values) + " values, footer says " +
+                        std::to_string(chunk->num_values());
+        return;
+    }
+
+    // The offset index must point at those data pages, header included,
+    // since readers seek to its offsets without walking the chunk
+    if (auto location = chunk->GetOffsetIndexLocation()) {
+        auto bytes = file.ReadAt(location->offset, location->length);
+        if (!bytes.ok()) {
+            result->error = "offset index: " + bytes.status().ToString();
+            return;
+        }
+        auto index = parquet::OffsetIndex::Make((*bytes)->data(), static_cast<uint32_t>((*bytes)->size()),
+                                                parquet::default_reader_properties());
+        const auto& locations = index->page_locations();
+        if (locations.size() != data_pages.size()) {
+            result->error = "offset index lists " + std::to_string(locations.size()) + " pages, chunk holds " +
+                            std::to_string(data_pages.size());
+            return;
+        }
+        for (size_t i = 0; i < locations.size(); i++) {
+            int page = data_pages[i];
+            int64_t end = static_cast<size_t>(page) + 1 < page_offsets.size() ? page_offsets[page + 1] : next_offset;
+            if (locations[i].offset != page_offsets[page] ||
+                locations[i].compressed_page_size != end - page_offsets[page]) {
+                result->error_page = page;
+                result->error_offset = page_offsets[page];
+                result->error = "offset index puts page " + std::to_string(page) + " at " +
+                                std::to_string(locations[i].offset);
+                return;
+            }
+        }
+    }
+
+    // Then the contents: every page is read, its CRC checked by the page
+    // reader when present, decompressed and decoded
+    auto counting = std::make_unique<CountingPageReader>(reader.RowGroup(rg)->GetColumnPageReader(c));
+    auto* pages = counting.get();
+    int64_t rows = 0;
+    int64_t levels = 0;
+    try {
+        auto column = parquet::ColumnReader::Make(metadata.schema()->Column(c), std::move(counting));
+        levels = decode_chunk(*column, &rows);
+    } catch (const std::exception& e) {
+        int page = pages->current_page();
+        result->pages = page;
+        result->checksummed_pages = std::count(page_checksummed.begin(), page_checksummed.begin() +
+                                               std::min<size_t>(page, page_checksummed.size()), true);
+        result->error_page = page;
+        result->error_offset = page >= 0 && page < static_cast<int>(page_offsets.size()) ? page_offsets[page] : -1;
+        result->error = e.what();
+        return;
+    }
+    result->pages = static_cast<int64_t>(page_offsets.size());
+    result->checksummed_pages = std::count(page_checksummed.begin(), page_checksummed.end(), true);
+
+    if (levels != chunk->num_values()) {
+        result->error = "decoded " + std::to_string(levels) + " values, footer says " +
+                        std::to_string(chunk->num_values());
+    } else if (rows != row_group->num_rows()) {
+        result->error = "decoded " + std::to_string(rows) + " rows, footer says " +
+                        std::to_string(row_group->num_rows());
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+ValidationReport* validate_parquet_file(const char* file_path, int max_workers) {
+    try {
+        auto* report = new ValidationReport();
+
+        // The footer is parsed afresh rather than taken from the reader
+        // cache or a sidecar: it is part of what is being validated
+        int64_t file_size = 0;
+        std::string footer_error;
+        auto metadata = parqview::read_footer(file_path, &file_size, &footer_error);
+        if (!metadata) {
+            report->error = strdup(footer_error.c_str());
+            return report;
+        }
+
+        int columns = metadata->num_columns();
+        int row_groups = metadata->num_row_groups();
+        report->column_count = columns;
+        report->row_group_count = row_groups;
+        report->row_count = metadata->num_rows();
+        report->columns = new ColumnValidation[columns]();
+        const auto* schema = metadata->schema();
+        for (int c = 0; c < columns; c++) {
+            report->columns[c].path = strdup(schema->Column(c)->path()->ToDotString().c_str());
+            report->columns[c].error_row_group = -1;
+            report->columns[c].error_page = -1;
+            report->columns[c].error_offset = -1;
+        }
+
+        int64_t group_rows = 0;
+        for (int rg = 0; rg < row_groups; rg++) {
+            group_rows += metadata->RowGroup(rg)->num_rows();
+        }
+        if (group_rows != metadata->num_rows()) {
+            report->error = strdup(("row groups hold " + std::to_string(group_rows) + " rows, footer says " +
+                                    std::to_string(metadata->num_rows())).c_str());
+        }
+
+        auto file = arrow::io::ReadableFile::Open(file_path);
+        if (!file.ok()) {
+            std::cerr << "Error opening file for validation: " << file.status().ToString() << std::endl;
+            free_validation_report(report);
+            return nullptr;
+        }
+        std::shared_ptr<arrow::io::RandomAccessFile> input = *file;
+
+        // Buffered streams keep each worker to a bounded window of its chunk
+        // instead of reading whole chunks into memory
+        parquet::ReaderProperties properties;
+        properties.set_page_checksum_verification(true);
+        properties.enable_buffered_stream();
+        properties.set_buffer_size(1 << 20);
+        auto reader = parquet::ParquetFileReader::Open(input, properties, metadata);
+
+        // Chunks in row group order, so workers move through the file
+        // together; a column's later chunks are skipped once one fails
+        std::vector<ChunkResult> results(static_cast<size_t>(row_groups) * columns);
+        std::vector<std::atomic<int>> first_bad(columns);
+        for (auto& bad : first_bad) {
+            bad = row_groups;
+        }
+        int workers = max_workers > 0 ? max_workers
+                                      : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        parqview::parallel_for(row_groups * columns, workers, [&](int i) {
+            int rg = i / columns;
+            int c = i % columns;
+            if (rg > first_bad[c]) {
+                return;
+            }
+            auto& result = results[i];
+            try {
+                check_chunk(*reader, *input, *metadata, rg, c, &result);
+            } catch (const std::exception& e) {
+                result.error = e.what();
+            }
+            if (!result.error.empty()) {
+                int current = first_bad[c];
+                while (rg < current && !first_bad[c].compare_exchange_weak(current, rg)) {
+                }
+            }
+        });
+
+        for (int rg = 0; rg < row_groups; rg++) {
+            for (int c = 0; c < columns; c++) {
+                const auto& result = results[static_cast<size_t>(rg) * columns + c];
+                auto& column = report->columns[c];
+                if (!result.checked || column.error) {
+                    continue;
+                }
+                column.page_count += result.pages;
+                column.checksummed_page_count += result.checksummed_pages;
+                report->bytes_checked += result.bytes;
+                if (!result.error.empty()) {
+                    column.error_row_group = rg;
+                    column.error_page = result.error_page;
+                    column.error_offset = result.error_offset;
+                    column.error = strdup(result.error.c_str());
+                    report->invalid_column_count++;
+                }
+            }
+        }
+        for (int c = 0; c < columns; c++) {
+            report->page_count += report->columns[c].page_count;
+            report->checksummed_page_count += report->columns[c].checksummed_page_count;
+        }
+        return report;
+    } catch (const std::exception& e) {
+        std::cerr << "Error validating file: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+void free_validation_report(ValidationReport* report) {
+    if (report) {
+        for (int c = 0; c < report->column_count; c++) {
+            free(report->columns[c].path);
+            free(report->columns[c].error);
+        }
+        delete[] report->columns;
+        free(report->error);
+        delete report;
+    }
+}
+
+} // extern "C"
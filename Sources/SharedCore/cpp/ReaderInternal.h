@@ -0,0 +1,257 @@
+#ifndef PARQVIEW_READER_INTERNAL_H
+#define PARQVIEW_READER_INTERNAL_H
+
+// Helpers shared between the C++ translation units.
+// Not part of the C API exposed to Swift.
+
+#include "../include/ParquetMetadata.h"
+#include "../include/ParquetReader.h"
+#include "../include/ParquetPredicate.h"
+#include <arrow/api.h>
+#include <parquet/arrow/reader.h>
+#include <parquet/arrow/schema.h>
+#include <parquet/file_reader.h>
+#include <parquet/metadata.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+extern "C" std::unique_ptr<parquet::arrow::FileReader>* get_cached_reader(const char* file_path);
+
+namespace parqview {
+
+class RowBitmap;
+
+// Formats a single cell the same way read_parquet_data does
+std::string format_value(const arrow::Array& array, int64_t index);
+
+// Binary bytes as the table shows them, in the format set by
+// set_binary_format: the first preview bytes, then the length when cut
+std::string format_binary(std::string_view bytes);
+
+// Every byte as base64, for outputs that keep whole values
+std::string encode_base64(std::string_view bytes);
+
+// Formats a single value the same way, falling back to Arrow's own text
+// for types the table has no format for
+std::string format_scalar(const arrow::Scalar& scalar);
+
+// Formats a cell into data, cut to at most max_cell_bytes bytes on a UTF-8
+// character boundary (0 for no limit) and flagged in data->truncated when
+// cut. Strings are cut before they are copied.
+void set_cell(TableData* data, int row, int column, const arrow::Array& array, int64_t index, int max_cell_bytes);
+
+// Opens a fresh reader over an already parsed footer. Used by worker
+// threads, which must not share the cached FileReader.
+std::unique_ptr<parquet::arrow::FileReader> open_reader(
+    const char* file_path,
+    const std::shared_ptr<parquet::FileMetaData>& metadata,
+    const parquet::ArrowReaderProperties& arrow_props);
+
+// Opens the low-level parquet reader over an already parsed footer, for
+// scans that work on pages and statistics rather than Arrow arrays
+std::unique_ptr<parquet::ParquetFileReader> open_parquet_file(
+    const char* file_path,
+    const std::shared_ptr<parquet::FileMetaData>& metadata);
+
+// Identifies a file's current contents: path, size, mtime and inode.
+// Empty when the file cannot be stat'ed.
+std::string file_fingerprint(const char* file_path);
+
+// First global row of each row group, plus the total row count at the end
+std::vector<int64_t> row_group_offsets(const parquet::FileMetaData& metadata);
+
+// Rows of one row group that passed a filter, as a bitset over local rows.
+// all == true (and no words) means every row.
+struct RowSelection {
+    bool all = true;
+    int64_t count = 0;  // selected rows, when not all
+    std::vector<uint64_t> words;
+
+    bool contains(int64_t row) const {
+        return all || (words[row >> 6] >> (row & 63)) & 1;
+    }
+    bool empty() const { return !all && count == 0; }
+};
+
+// Splits a set of global rows into one selection per row group
+std::vector<RowSelection> select_row_groups(const RowBitmap& rows, const parquet::FileMetaData& metadata);
+
+// True when every data page of the chunk is dictionary-encoded, so its
+// dictionary page holds every distinct non-null value
+bool is_fully_dictionary_encoded(const parquet::ColumnChunkMetaData& chunk);
+
+// Appends the parquet leaf column indices backing a top-level field
+void collect_leaf_columns(const parquet::arrow::SchemaField& field, std::vector<int>& leaves);
+
+// Top-level field `field` of the manifest as the table shows it. A
+// fixed_len_byte_array(16) leaf with the UUID logical type is read as plain
+// fixed_size_binary unless Arrow's reader extensions are on, and those would
+// turn JSON columns into extension types too; it comes back typed or wrapped
+// as arrow.uuid so every cell formatter prints it canonically. Anything else
+// comes back as it is.
+std::shared_ptr<arrow::DataType> with_uuid_type(const std::shared_ptr<arrow::DataType>& type,
+                                                const parquet::arrow::SchemaManifest& manifest, int field);
+std::shared_ptr<arrow::Array> with_uuid_type(const std::shared_ptr<arrow::Array>& array,
+                                             const parquet::arrow::SchemaManifest& manifest, int field);
+std::shared_ptr<arrow::ChunkedArray> with_uuid_type(const std::shared_ptr<arrow::ChunkedArray>& column,
+                                                    const parquet::arrow::SchemaManifest& manifest, int field);
+
+// Describes an Arrow schema's top-level fields as read_parquet_schema does
+SchemaInfo* schema_info(const arrow::Schema& schema, int64_t row_count);
+
+// Allocates a TableData with every cell set to nullptr
+TableData* allocate_table_data(int row_count, int column_count);
+
+// Writes the file row of each row of data to row_numbers unless either is
+// NULL: rows[i], or first_row + i when rows is empty (a page in file order)
+void copy_row_numbers(const TableData* data, const std::vector<int64_t>& rows, int64_t first_row,
+                      long long* row_numbers);
+
+// Formats the given rows (ascending) of one column into data starting at
+// first_row, cut as set_cell does
+void fill_column_rows(TableData* data, int first_row, int column, const arrow::ChunkedArray& values,
+                      const std::vector<int64_t>& rows, int max_cell_bytes = 0);
+
+// Reads the given global rows (ascending) with the given top-level columns
+// (ascending), or every column when columns is empty, cut as set_cell does.
+// Only the pages holding those rows are decoded where the column allows
+// it, otherwise only the row groups holding them. Defined in
+// RowMaterializer.cpp.
+TableData* take_rows(parquet::arrow::FileReader& reader, const std::vector<int64_t>& rows,
+                     const std::vector<int>& columns = {}, int max_cell_bytes = 0);
+
+// take_rows through a reader of its own over an already parsed footer.
+// Pages, samples and searches take rows while background scans and other
+// pages read the same file, so they must not share the cached FileReader.
+TableData* take_rows(const char* file_path, const std::shared_ptr<parquet::FileMetaData>& metadata,
+                     const std::vector<int64_t>& rows, const std::vector<int>& columns = {},
+                     int max_cell_bytes = 0);
+
+// Rows matching every predicate (AND), from the bitmap cache or a fresh
+// scan. A cached hit reports the stats of the scan that built it. NULL
+// when a predicate does not fit its column or a read fails.
+// Defined in ParquetPredicate.cpp.
+std::shared_ptr<const RowBitmap> match_predicates(const char* file_path, parquet::arrow::FileReader& reader,
+                                                  const ColumnPredicate* predicates, int predicate_count,
+                                                  PredicateScanStats* stats);
+
+// Rows holding filter_text in any of the given top-level columns (every
+// column when column_indices is NULL), matched as read_parquet_filtered_page
+// does, from the bitmap cache or a fresh scan. filter_text must not be
+// empty. NULL when a read fails. Defined in ParquetFilter.cpp.
+std::shared_ptr<const RowBitmap> match_text_filter(const char* file_path, parquet::arrow::FileReader& reader,
+                                                   const char* filter_text, const int* column_indices,
+                                                   int column_count);
+
+// Drops cached column statistics for file_path, or for every file when
+// file_path is null. Defined in ParquetStats.cpp.
+void clear_column_stats_cache(const char* file_path);
+
+// Drops cached profile sketches for file_path, or for every file when
+// file_path is null. Defined in ParquetProfile.cpp.
+void clear_profile_cache(const char* file_path);
+
+// Drops the cached listing and footers of dataset_path, or of every
+// dataset when dataset_path is null. Defined in ParquetDataset.cpp.
+void clear_dataset_cache(const char* dataset_path);
+
+// Every file under a directory (recursively, skipping hidden and
+// _-prefixed entries), a glob's matches, or the path itself, sorted. root
+// receives the directory partition paths are relative to. Defined in
+// ParquetCatalog.cpp.
+std::vector<std::string> list_dataset_files(const std::string& pattern, std::string* root);
+
+// Concurrent footer reads when scanning many files; footers are small, so
+// latency rather than bandwidth bounds them
+constexpr int kMaxConcurrentFooterReads = 16;
+
+// Parses a file's footer from a speculative read of its last 64 KB, plus
+// one exact read when the footer is larger, without opening a FileReader.
+// NULL with error set when the file is not readable Parquet. Defined in
+// ParquetCatalog.cpp.
+std::shared_ptr<parquet::FileMetaData> read_footer(const std::string& path, int64_t* file_size, std::string* error);
+
+// What a footer sidecar remembers about a file
+struct FooterSidecar {
+    int64_t row_count = 0;
+    std::vector<int64_t> row_group_offsets;
+    std::vector<std::pair<std::string, std::string>> columns;  // Arrow field names and types
+    std::string metadata;                                      // serialized FileMetaData
+};
+
+// Loads the sidecar of file_path if it was written for the same
+// fingerprint, leaving metadata empty unless with_metadata is set. False
+// when the cache is off or the sidecar is missing, stale or damaged.
+// Defined in ParquetFooterCache.cpp.
+bool load_footer_sidecar(const char* file_path, const std::string& fingerprint, bool with_metadata,
+                         FooterSidecar* sidecar);
+
+// Parses the footer kept in a sidecar; NULL when it does not decode
+std::shared_ptr<parquet::FileMetaData> sidecar_metadata(const FooterSidecar& sidecar);
+
+// Writes the sidecar of file_path, replacing any older one. Does nothing
+// when the cache is off; failures are logged and otherwise ignored.
+void store_footer_sidecar(const char* file_path, const std::string& fingerprint,
+                          const parquet::FileMetaData& metadata, const arrow::Schema& schema);
+
+// The C enum value of a chunk's compression. Defined in ParquetMetadata.cpp.
+ParquetCodec codec_of(parquet::Compression::type compression);
+
+// The compression a writer uses for codec; PARQUET_CODEC_OTHER writes
+// uncompressed. Defined in ParquetMetadata.cpp.
+parquet::Compression::type compression_of(ParquetCodec codec);
+
+// Reads rows [start_row, start_row + num_rows) from the Arrow copy of
+// file_path, formatted as read_parquet_page does. NULL when the file has no
+// current copy. Defined in ParquetAccelerate.cpp.
+TableData* read_accelerated_rows(const char* file_path, int64_t start_row, int num_rows, int max_cell_bytes = 0);
+
+// The column with dictionary chunks replaced by their values, for outputs
+// such as IPC files that cannot hold a different dictionary per chunk.
+// Other columns are returned as they are. Defined in ParquetAccelerate.cpp.
+std::shared_ptr<arrow::ChunkedArray> decode_dictionary(const std::shared_ptr<arrow::ChunkedArray>& column);
+
+// Closes the open Arrow copy of file_path, or of every file when file_path
+// is null. The copies stay on disk. Defined in ParquetAccelerate.cpp.
+void clear_accelerated_cache(const char* file_path);
+
+// Runs fn(i) for i in [0, count) on up to max_workers threads
+template <typename Fn>
+void parallel_for(int count, int max_workers, Fn&& fn) {
+    int workers = std::min(count, max_workers);
+    if (workers <= 1) {
+        for (int i = 0; i < count; i++) {
+            fn(i);
+        }
+        return;
+    }
+
+    std::atomic<int> next{0};
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for (int w = 0; w < workers; w++) {
+        threads.emplace_back([&]() {
+            for (int i = next++; i < count; i = next++) {
+                fn(i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+// Runs fn(i) for i in [0, count) on up to hardware_concurrency threads
+template <typename Fn>
+void parallel_for(int count, Fn&& fn) {
+    parallel_for(count, static_cast<int>(std::max(1u, std::thread::hardware_concurrency())), std::forward<Fn>(fn));
+}
+
+} // namespace parqview
+
+#endif // PARQVIEW_READER_INTERNAL_H
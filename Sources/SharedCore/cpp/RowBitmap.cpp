@@ -0,0 +1,215 @@
+#include "RowBitmap.h"
+#include <algorithm>
+
+namespace parqview {
+
+namespace {
+
+// Containers above this many values are cheaper as an 8 KB bitset
+constexpr size_t kArrayLimit = 4096;
+constexpr size_t kBitsetWords = 1024;
+
+} // namespace
+
+void RowBitmap::Builder::add(uint64_t row) {
+    uint64_t key = row >> 16;
+    if (!pending_.empty() && key != pending_key_) {
+        flush();
+    }
+    pending_key_ = key;
+    pending_.push_back(static_cast<uint16_t>(row & 0xFFFF));
+}
+
+void RowBitmap::Builder::flush() {
+    if (pending_.empty()) {
+        return;
+    }
+    result_.push(Container::make(pending_key_, pending_));
+    pending_.clear();
+}
+
+RowBitmap RowBitmap::Builder::finish() {
+    flush();
+    RowBitmap result = std::move(result_);
+    result_ = RowBitmap();
+    return result;
+}
+
+RowBitmap::Container RowBitmap::Container::make(uint64_t key, const std::vector<uint16_t>& lows) {
+    Container container;
+    container.key = key;
+    container.cardinality = static_cast<uint32_t>(lows.size());
+
+    size_t runs = lows.empty() ? 0 : 1;
+    for (size_t i = 1; i < lows.size(); i++) {
+        if (lows[i] != lows[i - 1] + 1) {
+            runs++;
+        }
+    }
+
+    // Pick the smallest encoding, in bytes
+    size_t array_bytes = lows.size() * sizeof(uint16_t);
+    size_t bitset_bytes = kBitsetWords * sizeof(uint64_t);
+    size_t run_bytes = runs * 2 * sizeof(uint16_t);
+
+    if (run_bytes < std::min(array_bytes, bitset_bytes)) {
+        container.kind = Kind::Runs;
+        container.values.reserve(runs * 2);
+        size_t start = 0;
+        for (size_t i = 1; i <= lows.size(); i++) {
+            if (i == lows.size() || lows[i] != lows[i - 1] + 1) {
+                container.values.push_back(lows[start]);
+                container.values.push_back(static_cast<uint16_t>(i - start - 1));
+                start = i;
+            }
+        }
+    } else if (lows.size() <= kArrayLimit) {
+        container.kind = Kind::Array;
+        container.values = lows;
+    } else {
+        container.kind = Kind::Bitset;
+        container.words.assign(kBitsetWords, 0);
+        for (uint16_t low : lows) {
+            container.words[low >> 6] |= uint64_t(1) << (low & 63);
+        }
+    }
+    return container;
+}
+
+void RowBitmap::Container::decode(std::vector<uint16_t>& lows) const {
+    visit(0, cardinality, [&](uint32_t low) { lows.push_back(static_cast<uint16_t>(low)); });
+}
+
+size_t RowBitmap::Container::memory_usage() const {
+    return sizeof(Container) + values.capacity() * sizeof(uint16_t) +
+           words.capacity() * sizeof(uint64_t);
+}
+
+void RowBitmap::push(Container&& container) {
+    cumulative_.push_back(cardinality_);
+    cardinality_ += container.cardinality;
+    containers_.push_back(std::move(container));
+}
+
+size_t RowBitmap::memory_usage() const {
+    size_t bytes = sizeof(RowBitmap) + cumulative_.capacity() * sizeof(uint64_t);
+    for (const auto& container : containers_) {
+        bytes += container.memory_usage();
+    }
+    return bytes;
+}
+
+void RowBitmap::append(RowBitmap&& later) {
+    size_t first = 0;
+
+    // Row groups rarely end on a container boundary: merge the shared container
+    if (!containers_.empty() && !later.containers_.empty() &&
+        containers_.back().key == later.containers_.front().key) {
+        std::vector<uint16_t> lows;
+        containers_.back().decode(lows);
+        later.containers_.front().decode(lows);
+        uint64_t key = containers_.back().key;
+
+        cardinality_ -= containers_.back().cardinality;
+        containers_.pop_back();
+        cumulative_.pop_back();
+        push(Container::make(key, lows));
+        first = 1;
+    }
+
+    for (size_t i = first; i < later.containers_.size(); i++) {
+        push(std::move(later.containers_[i]));
+    }
+    later = RowBitmap();
+}
+
+void RowBitmap::select_range(uint64_t first, uint64_t count, std::vector<uint64_t>& out) const {
+    if (first >= cardinality_ || count == 0) {
+        return;
+    }
+
+    // Last container whose cumulative count is <= first holds the first row
+    size_t index = static_cast<size_t>(
+        std::upper_bound(cumulative_.begin(), cumulative_.end(), first) - cumulative_.begin() - 1);
+
+    uint64_t remaining = std::min(count, cardinality_ - first);
+    uint64_t local_first = first - cumulative_[index];
+    for (; index < containers_.size() && remaining > 0; index++) {
+        const auto& container = containers_[index];
+        uint64_t base = container.key << 16;
+        uint32_t take = static_cast<uint32_t>(
+            std::min<uint64_t>(remaining, container.cardinality - local_first));
+        container.visit(static_cast<uint32_t>(local_first), take,
+                        [&](uint32_t low) { out.push_back(base | low); });
+        remaining -= take;
+        local_first = 0;
+    }
+}
+
+std::shared_ptr<const RowBitmap> RowBitmapCache::find(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        return nullptr;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second.position);
+    return it->second.bitmap;
+}
+
+void RowBitmapCache::insert(const std::string& key, std::shared_ptr<const RowBitmap> bitmap) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.count(key)) {
+        return;
+    }
+    size_t bytes = bitmap->memory_usage() + key.size();
+    if (bytes > kByteBudget) {
+        return;
+    }
+
+    lru_.push_front(key);
+    entries_[key] = Entry{std::move(bitmap), bytes, lru_.begin()};
+    bytes_ += bytes;
+
+    while (bytes_ > kByteBudget && !lru_.empty()) {
+        erase(lru_.back());
+    }
+}
+
+void RowBitmapCache::clear(const char* file_path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_path) {
+        entries_.clear();
+        lru_.clear();
+        bytes_ = 0;
+        return;
+    }
+
+    // Keys start with the file fingerprint, which starts with "path|"
+    std::string prefix = std::string(file_path) + "|";
+    std::vector<std::string> doomed;
+    for (const auto& entry : entries_) {
+        if (entry.first.compare(0, prefix.size(), prefix) == 0) {
+            doomed.push_back(entry.first);
+        }
+    }
+    for (const auto& key : doomed) {
+        erase(key);
+    }
+}
+
+void RowBitmapCache::erase(const std::string& key) {
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        return;
+    }
+    bytes_ -= it->second.bytes;
+    lru_.erase(it->second.position);
+    entries_.erase(it);
+}
+
+RowBitmapCache& row_bitmap_cache() {
+    static RowBitmapCache cache;
+    return cache;
+}
+
+} // namespace parqview
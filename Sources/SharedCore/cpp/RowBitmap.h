@@ -0,0 +1,171 @@
+#ifndef PARQVIEW_ROW_BITMAP_H
+#define PARQVIEW_ROW_BITMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace parqview {
+
+// Compressed set of row numbers, organised like a roaring bitmap: rows are
+// split into 65536-row containers, each stored as a sorted array, a bitset
+// or a list of runs, whichever is smallest. A running cardinality per
+// container makes select (the k-th matching row) a binary search.
+class RowBitmap {
+public:
+    class Builder;
+
+    uint64_t cardinality() const { return cardinality_; }
+    bool empty() const { return cardinality_ == 0; }
+    size_t memory_usage() const;
+
+    // Appends rows that all lie after the last row of this bitmap
+    void append(RowBitmap&& later);
+
+    // Appends the rows of rank [first, first + count) to out, ascending
+    void select_range(uint64_t first, uint64_t count, std::vector<uint64_t>& out) const;
+
+    // Calls fn(row) for every row, ascending
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (const auto& container : containers_) {
+            uint64_t base = container.key << 16;
+            container.visit(0, container.cardinality, [&](uint32_t low) { fn(base | low); });
+        }
+    }
+
+private:
+    enum class Kind : uint8_t { Array, Bitset, Runs };
+
+    struct Container {
+        uint64_t key = 0;
+        Kind kind = Kind::Array;
+        uint32_t cardinality = 0;
+        // Array: sorted lows. Runs: (start, length - 1) pairs.
+        std::vector<uint16_t> values;
+        // Bitset: 1024 words covering the 65536 lows
+        std::vector<uint64_t> words;
+
+        static Container make(uint64_t key, const std::vector<uint16_t>& lows);
+        void decode(std::vector<uint16_t>& lows) const;
+        size_t memory_usage() const;
+
+        // Calls fn(low) for the values of local rank [first, first + count)
+        template <typename Fn>
+        void visit(uint32_t first, uint32_t count, Fn&& fn) const;
+    };
+
+    void push(Container&& container);
+
+    std::vector<Container> containers_;
+    // cumulative_[i] = number of rows in the containers before i
+    std::vector<uint64_t> cumulative_;
+    uint64_t cardinality_ = 0;
+};
+
+// Accumulates rows in strictly ascending order
+class RowBitmap::Builder {
+public:
+    void add(uint64_t row);
+    RowBitmap finish();
+
+private:
+    void flush();
+
+    RowBitmap result_;
+    std::vector<uint16_t> pending_;
+    uint64_t pending_key_ = 0;
+};
+
+template <typename Fn>
+void RowBitmap::Container::visit(uint32_t first, uint32_t count, Fn&& fn) const {
+    uint32_t end = first + count < cardinality ? first + count : cardinality;
+    if (first >= end) {
+        return;
+    }
+
+    switch (kind) {
+        case Kind::Array:
+            for (uint32_t i = first; i < end; i++) {
+                fn(static_cast<uint32_t>(values[i]));
+            }
+            return;
+        case Kind::Bitset: {
+            uint32_t rank = 0;
+            for (uint32_t word = 0; word < words.size() && rank < end; word++) {
+                uint64_t bits = words[word];
+                uint32_t bit_count = static_cast<uint32_t>(__builtin_popcountll(bits));
+                // Whole words below the requested rank are skipped by popcount
+                if (rank + bit_count <= first) {
+                    rank += bit_count;
+                    continue;
+                }
+                while (bits && rank < end) {
+                    uint32_t bit = static_cast<uint32_t>(__builtin_ctzll(bits));
+                    bits &= bits - 1;
+                    if (rank++ >= first) {
+                        fn(word * 64 + bit);
+                    }
+                }
+            }
+            return;
+        }
+        case Kind::Runs: {
+            uint32_t rank = 0;
+            for (size_t i = 0; i + 1 < values.size() && rank < end; i += 2) {
+                uint32_t start = values[i];
+                uint32_t length = static_cast<uint32_t>(values[i + 1]) + 1;
+                if (rank + length <= first) {
+                    rank += length;
+                    continue;
+                }
+                uint32_t from = first > rank ? first - rank : 0;
+                uint32_t to = end - rank < length ? end - rank : length;
+                for (uint32_t v = from; v < to; v++) {
+                    fn(start + v);
+                }
+                rank += length;
+            }
+            return;
+        }
+    }
+}
+
+// Filter results keyed by file fingerprint plus a description of the filter,
+// so paging through a filtered view is a select over a cached bitmap rather
+// than a rescan. Least recently used entries go once the byte budget is hit.
+class RowBitmapCache {
+public:
+    std::shared_ptr<const RowBitmap> find(const std::string& key);
+    void insert(const std::string& key, std::shared_ptr<const RowBitmap> bitmap);
+
+    // Drops every entry whose fingerprint belongs to file_path, or all entries
+    void clear(const char* file_path);
+
+private:
+    static constexpr size_t kByteBudget = 256ull * 1024 * 1024;
+
+    struct Entry {
+        std::shared_ptr<const RowBitmap> bitmap;
+        size_t bytes;
+        std::list<std::string>::iterator position;
+    };
+
+    void erase(const std::string& key);
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::list<std::string> lru_;
+    size_t bytes_ = 0;
+};
+
+RowBitmapCache& row_bitmap_cache();
+
+} // namespace parqview
+
+#endif // PARQVIEW_ROW_BITMAP_H
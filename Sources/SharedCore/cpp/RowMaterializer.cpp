@@ -0,0 +1,378 @@
+#include "ReaderInternal.h"
+#include <parquet/column_reader.h>
+#include <parquet/page_index.h>
+#include <parquet/types.h>
+#include <iostream>
+
+// Late materialization: once a scan has decided which rows to show, only the
+// pages holding those rows are decompressed and decoded, column by column.
+// The Arrow reader can only read whole row groups, so flat columns of common
+// types go through the low-level column reader instead, and the decoded
+// values are wrapped in an Arrow array of the same type the Arrow reader
+// would have produced. Anything else falls back to a row-group read.
+
+namespace {
+
+// Whether the values of a flat column can be copied straight into an array
+// of its Arrow type: same physical layout, no unit or scale conversion
+bool supports_page_reads(const parquet::ColumnDescriptor& descr, const arrow::DataType& type) {
+    if (descr.max_repetition_level() > 0) {
+        return false;
+    }
+    const auto& logical = descr.logical_type();
+    switch (descr.physical_type()) {
+        case parquet::Type::BOOLEAN:
+            return type.id() == arrow::Type::BOOL;
+        case parquet::Type::INT32:
+            switch (type.id()) {
+                case arrow::Type::INT8:
+                case arrow::Type::INT16:
+                case arrow::Type::INT32:
+                case arrow::Type::UINT8:
+                case arrow::Type::UINT16:
+                case arrow::Type::UINT32:
+                case arrow::Type::DATE32:
+                case arrow::Type::TIME32:
+                    return true;
+                default:
+                    return false;
+            }
+        case parquet::Type::INT64:
+            switch (type.id()) {
+                case arrow::Type::INT64:
+                case arrow::Type::UINT64:
+                case arrow::Type::TIME64:
+                    return true;
+                case arrow::Type::TIMESTAMP: {
+                    // Arrow rescales when the stored schema asks for another unit
+                    if (!logical || !logical->is_timestamp()) {
+                        return false;
+                    }
+                    auto unit = static_cast<const parquet::TimestampLogicalType&>(*logical).time_unit();
+                    auto arrow_unit = static_cast<const arrow::TimestampType&>(type).unit();
+                    return (unit == parquet::LogicalType::TimeUnit::MILLIS && arrow_unit == arrow::TimeUnit::MILLI) ||
+                           (unit == parquet::LogicalType::TimeUnit::MICROS && arrow_unit == arrow::TimeUnit::MICRO) ||
+                           (unit == parquet::LogicalType::TimeUnit::NANOS && arrow_unit == arrow::TimeUnit::NANO);
+                }
+                default:
+                    return false;
+            }
+        case parquet::Type::FLOAT:
+            return type.id() == arrow::Type::FLOAT;
+        case parquet::Type::DOUBLE:
+            return type.id() == arrow::Type::DOUBLE;
+        case parquet::Type::BYTE_ARRAY:
+            return type.id() == arrow::Type::STRING || type.id() == arrow::Type::BINARY ||
+                   (type.id() == arrow::Type::DICTIONARY &&
+                    (static_cast<const arrow::DictionaryType&>(type).value_type()->id() == arrow::Type::STRING ||
+                     static_cast<const arrow::DictionaryType&>(type).value_type()->id() == arrow::Type::BINARY));
+        default:
+            return false;
+    }
+}
+
+// The type the decoded values are given: dictionaries are read as their
+// plain value type, which formats identically
+std::shared_ptr<arrow::DataType> materialized_type(const std::shared_ptr<arrow::DataType>& type) {
+    if (type->id() == arrow::Type::DICTIONARY) {
+        return static_cast<const arrow::DictionaryType&>(*type).value_type();
+    }
+    return type;
+}
+
+// Appends decoded physical values into a builder for the column's storage
+// type, e.g. Int16Builder for an int16 column stored as INT32
+template <typename T>
+arrow::Status append_value(arrow::ArrayBuilder& builder, arrow::Type::type storage, const T& value) {
+    if constexpr (std::is_same_v<T, parquet::ByteArray>) {
+        return static_cast<arrow::BinaryBuilder&>(builder).Append(value.ptr, static_cast<int32_t>(value.len));
+    } else {
+        switch (storage) {
+            case arrow::Type::BOOL: return static_cast<arrow::BooleanBuilder&>(builder).Append(value != 0);
+            case arrow::Type::INT8: return static_cast<arrow::Int8Builder&>(builder).Append(static_cast<int8_t>(value));
+            case arrow::Type::INT16: return static_cast<arrow::Int16Builder&>(builder).Append(static_cast<int16_t>(value));
+            case arrow::Type::INT32: return static_cast<arrow::Int32Builder&>(builder).Append(static_cast<int32_t>(value));
+            case arrow::Type::INT64: return static_cast<arrow::Int64Builder&>(builder).Append(static_cast<int64_t>(value));
+            case arrow::Type::UINT8: return static_cast<arrow::UInt8Builder&>(builder).Append(static_cast<uint8_t>(value));
+            case arrow::Type::UINT16: return static_cast<arrow::UInt16Builder&>(builder).Append(static_cast<uint16_t>(value));
+            case arrow::Type::UINT32: return static_cast<arrow::UInt32Builder&>(builder).Append(static_cast<uint32_t>(value));
+            case arrow::Type::UINT64: return static_cast<arrow::UInt64Builder&>(builder).Append(static_cast<uint64_t>(value));
+            case arrow::Type::FLOAT: return static_cast<arrow::FloatBuilder&>(builder).Append(static_cast<float>(value));
+            case arrow::Type::DOUBLE: return static_cast<arrow::DoubleBuilder&>(builder).Append(static_cast<double>(value));
+            default: return arrow::Status::NotImplemented("storage type");
+        }
+    }
+}
+
+// Storage type with the same layout as a supported Arrow type
+arrow::Type::type storage_type(const arrow::DataType& type) {
+    switch (type.id()) {
+        case arrow::Type::DATE32:
+        case arrow::Type::TIME32:
+            return arrow::Type::INT32;
+        case arrow::Type::TIME64:
+        case arrow::Type::TIMESTAMP:
+            return arrow::Type::INT64;
+        case arrow::Type::STRING:
+            return arrow::Type::BINARY;
+        default:
+            return type.id();
+    }
+}
+
+std::shared_ptr<arrow::DataType> storage_arrow_type(arrow::Type::type storage) {
+    switch (storage) {
+        case arrow::Type::BOOL: return arrow::boolean();
+        case arrow::Type::INT8: return arrow::int8();
+        case arrow::Type::INT16: return arrow::int16();
+        case arrow::Type::INT32: return arrow::int32();
+        case arrow::Type::INT64: return arrow::int64();
+        case arrow::Type::UINT8: return arrow::uint8();
+        case arrow::Type::UINT16: return arrow::uint16();
+        case arrow::Type::UINT32: return arrow::uint32();
+        case arrow::Type::UINT64: return arrow::uint64();
+        case arrow::Type::FLOAT: return arrow::float32();
+        case arrow::Type::DOUBLE: return arrow::float64();
+        default: return arrow::binary();
+    }
+}
+
+// Decodes the pages of one column that hold local_rows (ascending) and
+// returns their values in order. Pages without a requested row are skipped
+// before decompression when the offset index is available; without it the
+// column is decoded only up to the last requested row.
+template <typename DType>
+std::shared_ptr<arrow::Array> read_rows_typed(parquet::RowGroupReader& rg_reader, int leaf,
+                                              const parquet::ColumnDescriptor& descr,
+                                              const parquet::OffsetIndex* offset_index,
+                                              int64_t rg_rows, const std::vector<int64_t>& local_rows,
+                                              const std::shared_ptr<arrow::DataType>& type) {
+    using T = typename DType::c_type;
+
+    // Row spans of the pages that will be decoded, in order
+    std::vector<std::pair<int64_t, int64_t>> spans;
+    std::vector<bool> keep_page;
+    if (offset_index) {
+        const auto& pages = offset_index->page_locations();
+        size_t next = 0;
+        for (size_t i = 0; i < pages.size(); i++) {
+            int64_t begin = pages[i].first_row_index;
+            int64_t end = i + 1 < pages.size() ? pages[i + 1].first_row_index : rg_rows;
+            while (next < local_rows.size() && local_rows[next] < begin) {
+                next++;
+            }
+            bool keep = next < local_rows.size() && local_rows[next] < end;
+            keep_page.push_back(keep);
+            if (keep) {
+                spans.emplace_back(begin, end);
+            }
+        }
+    } else {
+        spans.emplace_back(0, rg_rows);
+    }
+
+    auto pager = rg_reader.GetColumnPageReader(leaf);
+    if (offset_index) {
+        size_t page_ordinal = 0;
+        pager->set_data_page_filter([&keep_page, page_ordinal](const parquet::DataPageStats&) mutable {
+            bool keep = page_ordinal < keep_page.size() && keep_page[page_ordinal];
+            page_ordinal++;
+            return !keep;
+        });
+    }
+    auto column_reader = parquet::ColumnReader::Make(&descr, std::move(pager));
+    auto* typed = static_cast<parquet::TypedColumnReader<DType>*>(column_reader.get());
+
+    arrow::Type::type storage = storage_type(*type);
+    std::unique_ptr<arrow::ArrayBuilder> builder;
+    if (!arrow::MakeBuilder(arrow::default_memory_pool(), storage_arrow_type(storage), &builder).ok()) {
+        return nullptr;
+    }
+
+    const int16_t max_def = descr.max_definition_level();
+    constexpr int64_t kBatch = 4096;
+    // Not std::vector: vector<bool> has no contiguous storage for BOOLEAN
+    std::unique_ptr<T[]> values(new T[kBatch]);
+    std::vector<int16_t> def_levels(kBatch);
+
+    size_t span = 0;
+    size_t wanted = 0;
+    int64_t row = spans.empty() ? rg_rows : spans[0].first;
+    while (wanted < local_rows.size() && typed->HasNext()) {
+        int64_t values_read = 0;
+        int64_t levels_read = typed->ReadBatch(kBatch, max_def > 0 ? def_levels.data() : nullptr,
+                                               nullptr, values.get(), &values_read);
+        if (levels_read <= 0) {
+            break;
+        }
+
+        int64_t value_index = 0;
+        for (int64_t level = 0; level < levels_read && wanted < local_rows.size(); level++) {
+            // Consecutive decoded pages may not be adjacent rows
+            while (span < spans.size() && row >= spans[span].second) {
+                span++;
+                if (span < spans.size()) {
+                    row = spans[span].first;
+                }
+            }
+            if (span >= spans.size()) {
+                break;
+            }
+
+            bool is_null = max_def > 0 && def_levels[level] < max_def;
+            if (row == local_rows[wanted]) {
+                auto status = is_null ? builder->AppendNull()
+                                      : append_value(*builder, storage, values[value_index]);
+                if (!status.ok()) {
+                    return nullptr;
+                }
+                wanted++;
+            }
+            if (!is_null) {
+                value_index++;
+            }
+            row++;
+        }
+    }
+    if (wanted != local_rows.size()) {
+        return nullptr;
+    }
+
+    std::shared_ptr<arrow::Array> storage_array;
+    if (!builder->Finish(&storage_array).ok()) {
+        return nullptr;
+    }
+    // Same layout, so only the type changes (int32 -> date32, binary -> utf8, ...)
+    auto data = storage_array->data()->Copy();
+    data->type = type;
+    return arrow::MakeArray(data);
+}
+
+std::shared_ptr<arrow::Array> read_rows_from_pages(parquet::RowGroupReader& rg_reader, int leaf,
+                                                   const parquet::ColumnDescriptor& descr,
+                                                   const parquet::OffsetIndex* offset_index,
+                                                   int64_t rg_rows, const std::vector<int64_t>& local_rows,
+                                                   const std::shared_ptr<arrow::DataType>& type) {
+    switch (descr.physical_type()) {
+        case parquet::Type::BOOLEAN:
+            return read_rows_typed<parquet::BooleanType>(rg_reader, leaf, descr, offset_index, rg_rows, local_rows, type);
+        case parquet::Type::INT32:
+            return read_rows_typed<parquet::Int32Type>(rg_reader, leaf, descr, offset_index, rg_rows, local_rows, type);
+        case parquet::Type::INT64:
+            return read_rows_typed<parquet::Int64Type>(rg_reader, leaf, descr, offset_index, rg_rows, local_rows, type);
+        case parquet::Type::FLOAT:
+            return read_rows_typed<parquet::FloatType>(rg_reader, leaf, descr, offset_index, rg_rows, local_rows, type);
+        case parquet::Type::DOUBLE:
+            return read_rows_typed<parquet::DoubleType>(rg_reader, leaf, descr, offset_index, rg_rows, local_rows, type);
+        case parquet::Type::BYTE_ARRAY:
+            return read_rows_typed<parquet::ByteArrayType>(rg_reader, leaf, descr, offset_index, rg_rows, local_rows, type);
+        default:
+            return nullptr;
+    }
+}
+
+} // namespace
+
+namespace parqview {
+
+TableData* take_rows(parquet::arrow::FileReader& reader, const std::vector<int64_t>& rows,
+                     const std::vector<int>& columns, int max_cell_bytes) {
+    auto* file = reader.parquet_reader();
+    auto metadata = file->metadata();
+    auto offsets = row_group_offsets(*metadata);
+    const auto& fields = reader.manifest().schema_fields;
+    std::vector<int> selected = columns;
+    if (selected.empty()) {
+        for (int col = 0; col < static_cast<int>(fields.size()); col++) {
+            selected.push_back(col);
+        }
+    }
+    int column_count = static_cast<int>(selected.size());
+
+    auto* data = allocate_table_data(static_cast<int>(rows.size()), column_count);
+    if (rows.empty()) {
+        data->column_count = 0;
+        return data;
+    }
+
+    auto page_index = file->GetPageIndexReader();
+
+    size_t next = 0;
+    while (next < rows.size()) {
+        // Row group holding the next row, and all following rows that share it
+        int rg = static_cast<int>(std::upper_bound(offsets.begin(), offsets.end(), rows[next]) - offsets.begin()) - 1;
+        if (rg < 0 || rg >= metadata->num_row_groups()) {
+            free_table_data(data);
+            return nullptr;
+        }
+
+        std::vector<int64_t> local_rows;
+        size_t first = next;
+        while (next < rows.size() && rows[next] < offsets[rg + 1]) {
+            local_rows.push_back(rows[next] - offsets[rg]);
+            next++;
+        }
+
+        int64_t rg_rows = offsets[rg + 1] - offsets[rg];
+        auto rg_reader = file->RowGroup(rg);
+        auto rg_page_index = page_index ? page_index->RowGroup(rg) : nullptr;
+
+        // Flat columns decode just the pages holding the rows; the rest are
+        // read together as whole row-group columns
+        std::vector<int> fallback_columns;
+        for (int col = 0; col < column_count; col++) {
+            const auto& field = fields[selected[col]];
+            const auto* descr = field.is_leaf() ? metadata->schema()->Column(field.column_index) : nullptr;
+            std::shared_ptr<arrow::Array> values;
+            if (descr && supports_page_reads(*descr, *field.field->type())) {
+                auto offset_index = rg_page_index ? rg_page_index->GetOffsetIndex(field.column_index) : nullptr;
+                values = read_rows_from_pages(*rg_reader, field.column_index, *descr, offset_index.get(),
+                                              rg_rows, local_rows, materialized_type(field.field->type()));
+            }
+            if (!values) {
+                fallback_columns.push_back(col);
+                continue;
+            }
+            values = with_uuid_type(values, reader.manifest(), selected[col]);
+
+            std::vector<int64_t> positions(local_rows.size());
+            for (size_t i = 0; i < positions.size(); i++) {
+                positions[i] = static_cast<int64_t>(i);
+            }
+            fill_column_rows(data, static_cast<int>(first), col, arrow::ChunkedArray(values), positions,
+                             max_cell_bytes);
+        }
+
+        if (!fallback_columns.empty()) {
+            std::vector<int> leaves;
+            for (int col : fallback_columns) {
+                collect_leaf_columns(fields[selected[col]], leaves);
+            }
+            std::shared_ptr<arrow::Table> table;
+            auto status = reader.ReadRowGroup(rg, leaves, &table);
+            if (!status.ok()) {
+                std::cerr << "Error reading row group " << rg << ": " << status.ToString() << std::endl;
+                free_table_data(data);
+                return nullptr;
+            }
+            for (size_t i = 0; i < fallback_columns.size() && static_cast<int>(i) < table->num_columns(); i++) {
+                auto column = with_uuid_type(table->column(static_cast<int>(i)), reader.manifest(),
+                                             selected[fallback_columns[i]]);
+                fill_column_rows(data, static_cast<int>(first), fallback_columns[i], *column, local_rows,
+                                 max_cell_bytes);
+            }
+        }
+    }
+    return data;
+}
+
+TableData* take_rows(const char* file_path, const std::shared_ptr<parquet::FileMetaData>& metadata,
+                     const std::vector<int64_t>& rows, const std::vector<int>& columns, int max_cell_bytes) {
+    auto reader = open_reader(file_path, metadata, parquet::default_arrow_reader_properties());
+    if (!reader) {
+        return nullptr;
+    }
+    return take_rows(*reader, rows, columns, max_cell_bytes);
+}
+
+} // namespace parqview
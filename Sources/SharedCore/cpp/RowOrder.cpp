@@ -0,0 +1,171 @@
+#include "RowOrder.h"
+#include <arrow/array/concatenate.h>
+#include <arrow/compute/api.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+
+namespace parqview {
+
+namespace {
+
+// Three-way comparison of two non-null rows of one array
+using RowCompare = std::function<int(int64_t, int64_t)>;
+
+template <typename T>
+int three_way(const T& a, const T& b) {
+    return a < b ? -1 : (b < a ? 1 : 0);
+}
+
+template <typename ArrayType>
+RowCompare compare_values(const arrow::Array& array) {
+    const auto& typed = static_cast<const ArrayType&>(array);
+    return [&typed](int64_t a, int64_t b) { return three_way(typed.GetView(a), typed.GetView(b)); };
+}
+
+template <typename ArrayType>
+RowCompare compare_floating(const arrow::Array& array) {
+    const auto& typed = static_cast<const ArrayType&>(array);
+    return [&typed](int64_t a, int64_t b) {
+        auto x = typed.Value(a);
+        auto y = typed.Value(b);
+        bool x_nan = std::isnan(x);
+        bool y_nan = std::isnan(y);
+        if (x_nan || y_nan) {
+            return three_way(x_nan, y_nan);
+        }
+        return three_way(x, y);
+    };
+}
+
+RowCompare compare_rows(const arrow::Array& array, std::vector<int64_t>& dictionary_ranks);
+
+// Dictionary rows compare by their values: the dictionary is ranked once,
+// then rows compare by the rank of their index
+RowCompare compare_dictionary(const arrow::Array& array, std::vector<int64_t>& ranks) {
+    const auto& dictionary_array = static_cast<const arrow::DictionaryArray&>(array);
+    const auto& dictionary = *dictionary_array.dictionary();
+    std::vector<int64_t> unused;
+    auto compare = compare_rows(dictionary, unused);
+    std::vector<int64_t> order(static_cast<size_t>(dictionary.length()));
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+        if (dictionary.IsNull(a) || dictionary.IsNull(b)) {
+            return !dictionary.IsNull(a) && dictionary.IsNull(b);
+        }
+        return compare(a, b) < 0;
+    });
+    ranks.assign(order.size(), 0);
+    for (size_t i = 1; i < order.size(); i++) {
+        bool same = dictionary.IsNull(order[i]) == dictionary.IsNull(order[i - 1]) &&
+                    (dictionary.IsNull(order[i]) || compare(order[i - 1], order[i]) == 0);
+        ranks[order[i]] = same ? ranks[order[i - 1]] : static_cast<int64_t>(i);
+    }
+    return [&dictionary_array, &ranks](int64_t a, int64_t b) {
+        return three_way(ranks[dictionary_array.GetValueIndex(a)], ranks[dictionary_array.GetValueIndex(b)]);
+    };
+}
+
+RowCompare compare_rows(const arrow::Array& array, std::vector<int64_t>& dictionary_ranks) {
+    switch (array.type_id()) {
+        case arrow::Type::BOOL: return compare_values<arrow::BooleanArray>(array);
+        case arrow::Type::INT8: return compare_values<arrow::Int8Array>(array);
+        case arrow::Type::INT16: return compare_values<arrow::Int16Array>(array);
+        case arrow::Type::INT32: return compare_values<arrow::Int32Array>(array);
+        case arrow::Type::INT64: return compare_values<arrow::Int64Array>(array);
+        case arrow::Type::UINT8: return compare_values<arrow::UInt8Array>(array);
+        case arrow::Type::UINT16: return compare_values<arrow::UInt16Array>(array);
+        case arrow::Type::UINT32: return compare_values<arrow::UInt32Array>(array);
+        case arrow::Type::UINT64: return compare_values<arrow::UInt64Array>(array);
+        case arrow::Type::FLOAT: return compare_floating<arrow::FloatArray>(array);
+        case arrow::Type::DOUBLE: return compare_floating<arrow::DoubleArray>(array);
+        case arrow::Type::DATE32: return compare_values<arrow::Date32Array>(array);
+        case arrow::Type::DATE64: return compare_values<arrow::Date64Array>(array);
+        case arrow::Type::TIME32: return compare_values<arrow::Time32Array>(array);
+        case arrow::Type::TIME64: return compare_values<arrow::Time64Array>(array);
+        case arrow::Type::TIMESTAMP: return compare_values<arrow::TimestampArray>(array);
+        case arrow::Type::DURATION: return compare_values<arrow::DurationArray>(array);
+        case arrow::Type::STRING: return compare_values<arrow::StringArray>(array);
+        case arrow::Type::LARGE_STRING: return compare_values<arrow::LargeStringArray>(array);
+        case arrow::Type::BINARY: return compare_values<arrow::BinaryArray>(array);
+        case arrow::Type::LARGE_BINARY: return compare_values<arrow::LargeBinaryArray>(array);
+        case arrow::Type::FIXED_SIZE_BINARY: return compare_values<arrow::FixedSizeBinaryArray>(array);
+        case arrow::Type::DECIMAL128: {
+            const auto& typed = static_cast<const arrow::Decimal128Array&>(array);
+            return [&typed](int64_t a, int64_t b) {
+                return three_way(arrow::Decimal128(typed.GetValue(a)), arrow::Decimal128(typed.GetValue(b)));
+            };
+        }
+        case arrow::Type::DICTIONARY: return compare_dictionary(array, dictionary_ranks);
+        default:
+            throw std::invalid_argument("cannot sort on values of type " + array.type()->ToString());
+    }
+}
+
+} // namespace
+
+std::vector<int64_t> sort_row_order(const arrow::Table& table, const std::vector<SortKey>& keys) {
+    struct Key {
+        std::shared_ptr<arrow::Array> values;
+        std::vector<int64_t> dictionary_ranks;
+        RowCompare compare;
+        bool descending;
+    };
+    std::vector<Key> sort_keys(keys.size());
+    for (size_t k = 0; k < keys.size(); k++) {
+        const auto& column = table.column(keys[k].column);
+        if (column->num_chunks() == 1) {
+            sort_keys[k].values = column->chunk(0);
+        } else {
+            auto combined = arrow::Concatenate(column->chunks());
+            if (!combined.ok()) {
+                throw std::runtime_error(combined.status().ToString());
+            }
+            sort_keys[k].values = *combined;
+        }
+        sort_keys[k].compare = compare_rows(*sort_keys[k].values, sort_keys[k].dictionary_ranks);
+        sort_keys[k].descending = keys[k].descending;
+    }
+
+    std::vector<int64_t> order(static_cast<size_t>(table.num_rows()));
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+        for (const auto& key : sort_keys) {
+            bool a_null = key.values->IsNull(a);
+            bool b_null = key.values->IsNull(b);
+            if (a_null || b_null) {
+                if (a_null != b_null) {
+                    return b_null;
+                }
+                continue;
+            }
+            int compared = key.compare(a, b);
+            if (compared != 0) {
+                return key.descending ? compared > 0 : compared < 0;
+            }
+        }
+        return false;
+    });
+    return order;
+}
+
+std::shared_ptr<arrow::Table> take_row_order(const std::shared_ptr<arrow::Table>& table,
+                                             const std::vector<int64_t>& order) {
+    arrow::Int64Builder builder;
+    if (!builder.AppendValues(order).ok()) {
+        throw std::runtime_error("out of memory ordering rows");
+    }
+    std::shared_ptr<arrow::Array> indices;
+    if (!builder.Finish(&indices).ok()) {
+        throw std::runtime_error("out of memory ordering rows");
+    }
+    auto taken = arrow::compute::Take(arrow::Datum(table), arrow::Datum(indices));
+    if (!taken.ok()) {
+        throw std::runtime_error(taken.status().ToString());
+    }
+    return taken->table();
+}
+
+} // namespace parqview
@@ -0,0 +1,28 @@
+#ifndef PARQVIEW_ROW_ORDER_H
+#define PARQVIEW_ROW_ORDER_H
+
+#include <arrow/api.h>
+#include <cstdint>
+#include <vector>
+
+namespace parqview {
+
+struct SortKey {
+    int column;         // in the table being sorted
+    bool descending;
+};
+
+// Row indices of table in key order, most significant key first. The sort
+// is stable and puts nulls last in either direction, and NaN above every
+// number. Done here rather than through Arrow's sort kernels, which recent
+// Arrow releases ship in a separate compute library. Throws
+// std::invalid_argument for a key column whose type has no ordering.
+std::vector<int64_t> sort_row_order(const arrow::Table& table, const std::vector<SortKey>& keys);
+
+// table's rows in the given order
+std::shared_ptr<arrow::Table> take_row_order(const std::shared_ptr<arrow::Table>& table,
+                                             const std::vector<int64_t>& order);
+
+} // namespace parqview
+
+#endif // PARQVIEW_ROW_ORDER_H
@@ -0,0 +1,189 @@
+#include "TDigest.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace parqview {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+} // namespace
+
+TDigest::TDigest(double compression)
+    : compression_(compression),
+      min_(std::numeric_limits<double>::infinity()),
+      max_(-std::numeric_limits<double>::infinity()) {}
+
+void TDigest::add(double value) {
+    if (std::isnan(value)) {
+        return;
+    }
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+    buffer_.push_back(Centroid{value, 1.0});
+    if (buffer_.size() >= static_cast<size_t>(compression_ * 5)) {
+        compress();
+    }
+}
+
+void TDigest::merge(const TDigest& other) {
+    if (other.count() == 0) {
+        return;
+    }
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    buffer_.insert(buffer_.end(), other.centroids_.begin(), other.centroids_.end());
+    buffer_.insert(buffer_.end(), other.buffer_.begin(), other.buffer_.end());
+    compress();
+}
+
+void TDigest::compress() {
+    if (buffer_.empty()) {
+        return;
+    }
+
+    std::vector<Centroid> all;
+    all.reserve(centroids_.size() + buffer_.size());
+    all.insert(all.end(), centroids_.begin(), centroids_.end());
+    all.insert(all.end(), buffer_.begin(), buffer_.end());
+    buffer_.clear();
+    std::sort(all.begin(), all.end(), [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; });
+
+    double total = 0;
+    for (const auto& centroid : all) {
+        total += centroid.weight;
+    }
+
+    // k1 scale function: a centroid may span one unit of k, which keeps
+    // centroids near q = 0 and q = 1 small
+    double scale = compression_ / (2 * kPi);
+    auto q_limit = [&](double q) {
+        double k = scale * std::asin(2 * q - 1) + 1;
+        if (k >= scale * kPi / 2) {
+            return 1.0;
+        }
+        return (std::sin(k / scale) + 1) / 2;
+    };
+
+    std::vector<Centroid> merged;
+    Centroid current = all[0];
+    double so_far = 0;
+    double limit = q_limit(0);
+    for (size_t i = 1; i < all.size(); i++) {
+        double proposed = current.weight + all[i].weight;
+        if ((so_far + proposed) / total <= limit) {
+            current.mean += (all[i].mean - current.mean) * all[i].weight / proposed;
+            current.weight = proposed;
+        } else {
+            merged.push_back(current);
+            so_far += current.weight;
+            limit = q_limit(so_far / total);
+            current = all[i];
+        }
+    }
+    merged.push_back(current);
+    centroids_ = std::move(merged);
+}
+
+const TDigest& TDigest::compressed(TDigest& scratch) const {
+    if (buffer_.empty()) {
+        return *this;
+    }
+    scratch = *this;
+    scratch.compress();
+    return scratch;
+}
+
+double TDigest::count() const {
+    double total = 0;
+    for (const auto& centroid : centroids_) {
+        total += centroid.weight;
+    }
+    return total + static_cast<double>(buffer_.size());
+}
+
+size_t TDigest::memory_usage() const {
+    return sizeof(TDigest) + (centroids_.capacity() + buffer_.capacity()) * sizeof(Centroid);
+}
+
+double TDigest::quantile(double q) const {
+    TDigest scratch;
+    const TDigest& digest = compressed(scratch);
+    const auto& c = digest.centroids_;
+    if (c.empty()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    q = std::min(1.0, std::max(0.0, q));
+    if (c.size() == 1) {
+        return min_ + q * (max_ - min_);
+    }
+
+    double total = digest.count();
+    double index = q * total;
+    if (index <= 0) {
+        return min_;
+    }
+    if (index >= total) {
+        return max_;
+    }
+
+    // Left of the first centroid's centre: interpolate from the exact minimum
+    if (index < c[0].weight / 2) {
+        return min_ + index / (c[0].weight / 2) * (c[0].mean - min_);
+    }
+
+    // Each centroid's weight is spread evenly around its mean, so the
+    // quantile lies on the line between two neighbouring centres
+    double cumulative = c[0].weight / 2;
+    for (size_t i = 0; i + 1 < c.size(); i++) {
+        double step = (c[i].weight + c[i + 1].weight) / 2;
+        if (cumulative + step > index) {
+            double fraction = (index - cumulative) / step;
+            return c[i].mean + fraction * (c[i + 1].mean - c[i].mean);
+        }
+        cumulative += step;
+    }
+
+    const auto& last = c.back();
+    double fraction = (index - cumulative) / (last.weight / 2);
+    return std::min(max_, last.mean + fraction * (max_ - last.mean));
+}
+
+double TDigest::cdf(double value) const {
+    TDigest scratch;
+    const TDigest& digest = compressed(scratch);
+    const auto& c = digest.centroids_;
+    if (c.empty()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    if (value < min_) {
+        return 0;
+    }
+    if (value >= max_) {
+        return 1;
+    }
+    if (c.size() == 1) {
+        return (value - min_) / (max_ - min_);
+    }
+
+    double total = digest.count();
+    if (value < c[0].mean) {
+        return c[0].weight / 2 * (value - min_) / (c[0].mean - min_) / total;
+    }
+
+    double cumulative = c[0].weight / 2;
+    for (size_t i = 0; i + 1 < c.size(); i++) {
+        double step = (c[i].weight + c[i + 1].weight) / 2;
+        if (value < c[i + 1].mean) {
+            return (cumulative + step * (value - c[i].mean) / (c[i + 1].mean - c[i].mean)) / total;
+        }
+        cumulative += step;
+    }
+
+    const auto& last = c.back();
+    return (cumulative + last.weight / 2 * (value - last.mean) / (max_ - last.mean)) / total;
+}
+
+} // namespace parqview
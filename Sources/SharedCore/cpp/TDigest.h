@@ -0,0 +1,51 @@
+#ifndef PARQVIEW_TDIGEST_H
+#define PARQVIEW_TDIGEST_H
+
+#include <cstddef>
+#include <vector>
+
+namespace parqview {
+
+// Merging t-digest (Dunning & Ertl, "Computing extremely accurate quantiles
+// using t-digests"). Values are summarised as weighted centroids that are
+// small near the tails and larger in the middle, so p99 stays accurate to
+// a fraction of a percent while the sketch holds a few hundred centroids
+// however many values go in. Digests built on separate threads merge.
+class TDigest {
+public:
+    explicit TDigest(double compression = 200.0);
+
+    void add(double value);
+    void merge(const TDigest& other);
+
+    // Value at probability q in [0, 1]; NaN when empty
+    double quantile(double q) const;
+    // Fraction of values <= value
+    double cdf(double value) const;
+
+    double count() const;
+    double min() const { return min_; }
+    double max() const { return max_; }
+    size_t memory_usage() const;
+
+private:
+    struct Centroid {
+        double mean;
+        double weight;
+    };
+
+    // Folds the buffer into the centroids. Quantile queries need a
+    // compressed digest, so they work on a copy when the buffer isn't empty.
+    void compress();
+    const TDigest& compressed(TDigest& scratch) const;
+
+    double compression_;
+    std::vector<Centroid> centroids_;
+    std::vector<Centroid> buffer_;
+    double min_;
+    double max_;
+};
+
+} // namespace parqview
+
+#endif // PARQVIEW_TDIGEST_H
@@ -0,0 +1,36 @@
+#ifndef PARQUET_ACCELERATE_H
+#define PARQUET_ACCELERATE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// An accelerated file has an Arrow IPC copy in a cache directory, which
+// read_parquet_data memory-maps and slices instead of decompressing and
+// decoding Parquet pages. A copy records its source's size, mtime and
+// inode and is dropped on first use after the source changes. The least
+// recently used copies are removed once the directory outgrows its budget.
+
+// Uses directory (created when missing) for Arrow copies, holding at most
+// max_bytes (0 for 4 GB); NULL turns acceleration off. Returns 0, leaving
+// it off, when the directory cannot be created.
+int set_accelerated_cache_directory(const char* directory, long long max_bytes);
+
+// Writes the Arrow copy of file_path, uncompressed or, with compress set,
+// with LZ4 buffers (smaller on disk, but every batch read decompresses).
+// Dictionary columns are stored decoded. Blocks until the copy is in
+// place, so call it off the main thread. Returns 0 when acceleration is
+// off or the file cannot be transcoded.
+int accelerate_parquet_file(const char* file_path, int compress);
+
+// 1 when file_path has an Arrow copy of its current contents
+int is_parquet_file_accelerated(const char* file_path);
+
+// Drops the Arrow copy of file_path
+void remove_accelerated_file(const char* file_path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARQUET_ACCELERATE_H
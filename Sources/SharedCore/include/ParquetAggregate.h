@@ -0,0 +1,61 @@
+#ifndef PARQUET_AGGREGATE_H
+#define PARQUET_AGGREGATE_H
+
+#include "ParquetPredicate.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    AGGREGATE_COUNT = 0,    // rows in the group; non-null values when a column is given
+    AGGREGATE_SUM,          // numeric and boolean columns; integer sums stay integers
+    AGGREGATE_MIN,          // numeric, boolean and temporal columns
+    AGGREGATE_MAX,
+    AGGREGATE_AVG           // numeric and boolean columns
+} AggregateFunction;
+
+typedef struct {
+    AggregateFunction function;
+    int column_index;       // top-level column; -1 with AGGREGATE_COUNT for count(*)
+} AggregateSpec;
+
+// GROUP BY group_columns over the rows matching every predicate. The result
+// is ordered by one of its columns and cut to limit rows.
+typedef struct {
+    const int* group_columns;
+    int group_count;        // 0 aggregates the whole file into one row
+    const AggregateSpec* aggregates;
+    int aggregate_count;
+    const ColumnPredicate* predicates;
+    int predicate_count;
+    int order_by;           // result column to sort on: keys first, then aggregates; -1 for the keys
+    int descending;
+    int limit;              // 0 for every group
+    long long memory_limit; // bytes of partial aggregates held before spilling; 0 for the default
+} AggregateRequest;
+
+typedef struct {
+    ColumnInfo* columns;    // group keys, then one column per aggregate, with their types
+    int column_count;
+    TableData* rows;        // NULL keys and empty aggregates render as "NULL"
+    long long group_count;  // groups before the limit
+    long long input_rows;   // rows that passed the predicates
+    int spilled;            // partial aggregates outgrew memory_limit and went through disk
+} AggregateResult;
+
+// Runs a hash aggregation over flat columns. Row groups are spread across
+// threads, each building its own partial hash table; the partials are
+// merged at the end. A thread whose table outgrows its share of
+// memory_limit writes it out in hash partitions, which are then merged one
+// partition at a time. Returns NULL on a read error or an invalid request
+// (nested columns, or a function that does not fit its column's type).
+AggregateResult* read_parquet_aggregate(const char* file_path, const AggregateRequest* request);
+
+void free_aggregate_result(AggregateResult* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARQUET_AGGREGATE_H
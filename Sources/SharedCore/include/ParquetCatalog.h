@@ -0,0 +1,45 @@
+#ifndef PARQUET_CATALOG_H
+#define PARQUET_CATALOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A catalog summarizes every file of a directory or glob (listed as for
+// datasets) from its footer alone: only the last 64 KB of each file is
+// read, plus the exact footer when it is larger, with a bounded number of
+// reads in flight and footers parsed as they arrive. Nothing is cached, so
+// a catalog always reflects the files on disk.
+
+typedef struct {
+    char* file_path;
+    long long file_size;
+    long long row_count;
+    int row_group_count;
+    int column_count;            // leaf columns
+    int schema_index;            // into CatalogResult.schemas, -1 when unreadable
+    char* created_by;            // writer recorded in the footer, NULL when absent
+    char* error;                 // NULL when the footer was read
+} CatalogFile;
+
+typedef struct {
+    CatalogFile* files;          // in path order
+    int file_count;
+    char** schemas;              // distinct schemas, "name: type" per leaf joined by ", "
+    int schema_count;
+    int unreadable_count;
+    long long total_rows;        // over readable files
+    long long total_bytes;       // over every file
+} CatalogResult;
+
+// max_concurrent_reads bounds the footer reads in flight; 0 uses the
+// default. Returns NULL when the path matches no file.
+CatalogResult* read_parquet_catalog(const char* path, int max_concurrent_reads);
+
+void free_catalog_result(CatalogResult* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARQUET_CATALOG_H
@@ -0,0 +1,66 @@
+#ifndef PARQUET_DATASET_H
+#define PARQUET_DATASET_H
+
+#include "ParquetPredicate.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A dataset is every Parquet file under a directory (recursively, skipping
+// hidden and _-prefixed entries) or matching a glob such as
+// "/data/dt=*/part-*.parquet". Directories named key=value below the root
+// become partition columns, typed int64 when every value is an integer and
+// string otherwise. Footers are read in parallel on first use and the
+// dataset is cached under its path until cleared.
+//
+// Every call takes optional predicates on partition columns only; files
+// whose partition values fail them are dropped before any read, and row
+// numbers count the remaining files in path order.
+
+typedef struct {
+    ColumnInfo* columns;         // file columns unified by name, then partition columns
+    int column_count;
+    int partition_column_count;  // the trailing columns
+    int file_count;              // files left after pruning
+    long long row_count;         // rows in those files
+    long long total_bytes;       // size of those files
+} DatasetInfo;
+
+typedef struct {
+    char* file_path;
+    int file_index;              // among the files left after pruning
+    int row_group;
+    long long row_in_group;
+    long long row_in_file;
+} DatasetRowLocation;
+
+// Returns NULL when the path matches no readable file or a predicate does
+// not fit a partition column
+DatasetInfo* read_dataset_info(const char* dataset_path,
+                               const ColumnPredicate* partition_predicates, int predicate_count);
+
+// Reads rows [start_row, start_row + num_rows) of the dataset, with a cell
+// for every DatasetInfo column. Columns a file lacks read as "NULL".
+TableData* read_dataset_data(const char* dataset_path,
+                             const ColumnPredicate* partition_predicates, int predicate_count,
+                             long long start_row, int num_rows);
+
+// Resolves a dataset row to its file, row group and offset by binary search
+// over per-file and per-row-group row counts. NULL when out of range.
+DatasetRowLocation* locate_dataset_row(const char* dataset_path,
+                                       const ColumnPredicate* partition_predicates, int predicate_count,
+                                       long long row);
+
+void free_dataset_info(DatasetInfo* info);
+void free_dataset_row_location(DatasetRowLocation* location);
+
+// Forgets the cached listing and footers of dataset_path, or of every
+// dataset when dataset_path is NULL
+void clear_dataset_cache(const char* dataset_path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARQUET_DATASET_H
@@ -0,0 +1,68 @@
+#ifndef PARQUET_EXPORT_H
+#define PARQUET_EXPORT_H
+
+#include "ParquetPredicate.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Writes a whole file, or a projected, filtered and sorted view of it, to
+// another format without passing rows through Swift. Runs of row groups
+// are read and formatted on a pool of workers and written in file order as
+// each one's turn comes, so at most one formatted run per worker is held
+// in memory. Sorting is the exception: the projected, filtered rows are
+// gathered and ordered in memory before they are written.
+
+typedef enum {
+    EXPORT_FORMAT_CSV,          // header line, RFC 4180 quoting
+    EXPORT_FORMAT_NDJSON,       // one JSON object per line
+    EXPORT_FORMAT_ARROW_IPC,    // Arrow IPC file, dictionaries decoded
+    EXPORT_FORMAT_PARQUET       // see below
+} ExportFormat;
+
+// A Parquet export with no predicates, filter text or sort copies the chosen columns'
+// chunks byte for byte, with their statistics, page index and bloom
+// filters, so nothing is decoded or re-encoded. Otherwise rows are decoded
+// and filtered on the workers while the writer encodes the previous run,
+// keeping each column's codec and adding a page index.
+
+// Called after each written chunk with the rows written so far and the
+// rows the export will write. Returning non-zero cancels the export.
+typedef int (*ExportProgressCallback)(long long rows_written, long long rows_total, void* context);
+
+typedef struct {
+    ExportFormat format;
+    const int* columns;                 // top-level columns in output order, NULL for all
+    int column_count;
+    const ColumnPredicate* predicates;  // ANDed, as for read_parquet_predicate_page
+    int predicate_count;
+    const char* filter_text;            // rows holding it in any column, as for
+                                        // read_parquet_filtered_page; NULL or "" for all
+    const int* sort_columns;            // top-level columns, most significant first
+    const int* sort_descending;         // one per sort column, NULL for all ascending
+    int sort_column_count;
+    int max_workers;                    // 0 for one per core
+    ExportProgressCallback progress;    // optional
+    void* progress_context;
+} ExportRequest;
+
+typedef struct {
+    long long row_count;
+    long long bytes_written;
+    int cancelled;                      // output_path was left untouched
+    char* error;                        // NULL on success or cancellation
+} ExportResult;
+
+// Exports source_path to output_path, which is replaced only once the
+// export completes. Blocks until done, so call it off the main thread.
+ExportResult* export_parquet_file(const char* source_path, const char* output_path,
+                                  const ExportRequest* request);
+
+void free_export_result(ExportResult* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARQUET_EXPORT_H
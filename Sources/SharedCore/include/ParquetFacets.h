@@ -0,0 +1,49 @@
+#ifndef PARQUET_FACETS_H
+#define PARQUET_FACETS_H
+
+#include "ParquetPredicate.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// One value and how often it occurs
+typedef struct {
+    char* value;
+    long long count;    // upper bound on the true count
+    long long error;    // the true count is at least count - error; 0 when exact
+} FacetValue;
+
+typedef struct {
+    int column_index;
+    int supported;          // 0 for nested columns
+    FacetValue* values;     // most frequent first
+    int value_count;
+    long long null_count;
+    int is_exact;           // every count is exact and no unlisted value can outrank a listed one
+} ColumnFacets;
+
+typedef struct {
+    ColumnFacets* columns;
+    int column_count;
+    long long row_count;    // rows that passed the filter
+} FacetResult;
+
+// Top-N most frequent values of the given top-level columns (every column
+// when column_count is 0), over the rows matching every predicate (all rows
+// when predicate_count is 0). Fully dictionary-encoded chunks are counted
+// exactly by dictionary index; other chunks go through a space-saving
+// sketch, so counts may carry an error bound. All columns are counted in
+// one parallel pass. Returns NULL on a read error or when a predicate does
+// not fit its column.
+FacetResult* read_parquet_facets(const char* file_path,
+                                 const int* column_indices, int column_count, int top_n,
+                                 const ColumnPredicate* predicates, int predicate_count);
+
+void free_facet_result(FacetResult* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARQUET_FACETS_H
@@ -0,0 +1,27 @@
+#ifndef PARQUET_FILTER_H
+#define PARQUET_FILTER_H
+
+#include "ParquetReader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Reads one page of rows whose cells contain filter_text, ignoring the case
+// of Latin, Greek and Cyrillic letters; letters of other scripts match exactly.
+// column_indices restricts the search to those columns; pass NULL/0 to search
+// every column. The returned rows always carry every column of the file,
+// cut as read_parquet_page cuts them to max_cell_bytes (0 for no limit).
+// total_matches (optional) receives the exact number of matching rows.
+// row_numbers, when not NULL, must hold limit entries and receives each
+// returned row's number in the file, for read_parquet_cell.
+TableData* read_parquet_filtered_page(const char* file_path, const char* filter_text,
+                                      const int* column_indices, int column_count,
+                                      long long offset, int limit, int max_cell_bytes,
+                                      long long* total_matches, long long* row_numbers);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARQUET_FILTER_H
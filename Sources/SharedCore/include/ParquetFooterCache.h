@@ -0,0 +1,34 @@
+#ifndef PARQUET_FOOTER_CACHE_H
+#define PARQUET_FOOTER_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// An on-disk cache of parsed footers, so a file reopened in a later session
+// skips reading and decoding its footer. One sidecar per file holds the
+// serialized FileMetaData, the row-group row offsets and the Arrow schema
+// summary, keyed by path and checked against the file's size, mtime and
+// inode; a sidecar for a file that has since changed is ignored and
+// replaced. Sidecars are written to a temporary file and renamed into
+// place, and carry a checksum, so a crash or a damaged file only costs a
+// cold open. The least recently used sidecars are removed once the
+// directory outgrows max_bytes.
+//
+// The cache is off until a directory is set. read_parquet_schema answers
+// from a sidecar without opening the file; every other read opens it over
+// the cached footer.
+
+// Uses directory (created when missing) for sidecars, holding at most
+// max_bytes (0 for 256 MB); NULL disables the cache. Returns 0, leaving
+// the cache off, when the directory cannot be created.
+int set_footer_cache_directory(const char* directory, long long max_bytes);
+
+// Removes every sidecar in the current directory
+void clear_footer_cache(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARQUET_FOOTER_CACHE_H
@@ -0,0 +1,78 @@
+#ifndef PARQUET_LAYOUT_H
+#define PARQUET_LAYOUT_H
+
+#include "ParquetMetadata.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// How a file's bytes are laid out in pages, for finding why it browses
+// slowly: oversized row groups, tiny pages, dictionaries that fell back to
+// PLAIN, codecs that barely compress. Built by walking every page header
+// of every column chunk; page bodies are never read or decompressed.
+
+// Data pages by uncompressed size: under 8 KB, then one bucket per
+// doubling up to 1 MB, then 1 MB and over
+#define PARQUET_PAGE_SIZE_BUCKETS 9
+
+typedef struct {
+    int data_page_count;
+    int dictionary_page_count;
+    int v2_page_count;                  // data pages in the v2 format
+    int checksummed_page_count;         // pages whose header carries a CRC
+    int fallback_page_count;            // non-dictionary data pages in chunks that have a dictionary
+    long long value_count;              // in data pages, nulls included
+    long long header_bytes;             // page headers
+    long long compressed_size;          // page bodies as stored
+    long long uncompressed_size;        // page bodies decompressed
+    long long dictionary_size;          // dictionary pages, decompressed
+    int min_page_size;                  // decompressed data page bodies; 0 when there are none
+    int max_page_size;
+    int page_size_histogram[PARQUET_PAGE_SIZE_BUCKETS];
+    unsigned int data_encodings;        // PARQUET_ENCODING_* bits of the data pages
+} PageLayout;
+
+typedef struct {
+    PageLayout pages;
+    ParquetCodec codec;
+    int has_column_index;
+    int has_offset_index;
+    char* error;                        // NULL when every header decoded
+} ColumnChunkLayout;
+
+typedef struct {
+    char* path;                         // dotted leaf path
+    PageLayout pages;                   // summed over row groups
+    int fallback_chunk_count;           // chunks with at least one fallback page
+    int indexed_chunk_count;            // chunks with both a column and an offset index
+} ColumnLayout;
+
+typedef struct {
+    long long row_count;
+    PageLayout pages;                   // summed over columns
+} RowGroupLayout;
+
+typedef struct {
+    int column_count;
+    ColumnLayout* columns;
+    int row_group_count;
+    RowGroupLayout* row_groups;
+    ColumnChunkLayout* chunks;          // row_group * column_count + column
+    PageLayout total;
+    int error_count;                    // chunks whose walk stopped at an error
+} LayoutReport;
+
+// Walks the column chunks of file_path on up to max_concurrent_reads
+// threads; 0 uses one per core. Chunks that fail to walk keep the pages
+// read before the error and set their error. NULL when the file cannot be
+// opened.
+LayoutReport* read_parquet_layout(const char* file_path, int max_concurrent_reads);
+
+void free_layout_report(LayoutReport* report);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARQUET_LAYOUT_H
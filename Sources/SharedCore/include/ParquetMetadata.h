@@ -0,0 +1,97 @@
+#ifndef PARQUET_METADATA_H
+#define PARQUET_METADATA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Everything the footer says about a file, flattened into contiguous arrays
+// so that a file with tens of thousands of row groups crosses to Swift in
+// one call.
+
+typedef enum {
+    PARQUET_CODEC_UNCOMPRESSED,
+    PARQUET_CODEC_SNAPPY,
+    PARQUET_CODEC_GZIP,
+    PARQUET_CODEC_LZO,
+    PARQUET_CODEC_BROTLI,
+    PARQUET_CODEC_LZ4,          // the deprecated Hadoop framing
+    PARQUET_CODEC_ZSTD,
+    PARQUET_CODEC_LZ4_RAW,
+    PARQUET_CODEC_OTHER
+} ParquetCodec;
+
+// Bits of ColumnChunkMetadata.encodings, numbered as in the Parquet format
+#define PARQUET_ENCODING_PLAIN                   (1u << 0)
+#define PARQUET_ENCODING_PLAIN_DICTIONARY        (1u << 2)
+#define PARQUET_ENCODING_RLE                     (1u << 3)
+#define PARQUET_ENCODING_BIT_PACKED              (1u << 4)
+#define PARQUET_ENCODING_DELTA_BINARY_PACKED     (1u << 5)
+#define PARQUET_ENCODING_DELTA_LENGTH_BYTE_ARRAY (1u << 6)
+#define PARQUET_ENCODING_DELTA_BYTE_ARRAY        (1u << 7)
+#define PARQUET_ENCODING_RLE_DICTIONARY          (1u << 8)
+#define PARQUET_ENCODING_BYTE_STREAM_SPLIT       (1u << 9)
+
+typedef struct {
+    long long file_offset;
+    long long data_page_offset;
+    long long dictionary_page_offset;   // -1 when the chunk has no dictionary page
+    long long column_index_offset;      // -1 when the file has no page index
+    long long offset_index_offset;      // -1 likewise
+    long long compressed_size;
+    long long uncompressed_size;
+    long long value_count;
+    long long null_count;               // -1 when unknown
+    long long distinct_count;           // -1 when unknown
+    long long min_value;                // offset into ParquetFileMetadata.strings, -1 when unknown
+    long long max_value;
+    ParquetCodec codec;
+    unsigned int encodings;             // PARQUET_ENCODING_* bits
+} ColumnChunkMetadata;
+
+typedef struct {
+    int column;                         // leaf column index
+    int descending;
+    int nulls_first;
+} SortingColumnMetadata;
+
+typedef struct {
+    long long row_count;
+    long long total_byte_size;          // uncompressed
+    long long total_compressed_size;    // 0 when the writer did not record it
+    long long file_offset;
+    int first_sorting_column;           // into ParquetFileMetadata.sorting_columns
+    int sorting_column_count;
+} RowGroupMetadata;
+
+typedef struct {
+    char* created_by;                   // NULL when the writer did not record itself
+    int format_version;                 // 1 or 2
+    long long row_count;
+    int key_value_count;
+    char** keys;
+    char** values;
+    int column_count;                   // leaf columns
+    char** column_paths;                // dotted paths of the leaf columns
+    char** physical_types;
+    int row_group_count;
+    RowGroupMetadata* row_groups;
+    ColumnChunkMetadata* column_chunks; // row_group * column_count + column
+    SortingColumnMetadata* sorting_columns;
+    int sorting_column_count;
+    char* strings;                      // NUL-terminated statistics text
+    long long strings_size;
+} ParquetFileMetadata;
+
+// Reads the footer of file_path. Chunk min/max values are formatted through
+// each column's logical type only when include_statistics is set, which
+// costs a conversion per chunk; null and distinct counts are always filled.
+ParquetFileMetadata* read_parquet_metadata(const char* file_path, int include_statistics);
+
+void free_parquet_metadata(ParquetFileMetadata* metadata);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARQUET_METADATA_H
@@ -0,0 +1,52 @@
+#ifndef PARQUET_NESTED_H
+#define PARQUET_NESTED_H
+
+#include "ParquetReader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Struct, list and map columns as a tree of fields, so a view can expand
+// them one level at a time and read only the leaves it shows. Paths join
+// Arrow field names with dots: a struct's children by name, a list's by
+// its element field's name (element or item), a map's as key and value.
+// In the table, nested cells show a bounded preview: lists and maps their
+// first PARQUET_NESTED_PREVIEW_ITEMS entries and their length.
+
+#define PARQUET_NESTED_PREVIEW_ITEMS 5
+
+typedef struct {
+    char* name;
+    char* path;                         // dotted from the top-level column, e.g. payload.user.id
+    char* type;                         // Arrow type
+    int parent;                         // node index, -1 for top-level columns
+    int child_count;
+    int leaf_column;                    // Parquet leaf column of a primitive field, -1 otherwise
+} FieldNode;
+
+typedef struct {
+    FieldNode* nodes;                   // depth first: each node before its children
+    int node_count;
+} FieldTree;
+
+// Every field of file_path. For CSV, NDJSON and Arrow files leaf_column
+// counts primitive fields depth first, as Parquet numbers its leaves.
+// NULL when the file cannot be opened.
+FieldTree* read_parquet_field_tree(const char* file_path);
+
+void free_field_tree(FieldTree* tree);
+
+// Reads rows [start_row, start_row + num_rows) of the given field paths,
+// one column per path. A Parquet file decodes only the leaves under those
+// paths, so expanding payload.user.id leaves the rest of payload unread.
+// Values under a list or map are read as lists of that field. NULL when a
+// path names no field or a read fails.
+TableData* read_parquet_field_paths(const char* file_path, const char* const* paths, int path_count,
+                                    long long start_row, int num_rows);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARQUET_NESTED_H
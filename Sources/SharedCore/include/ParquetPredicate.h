@@ -0,0 +1,63 @@
+#ifndef PARQUET_PREDICATE_H
+#define PARQUET_PREDICATE_H
+
+#include "ParquetReader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    PREDICATE_EQ = 0,
+    PREDICATE_NE,
+    PREDICATE_LT,
+    PREDICATE_LE,
+    PREDICATE_GT,
+    PREDICATE_GE,
+    PREDICATE_BETWEEN,      // values[0] <= x <= values[1]
+    PREDICATE_IN,           // x equals any of values
+    PREDICATE_IS_NULL,      // takes no values
+    PREDICATE_IS_NOT_NULL   // takes no values
+} PredicateOp;
+
+// A typed comparison against one top-level column. Values are given as text
+// and parsed for the column's type: integers, decimals (stored as integers
+// or as byte arrays of up to 16 bytes), floats, true/false, strings, dates
+// as YYYY-MM-DD and timestamps as ISO 8601 (UTC). Dates and timestamps also
+// accept their raw integer value.
+typedef struct {
+    int column_index;
+    PredicateOp op;
+    const char* const* values;
+    int value_count;
+} ColumnPredicate;
+
+// How much of the file a predicate scan had to touch
+typedef struct {
+    int row_groups_total;
+    int row_groups_read;       // row groups in which any page was decoded
+    long long pages_read;      // data pages decompressed and decoded
+    long long pages_skipped;   // data pages skipped via the page index
+    int row_groups_bloom_skipped;  // row groups ruled out by a bloom filter
+} PredicateScanStats;
+
+// Reads one page of the rows matching every predicate (AND). Row groups and
+// pages whose statistics rule out a match are skipped before any decoding,
+// as are row groups whose bloom filters exclude every EQ / IN value.
+// Cells are cut as read_parquet_page cuts them to max_cell_bytes (0 for no
+// limit). total_matches and stats are optional; a page of cached matches
+// reports the stats of the scan that found them. row_numbers, when not NULL,
+// must hold limit entries and receives each returned row's number in the
+// file. Returns NULL on a read error or when a predicate does not fit its
+// column.
+TableData* read_parquet_predicate_page(const char* file_path,
+                                       const ColumnPredicate* predicates, int predicate_count,
+                                       long long offset, int limit, int max_cell_bytes,
+                                       long long* total_matches, PredicateScanStats* stats,
+                                       long long* row_numbers);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARQUET_PREDICATE_H
@@ -0,0 +1,53 @@
+#ifndef PARQUET_PROFILE_H
+#define PARQUET_PROFILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Distribution of one numeric or temporal column. Values are in the
+// column's own units: dates in days, times and timestamps in ticks of their
+// unit since midnight / the epoch, decimals as their real value. Labels are
+// the same values formatted the way the table shows them.
+typedef struct {
+    int column_index;
+    int supported;              // 0 for columns that are not numeric or temporal
+    long long value_count;      // non-null values
+    double min;
+    double max;
+    char* min_label;
+    char* max_label;
+
+    int quantile_count;         // one per requested probability
+    double* quantiles;
+    char** quantile_labels;
+
+    int bin_count;
+    double* bin_edges;          // bin_count + 1 edges, equal width over [min, max]
+    long long* bin_counts;
+    int histogram_is_estimate;  // bins were read off the quantile sketch, because
+                                // the footer had no min/max to size them up front
+} ColumnProfile;
+
+typedef struct {
+    ColumnProfile* columns;
+    int column_count;
+} ProfileResult;
+
+// Profiles the given top-level columns (every column when column_count is 0)
+// in one parallel scan: a t-digest quantile sketch and an equal-width
+// histogram per column. Sketches are cached per file fingerprint, so asking
+// again, for other quantiles or after reopening the file, does not rescan.
+// Returns NULL on a read error.
+ProfileResult* read_parquet_profile(const char* file_path,
+                                    const int* column_indices, int column_count,
+                                    const double* probabilities, int probability_count,
+                                    int bin_count);
+
+void free_profile_result(ProfileResult* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARQUET_PROFILE_H
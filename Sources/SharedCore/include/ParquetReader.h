@@ -13,18 +13,66 @@ typedef struct {
 typedef struct {
     ColumnInfo* columns;
     int column_count;
-    long long row_count;
+    long long row_count;  // -1 for CSV and NDJSON, which read_row_count counts
 } SchemaInfo;
 
 typedef struct {
     char*** data;  // 2D array of strings
     int row_count;
     int column_count;
+    unsigned char* truncated;  // row_count * column_count flags, row by row, set for
+                               // cells cut to a preview; NULL when no cell was cut
 } TableData;
 
+// The format a file is read in, from its extension; anything else is read
+// as Parquet. Schema, page and search reads dispatch on it.
+typedef enum {
+    FILE_FORMAT_PARQUET,
+    FILE_FORMAT_ARROW_IPC,  // .arrow, .arrows, .feather, .ipc: IPC file or stream, Feather V1
+    FILE_FORMAT_CSV,        // .csv, .tsv, with a header line
+    FILE_FORMAT_NDJSON      // .jsonl, .ndjson
+} FileFormat;
+
+// How binary cells are shown. A cell holds its first preview_bytes bytes
+// (every byte when 0), followed by its length when cut. UUID columns show
+// the canonical 8-4-4-4-12 form whatever the format.
+typedef enum {
+    BINARY_FORMAT_HEX,      // 0x0123abcd
+    BINARY_FORMAT_BASE64
+} BinaryFormat;
+
+#define PARQUET_BINARY_PREVIEW_BYTES 32
+
 // Function declarations
+FileFormat detect_file_format(const char* file_path);
 SchemaInfo* read_parquet_schema(const char* file_path);
+
+// Rows in the file, or -1 when it cannot be read. A CSV or NDJSON file is
+// indexed to its end to answer, so this is asked only when the count is shown.
+long long read_row_count(const char* file_path);
 TableData* read_parquet_data(const char* file_path, int start_row, int num_rows);
+
+// Reads rows as read_parquet_data does, cutting every cell to at most
+// max_cell_bytes bytes of UTF-8 (0 for no limit) so that a page stays small
+// whatever its cells hold. Text values are cut before they are copied.
+TableData* read_parquet_page(const char* file_path, long long start_row, int num_rows, int max_cell_bytes);
+
+// Reads the given rows of a Parquet file in the order given, cut as
+// read_parquet_page cuts them, decoding only the pages that hold them
+// where the column allows it. NULL for other formats, when a row does not
+// exist, or when the read fails.
+TableData* read_parquet_rows(const char* file_path, const long long* rows, int row_count, int max_cell_bytes);
+
+// The full text of one cell, for a cell a page cut short. NULL when the
+// row or column does not exist or the read fails.
+char* read_parquet_cell(const char* file_path, long long row, int column);
+void free_parquet_cell(char* text);
+
+// Sets how binary cells are formatted from now on, by every read and
+// search. Cached search results, statistics and profiles are dropped, as
+// they hold the old text.
+void set_binary_format(BinaryFormat format, int preview_bytes);
+
 void free_schema_info(SchemaInfo* info);
 void free_table_data(TableData* data);
 void clear_parquet_cache(const char* file_path);  // Clear cache for specific file
@@ -0,0 +1,54 @@
+#ifndef PARQUET_REWRITE_H
+#define PARQUET_REWRITE_H
+
+#include "ParquetMetadata.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Rewrites a file into a layout that browses well: row groups of a
+// bounded size, small pages with a page index so a row read decodes only
+// the pages holding it, and optionally bloom filters and rows sorted
+// within each row group. The source is streamed through a record batch
+// reader, so memory stays bounded by one output row group whatever the
+// size of the source's row groups.
+
+typedef struct {
+    long long row_group_rows;           // rows per output row group; 0 for 131072
+    long long data_page_bytes;          // target encoded page size; 0 for 64 KB
+    long long max_rows_per_page;        // 0 for 20000
+    ParquetCodec codec;                 // PARQUET_CODEC_LZO and _OTHER cannot be written
+    int write_page_index;
+    int dictionary_encoding;
+    const int* bloom_filter_columns;    // top-level columns; boolean leaves are skipped
+    int bloom_filter_column_count;
+    const int* sort_columns;            // top-level primitive columns, most significant first
+    const int* sort_descending;         // one per sort column, NULL for all ascending
+    int sort_column_count;
+} RewriteOptions;
+
+typedef struct {
+    long long row_count;
+    int row_group_count;
+    long long output_bytes;
+    double source_latency_ms;           // mean time to read one random row, before and after
+    double output_latency_ms;
+    char* error;                        // NULL when output_path was written
+} RewriteResult;
+
+// Writes source_path rewritten per options to output_path, which is
+// replaced only once the new file is complete and must not be the
+// source. Sorting orders rows within each output row group, which is what
+// the sorting columns recorded in the footer promise; rows are not sorted
+// across row groups. Blocks until done, so call it off the main thread.
+RewriteResult* rewrite_parquet_file(const char* source_path, const char* output_path,
+                                    const RewriteOptions* options);
+
+void free_rewrite_result(RewriteResult* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARQUET_REWRITE_H
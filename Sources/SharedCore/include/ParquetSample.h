@@ -0,0 +1,26 @@
+#ifndef PARQUET_SAMPLE_H
+#define PARQUET_SAMPLE_H
+
+#include "ParquetReader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Reads sample_size rows drawn uniformly at random without replacement
+// (every row when the file has no more), in file order. With stratified
+// set, each row group contributes in proportion to its row count, so every
+// stretch of the file is represented; otherwise every subset of the rows is
+// equally likely. The same non-zero seed draws the same rows; seed 0 draws
+// fresh ones. Only the pages holding sampled rows are decoded where the
+// offset index allows it, and cells are cut as read_parquet_page cuts them
+// to max_cell_bytes (0 for no limit). row_numbers, when not NULL, must hold
+// sample_size entries and receives each sampled row's number in the file.
+TableData* read_parquet_sample(const char* file_path, int sample_size, unsigned long long seed,
+                               int stratified, int max_cell_bytes, long long* row_numbers);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARQUET_SAMPLE_H
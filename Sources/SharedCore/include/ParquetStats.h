@@ -0,0 +1,34 @@
+#ifndef PARQUET_STATS_H
+#define PARQUET_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Summary of one top-level column
+typedef struct {
+    long long count;            // rows in the file
+    long long null_count;       // -1 when unknown
+    long long distinct_count;   // distinct non-null values, -1 when unknown
+    int distinct_is_estimate;   // distinct_count comes from a HyperLogLog sketch
+    char* min_value;            // NULL when unknown or every value is null
+    char* max_value;
+    int scanned;                // data pages had to be decoded
+} ColumnStats;
+
+// Computes statistics for a flat top-level column. Null count, min and max
+// come from the footer statistics when every row group has them; distinct
+// counts come from the dictionary pages when every page is dictionary
+// encoded. Anything else needs a parallel scan of the column's data pages,
+// which only happens when allow_scan is non-zero; otherwise those fields
+// are left unknown. Results are cached per file. Returns NULL on a read
+// error or for nested columns.
+ColumnStats* read_parquet_column_stats(const char* file_path, int column_index, int allow_scan);
+
+void free_column_stats(ColumnStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARQUET_STATS_H
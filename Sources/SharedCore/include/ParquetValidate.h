@@ -0,0 +1,50 @@
+#ifndef PARQUET_VALIDATE_H
+#define PARQUET_VALIDATE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Checks a file end to end rather than reading the first rows: every page
+// of every column chunk is read, its CRC verified when the writer recorded
+// one, decompressed and decoded, and value and row counts are compared
+// with the footer. A chunk's offset index, when it has one, must list the
+// data pages where the page headers put them. Column chunks are spread over a pool of workers, so a
+// large file validates at the speed the disk can deliver it.
+
+typedef struct {
+    char* path;                         // dotted leaf path
+    long long page_count;               // pages decoded
+    long long checksummed_page_count;   // of those, pages whose CRC was verified
+    int error_row_group;                // of the first bad page, -1 when the column is valid
+    int error_page;                     // ordinal of that page within its chunk, dictionary included;
+                                        // -1 when the chunk's pages disagree with the footer as a whole
+    long long error_offset;             // file offset of that page's header, -1 when unknown
+    char* error;                        // NULL when the column is valid
+} ColumnValidation;
+
+typedef struct {
+    int column_count;
+    ColumnValidation* columns;
+    int row_group_count;
+    long long row_count;                // as the footer records it
+    long long page_count;
+    long long checksummed_page_count;
+    long long bytes_checked;            // compressed bytes of the pages read
+    int invalid_column_count;
+    char* error;                        // the footer did not parse or disagrees with itself; NULL otherwise
+} ValidationReport;
+
+// Validates file_path on up to max_workers threads; 0 uses one per core.
+// A file whose footer cannot be parsed yields a report with no columns and
+// error set. Only a column's first bad page is reported, and its later
+// row groups are skipped once one fails.
+ValidationReport* validate_parquet_file(const char* file_path, int max_workers);
+
+void free_validation_report(ValidationReport* report);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARQUET_VALIDATE_H
@@ -2,5 +2,22 @@
 #define SharedCore_Bridging_Header_h
 
 #include "ParquetReader.h"
+#include "ParquetFilter.h"
+#include "ParquetPredicate.h"
+#include "ParquetStats.h"
+#include "ParquetProfile.h"
+#include "ParquetFacets.h"
+#include "ParquetAggregate.h"
+#include "ParquetSample.h"
+#include "ParquetDataset.h"
+#include "ParquetCatalog.h"
+#include "ParquetFooterCache.h"
+#include "ParquetAccelerate.h"
+#include "ParquetMetadata.h"
+#include "ParquetLayout.h"
+#include "ParquetValidate.h"
+#include "ParquetRewrite.h"
+#include "ParquetExport.h"
+#include "ParquetNested.h"
 
 #endif /* SharedCore_Bridging_Header_h */
\ No newline at end of file
@@ -41,6 +41,12 @@ func testFile(_ fileName: String) {
             print("✅ Middle 100 rows in \(String(format: "%.3f", midTime))s - \(midRows.count) rows loaded")
         }
         
+        // Test a random sample spread over the whole file
+        let sampleStart = Date()
+        let sample = try ParquetBridge.shared.readRandomSample(from: fileURL, count: 1000, seed: 1)
+        let sampleTime = Date().timeIntervalSince(sampleStart)
+        print("✅ Random 1000-row sample in \(String(format: "%.3f", sampleTime))s - \(sample.rows.count) rows loaded")
+        
         // Test sequential reads (simulate pagination)
         let pageStart = Date()
         var totalPagedRows = 0
@@ -136,18 +136,158 @@ final class DuckDBServiceTests: XCTestCase {
         XCTAssertNotNil(descRows)
     }
     
-    // MARK: - Column Statistics Tests
-    
-    func testGetColumnStats() async throws {
+    func testGetPageSortsThenPages() async throws {
+        try await service.loadFile(at: dataFile)
+
+        let rows = try await service.getPage(offset: 1, limit: 2, sortBy: "Age", ascending: false)
+        XCTAssertEqual(rows.count, 2)
+        guard case .string(let name)? = rows.first?.values.first,
+              case .int(let age)? = rows.first?.values[1] else {
+            return XCTFail("Expected a name and an integer age")
+        }
+        XCTAssertEqual(name, "Bob")
+        XCTAssertEqual(age, 30)
+        guard case .string(let last)? = rows.last?.values.first else {
+            return XCTFail("Expected a name")
+        }
+        XCTAssertEqual(last, "Alice")
+    }
+
+    func testSortedPageCutsCellsAndKeepsRowNumbers() async throws {
+        try await service.loadFile(at: dataFile)
+
+        let page = try await service.getPageWithRowNumbers(offset: 0, limit: 3, sortBy: "City", maxCellLength: 4)
+        XCTAssertEqual(page.rowNumbers, [2, 1, 0])
+        guard case .string(let city) = page.rows[0].values[2] else {
+            return XCTFail("Expected a city")
+        }
+        XCTAssertEqual(city, "Chic")
+        XCTAssertEqual(page.rows[0].truncatedColumns, [0, 2])
+
+        // The row number reads the full value back
+        guard case .string(let full) = try ParquetBridge.shared.readCell(from: dataFile, row: page.rowNumbers[0], column: 2) else {
+            return XCTFail("Expected a city")
+        }
+        XCTAssertEqual(full, "Chicago")
+    }
+
+    func testSortedPageFormatsBinaryAsSet() async throws {
+        // Tests/TestData/binary.parquet: ids 1 to 3 with 16, 4 and 8 byte payloads
+        let file = dataFile.deletingLastPathComponent().appendingPathComponent("binary.parquet")
+        defer { ParquetBridge.shared.setBinaryFormat(.hex) }
+        ParquetBridge.shared.setBinaryFormat(.base64, previewBytes: 0)
+        try await service.loadFile(at: file)
+
+        func payloads(_ rows: [ParquetRow]) -> [String] {
+            rows.map { row in
+                guard case .string(let text) = row.values[1] else { return "" }
+                return text
+            }
+        }
+        let sorted = try await service.getPage(offset: 0, limit: 3, sortBy: "id", ascending: false)
+        XCTAssertEqual(payloads(sorted), ["UGFycVZpZXc=", "/////w==", "AAECAwQFBgcICQoLDA0ODw=="])
+        let unsorted = try await service.getPage(offset: 0, limit: 3)
+        XCTAssertEqual(payloads(unsorted), Array(payloads(sorted).reversed()))
+    }
+
+    func testCSVFilePagesAndQueries() async throws {
+        let csv = FileManager.default.temporaryDirectory.appendingPathComponent("people_\(UUID().uuidString).csv")
+        defer { try? FileManager.default.removeItem(at: csv) }
+        try "name,age\nAlice,25\nBob,30\nCharlie,35\n".write(to: csv, atomically: true, encoding: .utf8)
+        try await service.loadFile(at: csv)
+
+        let page = try await service.getPageWithRowNumbers(offset: 1, limit: 5)
+        XCTAssertEqual(page.rowNumbers, [1, 2])
+        guard case .string(let name) = page.rows[0].values[0] else {
+            return XCTFail("Expected a name")
+        }
+        XCTAssertEqual(name, "Bob")
+
+        // Sorting needs Parquet; the SQL view reads the CSV itself
+        do {
+            _ = try await service.getPage(offset: 0, limit: 5, sortBy: "age")
+            XCTFail("Sorting a CSV file should throw")
+        } catch DuckDBError.queryFailed {
+        }
+        let result = try await service.executeQuery("SELECT max(age) AS oldest FROM parquet")
+        guard case .int(let oldest)? = result.rows.first?.values.first else {
+            return XCTFail("Expected an integer age")
+        }
+        XCTAssertEqual(oldest, 35)
+    }
+
+    // MARK: - Query Tests
+
+    func testExecuteQueryDecodesTypedValues() async throws {
+        try await service.loadFile(at: dataFile)
+
+        let result = try await service.executeQuery("""
+            SELECT Name, Age * 2 AS doubled, 1.5::DECIMAL(4,2) AS ratio, [1, 2] AS pair
+            FROM parquet ORDER BY Age LIMIT 2;
+            """)
+        XCTAssertEqual(result.columns.map { $0.name }, ["Name", "doubled", "ratio", "pair"])
+        XCTAssertEqual(result.columns.map { $0.type }, [.string, .int64, .string, .string])
+        XCTAssertEqual(result.rowCount, 2)
+        guard case .string(let name) = result.rows[0].values[0],
+              case .int(let doubled) = result.rows[0].values[1],
+              case .string(let ratio) = result.rows[0].values[2],
+              case .string(let pair) = result.rows[0].values[3] else {
+            return XCTFail("Unexpected value types")
+        }
+        XCTAssertEqual(name, "Alice")
+        XCTAssertEqual(doubled, 50)
+        XCTAssertEqual(ratio, "1.50")
+        XCTAssertEqual(pair, "[1, 2]")
+    }
+
+    func testExecuteQueryWrapsQueryEndingInComment() async throws {
+        try await service.loadFile(at: dataFile)
+
+        // Unwrapped, the decimal would come back null rather than as text
+        let result = try await service.executeQuery("SELECT 1.5::DECIMAL(4,2) AS ratio FROM parquet LIMIT 1 -- one row")
+        XCTAssertEqual(result.rowCount, 1)
+        guard case .string(let ratio)? = result.rows.first?.values.first else {
+            return XCTFail("Expected the decimal cast to text")
+        }
+        XCTAssertEqual(ratio, "1.50")
+    }
+
+    func testExecuteQueryRunsStatementsThatCannotBeWrapped() async throws {
+        try await service.loadFile(at: dataFile)
+
+        let result = try await service.executeQuery("PRAGMA table_info('parquet')")
+        let names = result.rows.compactMap { row -> String? in
+            guard case .string(let name) = row.values[1] else { return nil }
+            return name
+        }
+        XCTAssertEqual(names, ["Name", "Age", "City"])
+    }
+
+    func testExecuteQueryOnInvalidFileThrows() async throws {
         let testFile = createTestParquetFile()
         defer { try? FileManager.default.removeItem(at: testFile) }
-        
+
         try await service.loadFile(at: testFile)
+
+        // The view is created on first use, which must surface the bad file
+        do {
+            _ = try await service.executeQuery("SELECT COUNT(*) FROM parquet")
+            XCTFail("Querying an invalid parquet file should throw")
+        } catch {
+            XCTAssertNotNil(error)
+        }
+    }
+
+    // MARK: - Column Statistics Tests
+    
+    func testGetColumnStats() async throws {
+        try await service.loadFile(at: dataFile)
         
-        let stats = try await service.getColumnStats(columnName: "test_column")
+        let stats = try await service.getColumnStats(columnName: "City")
         
         // Verify statistics structure
-        XCTAssertGreaterThanOrEqual(stats.count, 0)
+        XCTAssertEqual(stats.count, 3)
+        XCTAssertEqual(stats.distinctCount, 3)
         XCTAssertGreaterThanOrEqual(stats.distinctCount, 0)
         XCTAssertGreaterThanOrEqual(stats.nullCount, 0)
         XCTAssertLessThanOrEqual(stats.distinctCount, stats.count)
@@ -202,23 +342,31 @@ final class DuckDBServiceTests: XCTestCase {
     
     // MARK: - Export Tests
     
-    func testExportToCSVNotImplemented() async throws {
-        let testFile = createTestParquetFile()
-        defer { try? FileManager.default.removeItem(at: testFile) }
-        
-        try await service.loadFile(at: testFile)
-        
-        let outputPath = URL(fileURLWithPath: "/tmp/output.csv")
-        
-        // Should throw not implemented error
-        do {
-            try await service.exportToCSV(outputPath: outputPath)
-            XCTFail("Export should not be implemented yet")
-        } catch DuckDBError.queryFailed(let message) {
-            XCTAssertTrue(message.contains("not yet implemented"))
-        } catch {
-            XCTFail("Unexpected error type: \(error)")
+    func testExportToCSVRoundTrip() async throws {
+        try await service.loadFile(at: dataFile)
+
+        let outputPath = FileManager.default.temporaryDirectory.appendingPathComponent("export_\(UUID().uuidString).csv")
+        defer { try? FileManager.default.removeItem(at: outputPath) }
+
+        let result = try await service.exportToCSV(outputPath: outputPath)
+        XCTAssertEqual(result.rowCount, 3)
+        XCTAssertFalse(result.cancelled)
+
+        let text = try String(contentsOf: outputPath, encoding: .utf8)
+        XCTAssertEqual(text.split(separator: "\n"), [
+            "Name,Age,City",
+            "\"Alice\",25,\"New York\"",
+            "\"Bob\",30,\"Los Angeles\"",
+            "\"Charlie\",35,\"Chicago\""
+        ])
+
+        // The CSV reads back as the same rows
+        let rows = try ParquetBridge.shared.readSampleRows(from: outputPath)
+        XCTAssertEqual(rows.count, 3)
+        guard case .string(let city) = rows[1].values[2] else {
+            return XCTFail("Expected a city")
         }
+        XCTAssertEqual(city, "Los Angeles")
     }
     
     // MARK: - Error Handling Tests
@@ -298,6 +446,15 @@ final class DuckDBServiceTests: XCTestCase {
     }
     
     // MARK: - Helper Methods
+
+    /// Tests/TestData/data.parquet: Name, Age and City of Alice (25, New York),
+    /// Bob (30, Los Angeles) and Charlie (35, Chicago)
+    private var dataFile: URL {
+        URL(fileURLWithPath: #filePath)
+            .deletingLastPathComponent()
+            .deletingLastPathComponent()
+            .appendingPathComponent("TestData/data.parquet")
+    }
     
     private func createTestParquetFile(rows: Int = 100) -> URL {
         // Create a minimal parquet file for testing
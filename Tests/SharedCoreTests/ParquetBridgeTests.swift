@@ -121,6 +121,750 @@ final class ParquetBridgeTests: XCTestCase {
         XCTAssertEqual(rows.count, 0)
     }
     
+    func testReadCSVRowsPastRowIndexBlock() throws {
+        let csv = FileManager.default.temporaryDirectory.appendingPathComponent("rows_\(UUID().uuidString).csv")
+        defer { try? FileManager.default.removeItem(at: csv) }
+        let lines = ["id,name"] + (0..<10_000).map { "\($0),\"name \($0)\"" }
+        try lines.joined(separator: "\n").write(to: csv, atomically: true, encoding: .utf8)
+
+        XCTAssertEqual(bridge.fileFormat(of: csv), .csv)
+        XCTAssertEqual(try bridge.getRowCount(from: csv), 10_000)
+        let rows = try bridge.readSampleRows(from: csv, limit: 2, offset: 5_000)
+        XCTAssertEqual(rows.count, 2)
+        guard case .int(let id)? = rows.first?.values.first else {
+            return XCTFail("Expected an integer id")
+        }
+        XCTAssertEqual(id, 5_000)
+    }
+
+    func testReadSampleRowsCutsLongCells() throws {
+        let csv = FileManager.default.temporaryDirectory.appendingPathComponent("cells_\(UUID().uuidString).csv")
+        defer { try? FileManager.default.removeItem(at: csv) }
+        let long = String(repeating: "é", count: 10_000)
+        try "id,text\n1,short\n2,\(long)\n".write(to: csv, atomically: true, encoding: .utf8)
+
+        let rows = try bridge.readSampleRows(from: csv, limit: 2, maxCellLength: 9)
+        XCTAssertEqual(rows.count, 2)
+        XCTAssertTrue(rows[0].truncatedColumns.isEmpty)
+        XCTAssertEqual(rows[1].truncatedColumns, [1])
+        guard case .string(let preview) = rows[1].values[1], case .string(let full) = try bridge.readCell(from: csv, row: 1, column: 1) else {
+            return XCTFail("Expected text values")
+        }
+        XCTAssertEqual(preview, String(repeating: "é", count: 4))
+        XCTAssertEqual(full, long)
+    }
+
+    func testReadRowsInRequestedOrder() throws {
+        let rows = try bridge.readRows(from: dataFile, rowNumbers: [2, 0, 2], maxCellLength: 4)
+        let names = rows.map { row -> String in
+            guard case .string(let name) = row.values[0] else { return "" }
+            return name
+        }
+        XCTAssertEqual(names, ["Char", "Alic", "Char"])
+        XCTAssertEqual(rows.map { $0.truncatedColumns }, [[0, 2], [0, 2], [0, 2]])
+
+        XCTAssertThrowsError(try bridge.readRows(from: dataFile, rowNumbers: [3]))
+    }
+
+    func testReadRowsFromPagesInsideRowGroups() throws {
+        let indexed = FileManager.default.temporaryDirectory.appendingPathComponent("indexed_\(UUID().uuidString).parquet")
+        defer { try? FileManager.default.removeItem(at: indexed) }
+        // Row groups of 4,000 rows in 500-row pages, with an offset index, so
+        // each row decodes only the page holding it
+        var rewrite = ParquetRewriteOptions()
+        rewrite.rowGroupRows = 4_000
+        rewrite.maxRowsPerPage = 500
+        _ = try bridge.rewriteForViewing(numbersFile, to: indexed, options: rewrite)
+        XCTAssertEqual(try bridge.readMetadata(from: indexed).rowGroups, 3)
+
+        // Rows either side of page boundaries, in the middle of each row group
+        let wanted = [1_001, 4_499, 4_500, 7_250, 999, 9_999, 4_500, 1_000]
+        let rows = try bridge.readRows(from: indexed, rowNumbers: wanted)
+        XCTAssertEqual(rows.count, wanted.count)
+        for (row, number) in zip(rows, wanted) {
+            guard case .int(let id) = row.values[0], case .string(let label) = row.values[1],
+                  case .string(let region) = row.values[2] else {
+                return XCTFail("Expected an id, a label and a region")
+            }
+            XCTAssertEqual(id, Int64(number))
+            XCTAssertEqual(label, "row \(number)")
+            XCTAssertEqual(region, number % 10 < 5 ? "north" : (number % 10 < 8 ? "south" : "east"))
+        }
+    }
+
+    func testBinaryFormatLeavesTextCellsAlone() throws {
+        let csv = FileManager.default.temporaryDirectory.appendingPathComponent("binary_\(UUID().uuidString).csv")
+        defer {
+            try? FileManager.default.removeItem(at: csv)
+            bridge.setBinaryFormat(.hex)
+        }
+        try "id,text\n1,0xff\n".write(to: csv, atomically: true, encoding: .utf8)
+
+        bridge.setBinaryFormat(.base64, previewBytes: 0)
+        let rows = try bridge.readSampleRows(from: csv, limit: 1)
+        guard case .string(let text) = rows.first?.values[1] else {
+            return XCTFail("Expected a text value")
+        }
+        XCTAssertEqual(text, "0xff")
+    }
+
+    func testUUIDLogicalTypeShowsCanonically() throws {
+        // A bare fixed_len_byte_array(16) with the UUID logical type and no
+        // stored Arrow schema
+        let expected = ["0f8fad5b-d9cb-469f-a165-70867728950e", "7c9e6679-7425-40de-944b-e07fc1f90ae7"]
+        let keys = try bridge.readSampleRows(from: uuidFile).map { row -> String in
+            guard case .string(let key) = row.values[1] else { return "" }
+            return key
+        }
+        XCTAssertEqual(keys, expected)
+
+        // Searches match the text shown, and exports write it
+        let (rows, total) = try bridge.readFilteredRows(from: uuidFile, filterText: "944B-E07F")
+        XCTAssertEqual(total, 1)
+        guard case .string(let key)? = rows.first?.values[1] else {
+            return XCTFail("Expected a UUID")
+        }
+        XCTAssertEqual(key, expected[1])
+
+        let csv = FileManager.default.temporaryDirectory.appendingPathComponent("uuid_\(UUID().uuidString).csv")
+        defer { try? FileManager.default.removeItem(at: csv) }
+        _ = try bridge.export(uuidFile, to: csv, format: .csv)
+        let text = try String(contentsOf: csv, encoding: .utf8)
+        XCTAssertTrue(expected.allSatisfy { text.contains($0) }, text)
+    }
+
+    func testLargeStringIPCColumnReadsAsText() throws {
+        // Cut cells are viewed in place; full values, searches and nested
+        // items go through the shared formatter
+        let rows = try bridge.readSampleRows(from: largeStringFile, limit: 3, maxCellLength: 9)
+        XCTAssertEqual(rows.count, 3)
+        XCTAssertEqual(rows[1].truncatedColumns, [1])
+        guard case .string(let first) = rows[0].values[1], case .string(let preview) = rows[1].values[1],
+              case .string(let full) = try bridge.readCell(from: largeStringFile, row: 1, column: 1) else {
+            return XCTFail("Expected text values")
+        }
+        XCTAssertEqual(first, "alpha")
+        XCTAssertEqual(preview, String(repeating: "é", count: 4))
+        XCTAssertEqual(full, String(repeating: "é", count: 10_000))
+
+        let (matches, total) = try bridge.readFilteredRows(from: largeStringFile, filterText: "GAMMA")
+        XCTAssertEqual(total, 1)
+        guard case .int(let id)? = matches.first?.values[0], case .string(let text)? = matches.first?.values[1] else {
+            return XCTFail("Expected an id and a text value")
+        }
+        XCTAssertEqual(id, 3)
+        XCTAssertEqual(text, "gamma ray")
+    }
+
+    func testReadNestedFieldPaths() throws {
+        let jsonl = FileManager.default.temporaryDirectory.appendingPathComponent("nested_\(UUID().uuidString).jsonl")
+        defer { try? FileManager.default.removeItem(at: jsonl) }
+        let lines = (0..<10).map { "{\"id\": \($0), \"payload\": {\"user\": {\"id\": \($0 * 10)}}, \"tags\": [\"a\", \"b\"]}" }
+        try lines.joined(separator: "\n").write(to: jsonl, atomically: true, encoding: .utf8)
+
+        let payload = try XCTUnwrap(bridge.readFieldTree(from: jsonl).first { $0.path == "payload" })
+        XCTAssertEqual(payload.children.first?.children.first?.path, "payload.user.id")
+        XCTAssertEqual(try bridge.readSchema(from: jsonl).columns.last?.type, .list)
+
+        let rows = try bridge.readFieldPaths(from: jsonl, paths: ["payload.user.id"], limit: 1, offset: 3)
+        guard case .int(let id)? = rows.first?.values.first else {
+            return XCTFail("Expected an integer leaf")
+        }
+        XCTAssertEqual(id, 30)
+        XCTAssertThrowsError(try bridge.readFieldPaths(from: jsonl, paths: ["payload.nope"]))
+    }
+
+    func testReadNestedParquetFieldPaths() throws {
+        // Leaves come from the file's own column numbering
+        let tree = try bridge.readFieldTree(from: nestedFile)
+        XCTAssertEqual(tree.map { $0.path }, ["id", "payload", "events", "attrs"])
+        let leaves = { (field: ParquetField) in field.children.map { "\($0.path)=\($0.leafColumn ?? -1)" } }
+        XCTAssertEqual(leaves(tree[1].children[0]), ["payload.user.id=1", "payload.user.name=2"])
+        XCTAssertEqual(leaves(tree[2].children[0]), ["events.element.kind=4", "events.element.step=5"])
+        XCTAssertEqual(leaves(tree[3]), ["attrs.key=6", "attrs.value=7"])
+
+        // Only the leaves asked for are read: the map's values come back
+        // without their keys, and the list's structs as lists of one field
+        let rows = try bridge.readFieldPaths(from: nestedFile,
+                                             paths: ["payload.user.id", "events.element.kind", "attrs.value"])
+        XCTAssertEqual(rows.count, 3)
+        let ids = rows.map { row -> Int64 in
+            guard case .int(let id) = row.values[0] else { return -1 }
+            return id
+        }
+        XCTAssertEqual(ids, [10, 20, 30])
+        let lists = rows.map { row in
+            row.values[1...].map { value -> String in
+                guard case .string(let text) = value else { return "" }
+                return text
+            }
+        }
+        XCTAssertEqual(lists, [["[\"open\", \"close\"]", "[1, 2]"], ["[]", "[]"], ["[\"view\"]", "[3]"]])
+
+        let last = try bridge.readFieldPaths(from: nestedFile, paths: ["payload.user.name"], limit: 1, offset: 2)
+        guard case .string(let name)? = last.first?.values.first else {
+            return XCTFail("Expected a name")
+        }
+        XCTAssertEqual(name, "cy")
+    }
+
+    // MARK: - Filter Tests
+
+    func testReadFilteredRowsFromInvalidFile() throws {
+        let invalidFile = URL(fileURLWithPath: "/tmp/nonexistent.parquet")
+
+        // Should throw rather than report zero matches
+        XCTAssertThrowsError(try bridge.readFilteredRows(from: invalidFile, filterText: "a"))
+    }
+
+    func testReadFilteredRowsPageWithinTotal() throws {
+        // "o" is in every name but Charlie's and in every city
+        let (rows, total) = try bridge.readFilteredRows(from: dataFile, filterText: "O", limit: 2, offset: 1)
+
+        XCTAssertEqual(total, 3)
+        XCTAssertEqual(rows.count, 2)
+        guard case .string(let name)? = rows.first?.values.first else {
+            return XCTFail("Expected a name")
+        }
+        XCTAssertEqual(name, "Bob")
+    }
+
+    func testReadFilteredRowsIgnoresCase() throws {
+        let (rows, total) = try bridge.readFilteredRows(from: dataFile, filterText: "new YORK", columns: ["City"])
+        XCTAssertEqual(total, 1)
+        guard case .string(let name)? = rows.first?.values.first else {
+            return XCTFail("Expected a name")
+        }
+        XCTAssertEqual(name, "Alice")
+
+        let csv = FileManager.default.temporaryDirectory.appendingPathComponent("cities_\(UUID().uuidString).csv")
+        defer { try? FileManager.default.removeItem(at: csv) }
+        try "city\nÉvry\nStraße\nМОСКВА\nİSTANBUL\n".write(to: csv, atomically: true, encoding: .utf8)
+        XCTAssertEqual(try bridge.readFilteredRows(from: csv, filterText: "évry").1, 1)
+        XCTAssertEqual(try bridge.readFilteredRows(from: csv, filterText: "STRAßE").1, 1)
+        XCTAssertEqual(try bridge.readFilteredRows(from: csv, filterText: "москва").1, 1)
+        XCTAssertEqual(try bridge.readFilteredRows(from: csv, filterText: "istanbul").1, 1)
+        XCTAssertEqual(try bridge.readFilteredRows(from: csv, filterText: "İstanbul").1, 1)
+    }
+
+    func testReadPredicateRowsFromInvalidFile() throws {
+        let invalidFile = URL(fileURLWithPath: "/tmp/nonexistent.parquet")
+        let predicate = ParquetPredicate(column: "id", op: .equal, values: ["1"])
+
+        XCTAssertThrowsError(try bridge.readPredicateRows(from: invalidFile, predicates: [predicate]))
+    }
+
+    func testReadPredicateRowsMatchesTypedValues() throws {
+        let older = ParquetPredicate(column: "Age", op: .greaterThan, values: ["28"])
+        let (rows, total, summary) = try bridge.readPredicateRows(from: dataFile, predicates: [older])
+        XCTAssertEqual(total, 2)
+        XCTAssertEqual(summary.rowGroupsTotal, 1)
+        guard case .string(let name)? = rows.first?.values.first else {
+            return XCTFail("Expected a name")
+        }
+        XCTAssertEqual(name, "Bob")
+
+        let cities = ParquetPredicate(column: "City", op: .isIn, values: ["Chicago", "Paris"])
+        XCTAssertEqual(try bridge.readPredicateRows(from: dataFile, predicates: [older, cities]).1, 1)
+    }
+
+    func testReadPredicateRowsOnByteArrayDecimals() throws {
+        func ids(_ predicate: ParquetPredicate) throws -> [Int64] {
+            try bridge.readPredicateRows(from: decimalsFile, predicates: [predicate]).0.map { row in
+                guard case .int(let id) = row.values[0] else { return 0 }
+                return id
+            }
+        }
+
+        // amount is stored as FIXED_LEN_BYTE_ARRAY(16), price as INT32
+        XCTAssertEqual(try ids(ParquetPredicate(column: "amount", op: .greaterThan, values: ["100"])), [4, 6])
+        XCTAssertEqual(try ids(ParquetPredicate(column: "amount", op: .equal, values: ["0.1"])), [2])
+        XCTAssertEqual(try ids(ParquetPredicate(column: "amount", op: .between, values: ["-10", "1"])), [1, 2])
+        XCTAssertEqual(try ids(ParquetPredicate(column: "amount", op: .equal, values: ["12345678901234567.89"])), [4])
+        XCTAssertEqual(try ids(ParquetPredicate(column: "price", op: .equal, values: ["7.25"])), [5, 6])
+
+        // Above the footer's max, so the row group is never read
+        let above = ParquetPredicate(column: "amount", op: .greaterThan, values: ["99999999999999999.99"])
+        let (rows, total, summary) = try bridge.readPredicateRows(from: decimalsFile, predicates: [above])
+        XCTAssertTrue(rows.isEmpty)
+        XCTAssertEqual(total, 0)
+        XCTAssertEqual(summary.rowGroupsRead, 0)
+
+        let badOperand = ParquetPredicate(column: "amount", op: .equal, values: ["ten"])
+        XCTAssertThrowsError(try bridge.readPredicateRows(from: decimalsFile, predicates: [badOperand]))
+    }
+
+    func testFilteredPredicateAndSamplePagesCutCells() throws {
+        func names(_ rows: [ParquetRow]) -> [String] {
+            rows.map { row in
+                guard case .string(let name) = row.values[0] else { return "" }
+                return name
+            }
+        }
+
+        let filtered = try bridge.readFilteredRowsWithRowNumbers(from: dataFile, filterText: "o", limit: 2, offset: 1,
+                                                                 maxCellLength: 2)
+        XCTAssertEqual(filtered.totalMatches, 3)
+        XCTAssertEqual(filtered.rowNumbers, [1, 2])
+        XCTAssertEqual(names(filtered.rows), ["Bo", "Ch"])
+        XCTAssertTrue(filtered.rows[1].truncatedColumns.contains(0))
+        guard case .string(let full) = try bridge.readCell(from: dataFile, row: filtered.rowNumbers[1], column: 0) else {
+            return XCTFail("Expected a name")
+        }
+        XCTAssertEqual(full, "Charlie")
+
+        let older = ParquetPredicate(column: "Age", op: .greaterThan, values: ["28"])
+        let matched = try bridge.readPredicateRowsWithRowNumbers(from: dataFile, predicates: [older], maxCellLength: 2)
+        XCTAssertEqual(matched.rowNumbers, [1, 2])
+        XCTAssertEqual(names(matched.rows), ["Bo", "Ch"])
+
+        let sample = try bridge.readRandomSample(from: dataFile, count: 3, seed: 1, maxCellLength: 2)
+        XCTAssertEqual(sample.rowNumbers, [0, 1, 2])
+        XCTAssertEqual(names(sample.rows), ["Al", "Bo", "Ch"])
+    }
+
+    func testReadPredicateRowsSkipsRowGroupsByBloomFilter() throws {
+        let output = FileManager.default.temporaryDirectory.appendingPathComponent("bloom_\(UUID().uuidString).parquet")
+        defer { try? FileManager.default.removeItem(at: output) }
+        var options = ParquetRewriteOptions()
+        options.rowGroupRows = 2_000
+        options.bloomFilterColumns = ["label"]
+        _ = try bridge.rewriteForViewing(numbersFile, to: output, options: options)
+
+        // "row 12345" lies between the first row group's min and max labels,
+        // "row 0" and "row 999", so only the bloom filter can rule it out
+        let absent = ParquetPredicate(column: "label", op: .equal, values: ["row 12345"])
+        let (rows, total, summary) = try bridge.readPredicateRows(from: output, predicates: [absent])
+        XCTAssertEqual(summary.rowGroupsTotal, 5)
+        XCTAssertGreaterThan(summary.rowGroupsSkippedByBloomFilter, 0)
+        XCTAssertEqual(summary.rowGroupsRead, 0)
+        XCTAssertEqual(total, 0)
+        XCTAssertTrue(rows.isEmpty)
+        // A cached hit reports the scan that found its matches
+        XCTAssertEqual(try bridge.readPredicateRows(from: output, predicates: [absent]).2, summary)
+
+        // A present value is still found
+        let present = ParquetPredicate(column: "label", op: .equal, values: ["row 1234"])
+        XCTAssertEqual(try bridge.readPredicateRows(from: output, predicates: [present]).1, 1)
+    }
+
+    func testPredicateMatchesAgreeWithPlainBitVector() throws {
+        // Per 65,536-row container: m16 == 0 fills an array to its 4,096
+        // limit, m15 == 0 just passes it into a bitset, and band is a run,
+        // then an array, then a bitset. Row groups end at 51,200 and 102,400,
+        // so containers are merged as row groups are appended.
+        let cases: [(ParquetPredicate, (Int) -> Bool)] = [
+            (ParquetPredicate(column: "m16", op: .equal, values: ["0"]), { $0 % 16 == 0 }),
+            (ParquetPredicate(column: "m15", op: .equal, values: ["0"]), { $0 % 15 == 0 }),
+            (ParquetPredicate(column: "band", op: .equal, values: ["true"]), { row in
+                row < 65_536 ? (1_000..<30_000).contains(row) : (row < 131_072 ? row % 16 == 0 : row % 3 == 0)
+            }),
+            (ParquetPredicate(column: "id", op: .between, values: ["60000", "140000"]), { (60_000...140_000).contains($0) })
+        ]
+
+        for (predicate, matches) in cases {
+            let reference = (0..<150_000).map(matches)
+            let expected = reference.indices.filter { reference[$0] }
+            // Pages starting at every container and row group boundary, and at both ends
+            var offsets = [0, expected.count - 3, expected.count]
+            for boundary in [51_200, 65_536, 102_400, 131_072] {
+                let rank = reference[..<boundary].filter { $0 }.count
+                offsets += [max(rank - 2, 0), rank]
+            }
+
+            for offset in offsets {
+                let (rows, total, _) = try bridge.readPredicateRows(from: bitmapFile, predicates: [predicate],
+                                                                    limit: 5, offset: offset)
+                XCTAssertEqual(total, expected.count, "\(predicate.column)")
+                let ids = rows.map { row -> Int in
+                    guard case .int(let id) = row.values[0] else { return -1 }
+                    return Int(id)
+                }
+                XCTAssertEqual(ids, Array(expected[offset..<min(offset + 5, expected.count)]),
+                               "\(predicate.column) at \(offset)")
+            }
+        }
+    }
+
+    func testClearCacheDropsCachedPredicateMatches() throws {
+        let file = FileManager.default.temporaryDirectory.appendingPathComponent("cached_\(UUID().uuidString).parquet")
+        defer { try? FileManager.default.removeItem(at: file) }
+        try FileManager.default.copyItem(at: bitmapFile, to: file)
+
+        let later = ParquetPredicate(column: "id", op: .greaterThanOrEqual, values: ["5000"])
+        XCTAssertEqual(try bridge.readPredicateRows(from: file, predicates: [later]).1, 145_000)
+        // The second read pages through the cached matches
+        let (rows, total, _) = try bridge.readPredicateRows(from: file, predicates: [later], limit: 1, offset: 144_999)
+        XCTAssertEqual(total, 145_000)
+        guard case .int(let last)? = rows.first?.values[0] else {
+            return XCTFail("Expected an id")
+        }
+        XCTAssertEqual(last, 149_999)
+
+        // Once the file is replaced and its cache cleared, the same filter rescans
+        try FileManager.default.removeItem(at: file)
+        try FileManager.default.copyItem(at: numbersFile, to: file)
+        bridge.clearCache(for: file)
+        XCTAssertEqual(try bridge.readPredicateRows(from: file, predicates: [later]).1, 5_000)
+    }
+
+    func testReadPredicateRowsUnknownColumn() throws {
+        let predicate = ParquetPredicate(column: "no_such_column", op: .isNull)
+        XCTAssertThrowsError(try bridge.readPredicateRows(from: dataFile, predicates: [predicate]))
+
+        // A column of the wrong type for its operand is rejected too
+        let badOperand = ParquetPredicate(column: "Age", op: .equal, values: ["thirty"])
+        XCTAssertThrowsError(try bridge.readPredicateRows(from: dataFile, predicates: [badOperand]))
+    }
+
+    // MARK: - Statistics Tests
+
+    func testReadColumnStatisticsFromInvalidFile() throws {
+        let invalidFile = URL(fileURLWithPath: "/tmp/nonexistent.parquet")
+
+        XCTAssertThrowsError(try bridge.readColumnStatistics(from: invalidFile, columnIndex: 0))
+    }
+
+    func testReadColumnStatistics() throws {
+        let stats = try bridge.readColumnStatistics(from: dataFile, columnIndex: 1)
+
+        XCTAssertEqual(stats.count, 3)
+        XCTAssertEqual(stats.nullCount, 0)
+        XCTAssertEqual(stats.distinctCount, 3)
+        XCTAssertEqual(stats.minValue, "25")
+        XCTAssertEqual(stats.maxValue, "35")
+    }
+
+    func testReadColumnProfilesFromInvalidFile() throws {
+        let invalidFile = URL(fileURLWithPath: "/tmp/nonexistent.parquet")
+
+        XCTAssertThrowsError(try bridge.readColumnProfiles(from: invalidFile))
+    }
+
+    func testReadColumnProfiles() throws {
+        let profiles = try bridge.readColumnProfiles(from: dataFile, columns: ["Age"],
+                                                     probabilities: [0.5], binCount: 2)
+        let age = try XCTUnwrap(profiles.first)
+
+        XCTAssertEqual(age.column, "Age")
+        XCTAssertEqual(age.valueCount, 3)
+        XCTAssertEqual(age.minimumLabel, "25")
+        XCTAssertEqual(age.maximumLabel, "35")
+        XCTAssertEqual(age.quantiles.first?.value ?? 0, 30, accuracy: 0.001)
+        // 25 in [25, 30); 30 and 35 in [30, 35]
+        XCTAssertEqual(age.histogram.map { $0.count }, [1, 2])
+    }
+
+    func testReadFacetsFromInvalidFile() throws {
+        let invalidFile = URL(fileURLWithPath: "/tmp/nonexistent.parquet")
+
+        XCTAssertThrowsError(try bridge.readFacets(from: invalidFile, topN: 5))
+    }
+
+    func testReadFacetsOverMatchingRows() throws {
+        let older = ParquetPredicate(column: "Age", op: .greaterThan, values: ["28"])
+        let facets = try bridge.readFacets(from: dataFile, columns: ["City"], topN: 10, predicates: [older])
+        let city = try XCTUnwrap(facets.first)
+
+        XCTAssertEqual(city.column, "City")
+        XCTAssertEqual(city.rowCount, 2)
+        XCTAssertTrue(city.isExact)
+        XCTAssertEqual(city.values.map { $0.value }.sorted(), ["Chicago", "Los Angeles"])
+        XCTAssertEqual(city.values.map { $0.count }, [1, 1])
+    }
+
+    func testAggregateFromInvalidFile() throws {
+        let invalidFile = URL(fileURLWithPath: "/tmp/nonexistent.parquet")
+
+        XCTAssertThrowsError(try bridge.aggregate(from: invalidFile, groupBy: [],
+                                                  aggregations: [Aggregation(.count)]))
+    }
+
+    func testAggregateWholeFile() throws {
+        let result = try bridge.aggregate(from: dataFile, groupBy: [], aggregations: [
+            Aggregation(.count), Aggregation(.sum, "Age"), Aggregation(.average, "Age"), Aggregation(.max, "Age")
+        ])
+
+        XCTAssertEqual(result.groupCount, 1)
+        XCTAssertEqual(result.inputRowCount, 3)
+        let values = try XCTUnwrap(result.table.rows.first?.values)
+        guard case .int(let count) = values[0], case .int(let sum) = values[1],
+              case .float(let average) = values[2], case .int(let oldest) = values[3] else {
+            return XCTFail("Expected integer count, sum and max and a floating average")
+        }
+        XCTAssertEqual(count, 3)
+        XCTAssertEqual(sum, 90)
+        XCTAssertEqual(average, 30, accuracy: 0.001)
+        XCTAssertEqual(oldest, 35)
+    }
+
+    func testAggregateGroupsMatchingRows() throws {
+        let older = ParquetPredicate(column: "Age", op: .greaterThan, values: ["28"])
+        let result = try bridge.aggregate(from: dataFile, groupBy: ["City"], aggregations: [Aggregation(.sum, "Age")],
+                                          predicates: [older], orderBy: 1, descending: true)
+
+        XCTAssertEqual(result.groupCount, 2)
+        XCTAssertEqual(result.inputRowCount, 2)
+        XCTAssertEqual(result.table.columns.first?.name, "City")
+        guard case .string(let city) = result.table.rows[0].values[0],
+              case .int(let sum) = result.table.rows[0].values[1] else {
+            return XCTFail("Expected a city and an integer sum")
+        }
+        XCTAssertEqual(city, "Chicago")
+        XCTAssertEqual(sum, 35)
+
+        let unknown = Aggregation(.sum, "no_such_column")
+        XCTAssertThrowsError(try bridge.aggregate(from: dataFile, groupBy: [], aggregations: [unknown]))
+    }
+
+    func testAggregateSpillsAndMatchesInMemoryRun() throws {
+        let aggregations = [Aggregation(.count), Aggregation(.sum, "id"), Aggregation(.min, "id"),
+                            Aggregation(.max, "id"), Aggregation(.average, "id")]
+        func cells(_ result: AggregationResult) -> [String] {
+            result.table.rows.map { String(describing: $0.values) }
+        }
+
+        // A one-byte limit spills after every batch, so every group goes
+        // through the spill files and the partition merge
+        for key in ["region", "id"] {
+            let inMemory = try bridge.aggregate(from: numbersFile, groupBy: [key], aggregations: aggregations)
+            let spilled = try bridge.aggregate(from: numbersFile, groupBy: [key], aggregations: aggregations,
+                                               memoryLimit: 1)
+            XCTAssertFalse(inMemory.spilled)
+            XCTAssertTrue(spilled.spilled)
+            XCTAssertEqual(spilled.groupCount, key == "region" ? 3 : 10_000)
+            XCTAssertEqual(spilled.groupCount, inMemory.groupCount)
+            XCTAssertEqual(spilled.inputRowCount, 10_000)
+            XCTAssertEqual(cells(spilled), cells(inMemory))
+        }
+
+        // north holds the ids ending in 0 to 4
+        let regions = try bridge.aggregate(from: numbersFile, groupBy: ["region"], aggregations: aggregations,
+                                           memoryLimit: 1)
+        guard case .string(let region) = regions.table.rows[1].values[0],
+              case .int(let count) = regions.table.rows[1].values[1],
+              case .int(let sum) = regions.table.rows[1].values[2] else {
+            return XCTFail("Expected a region, a count and a sum")
+        }
+        XCTAssertEqual(region, "north")
+        XCTAssertEqual(count, 5_000)
+        XCTAssertEqual(sum, 24_985_000)
+    }
+
+    func testReadRandomSampleFromInvalidFile() throws {
+        let invalidFile = URL(fileURLWithPath: "/tmp/nonexistent.parquet")
+
+        XCTAssertThrowsError(try bridge.readRandomSample(from: invalidFile, count: 10, seed: 42))
+    }
+
+    func testReadRandomSampleRepeatsSeededDraw() throws {
+        let first = try bridge.readRandomSample(from: dataFile, count: 2, seed: 42)
+        let second = try bridge.readRandomSample(from: dataFile, count: 2, seed: 42)
+
+        XCTAssertEqual(first.rows.count, 2)
+        XCTAssertEqual(first.rowNumbers, second.rowNumbers)
+        XCTAssertEqual(first.rowNumbers, first.rowNumbers.sorted())
+
+        // Each row is the one its row number names
+        let names = ["Alice", "Bob", "Charlie"]
+        for (row, number) in zip(first.rows, first.rowNumbers) {
+            guard case .string(let name) = row.values[0] else {
+                return XCTFail("Expected a name")
+            }
+            XCTAssertEqual(name, names[number])
+        }
+
+        // Asking for more rows than the file has returns every row
+        XCTAssertEqual(try bridge.readRandomSample(from: dataFile, count: 10, seed: 42).rowNumbers, [0, 1, 2])
+    }
+
+    func testStratifiedSampleDrawsEachRowGroupsShare() throws {
+        let grouped = FileManager.default.temporaryDirectory.appendingPathComponent("strata_\(UUID().uuidString).parquet")
+        defer { try? FileManager.default.removeItem(at: grouped) }
+        // Row groups of 4,000, 4,000 and 2,000 rows: 40%, 40% and 20%
+        var rewrite = ParquetRewriteOptions()
+        rewrite.rowGroupRows = 4_000
+        _ = try bridge.rewriteForViewing(numbersFile, to: grouped, options: rewrite)
+        XCTAssertEqual(try bridge.readMetadata(from: grouped).rowGroups, 3)
+
+        // 7 rows split 2.8 / 2.8 / 1.4, the remainder going to the largest fractions
+        for (count, shares) in [(50, [20, 20, 10]), (7, [3, 3, 1])] {
+            for seed: UInt64 in [1, 42, 2024] {
+                let sample = try bridge.readRandomSample(from: grouped, count: count, seed: seed, stratified: true)
+                XCTAssertEqual(sample.rowNumbers.count, count)
+                XCTAssertEqual(Set(sample.rowNumbers).count, count)
+                let drawn = [0..<4_000, 4_000..<8_000, 8_000..<10_000].map { group in
+                    sample.rowNumbers.filter { group.contains($0) }.count
+                }
+                XCTAssertEqual(drawn, shares, "seed \(seed)")
+                for (row, number) in zip(sample.rows, sample.rowNumbers) {
+                    guard case .int(let id) = row.values[0] else {
+                        return XCTFail("Expected an id")
+                    }
+                    XCTAssertEqual(id, Int64(number))
+                }
+            }
+        }
+    }
+
+    func testReadDatasetInfoFromMissingDirectory() throws {
+        let missing = FileManager.default.temporaryDirectory.appendingPathComponent("dataset_\(UUID().uuidString)")
+
+        XCTAssertThrowsError(try bridge.readDatasetInfo(from: missing))
+    }
+
+    func testReadDatasetRowsAcrossPartitions() throws {
+        let root = FileManager.default.temporaryDirectory.appendingPathComponent("dataset_\(UUID().uuidString)")
+        defer { try? FileManager.default.removeItem(at: root) }
+        for (year, name) in [("2023", "a"), ("2024", "b")] {
+            let directory = root.appendingPathComponent("year=\(year)")
+            try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+            try FileManager.default.copyItem(at: dataFile, to: directory.appendingPathComponent("\(name).parquet"))
+        }
+
+        let info = try bridge.readDatasetInfo(from: root)
+        XCTAssertEqual(info.fileCount, 2)
+        XCTAssertEqual(info.rowCount, 6)
+        XCTAssertEqual(info.schema.columns.map { $0.name }, ["Name", "Age", "City", "year"])
+        XCTAssertEqual(info.partitionColumns, ["year"])
+
+        // File columns and the partition column are both filled
+        let rows = try bridge.readDatasetRows(from: root, limit: 2, offset: 2)
+        XCTAssertEqual(rows.count, 2)
+        guard case .string(let name) = rows[1].values[0], case .int(let age) = rows[1].values[1],
+              case .int(let year) = rows[1].values[3] else {
+            return XCTFail("Expected file and partition values")
+        }
+        XCTAssertEqual(name, "Alice")
+        XCTAssertEqual(age, 25)
+        XCTAssertEqual(year, 2024)
+
+        let recent = ParquetPredicate(column: "year", op: .equal, values: ["2024"])
+        XCTAssertEqual(try bridge.readDatasetInfo(from: root, partitionFilter: [recent]).rowCount, 3)
+
+        // A file added after the first open shows up without clearing the cache
+        try FileManager.default.copyItem(at: dataFile,
+                                         to: root.appendingPathComponent("year=2024").appendingPathComponent("c.parquet"))
+        let grown = try bridge.readDatasetInfo(from: root)
+        XCTAssertEqual(grown.fileCount, 3)
+        XCTAssertEqual(grown.rowCount, 9)
+    }
+
+    func testReadCatalogFromMissingDirectory() throws {
+        let missing = FileManager.default.temporaryDirectory.appendingPathComponent("catalog_\(UUID().uuidString)")
+
+        XCTAssertThrowsError(try bridge.readCatalog(from: missing))
+    }
+
+    func testReadCatalogSummarizesFooters() throws {
+        let root = FileManager.default.temporaryDirectory.appendingPathComponent("catalog_\(UUID().uuidString)")
+        try FileManager.default.createDirectory(at: root, withIntermediateDirectories: true)
+        defer { try? FileManager.default.removeItem(at: root) }
+        try FileManager.default.copyItem(at: dataFile, to: root.appendingPathComponent("a.parquet"))
+        try FileManager.default.copyItem(at: dataFile, to: root.appendingPathComponent("b.parquet"))
+        try Data("not parquet".utf8).write(to: root.appendingPathComponent("c.parquet"))
+
+        let catalog = try bridge.readCatalog(from: root)
+        XCTAssertEqual(catalog.files.map { $0.url.lastPathComponent }, ["a.parquet", "b.parquet", "c.parquet"])
+        XCTAssertEqual(catalog.totalRows, 6)
+        XCTAssertEqual(catalog.schemas, ["Name: String, Age: INT64, City: String"])
+        XCTAssertEqual(catalog.files[0].rowCount, 3)
+        XCTAssertEqual(catalog.files[0].columnCount, 3)
+        XCTAssertEqual(catalog.files[1].schemaIndex, 0)
+        XCTAssertEqual(catalog.unreadableFiles.map { $0.url.lastPathComponent }, ["c.parquet"])
+    }
+
+    func testSetFooterCacheRejectsUnusableDirectory() throws {
+        let file = FileManager.default.temporaryDirectory.appendingPathComponent("footers_\(UUID().uuidString)")
+        FileManager.default.createFile(atPath: file.path, contents: Data())
+        defer {
+            try? FileManager.default.removeItem(at: file)
+            bridge.setFooterCache(directory: nil)
+        }
+
+        XCTAssertFalse(bridge.setFooterCache(directory: file))
+    }
+
+    func testFooterCacheRemovesOnlyItsAbandonedTempFiles() throws {
+        let directory = FileManager.default.temporaryDirectory.appendingPathComponent("footers_\(UUID().uuidString)")
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        defer {
+            bridge.setFooterCache(directory: nil)
+            try? FileManager.default.removeItem(at: directory)
+        }
+        // A user's file, a temp file of a live writer and one whose writer is gone
+        let live = "0123456789abcdef.footer.tmp\(ProcessInfo.processInfo.processIdentifier)-0"
+        let abandoned = "0123456789abcdef.footer.tmp999999999-0"
+        for name in ["notes.tmp", live, abandoned] {
+            FileManager.default.createFile(atPath: directory.appendingPathComponent(name).path, contents: Data())
+        }
+
+        XCTAssertTrue(bridge.setFooterCache(directory: directory))
+        let remaining = try FileManager.default.contentsOfDirectory(atPath: directory.path)
+        XCTAssertEqual(Set(remaining), ["notes.tmp", live])
+    }
+
+    func testFooterCacheServesReopenedFile() throws {
+        let directory = FileManager.default.temporaryDirectory.appendingPathComponent("footers_\(UUID().uuidString)")
+        let file = FileManager.default.temporaryDirectory.appendingPathComponent("footer_\(UUID().uuidString).parquet")
+        try FileManager.default.copyItem(at: dataFile, to: file)
+        defer {
+            bridge.setFooterCache(directory: nil)
+            try? FileManager.default.removeItem(at: directory)
+            try? FileManager.default.removeItem(at: file)
+        }
+        XCTAssertTrue(bridge.setFooterCache(directory: directory))
+
+        XCTAssertEqual(try bridge.readSchema(from: file).columns.count, 3)
+        let sidecars = try FileManager.default.contentsOfDirectory(atPath: directory.path)
+        XCTAssertEqual(sidecars.filter { $0.hasSuffix(".footer") }.count, 1)
+
+        // Reopened over the sidecar, rows still read
+        bridge.clearAllCache()
+        let rows = try bridge.readSampleRows(from: file, limit: 1, offset: 1)
+        guard case .string(let name)? = rows.first?.values.first else {
+            return XCTFail("Expected a name")
+        }
+        XCTAssertEqual(name, "Bob")
+
+        bridge.clearFooterCache()
+        XCTAssertTrue(try FileManager.default.contentsOfDirectory(atPath: directory.path).isEmpty)
+    }
+
+    func testAccelerateMissingFile() throws {
+        let missing = FileManager.default.temporaryDirectory.appendingPathComponent("missing_\(UUID().uuidString).parquet")
+
+        XCTAssertThrowsError(try bridge.accelerate(missing))
+        XCTAssertFalse(bridge.isAccelerated(missing))
+    }
+
+    func testAccelerateServesRowsFromArrowCopy() throws {
+        let directory = FileManager.default.temporaryDirectory.appendingPathComponent("accelerated_\(UUID().uuidString)")
+        let file = FileManager.default.temporaryDirectory.appendingPathComponent("accelerate_\(UUID().uuidString).parquet")
+        try FileManager.default.copyItem(at: dataFile, to: file)
+        defer {
+            bridge.removeAcceleration(for: file)
+            bridge.setAcceleratedCache(directory: nil)
+            try? FileManager.default.removeItem(at: directory)
+            try? FileManager.default.removeItem(at: file)
+        }
+        XCTAssertTrue(bridge.setAcceleratedCache(directory: directory))
+        XCTAssertFalse(bridge.isAccelerated(file))
+
+        try bridge.accelerate(file)
+        XCTAssertTrue(bridge.isAccelerated(file))
+        bridge.clearAllCache()
+        let rows = try bridge.readSampleRows(from: file, limit: 1, offset: 2)
+        guard case .string(let name) = rows[0].values[0], case .int(let age) = rows[0].values[1] else {
+            return XCTFail("Expected a name and an age")
+        }
+        XCTAssertEqual(name, "Charlie")
+        XCTAssertEqual(age, 35)
+
+        bridge.removeAcceleration(for: file)
+        XCTAssertFalse(bridge.isAccelerated(file))
+    }
+
     // MARK: - Row Count Tests
     
     func testGetRowCount() throws {
@@ -150,17 +894,247 @@ final class ParquetBridgeTests: XCTestCase {
     // MARK: - Metadata Tests
     
     func testReadMetadata() throws {
-        let testFile = createTestParquetFile()
-        defer { try? FileManager.default.removeItem(at: testFile) }
-        
-        let metadata = try bridge.readMetadata(from: testFile)
+        let metadata = try bridge.readMetadata(from: dataFile, includeStatistics: true)
         
         // Verify metadata fields
-        XCTAssertFalse(metadata.createdBy.isEmpty)
-        XCTAssertFalse(metadata.version.isEmpty)
-        XCTAssertGreaterThan(metadata.rowGroups, 0)
+        XCTAssertEqual(metadata.createdBy?.hasPrefix("parquet-cpp-arrow"), true)
+        XCTAssertFalse(metadata.version?.isEmpty ?? true)
+        XCTAssertEqual(metadata.rowGroups, 1)
+        XCTAssertEqual(metadata.compressionCodec, "SNAPPY")
+        XCTAssertEqual(metadata.columnPaths, ["Name", "Age", "City"])
+        let age = try XCTUnwrap(metadata.rowGroupDetails.first?.columns[1])
+        XCTAssertEqual(age.valueCount, 3)
+        XCTAssertEqual(age.nullCount, 0)
+        XCTAssertEqual(age.minValue, "25")
+        XCTAssertEqual(age.maxValue, "35")
     }
-    
+
+    func testReadMetadataFromDummyFooterThrows() throws {
+        let testFile = createTestParquetFile()
+        defer { try? FileManager.default.removeItem(at: testFile) }
+
+        XCTAssertThrowsError(try bridge.readMetadata(from: testFile))
+    }
+
+    func testReadMetadataFromMissingFile() {
+        let missing = URL(fileURLWithPath: "/nonexistent/file.parquet")
+        XCTAssertThrowsError(try bridge.readMetadata(from: missing, includeStatistics: true))
+    }
+
+    func testReadLayoutFromMissingFile() {
+        let missing = URL(fileURLWithPath: "/nonexistent/file.parquet")
+        XCTAssertThrowsError(try bridge.readLayout(from: missing))
+    }
+
+    func testReadLayoutWalksEveryPage() throws {
+        let layout = try bridge.readLayout(from: dataFile)
+
+        XCTAssertEqual(layout.errorCount, 0)
+        XCTAssertEqual(layout.columns.map { $0.path }, ["Name", "Age", "City"])
+        XCTAssertEqual(layout.rowGroups.map { $0.rowCount }, [3])
+        // One dictionary and one data page per column chunk
+        XCTAssertEqual(layout.total.dataPageCount, 3)
+        XCTAssertEqual(layout.total.dictionaryPageCount, 3)
+        XCTAssertEqual(layout.total.valueCount, 9)
+        XCTAssertEqual(layout.total.encodings, ["RLE_DICTIONARY"])
+        XCTAssertEqual(layout.columns.map { $0.fallbackChunkCount }, [0, 0, 0])
+        XCTAssertEqual(layout.rowGroups[0].chunks.map { $0.codec }, ["SNAPPY", "SNAPPY", "SNAPPY"])
+    }
+
+    func testRewriteRefusesToOverwriteSource() throws {
+        let testFile = createTestParquetFile()
+        defer { try? FileManager.default.removeItem(at: testFile) }
+
+        XCTAssertThrowsError(try bridge.rewriteForViewing(testFile, to: testFile))
+    }
+
+    func testRewriteKeepsRowsAndAddsPageIndex() throws {
+        let output = FileManager.default.temporaryDirectory.appendingPathComponent("rewritten_\(UUID().uuidString).parquet")
+        defer { try? FileManager.default.removeItem(at: output) }
+
+        var options = ParquetRewriteOptions()
+        options.rowGroupRows = 2
+        options.sortBy = [ParquetSortKey(column: "Age", descending: true)]
+        let result = try bridge.rewriteForViewing(dataFile, to: output, options: options)
+        XCTAssertEqual(result.rowCount, 3)
+        XCTAssertEqual(result.rowGroupCount, 2)
+
+        // Rows are sorted within each row group, not across them
+        let names = try bridge.readSampleRows(from: output).map { row -> String in
+            guard case .string(let name) = row.values[0] else { return "" }
+            return name
+        }
+        XCTAssertEqual(names, ["Bob", "Alice", "Charlie"])
+
+        let layout = try bridge.readLayout(from: output)
+        XCTAssertEqual(layout.columns.map { $0.indexedChunkCount }, [2, 2, 2])
+        XCTAssertEqual(layout.rowGroups[0].chunks[0].codec, "ZSTD")
+    }
+
+    func testValidateReportsUnreadableFooter() throws {
+        let missing = URL(fileURLWithPath: "/nonexistent/file.parquet")
+        let report = try bridge.validate(missing)
+        XCTAssertFalse(report.isValid)
+        XCTAssertNotNil(report.error)
+        XCTAssertTrue(report.columns.isEmpty)
+    }
+
+    func testValidateChecksPageCRCs() throws {
+        // Tests/TestData/checksummed.parquet: data.parquet written with page checksums
+        let checksummed = dataFile.deletingLastPathComponent().appendingPathComponent("checksummed.parquet")
+        let report = try bridge.validate(checksummed)
+        XCTAssertTrue(report.isValid)
+        XCTAssertEqual(report.rowCount, 3)
+        XCTAssertEqual(report.pageCount, 6)
+        XCTAssertEqual(report.checksummedPageCount, 6)
+
+        // Flip the last byte of the Age chunk, inside its data page body
+        let age = try XCTUnwrap(bridge.readMetadata(from: checksummed).rowGroupDetails.first?.columns[1])
+        let end = (age.dictionaryPageOffset ?? age.dataPageOffset) + age.compressedSize - 1
+        var bytes = try Data(contentsOf: checksummed)
+        bytes[end] ^= 0xFF
+        let corrupted = FileManager.default.temporaryDirectory.appendingPathComponent("corrupted_\(UUID().uuidString).parquet")
+        try bytes.write(to: corrupted)
+        defer { try? FileManager.default.removeItem(at: corrupted) }
+
+        let damaged = try bridge.validate(corrupted)
+        XCTAssertFalse(damaged.isValid)
+        XCTAssertNil(damaged.error)
+        XCTAssertEqual(damaged.invalidColumns.map { $0.path }, ["Age"])
+        let column = try XCTUnwrap(damaged.invalidColumns.first)
+        XCTAssertEqual(column.errorRowGroup, 0)
+        XCTAssertEqual(column.errorPage, 1)
+        XCTAssertTrue(column.error?.contains("CRC") ?? false)
+    }
+
+    func testExportRejectsUnknownColumn() throws {
+        let testFile = createTestParquetFile()
+        defer { try? FileManager.default.removeItem(at: testFile) }
+        let output = FileManager.default.temporaryDirectory.appendingPathComponent("export.csv")
+
+        var options = ParquetExportOptions()
+        options.columns = ["no_such_column"]
+        XCTAssertThrowsError(try bridge.export(testFile, to: output, format: .csv, options: options))
+        XCTAssertFalse(FileManager.default.fileExists(atPath: output.path))
+    }
+
+    func testParquetExportWritesSelectedRows() throws {
+        let output = FileManager.default.temporaryDirectory.appendingPathComponent("export_\(UUID().uuidString).parquet")
+        defer { try? FileManager.default.removeItem(at: output) }
+
+        var options = ParquetExportOptions()
+        options.columns = ["Name", "Age"]
+        options.predicates = [ParquetPredicate(column: "Age", op: .greaterThan, values: ["28"])]
+        options.sortBy = [ParquetSortKey(column: "Age", descending: true)]
+        var reported: [(Int, Int)] = []
+        let result = try bridge.export(dataFile, to: output, format: .parquet, options: options) { written, total in
+            reported.append((written, total))
+            return true
+        }
+        XCTAssertEqual(result.rowCount, 2)
+        XCTAssertFalse(result.cancelled)
+        XCTAssertEqual(reported.last?.0, 2)
+
+        XCTAssertEqual(try bridge.readSchema(from: output).columns.map { $0.name }, ["Name", "Age"])
+        let rows = try bridge.readSampleRows(from: output)
+        XCTAssertEqual(rows.count, 2)
+        guard case .string(let first) = rows[0].values[0], case .int(let age) = rows[0].values[1],
+              case .string(let second) = rows[1].values[0] else {
+            return XCTFail("Expected names and ages")
+        }
+        XCTAssertEqual(first, "Charlie")
+        XCTAssertEqual(age, 35)
+        XCTAssertEqual(second, "Bob")
+    }
+
+    func testParquetExportCopiesProjectedChunks() throws {
+        let indexed = FileManager.default.temporaryDirectory.appendingPathComponent("indexed_\(UUID().uuidString).parquet")
+        let output = FileManager.default.temporaryDirectory.appendingPathComponent("export_\(UUID().uuidString).parquet")
+        defer {
+            try? FileManager.default.removeItem(at: indexed)
+            try? FileManager.default.removeItem(at: output)
+        }
+        // Three row groups of 500-row pages, with a page index and a stored Arrow schema
+        var rewrite = ParquetRewriteOptions()
+        rewrite.rowGroupRows = 4_000
+        rewrite.maxRowsPerPage = 500
+        _ = try bridge.rewriteForViewing(numbersFile, to: indexed, options: rewrite)
+
+        // No predicates or sort: the chunks are copied as stored
+        var options = ParquetExportOptions()
+        options.columns = ["label", "id"]
+        let result = try bridge.export(indexed, to: output, format: .parquet, options: options)
+        XCTAssertEqual(result.rowCount, 10_000)
+
+        // The stored Arrow schema describes only the copied columns
+        XCTAssertEqual(try bridge.readSchema(from: output).columns.map { $0.name }, ["label", "id"])
+        let rows = try bridge.readSampleRows(from: output, limit: 1, offset: 5_123)
+        guard case .string(let label)? = rows.first?.values[0], case .int(let id)? = rows.first?.values[1] else {
+            return XCTFail("Expected a label and an id")
+        }
+        XCTAssertEqual(label, "row 5123")
+        XCTAssertEqual(id, 5_123)
+
+        // Chunk statistics come across from the source footer
+        let metadata = try bridge.readMetadata(from: output, includeStatistics: true)
+        XCTAssertEqual(metadata.rowGroups, 3)
+        XCTAssertEqual(metadata.columnPaths, ["label", "id"])
+        let ids = try XCTUnwrap(metadata.rowGroupDetails[1].columns[1])
+        XCTAssertEqual(ids.valueCount, 4_000)
+        XCTAssertEqual(ids.minValue, "4000")
+        XCTAssertEqual(ids.maxValue, "7999")
+
+        // Every chunk keeps its page index, and the shifted offset index
+        // still points at the chunk's pages
+        let layout = try bridge.readLayout(from: output)
+        XCTAssertEqual(layout.columns.map { $0.indexedChunkCount }, [3, 3])
+        let report = try bridge.validate(output)
+        XCTAssertTrue(report.isValid, report.invalidColumns.first?.error ?? "")
+
+        // The copied column index skips pages that cannot hold the id
+        let wanted = ParquetPredicate(column: "id", op: .equal, values: ["4321"])
+        let (found, total, summary) = try bridge.readPredicateRows(from: output, predicates: [wanted])
+        XCTAssertEqual(total, 1)
+        XCTAssertGreaterThan(summary.pagesSkipped, 0)
+        guard case .string(let foundLabel)? = found.first?.values.first else {
+            return XCTFail("Expected a label")
+        }
+        XCTAssertEqual(foundLabel, "row 4321")
+    }
+
+    func testExportKeepsRowsMatchingFilterText() throws {
+        let output = FileManager.default.temporaryDirectory.appendingPathComponent("export_\(UUID().uuidString).parquet")
+        defer { try? FileManager.default.removeItem(at: output) }
+
+        // "ic" is in Alice and in Chicago; Age > 28 leaves Charlie
+        var options = ParquetExportOptions()
+        options.columns = ["Name"]
+        options.filterText = "IC"
+        options.predicates = [ParquetPredicate(column: "Age", op: .greaterThan, values: ["28"])]
+        let result = try bridge.export(dataFile, to: output, format: .parquet, options: options)
+        XCTAssertEqual(result.rowCount, 1)
+
+        let rows = try bridge.readSampleRows(from: output)
+        XCTAssertEqual(rows.count, 1)
+        guard case .string(let name)? = rows.first?.values.first else {
+            return XCTFail("Expected a name")
+        }
+        XCTAssertEqual(name, "Charlie")
+
+        // The search alone keeps the rows the filtered page shows
+        options.predicates = []
+        XCTAssertEqual(try bridge.export(dataFile, to: output, format: .parquet, options: options).rowCount, 2)
+        XCTAssertEqual(try bridge.readFilteredRows(from: dataFile, filterText: "IC").1, 2)
+    }
+
+    func testParquetExportRefusesToOverwriteSource() throws {
+        let testFile = createTestParquetFile()
+        defer { try? FileManager.default.removeItem(at: testFile) }
+
+        XCTAssertThrowsError(try bridge.export(testFile, to: testFile, format: .parquet))
+        XCTAssertTrue(FileManager.default.fileExists(atPath: testFile.path))
+    }
+
     // MARK: - Type Conversion Tests
     
     func testParquetTypeConversion() throws {
@@ -277,7 +1251,59 @@ final class ParquetBridgeTests: XCTestCase {
     }
     
     // MARK: - Helper Methods
+
+    /// Tests/TestData/data.parquet: Name, Age and City of Alice (25, New York),
+    /// Bob (30, Los Angeles) and Charlie (35, Chicago)
+    private var dataFile: URL {
+        URL(fileURLWithPath: #filePath)
+            .deletingLastPathComponent()
+            .deletingLastPathComponent()
+            .appendingPathComponent("TestData/data.parquet")
+    }
     
+    /// Tests/TestData/numbers.parquet: one row group of 10,000 rows with id
+    /// 0 to 9999, label "row <id>" and region north (id % 10 < 5), south
+    /// (5 to 7) or east (8 and 9)
+    private var numbersFile: URL {
+        dataFile.deletingLastPathComponent().appendingPathComponent("numbers.parquet")
+    }
+
+    /// Tests/TestData/bitmap.parquet: 150,000 rows in row groups of 51,200
+    /// with id, m15 (id % 15), m16 (id % 16) and band, true for ids 1000 to
+    /// 29999, then every 16th id from 65536, then every 3rd from 131072
+    private var bitmapFile: URL {
+        dataFile.deletingLastPathComponent().appendingPathComponent("bitmap.parquet")
+    }
+
+    /// Tests/TestData/decimals.parquet: ids 1 to 6, amount DECIMAL(20,2) as
+    /// FIXED_LEN_BYTE_ARRAY (-5.50, 0.10, 100.00, 12345678901234567.89, null,
+    /// 99999999999999999.99) and price DECIMAL(9,2) as INT32 (-5.50, 0.10,
+    /// 100.00, null, 7.25, 7.25), in one row group
+    private var decimalsFile: URL {
+        dataFile.deletingLastPathComponent().appendingPathComponent("decimals.parquet")
+    }
+
+    /// Tests/TestData/large_string.arrow: an Arrow IPC file with ids 1 to 3
+    /// and a large_string text column holding "alpha", 10,000 "é" and
+    /// "gamma ray"
+    private var largeStringFile: URL {
+        dataFile.deletingLastPathComponent().appendingPathComponent("large_string.arrow")
+    }
+
+    /// Tests/TestData/uuid.parquet: ids 1 and 2 and key, a UUID logical type
+    /// column holding 0f8fad5b-d9cb-469f-a165-70867728950e and
+    /// 7c9e6679-7425-40de-944b-e07fc1f90ae7
+    private var uuidFile: URL {
+        dataFile.deletingLastPathComponent().appendingPathComponent("uuid.parquet")
+    }
+
+    /// Tests/TestData/nested.parquet: three rows of id, payload (a struct
+    /// of user {id, name} and score), events (a list of {kind, step}) and
+    /// attrs (a map of string to integer); user ids are 10, 20 and 30
+    private var nestedFile: URL {
+        dataFile.deletingLastPathComponent().appendingPathComponent("nested.parquet")
+    }
+
     private func createTestParquetFile(rows: Int = 100) -> URL {
         // Create a minimal parquet file for testing
         // In a real test, this would create an actual parquet file